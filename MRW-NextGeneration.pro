@@ -15,12 +15,19 @@ SUBDIRS  = \
 	ui \
 	test \
 	test-sct \
+	bench-routing \
+	bench-load \
+	bench-messages \
+	bench-model \
 	ping \
 	reset \
 	reader \
+	replay \
+	generator \
 	sim \
 	proxy \
 	tracker \
+	trace \
 	config \
 	update \
 	study \
@@ -36,12 +43,19 @@ mock.file              = mock/MRW-CtrlMock.pro
 ui.file                = ui/MRW-UI.pro
 test.file              = test/MRW-Test.pro
 test-sct.file          = statecharts/test/MRW-Test-Statecharts.pro
+bench-routing.file     = benchmark/routing/MRW-Benchmark-Routing.pro
+bench-load.file        = benchmark/loading/MRW-Benchmark-Load.pro
+bench-messages.file    = benchmark/messages/MRW-Benchmark-Messages.pro
+bench-model.file       = benchmark/model/MRW-Benchmark-Model.pro
 ping.file              = tools/ping/MRW-Ping.pro
 reset.file             = tools/reset/MRW-Reset.pro
 reader.file            = tools/reader/MRW-Reader.pro
+replay.file            = tools/replay/MRW-Replay.pro
+generator.file         = tools/generator/MRW-Generator.pro
 sim.file               = tools/sim/MRW-Simulator.pro
 proxy.file             = tools/proxy/MRW-Proxy.pro
 tracker.file           = tools/tracker/MRW-Tracker.pro
+trace.file             = tools/trace/MRW-Trace.pro
 config.file            = tools/config/MRW-Configure.pro
 update.file            = tools/update/MRW-Update.pro
 study.file             = widget-study/MRW-WidgetStudy.pro
@@ -53,13 +67,20 @@ model.depends          = util can
 ctrl.depends           = util can model
 mock.depends           = ctrl
 ui.depends             = ctrl
-test.depends           = util can model mock ui
+test.depends           = util log can model statecharts mock ui
+bench-routing.depends  = util can model
+bench-load.depends     = util can model
+bench-messages.depends = util can
+bench-model.depends    = util can model
 ping.depends           = util can model
 reset.depends          = util can model
 reader.depends         = util can model
-sim.depends            = util can model
+replay.depends         = util can statecharts
+generator.depends      = util can model
+sim.depends            = util can model statecharts
 proxy.depends          = util can model
 tracker.depends        = util can model statecharts
+trace.depends          = util can
 config.depends         = util can model statecharts
 update.depends         = util can model statecharts
 study.depends          = test
@@ -0,0 +1,16 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT     -= gui
+CONFIG += console
+
+include(../../common.pri)
+
+SOURCES += \
+	main.cpp
+
+LIBS   += -lMRW-Model -lMRW-Can -lMRW-Util
+
+QMAKE_CLEAN += $$TARGET
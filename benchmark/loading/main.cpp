@@ -0,0 +1,275 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <optional>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+
+#include <util/appsupport.h>
+#include <util/phaseprofile.h>
+#include <util/settings.h>
+#include <model/modelrepository.h>
+
+using namespace mrw::util;
+using namespace mrw::model;
+
+/*************************************************************************
+**                                                                      **
+**       Allocation counting                                            **
+**                                                                      **
+*************************************************************************/
+
+static std::atomic<size_t> allocation_count{0};
+
+void * operator new(size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	void * ptr = std::malloc(size > 0 ? size : 1);
+
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t size) noexcept
+{
+	(void)size;
+
+	std::free(ptr);
+}
+
+static size_t allocations()
+{
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+/*************************************************************************
+**                                                                      **
+**       Benchmark                                                      **
+**                                                                      **
+*************************************************************************/
+
+static constexpr const char * TOTAL = "total";
+
+struct Result
+{
+	const char     *     name        = nullptr;
+	size_t               calls       = 0;
+	size_t               allocations = 0;
+	long                 peak_rss    = 0;
+	std::vector<qint64>  nsecs;
+};
+
+static QString propertyFile(const QFileInfo & model_info, const char * name)
+{
+	const QFileInfo info(model_info.dir(), name);
+
+	return info.exists() ? info.absoluteFilePath() : QString();
+}
+
+/**
+ * The ModelRepository finds its files using the QSettings of the model
+ * name. So the settings are prepared here pointing to the given model file
+ * and the properties files next to it. The model snapshot is disabled so
+ * the XML file is parsed each time.
+ */
+static QString prepareSettings(const QString & filename)
+{
+	const QFileInfo info(filename);
+	const QString   modelname = "Benchmark" + info.completeBaseName().remove(' ');
+
+	{
+		Settings      settings(modelname);
+		SettingsGroup group(&settings, "files");
+
+		settings.setValue("filename",  info.absoluteFilePath());
+		settings.setValue("regions",   propertyFile(info, "Gruppen.properties"));
+		settings.setValue("signals",   propertyFile(info, "Signale.properties"));
+		settings.setValue("railparts", propertyFile(info, "Gleisteile.properties"));
+	}
+
+	{
+		Settings      settings;
+		SettingsGroup group(&settings, AppSupport::instance().hostname());
+
+		settings.setValue("snapshot", false);
+	}
+	return modelname;
+}
+
+static std::vector<Result> measure(const QString & modelname, const unsigned runs)
+{
+	std::vector<Result> results;
+
+	for (unsigned r = 0; r < runs; r++)
+	{
+		std::optional<ModelRepository> repo;
+		PhaseProfile                   profile(&allocations);
+
+		{
+			PhaseProfile::Scope phase(TOTAL);
+
+			repo.emplace(modelname, true);
+		}
+
+		for (const PhaseProfile::Phase & phase : profile.phases())
+		{
+			auto it = std::find_if(results.begin(), results.end(), [&](const Result & result)
+			{
+				return qstrcmp(result.name, phase.name) == 0;
+			});
+
+			if (it == results.end())
+			{
+				results.push_back(Result{phase.name});
+				it = std::prev(results.end());
+			}
+			it->calls       = phase.calls;
+			it->allocations = phase.allocations;
+			it->peak_rss    = std::max(it->peak_rss, phase.peak_rss);
+			it->nsecs.push_back(phase.nsecs);
+		}
+	}
+	return results;
+}
+
+static qint64 median(std::vector<qint64> values)
+{
+	std::sort(values.begin(), values.end());
+
+	return values.empty() ? 0 : values[values.size() / 2];
+}
+
+int main(int argc, char * argv[])
+{
+	QCoreApplication app(argc, argv);
+	QLoggingCategory log("mrw.benchmark.load");
+	QStringList      files;
+	QString          json_filename;
+	unsigned         runs = 5;
+
+	// Keep the user settings untouched.
+	QStandardPaths::setTestModeEnabled(true);
+	QLoggingCategory::setFilterRules("mrw.*.debug=false\nmrw.*.info=false\nmrw.benchmark.*.info=true");
+
+	for (int i = 1; i < argc; i++)
+	{
+		const bool has_value = (i + 1) < argc;
+
+		if ((qstrcmp(argv[i], "--runs") == 0) && has_value)
+		{
+			runs = std::max(QString(argv[++i]).toUInt(), 1u);
+		}
+		else if ((qstrcmp(argv[i], "--json") == 0) && has_value)
+		{
+			json_filename = argv[++i];
+		}
+		else
+		{
+			files << argv[i];
+		}
+	}
+
+	if (files.isEmpty())
+	{
+		qCCritical(log, "Usage: MRW-Benchmark-Load [--runs n] [--json file|-] <modelrailway files...>");
+		return EXIT_FAILURE;
+	}
+
+	QJsonArray models;
+
+	for (const QString & filename : files)
+	{
+		if (!QFileInfo::exists(filename))
+		{
+			qCCritical(log).noquote() << "Model file not found:" << filename;
+			return EXIT_FAILURE;
+		}
+
+		const std::vector<Result> & results = measure(prepareSettings(filename), runs);
+		QJsonArray                  phases;
+
+		qCInfo(log).noquote() << "=====" << filename;
+		qCInfo(log, "%-18s %6s %12s %12s %12s %10s",
+			"Phase", "Calls", "Median [us]", "Min [us]", "Allocations", "RSS [kB]");
+		for (const Result & result : results)
+		{
+			const qint64 median_ns = median(result.nsecs);
+			const qint64 min_ns    = *std::min_element(result.nsecs.begin(), result.nsecs.end());
+
+			qCInfo(log, "%-18s %6zu %12.1f %12.1f %12zu %10ld",
+				result.name, result.calls,
+				median_ns / 1000.0, min_ns / 1000.0,
+				result.allocations, result.peak_rss);
+
+			phases.append(QJsonObject
+			{
+				{ "phase",       result.name },
+				{ "calls",       qint64(result.calls) },
+				{ "median_ns",   median_ns },
+				{ "min_ns",      min_ns },
+				{ "allocations", qint64(result.allocations) },
+				{ "peak_rss_kb", qint64(result.peak_rss) }
+			});
+		}
+
+		models.append(QJsonObject
+		{
+			{ "model",  filename },
+			{ "runs",   qint64(runs) },
+			{ "phases", phases }
+		});
+	}
+
+	if (!json_filename.isEmpty())
+	{
+		QJsonObject root
+		{
+			{ "benchmark", "model-load" },
+			{ "models",    models }
+		};
+
+#ifdef BUILD_NUMBER
+		root.insert("build", BUILD_NUMBER);
+#endif
+		const QByteArray json = QJsonDocument(root).toJson();
+
+		if (json_filename == "-")
+		{
+			fwrite(json.constData(), 1, json.size(), stdout);
+		}
+		else
+		{
+			QFile file(json_filename);
+
+			if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || (file.write(json) != json.size()))
+			{
+				qCCritical(log).noquote() << "Cannot write" << json_filename;
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	return EXIT_SUCCESS;
+}
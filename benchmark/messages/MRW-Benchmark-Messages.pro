@@ -0,0 +1,21 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT     += testlib
+QT     -= gui
+CONFIG += console
+
+include(../../common.pri)
+
+SOURCES += \
+	benchmessages.cpp \
+	main.cpp
+
+HEADERS += \
+	benchmessages.h
+
+LIBS   += -lMRW-Can -lMRW-Util
+
+QMAKE_CLEAN += $$TARGET
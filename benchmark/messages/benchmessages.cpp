@@ -0,0 +1,104 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <vector>
+
+#include <QCanBusFrame>
+#include <QTest>
+
+#include <can/mrwmessage.h>
+#include <can/wiremessage.h>
+
+#include "benchmessages.h"
+
+using namespace mrw::benchmark;
+using namespace mrw::can;
+
+void BenchMessages::commands()
+{
+	static const std::vector<Command> all_commands
+	{
+		SETLFT, SETRGT, GETDIR,
+		SETRON, SETROF, GETRBS,
+		SETSGN,
+		CFGCRX, CFGSWN, CFGSWO, CFGRAI, CFGPF2, CFGPF3, CFGMF2, CFGMF3,
+		CFGPL2, CFGPL3, CFGSL2, CFGML2, CFGML3, CFGML4, CFGLGT, CFGSF2,
+		CFGBGN, CFGEND, SET_ID, PING, RESET, GETCFG, GETDVC,
+		FLASH_REQ, FLASH_DATA, FLASH_CHECK, QRYBUF, QRYERR, GETVER, SENSOR
+	};
+
+	QTest::addColumn<int>("code");
+	QTest::addColumn<bool>("response");
+
+	for (const Command command : all_commands)
+	{
+		const QByteArray name = MrwMessage::get(command).toLatin1();
+
+		QTest::newRow((name + " request").constData())  << int(command) << false;
+		QTest::newRow((name + " response").constData()) << int(command) << true;
+	}
+}
+
+void BenchMessages::benchWireMessage_data()
+{
+	commands();
+}
+
+void BenchMessages::benchWireMessage()
+{
+	QFETCH(int,  code);
+	QFETCH(bool, response);
+
+	const Command command = Command(code);
+	size_t        sum     = 0;
+
+	QBENCHMARK
+	{
+		sum = 0;
+		for (unsigned i = 0; i < COUNT; i++)
+		{
+			const ControllerId id = ControllerId(i & CAN_SID_MASK);
+			const WireMessage  message = response ?
+				WireMessage(id, UnitNo(i), command, Response::MSG_OK) :
+				WireMessage(command, id, UnitNo(i));
+			const QCanBusFrame frame(message);
+			const WireMessage  decoded(frame);
+
+			sum += decoded.unitNo() + decoded.command();
+		}
+	}
+	QVERIFY(sum > 0);
+}
+
+void BenchMessages::benchMrwMessage_data()
+{
+	commands();
+}
+
+void BenchMessages::benchMrwMessage()
+{
+	QFETCH(int,  code);
+	QFETCH(bool, response);
+
+	const Command command = Command(code);
+	size_t        sum     = 0;
+
+	QBENCHMARK
+	{
+		sum = 0;
+		for (unsigned i = 0; i < COUNT; i++)
+		{
+			const ControllerId id = ControllerId(i & CAN_SID_MASK);
+			const MrwMessage   message = response ?
+				MrwMessage(id, UnitNo(i), command, Response::MSG_OK) :
+				MrwMessage(command, id, UnitNo(i));
+			const QCanBusFrame frame(message);
+			const MrwMessage   decoded(frame);
+
+			sum += decoded.unitNo() + decoded.command();
+		}
+	}
+	QVERIFY(sum > 0);
+}
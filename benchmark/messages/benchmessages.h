@@ -0,0 +1,37 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_BENCHMARK_BENCHMESSAGES_H
+#define MRW_BENCHMARK_BENCHMESSAGES_H
+
+#include <QObject>
+
+namespace mrw::benchmark
+{
+	/**
+	 * This class measures encoding a request or response into a
+	 * QCanBusFrame and decoding it again for each Command. The compact
+	 * WireMessage is compared with the MrwMessage.
+	 */
+	class BenchMessages : public QObject
+	{
+		Q_OBJECT
+
+		static constexpr unsigned COUNT = 10000;
+
+	private slots:
+		void benchWireMessage_data();
+		void benchWireMessage();
+		void benchMrwMessage_data();
+		void benchMrwMessage();
+
+	private:
+		static void commands();
+	};
+}
+
+#endif
@@ -0,0 +1,24 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT     += testlib
+QT     -= gui
+CONFIG += console
+
+include(../../common.pri)
+
+SOURCES += \
+	benchmodel.cpp \
+	main.cpp
+
+HEADERS += \
+	benchmodel.h
+
+DEFINES += \
+	MRW_TEST_DIR=\"\\\"$$PWD/../../test\\\"\"
+
+LIBS   += -lMRW-Model -lMRW-Can -lMRW-Util
+
+QMAKE_CLEAN += $$TARGET
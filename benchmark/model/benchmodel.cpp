@@ -0,0 +1,221 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <regex>
+#include <unordered_map>
+
+#include <QDir>
+#include <QFile>
+#include <QTest>
+#include <QXmlStreamReader>
+
+#include <util/stringutil.h>
+#include <can/mrwmessage.h>
+#include <model/device.h>
+#include <model/emfpath.h>
+
+#include "benchmodel.h"
+
+using namespace mrw::benchmark;
+using namespace mrw::can;
+using namespace mrw::model;
+
+namespace
+{
+	struct Registrand
+	{
+		virtual ~Registrand() = default;
+	};
+
+	struct TestRegistrand : public Registrand
+	{
+	};
+}
+
+void BenchModel::benchDeviceTable()
+{
+	// Replays the response trace using the flat lookup of the message
+	// dispatcher.
+	using Entry = std::pair<Device *, Registrand *>;
+
+	const ModelRailway             model(MRW_TEST_DIR "/Test-Railway.modelrailway");
+	const std::vector<DeviceKey> & keys = trace(model);
+	std::vector<Device *>          devices;
+	std::vector<TestRegistrand>    registrands;
+	DeviceTable<Entry>             table;
+	size_t                         count = 0;
+
+	model.parts<Device>(devices);
+	registrands.resize(devices.size());
+	for (size_t i = 0; i < devices.size(); i++)
+	{
+		table.slot(DeviceId(devices[i])) = { devices[i], &registrands[i] };
+	}
+
+	QBENCHMARK
+	{
+		count = 0;
+		for (const DeviceKey & key : keys)
+		{
+			count += table.get(key).second != nullptr;
+		}
+	}
+	QCOMPARE(count, keys.size());
+}
+
+void BenchModel::benchDeviceHash()
+{
+	// Replays the response trace using the former hashed lookups of the
+	// message dispatcher.
+	const ModelRailway                                  model(MRW_TEST_DIR "/Test-Railway.modelrailway");
+	const std::vector<DeviceKey>                      & keys = trace(model);
+	std::vector<Device *>                               devices;
+	std::vector<TestRegistrand>                         registrands;
+	std::unordered_map<DeviceKey, Device *, DeviceId>   device_map;
+	std::unordered_map<Device *, Registrand *>          registry;
+	size_t                                              count = 0;
+
+	model.parts<Device>(devices);
+	registrands.resize(devices.size());
+	for (size_t i = 0; i < devices.size(); i++)
+	{
+		device_map.emplace(DeviceId(devices[i]), devices[i]);
+		registry.emplace(devices[i], &registrands[i]);
+	}
+
+	QBENCHMARK
+	{
+		count = 0;
+		for (const DeviceKey & key : keys)
+		{
+			const auto   device_it = device_map.find(key);
+			Device     * device    = device_it != device_map.end() ? device_it->second : nullptr;
+			const auto   ctrl_it   = registry.find(device);
+			Registrand * ctrl      = ctrl_it != registry.end() ? ctrl_it->second : nullptr;
+
+			count += dynamic_cast<TestRegistrand *>(ctrl) != nullptr;
+		}
+	}
+	QCOMPARE(count, keys.size());
+}
+
+void BenchModel::benchEmfPath()
+{
+	const QStringList & paths = references();
+	size_t              count = 0;
+
+	QVERIFY(!paths.isEmpty());
+	QBENCHMARK
+	{
+		count = 0;
+		for (const QString & path : paths)
+		{
+			count += EmfPath::match(path, EmfPath::ASSEMBLY_PART).has_value();
+			count += EmfPath::match(path, EmfPath::SECTION).has_value();
+			count += EmfPath::match(path, EmfPath::MODULE).has_value();
+			count += EmfPath::match(path, EmfPath::CONNECTION).has_value();
+			count += EmfPath::match(path, EmfPath::CROSSING).has_value();
+		}
+	}
+	QCOMPARE(count, size_t(paths.size()));
+}
+
+void BenchModel::benchEmfPathRegex()
+{
+	// These are the regular expressions formerly used for linking.
+	static const std::regex patterns[]
+	{
+		std::regex(R"(^\/\/@gruppe\.(\d+)\/@abschnitt\.(\d+)\/@bauelement\.(\d+))"),
+		std::regex(R"(^\/\/@gruppe\.(\d+)\/@abschnitt\.(\d+))"),
+		std::regex(R"(^\/\/@controller\.(\d+)\/@module\.(\d+))"),
+		std::regex(R"(^\/\/@controller\.(\d+)\/@anschluesse\.(\d+))"),
+		std::regex(R"(^\/\/@controller\.(\d+)\/@anschluesse\.(\d+)\/@crossing\.(\d+))")
+	};
+
+	const QStringList & paths = references();
+	size_t              count = 0;
+
+	QVERIFY(!paths.isEmpty());
+	QBENCHMARK
+	{
+		count = 0;
+		for (const QString & path : paths)
+		{
+			for (const std::regex & pattern : patterns)
+			{
+				std::smatch         matcher;
+				const std::string & input = path.toStdString();
+
+				if (std::regex_match(input, matcher, pattern))
+				{
+					const unsigned index = std::stoul(matcher[1]);
+
+					Q_UNUSED(index);
+					count++;
+				}
+			}
+		}
+	}
+	QCOMPARE(count, size_t(paths.size()));
+}
+
+QStringList BenchModel::references()
+{
+	const QDir  dir(MRW_TEST_DIR);
+	QStringList paths;
+
+	// Collect all EMF paths of all test models.
+	for (const QString & model_filename : dir.entryList({ "*.modelrailway" }, QDir::Files))
+	{
+		QFile            file(dir.filePath(model_filename));
+		QXmlStreamReader reader;
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			continue;
+		}
+
+		reader.setDevice(&file);
+		while (!reader.atEnd())
+		{
+			if (reader.readNext() == QXmlStreamReader::StartElement)
+			{
+				for (const QXmlStreamAttribute & attribute : reader.attributes())
+				{
+					const QString & value = attribute.value().toString();
+
+					if (value.startsWith("//@"))
+					{
+						paths << value.split(' ', SKIP_EMPTY_PARTS);
+					}
+				}
+			}
+		}
+	}
+	return paths;
+}
+
+std::vector<DeviceKey> BenchModel::trace(const ModelRailway & model)
+{
+	static constexpr size_t ROUNDS = 100;
+
+	std::vector<Device *>  devices;
+	std::vector<DeviceKey> keys;
+
+	// Every Device answers once per round in model order like after a
+	// complete state request.
+	model.parts<Device>(devices);
+	keys.reserve(devices.size() * ROUNDS);
+	for (size_t r = 0; r < ROUNDS; r++)
+	{
+		for (const Device * device : devices)
+		{
+			const MrwMessage & message = device->command(GETRBS);
+
+			keys.emplace_back(message.sid(), message.unitNo());
+		}
+	}
+	return keys;
+}
@@ -0,0 +1,45 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_BENCHMARK_BENCHMODEL_H
+#define MRW_BENCHMARK_BENCHMODEL_H
+
+#include <vector>
+
+#include <QObject>
+#include <QStringList>
+
+#include <can/devicetable.h>
+#include <model/modelrailway.h>
+
+namespace mrw::benchmark
+{
+	/**
+	 * This class measures the lookups used while loading and running a
+	 * model railway. The flat DeviceTable lookup of the message dispatcher
+	 * is compared with the former hashed lookups. The EMF path parser is
+	 * compared with the regular expressions formerly used for linking.
+	 * The build system passes the test directory containing the test
+	 * layouts as MRW_TEST_DIR.
+	 */
+	class BenchModel : public QObject
+	{
+		Q_OBJECT
+
+	private slots:
+		void benchDeviceTable();
+		void benchDeviceHash();
+		void benchEmfPath();
+		void benchEmfPathRegex();
+
+	private:
+		static QStringList references();
+		static std::vector<mrw::can::DeviceKey> trace(const mrw::model::ModelRailway & model);
+	};
+}
+
+#endif
@@ -0,0 +1,23 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTest>
+
+#include "benchmodel.h"
+
+using namespace mrw::benchmark;
+
+int main(int argc, char * argv[])
+{
+	QCoreApplication app(argc, argv);
+	BenchModel       bench;
+
+	// Logging would dominate the measured times.
+	QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+
+	return QTest::qExec(&bench, argc, argv);
+}
@@ -0,0 +1,25 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT     += testlib
+QT     -= gui
+CONFIG += console
+
+include(../../common.pri)
+
+SOURCES += \
+	benchrouting.cpp \
+	main.cpp
+
+HEADERS += \
+	benchrouting.h
+
+DEFINES += \
+	MRW_TEST_DIR=\"\\\"$$PWD/../../test\\\"\" \
+	MRW_SYNTHETIC_MODEL=\"\\\"$$OUT_PWD/synthetic/Synthetic.modelrailway\\\"\"
+
+LIBS   += -lMRW-Model -lMRW-Can -lMRW-Util
+
+QMAKE_CLEAN += $$TARGET
@@ -0,0 +1,83 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+
+#include <QFile>
+#include <QTest>
+
+#include <model/modelrailway.h>
+#include <model/rail.h>
+#include <model/route.h>
+#include <model/routecost.h>
+
+#include "benchrouting.h"
+
+using namespace mrw::benchmark;
+using namespace mrw::model;
+
+void BenchRouting::benchRoute_data()
+{
+	QTest::addColumn<QString>("filename");
+	QTest::addColumn<bool>("planner");
+
+	const QString synthetic(MRW_SYNTHETIC_MODEL);
+
+	QTest::newRow("Railway DFS")       << testModel("Test-Railway") << false;
+	QTest::newRow("Railway planner")   << testModel("Test-Railway") << true;
+	QTest::newRow("Flank DFS")         << testModel("Test-Flank")   << false;
+	QTest::newRow("Flank planner")     << testModel("Test-Flank")   << true;
+	QTest::newRow("Synthetic DFS")     << synthetic                 << false;
+	QTest::newRow("Synthetic planner") << synthetic                 << true;
+}
+
+void BenchRouting::benchRoute()
+{
+	QFETCH(QString, filename);
+	QFETCH(bool,    planner);
+
+	if (!QFile::exists(filename))
+	{
+		QSKIP("Model railway file not generated.");
+	}
+
+	static const SwitchingCost switching_cost;
+
+	ModelRailway        model(filename);
+	std::vector<Rail *> rails;
+
+	model.parts<Rail>(rails);
+	QVERIFY(!rails.empty());
+
+	const size_t stride = std::max<size_t>(1, rails.size() / MAX_STARTS);
+	size_t       found  = 0;
+
+	QBENCHMARK
+	{
+		found = 0;
+		for (size_t s = 0; s < rails.size(); s += stride)
+		{
+			for (const bool dir : { false, true })
+			{
+				for (size_t t = 1; t <= TARGETS; t++)
+				{
+					Route route(dir, SectionState::TOUR, rails[s]);
+
+					route.setCostModel(planner ? &switching_cost : nullptr);
+					if (route.append(rails[(s + t) % rails.size()]))
+					{
+						found++;
+					}
+				}
+			}
+		}
+	}
+	QVERIFY(found > 0);
+}
+
+QString BenchRouting::testModel(const char * modelname)
+{
+	return QString(MRW_TEST_DIR "/") + modelname + ".modelrailway";
+}
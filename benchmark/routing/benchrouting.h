@@ -0,0 +1,38 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_BENCHMARK_BENCHROUTING_H
+#define MRW_BENCHMARK_BENCHROUTING_H
+
+#include <QObject>
+
+namespace mrw::benchmark
+{
+	/**
+	 * This class measures the Route search on the test layouts and on a
+	 * large synthetic layout generated by MRW-Generator. Each layout is
+	 * measured using the depth first search only and using the least cost
+	 * planner. The build system passes the test directory as
+	 * MRW_TEST_DIR and the generated layout as MRW_SYNTHETIC_MODEL.
+	 */
+	class BenchRouting : public QObject
+	{
+		Q_OBJECT
+
+		static constexpr size_t MAX_STARTS = 64;
+		static constexpr size_t TARGETS    = 8;
+
+	private slots:
+		void benchRoute_data();
+		void benchRoute();
+
+	private:
+		static QString testModel(const char * modelname);
+	};
+}
+
+#endif
@@ -11,13 +11,18 @@ include(../common.pri)
 SOURCES += \
 	cansettings.cpp \
 	mrwbusservice.cpp \
-	mrwmessage.cpp
+	mrwmessage.cpp \
+	occupationcoalescer.cpp \
+	wiremessage.cpp
 
 HEADERS += \
 	cansettings.h \
 	commands.h \
+	devicetable.h \
 	mrwbusservice.h \
 	mrwmessage.h \
-	types.h
+	occupationcoalescer.h \
+	types.h \
+	wiremessage.h
 
 QMAKE_CLEAN  += $$TARGET
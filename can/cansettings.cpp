@@ -14,8 +14,9 @@ CanSettings::CanSettings() :
 {
 	SettingsGroup group (this, hostname);
 
-	can_plugin  = value("plugin", "socketcan").toString();
-	can_iface   = value("interface", "can0").toString();
+	can_plugin   = value("plugin", "socketcan").toString();
+	can_iface    = value("interface", "can0").toString();
+	can_threaded = value("threaded", false).toBool();
 }
 
 const QString & CanSettings::plugin() const noexcept
@@ -28,6 +29,11 @@ const QString & CanSettings::interface() const noexcept
 	return can_iface;
 }
 
+bool CanSettings::threaded() const noexcept
+{
+	return can_threaded;
+}
+
 CanSettings::operator SettingsGroup()
 {
 	return SettingsGroup(this, hostname);
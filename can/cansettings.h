@@ -29,6 +29,7 @@ namespace mrw::can
 		QString  hostname;
 		QString  can_plugin;
 		QString  can_iface;
+		bool     can_threaded = false;
 
 	public:
 		CanSettings();
@@ -54,6 +55,17 @@ namespace mrw::can
 		 */
 		const QString & interface() const noexcept;
 
+		/**
+		 * This method returns true if the QCanBusDevice should run on its
+		 * own I/O thread. The mode is configured inside the
+		 * &lt;modelname&gt;.conf file under the value
+		 * &lt;hostname&gt;/threaded. The default is false.
+		 *
+		 * @return True if the CAN bus should use its own I/O thread.
+		 * @see MrwBusService
+		 */
+		bool threaded() const noexcept;
+
 		/**
 		 * This method returns a mrw::util::SettingsGroup for a per host
 		 * usage.
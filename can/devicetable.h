@@ -0,0 +1,152 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_CAN_DEVICETABLE_H
+#define MRW_CAN_DEVICETABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <can/types.h>
+
+namespace mrw::can
+{
+	/**
+	 * This template class is a flat two-level lookup table keyed by a
+	 * ControllerId and a UnitNo. Both are small integers so the first level
+	 * maps the ControllerId by direct indexing to a row. Each row covers
+	 * the range from the lowest to the highest UnitNo inserted for that
+	 * ControllerId. So a lookup consists of two bounds checked array
+	 * accesses without hashing.
+	 *
+	 * A default constructed value marks an empty slot.
+	 *
+	 * @note The table is intended to be filled once during initialization.
+	 * Inserting a UnitNo below the row range moves the row contents.
+	 */
+	template<class T> class DeviceTable
+	{
+		static constexpr uint16_t NO_ROW = 0;
+
+		struct Row
+		{
+			UnitNo         base = 0;
+			std::vector<T> units;
+		};
+
+		static inline const T  empty{};
+
+		std::vector<uint16_t>  row_index;
+		std::vector<Row>       rows;
+
+	public:
+		/**
+		 * This method returns the value stored for the given key.
+		 *
+		 * @param id The ControllerId of the key.
+		 * @param unit_no The UnitNo of the key.
+		 * @return The stored value or a default constructed value if no
+		 * value was stored.
+		 */
+		[[nodiscard]]
+		const T & get(const ControllerId id, const UnitNo unit_no) const noexcept
+		{
+			if (id < row_index.size())
+			{
+				const uint16_t r = row_index[id];
+
+				if (r != NO_ROW)
+				{
+					const Row    & row    = rows[r - 1];
+					const size_t   offset = size_t(unit_no) - row.base;
+
+					if ((unit_no >= row.base) && (offset < row.units.size()))
+					{
+						return row.units[offset];
+					}
+				}
+			}
+			return empty;
+		}
+
+		/**
+		 * This method returns the value stored for the given DeviceKey.
+		 *
+		 * @param key The DeviceKey to look up.
+		 * @return The stored value or a default constructed value.
+		 */
+		[[nodiscard]]
+		const T & get(const DeviceKey & key) const noexcept
+		{
+			return get(key.first, key.second);
+		}
+
+		/**
+		 * This method returns a modifiable slot for the given key. The slot
+		 * is created if it does not exist yet.
+		 *
+		 * @param id The ControllerId of the key.
+		 * @param unit_no The UnitNo of the key.
+		 * @return The reference to the slot.
+		 */
+		T & slot(const ControllerId id, const UnitNo unit_no)
+		{
+			if (id >= row_index.size())
+			{
+				row_index.resize(size_t(id) + 1, NO_ROW);
+			}
+
+			if (row_index[id] == NO_ROW)
+			{
+				rows.push_back(Row{ unit_no, {} });
+				row_index[id] = rows.size();
+			}
+
+			Row & row = rows[row_index[id] - 1];
+
+			if (row.units.empty())
+			{
+				row.base = unit_no;
+			}
+			else if (unit_no < row.base)
+			{
+				row.units.insert(row.units.begin(), size_t(row.base) - unit_no, T{});
+				row.base = unit_no;
+			}
+
+			const size_t offset = size_t(unit_no) - row.base;
+
+			if (offset >= row.units.size())
+			{
+				row.units.resize(offset + 1);
+			}
+			return row.units[offset];
+		}
+
+		/**
+		 * This method returns a modifiable slot for the given DeviceKey.
+		 *
+		 * @param key The DeviceKey to look up.
+		 * @return The reference to the slot.
+		 */
+		T & slot(const DeviceKey & key)
+		{
+			return slot(key.first, key.second);
+		}
+
+		/**
+		 * This method removes all rows.
+		 */
+		void clear() noexcept
+		{
+			row_index.clear();
+			rows.clear();
+		}
+	};
+}
+
+#endif
@@ -12,17 +12,28 @@
 #include <QVariant>
 
 #include <util/method.h>
+#include <util/tracerecorder.h>
 #include <can/mrwbusservice.h>
 
 using namespace std::chrono;
 using namespace std::chrono_literals;
 using namespace mrw::can;
 
+using mrw::util::TraceRecorder;
+using mrw::util::TraceType;
+
+static void trace(const TraceType type, const WireMessage & wire) noexcept
+{
+	TraceRecorder::instance().frame(
+		type, wire.frameId(), wire.isExtended(), wire.data(), wire.length());
+}
+
 MrwBusService::MrwBusService(
 	const QString & interface,
 	const QString & plugin,
 	QObject    *    parent,
-	const bool      auto_connect) :
+	const bool      auto_connect,
+	const bool      threaded) :
 	QObject(parent),
 	can_bus(QCanBus::instance())
 
@@ -34,10 +45,48 @@ MrwBusService::MrwBusService(
 	if (can_device != nullptr)
 	{
 		can_device->setConfigurationParameter(QCanBusDevice::BitRateKey, QVariant());
+		retry_timer = new QTimer();
+		retry_timer->setSingleShot(true);
+
+		if (threaded)
+		{
+			io_thread = new QThread();
+			io_thread->setObjectName("CAN I/O");
+			can_device->moveToThread(io_thread);
+			retry_timer->moveToThread(io_thread);
+
+			connect(
+				can_device, &QCanBusDevice::framesReceived,
+				can_device, [this] ()
+			{
+				enqueue();
+			});
+		}
+		else
+		{
+			connect(
+				can_device, &QCanBusDevice::framesReceived,
+				this, &MrwBusService::receive,
+				Qt::QueuedConnection);
+		}
 		connect(
-			can_device, &QCanBusDevice::framesReceived,
-			this, &MrwBusService::receive,
-			Qt::QueuedConnection);
+			retry_timer, &QTimer::timeout,
+			can_device, [this] ()
+		{
+			transmit();
+		});
+		connect(
+			can_device, &QCanBusDevice::framesWritten,
+			can_device, [this] ()
+		{
+			transmit();
+		});
+		connect(
+			can_device, &QCanBusDevice::stateChanged,
+			can_device, [this] (QCanBusDevice::CanBusDeviceState state)
+		{
+			device_state = state;
+		});
 		connect(
 			can_device, &QCanBusDevice::stateChanged,
 			this, &MrwBusService::stateChanged,
@@ -50,9 +99,14 @@ MrwBusService::MrwBusService(
 			qCCritical(log).noquote() << "CAN bus status:       " << can_device->busStatus();
 		});
 
+		if (io_thread != nullptr)
+		{
+			io_thread->start();
+		}
+
 		if (auto_connect)
 		{
-			if (!can_device->connectDevice())
+			if (!connectDevice())
 			{
 				qCCritical(log).noquote() << "Cannot connect to CAN device!";
 			}
@@ -67,20 +121,96 @@ MrwBusService::MrwBusService(
 MrwBusService::~MrwBusService()
 {
 	qCInfo(log, " Shutting down MRW bus service.");
-	if (can_device != nullptr)
+	if (io_thread != nullptr)
+	{
+		// The device owns socket notifiers of the I/O thread. So it has to
+		// be destroyed there.
+		QMetaObject::invokeMethod(can_device, [this] ()
+		{
+			can_device->disconnectDevice();
+			delete retry_timer;
+			delete can_device;
+		}, Qt::BlockingQueuedConnection);
+
+		io_thread->quit();
+		io_thread->wait();
+		delete io_thread;
+	}
+	else if (can_device != nullptr)
 	{
 		can_device->disconnectDevice();
+		delete retry_timer;
 		delete can_device;
 	}
 }
 
 bool MrwBusService::valid() noexcept
 {
+	if (io_thread != nullptr)
+	{
+		return device_state == QCanBusDevice::ConnectedState;
+	}
 	return
 		(can_device != nullptr) &&
 		(can_device->state() == QCanBusDevice::ConnectedState);
 }
 
+bool MrwBusService::isThreaded() const noexcept
+{
+	return io_thread != nullptr;
+}
+
+MrwBusService::Statistics MrwBusService::statistics() const noexcept
+{
+	Statistics result;
+
+	result.rx_depth   = rx_ring.size();
+	for (const TxRing & ring : tx_rings)
+	{
+		result.tx_depth += ring.size();
+	}
+	result.rx_dropped = rx_dropped;
+	result.tx_queued  = tx_queued;
+	result.tx_dropped = tx_dropped;
+	result.tx_sent    = tx_sent;
+	result.tx_retried = tx_retried;
+
+	return result;
+}
+
+bool MrwBusService::connectDevice() noexcept
+{
+	bool success = false;
+
+	if (io_thread != nullptr)
+	{
+		QMetaObject::invokeMethod(can_device, [this] ()
+		{
+			return can_device->connectDevice();
+		}, Qt::BlockingQueuedConnection, &success);
+	}
+	else if (can_device != nullptr)
+	{
+		success = can_device->connectDevice();
+	}
+	return success;
+}
+
+void MrwBusService::disconnectDevice() noexcept
+{
+	if (io_thread != nullptr)
+	{
+		QMetaObject::invokeMethod(can_device, [this] ()
+		{
+			can_device->disconnectDevice();
+		}, Qt::BlockingQueuedConnection);
+	}
+	else if (can_device != nullptr)
+	{
+		can_device->disconnectDevice();
+	}
+}
+
 bool MrwBusService::list() noexcept
 {
 	bool success = true;
@@ -111,25 +241,120 @@ bool MrwBusService::list() noexcept
 
 bool MrwBusService::write(const MrwMessage & message) noexcept
 {
-	qCDebug(log).noquote() << message;
+	return write(message, priorityOf(message.command()));
+}
 
-	if (can_device != nullptr)
+bool MrwBusService::write(const MrwMessage & message, const Priority level) noexcept
+{
+	const bool success = queue(message, level);
+
+	if (success && (burst_depth == 0))
+	{
+		flush();
+	}
+	return success;
+}
+
+size_t MrwBusService::write(
+	std::span<const MrwMessage> messages,
+	std::span<bool>             results) noexcept
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < messages.size(); i++)
 	{
-		if (can_device->writeFrame(message))
+		const MrwMessage & message = messages[i];
+		const bool         success = queue(message, priorityOf(message.command()));
+
+		if (i < results.size())
 		{
-			return true;
+			results[i] = success;
 		}
-		else if (can_device->busStatus() == QCanBusDevice::CanBusStatus::Good)
+		if (success)
 		{
-			static constexpr microseconds retry = 20ms;
+			count++;
+		}
+	}
 
-			qCWarning(log, "Retrying...");
+	if ((count > 0) && (burst_depth == 0))
+	{
+		flush();
+	}
+	return count;
+}
 
-			QThread::usleep(retry.count());
-			return can_device->writeFrame(message);
-		}
+MrwBusService::Priority MrwBusService::priorityOf(const Command command) noexcept
+{
+	switch (command)
+	{
+	case SETROF:
+	case RESET:
+		return Priority::EMERGENCY;
+
+	case CFGCRX:
+	case CFGSWN:
+	case CFGSWO:
+	case CFGRAI:
+	case CFGPF2:
+	case CFGPF3:
+	case CFGMF2:
+	case CFGMF3:
+	case CFGPL2:
+	case CFGPL3:
+	case CFGSL2:
+	case CFGML2:
+	case CFGML3:
+	case CFGML4:
+	case CFGLGT:
+	case CFGSF2:
+	case CFGBGN:
+	case CFGEND:
+	case SET_ID:
+	case GETCFG:
+	case GETDVC:
+	case FLASH_REQ:
+	case FLASH_DATA:
+	case FLASH_CHECK:
+		return Priority::BULK;
+
+	default:
+		return Priority::CONTROL;
+	}
+}
+
+bool MrwBusService::queue(const MrwMessage & message, const Priority level) noexcept
+{
+	qCDebug(log).noquote() << message;
+
+	if (!valid())
+	{
+		tx_dropped++;
+		return false;
+	}
+
+	if (!tx_rings[size_t(level)].push(message.wire()))
+	{
+		qCWarning(log, "CAN transmit queue full, dropping frame.");
+		tx_dropped++;
+		return false;
+	}
+	tx_queued++;
+	return true;
+}
+
+void MrwBusService::flush() noexcept
+{
+	if (io_thread == nullptr)
+	{
+		transmit();
+	}
+	else if (!tx_signalled.exchange(true))
+	{
+		QMetaObject::invokeMethod(can_device, [this] ()
+		{
+			transmit();
+		}, Qt::QueuedConnection);
 	}
-	return false;
 }
 
 void MrwBusService::process(const MrwMessage & message)
@@ -194,6 +419,132 @@ void MrwBusService::receive() noexcept
 {
 	for (const QCanBusFrame & frame : can_device->readAllFrames())
 	{
-		process(MrwMessage(frame));
+		const WireMessage wire(frame);
+
+		trace(TraceType::CAN_RX, wire);
+		process(MrwMessage(wire));
+	}
+}
+
+void MrwBusService::enqueue() noexcept
+{
+	// Runs on the I/O thread.
+	for (const QCanBusFrame & frame : can_device->readAllFrames())
+	{
+		if (!rx_ring.push(WireMessage(frame)))
+		{
+			rx_dropped++;
+		}
+	}
+
+	if (!rx_signalled.exchange(true))
+	{
+		QMetaObject::invokeMethod(this, [this] ()
+		{
+			drain();
+		}, Qt::QueuedConnection);
+	}
+}
+
+void MrwBusService::drain() noexcept
+{
+	// Reset before popping so that a concurrent enqueue() signals again.
+	rx_signalled = false;
+
+	while (std::optional<WireMessage> wire = rx_ring.pop())
+	{
+		trace(TraceType::CAN_RX, *wire);
+		process(MrwMessage(*wire));
+	}
+}
+
+void MrwBusService::transmit() noexcept
+{
+	// Runs on the thread of the CAN device.
+	static constexpr milliseconds retry = 20ms;
+
+	tx_signalled = false;
+	if (tx_busy)
+	{
+		// A reentrant call from framesWritten().
+		return;
+	}
+
+	// During backoff only frames of a higher Priority than the failed
+	// one overtake. The timer continues the transmission afterwards.
+	const size_t limit = retry_timer->isActive() ? size_t(tx_backoff) : tx_rings.size();
+
+	tx_busy = true;
+	while (can_device->framesToWrite() < TX_WINDOW)
+	{
+		const size_t level = dequeue(limit);
+
+		if (level >= limit)
+		{
+			break;
+		}
+
+		std::optional<WireMessage> & pending = tx_pending[level];
+		unsigned          &          retries = tx_retries[level];
+
+		if (can_device->writeFrame(QCanBusFrame(*pending)))
+		{
+			trace(TraceType::CAN_TX, *pending);
+			tx_sent++;
+			retries = 0;
+			pending.reset();
+		}
+		else if ((can_device->state() == QCanBusDevice::ConnectedState) &&
+			(retries < MAX_RETRIES))
+		{
+			qCWarning(log, "Retrying...");
+
+			tx_backoff = Priority(level);
+			retry_timer->start(retry * (1 << retries));
+			retries++;
+			tx_retried++;
+			break;
+		}
+		else
+		{
+			qCWarning(log, "Dropping CAN frame.");
+
+			tx_dropped++;
+			retries = 0;
+			pending.reset();
+		}
+	}
+	tx_busy = false;
+}
+
+size_t MrwBusService::dequeue(const size_t limit) noexcept
+{
+	// A pending frame is the head of its ring and is retried first.
+	for (size_t level = 0; level < limit; level++)
+	{
+		std::optional<WireMessage> & pending = tx_pending[level];
+
+		if (!pending.has_value())
+		{
+			pending = tx_rings[level].pop();
+		}
+		if (pending.has_value())
+		{
+			return level;
+		}
+	}
+	return limit;
+}
+
+MrwBusService::Burst::Burst(MrwBusService * bus) noexcept : service(bus)
+{
+	service->burst_depth++;
+}
+
+MrwBusService::Burst::~Burst()
+{
+	if (--service->burst_depth == 0)
+	{
+		service->flush();
 	}
 }
@@ -8,10 +8,23 @@
 #ifndef MRW_CAN_MRWBUSSERVICE_H
 #define MRW_CAN_MRWBUSSERVICE_H
 
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <optional>
+#include <span>
+#include <vector>
+
 #include <QCanBus>
 #include <QCanBusDevice>
+#include <QCanBusFrame>
 
+#include <util/spscring.h>
 #include <can/mrwmessage.h>
+#include <can/wiremessage.h>
+
+class QThread;
+class QTimer;
 
 /**
  * The mrw::can namespace provides the CAN bus infrastructure using the Qt
@@ -34,12 +47,69 @@ namespace mrw::can
 	 *
 	 * The MrwBusService allows to connect to the CAN bus manually. So you have
 	 * to set the @c auto_connect parameter to false and call the
-	 * QCanBusService::connectDevice() method manually.
+	 * connectDevice() method manually.
+	 *
+	 * In threaded mode the QCanBusDevice lives on its own I/O thread. The
+	 * received CAN frames are parsed on the I/O thread and handed over to
+	 * the thread owning this service through a lock free SpscRing. The
+	 * written frames flow the other way through a second SpscRing. So a busy
+	 * GUI thread never delays the CAN bus reception and a congested CAN bus
+	 * never blocks the GUI thread. Retries with exponential backoff are
+	 * done on the I/O thread, too. A frame waiting for its retry blocks
+	 * only its own Priority. So an emergency stop is not delayed by the
+	 * backoff of a failed configuration frame.
+	 *
+	 * Written frames are queued by Priority. So an emergency stop overtakes
+	 * pending configuration traffic. The queues are drained as long as the
+	 * QCanBusDevice has less than TX_WINDOW frames to write. The draining
+	 * continues on QCanBusDevice::framesWritten(). So neither write() nor
+	 * a burst of writes ever blocks the event loop.
+	 *
+	 * @note In threaded mode write() must only be called from the thread
+	 * owning this service.
 	 */
 	class MrwBusService : public QObject
 	{
 		Q_OBJECT
 
+	public:
+		/**
+		 * The transmit priorities. Lower values are transmitted first.
+		 */
+		enum class Priority : uint8_t
+		{
+			EMERGENCY, ///< Power cutoff and resets.
+			CONTROL,   ///< Regular switch, section and signal commands.
+			BULK,      ///< Configuration and firmware update traffic.
+			COUNT
+		};
+
+		/** The maximum amount of received but not processed messages. */
+		static constexpr size_t RX_CAPACITY = 1024;
+
+		/** The maximum amount of queued but not sent CAN frames per Priority. */
+		static constexpr size_t TX_CAPACITY = 1024;
+
+		/** The maximum amount of CAN frames pending inside the QCanBusDevice. */
+		static constexpr qint64 TX_WINDOW   = 16;
+
+		/** The maximum amount of retries before a CAN frame is dropped. */
+		static constexpr unsigned MAX_RETRIES = 5;
+
+		/**
+		 * This structure contains a snapshot of the bus counters.
+		 */
+		struct Statistics
+		{
+			size_t   rx_depth   = 0; ///< The received messages pending processing.
+			size_t   tx_depth   = 0; ///< The CAN frames pending transmission.
+			uint64_t rx_dropped = 0; ///< The received messages dropped on a full ring.
+			uint64_t tx_queued  = 0; ///< The CAN frames accepted for transmission.
+			uint64_t tx_dropped = 0; ///< The CAN frames dropped on full ring or error.
+			uint64_t tx_sent    = 0; ///< The CAN frames successfully written.
+			uint64_t tx_retried = 0; ///< The retries of writing CAN frames.
+		};
+
 	protected:
 		QCanBus     *    can_bus    = nullptr;
 		QCanBusDevice  * can_device = nullptr;
@@ -49,7 +119,8 @@ namespace mrw::can
 			const QString & interface    = "can0",
 			const QString & plugin       = "socketcan",
 			QObject    *    parent       = nullptr,
-			const bool      auto_connect = true);
+			const bool      auto_connect = true,
+			const bool      threaded     = false);
 		MrwBusService() = delete;
 		~MrwBusService();
 
@@ -60,6 +131,22 @@ namespace mrw::can
 		 */
 		bool valid() noexcept;
 
+		/**
+		 * This method returns true if the QCanBusDevice lives on its own
+		 * I/O thread.
+		 *
+		 * @return True in threaded mode.
+		 */
+		bool isThreaded() const noexcept;
+
+		/**
+		 * This method returns a snapshot of the ring depths and the bus
+		 * counters. The ring depths are always zero in non threaded mode.
+		 *
+		 * @return The actual bus Statistics.
+		 */
+		Statistics statistics() const noexcept;
+
 		/**
 		 * This is a convenience method which shows all CAN plugins and their
 		 * connected devices.
@@ -69,13 +156,49 @@ namespace mrw::can
 		bool list() noexcept;
 
 		/**
-		 * This method writes a MrwMessage as a CAN frame onto the CAN bus.
+		 * This method queues a MrwMessage as a CAN frame for the CAN bus
+		 * using the Priority of its Command.
 		 *
 		 * @param message The MrwMessage to write.
-		 * @return True on successful writing.
+		 * @return True on successful queueing.
+		 * @see priorityOf()
 		 */
 		bool write(const MrwMessage & message) noexcept;
 
+		/**
+		 * This method queues a MrwMessage as a CAN frame for the CAN bus
+		 * using the given Priority. In non threaded mode the transmission
+		 * starts immediately if the transmit window is not exhausted.
+		 *
+		 * @param message The MrwMessage to write.
+		 * @param level The transmit Priority.
+		 * @return True on successful queueing.
+		 */
+		bool write(const MrwMessage & message, const Priority level) noexcept;
+
+		/**
+		 * This method queues a burst of MrwMessage instances using the
+		 * Priority of their Command. The transmission is triggered once
+		 * after all CAN frames are queued.
+		 *
+		 * @param messages The MrwMessage instances to write.
+		 * @param results If not empty it receives the queueing result of
+		 * each MrwMessage at the same index.
+		 * @return The amount of queued MrwMessage instances.
+		 */
+		size_t write(
+			std::span<const MrwMessage> messages,
+			std::span<bool>             results = {}) noexcept;
+
+		/**
+		 * This method returns the default transmit Priority of the given
+		 * Command.
+		 *
+		 * @param command The Command to classify.
+		 * @return The transmit Priority.
+		 */
+		static Priority priorityOf(const Command command) noexcept;
+
 		/**
 		 * This method processes a single MrwMessage. It is intended to
 		 * overload this method to do further processing. The default
@@ -89,12 +212,84 @@ namespace mrw::can
 		 */
 		virtual void process(const MrwMessage & message);
 
+		/**
+		 * This class collects all writes of its lifetime into one burst.
+		 * Since controllers write their commands individually a caller
+		 * turning many controllers at once should wrap the loop into a
+		 * Burst. Bursts may be nested.
+		 *
+		 * @code
+		 * {
+		 * 	MrwBusService::Burst burst(ControllerRegistry::can());
+		 *
+		 * 	for (auto * controller : controllers)
+		 * 	{
+		 * 		controller->turn();
+		 * 	}
+		 * }
+		 * @endcode
+		 */
+		class Burst
+		{
+			MrwBusService * service;
+
+		public:
+			explicit Burst(MrwBusService * bus) noexcept;
+			Burst(const Burst & other) = delete;
+			Burst & operator=(const Burst & other) = delete;
+			~Burst();
+		};
+
+	protected:
+		/**
+		 * This method connects the QCanBusDevice. In threaded mode the
+		 * connection is established on the I/O thread while the calling
+		 * thread waits for the result.
+		 *
+		 * @return True if the connection process was started successfully.
+		 */
+		bool connectDevice() noexcept;
+
+		/**
+		 * This method disconnects the QCanBusDevice. In threaded mode the
+		 * calling thread waits until the I/O thread disconnected.
+		 */
+		void disconnectDevice() noexcept;
+
 	signals:
 		void connected();
 		void disconnected();
 
 	private:
-		QString select(const QString & interface, const QString & plugin) noexcept;
+		QThread                                        * io_thread   = nullptr;
+		QTimer                                         * retry_timer = nullptr;
+		std::atomic<QCanBusDevice::CanBusDeviceState>    device_state{QCanBusDevice::UnconnectedState};
+
+		using TxRing = mrw::util::SpscRing<WireMessage, TX_CAPACITY>;
+
+		mrw::util::SpscRing<WireMessage, RX_CAPACITY>    rx_ring;
+		std::array<TxRing, size_t(Priority::COUNT)>      tx_rings;
+		std::atomic<bool>                                rx_signalled{false};
+		std::atomic<bool>                                tx_signalled{false};
+		std::array<std::optional<WireMessage>, size_t(Priority::COUNT)> tx_pending;
+		std::array<unsigned, size_t(Priority::COUNT)>    tx_retries{};
+		Priority                                         tx_backoff  = Priority::EMERGENCY;
+		bool                                             tx_busy     = false;
+		unsigned                                         burst_depth = 0;
+
+		std::atomic<uint64_t>                            rx_dropped{0};
+		std::atomic<uint64_t>                            tx_queued{0};
+		std::atomic<uint64_t>                            tx_dropped{0};
+		std::atomic<uint64_t>                            tx_sent{0};
+		std::atomic<uint64_t>                            tx_retried{0};
+
+		QString                     select(const QString & interface, const QString & plugin) noexcept;
+		void                        enqueue() noexcept;
+		void                        drain() noexcept;
+		bool                        queue(const MrwMessage & message, const Priority level) noexcept;
+		void                        flush() noexcept;
+		void                        transmit() noexcept;
+		size_t                      dequeue(const size_t limit) noexcept;
 
 	private slots:
 		void stateChanged(QCanBusDevice::CanBusDeviceState state) noexcept;
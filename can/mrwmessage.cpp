@@ -142,48 +142,31 @@ MrwMessage::MrwMessage(
 	len         = 4;
 }
 
-MrwMessage::MrwMessage(const QCanBusFrame & frame)
+MrwMessage::MrwMessage(const QCanBusFrame & frame) :
+	MrwMessage(WireMessage(frame))
 {
-	const QByteArray & payload(frame.payload());
-	const quint32      id = frame.frameId();
+}
 
-	is_extended = frame.hasExtendedFrameFormat();
-	len         = payload.size();
+MrwMessage::MrwMessage(const WireMessage & wire) noexcept :
+	info{}
+{
+	is_extended = wire.isExtended();
+	len         = wire.length();
 
 	if (len >= IDX_COMMAND_SIZE)
 	{
-		msg_command =  Command(payload[0] & CMD_MASK);
-		is_response = (payload[0] & CMD_RESPONSE) != 0;
+		const std::uint8_t * payload = wire.data();
 
-		if (is_response)
-		{
-			dst         = is_extended ? id >> CAN_SID_SHIFT : id & CAN_SID_MASK;
-			src         = is_extended ? id &  CAN_EID_UNITNO_MASK : 0;
+		msg_command  = wire.command();
+		is_response  = wire.isResponse();
+		dst          = wire.sid();
+		src          = is_response ? wire.eid() : 0;
+		msg_response = wire.response();
+		unit_no      = wire.unitNo();
 
-			if (len >= IDX_RESPONSE_SIZE)
-			{
-				msg_response  = Response(payload[1]);
-				unit_no       =
-					(UnitNo(payload[2]) & 0xff) |
-					(UnitNo(payload[3]) << 8);
-
-				std::copy(payload.begin() + IDX_RESPONSE_SIZE, payload.end(), info);
-			}
-			else
-			{
-				// Invalid! message response needs at least four bytes.
-				msg_response = Response::MSG_NO_RESPONSE;
-				unit_no      = NO_UNITNO;
-			}
-		}
-		else
+		if (len >= start())
 		{
-			dst           = is_extended ? id >> CAN_SID_SHIFT : id & CAN_SID_MASK;
-			src           = 0;
-			msg_response  = Response::MSG_NO_RESPONSE;
-			unit_no       = is_extended ? id & CAN_EID_UNITNO_MASK : NO_UNITNO;
-
-			std::copy(payload.begin() + IDX_COMMAND_SIZE, payload.end(), info);
+			std::copy(payload + start(), payload + len, info);
 		}
 	}
 	else
@@ -257,28 +240,39 @@ std::uint8_t MrwMessage::operator [](const std::size_t index) const
 
 MrwMessage::operator QCanBusFrame() const noexcept
 {
-	QByteArray array;
+	return wire();
+}
 
-	if (is_response)
-	{
-		array.append(msg_command | CMD_RESPONSE);
-		array.append(std::underlying_type_t<Response>(msg_response));
-		array.append(unit_no & 0xff);
-		array.append(unit_no >> 8);
-		copy(array);
+WireMessage MrwMessage::wire() const noexcept
+{
+	Payload           payload;
+	const std::size_t length = encode(payload);
 
-		QCanBusFrame frame = QCanBusFrame(id(), array);
-		frame.setExtendedFrameFormat(is_extended);
+	return WireMessage(id(), is_extended, payload, length);
+}
 
-		return frame;
+std::size_t MrwMessage::encode(Payload & payload) const noexcept
+{
+	const std::size_t s   = start();
+	std::size_t       pos = 0;
+
+	if (is_response)
+	{
+		payload[pos++] = msg_command | CMD_RESPONSE;
+		payload[pos++] = std::underlying_type_t<Response>(msg_response);
+		payload[pos++] = unit_no & 0xff;
+		payload[pos++] = unit_no >> 8;
 	}
 	else
 	{
-		array.append(msg_command);
-		copy(array);
+		payload[pos++] = msg_command;
+	}
 
-		return QCanBusFrame(id(), array);
+	for (std::size_t i = s; (i < len) && (pos < sizeof(payload)); i++)
+	{
+		payload[pos++] = info[i - s];
 	}
+	return pos;
 }
 
 QString MrwMessage::toString() const noexcept
@@ -363,14 +357,9 @@ QString MrwMessage::get(const SignalAspect state) noexcept
 	return signal_map.get(state);
 }
 
-void MrwMessage::copy(QByteArray & array) const noexcept
+QString MrwMessage::get(const Command command) noexcept
 {
-	const std::size_t s = start();
-
-	for (std::size_t i = s; i < len; i++)
-	{
-		array.append(info[i - s]);
-	}
+	return command_map.get(command);
 }
 
 std::size_t MrwMessage::max() const noexcept
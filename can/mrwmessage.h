@@ -12,6 +12,7 @@
 #include <QCanBusFrame>
 
 #include <can/commands.h>
+#include <can/wiremessage.h>
 #include <util/stringutil.h>
 #include <util/constantenumerator.h>
 
@@ -19,10 +20,6 @@ namespace mrw::can
 {
 	Q_DECLARE_LOGGING_CATEGORY(log)
 
-	static constexpr std::uint16_t CAN_SID_MASK         = 0x07ff;
-	static constexpr std::uint16_t CAN_EID_UNITNO_MASK  = 0xffff;
-	static constexpr std::size_t   CAN_SID_SHIFT        = 18;
-
 	/**
 	 * This class represents a CAN bus frame in model railway manner. It may
 	 * have two message types:
@@ -120,6 +117,15 @@ namespace mrw::can
 		 */
 		explicit MrwMessage(const QCanBusFrame & frame);
 
+		/**
+		 * This constructor parses a compact WireMessage. Depending on the
+		 * contents the resulting MrwMessage may be invalid.
+		 *
+		 * @param wire The WireMessage to parse.
+		 * @see valid()
+		 */
+		explicit MrwMessage(const WireMessage & wire) noexcept;
+
 		std::uint16_t eid() const noexcept;
 		std::uint16_t sid() const noexcept;
 		quint32       id()  const noexcept;
@@ -177,6 +183,26 @@ namespace mrw::can
 		 */
 		operator QCanBusFrame() const noexcept;
 
+		/** The raw payload of a classic CAN frame. */
+		using Payload = std::uint8_t[8];
+
+		/**
+		 * This method encodes the CAN payload of this MrwMessage into the
+		 * given buffer without any heap allocation.
+		 *
+		 * @param payload The buffer to fill.
+		 * @return The amount of payload bytes written.
+		 */
+		std::size_t encode(Payload & payload) const noexcept;
+
+		/**
+		 * This method converts this MrwMessage into its compact trivially
+		 * copyable WireMessage representation.
+		 *
+		 * @return The WireMessage.
+		 */
+		WireMessage wire() const noexcept;
+
 		inline bool isResponse() const noexcept
 		{
 			return is_response;
@@ -220,12 +246,19 @@ namespace mrw::can
 		 */
 		static QString get(const SignalAspect state) noexcept;
 
+		/**
+		 * This method returns the clear text QString of the Command.
+		 *
+		 * @param command The Command enumeration to translate.
+		 * @return The QString clear text of the given Command enumeration.
+		 */
+		static QString get(const Command command) noexcept;
+
 		QString toString() const noexcept override;
 
 	private:
 		std::size_t max() const noexcept;
 		std::size_t start() const noexcept;
-		void        copy(QByteArray & array) const noexcept;
 	};
 }
 
@@ -0,0 +1,91 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <can/occupationcoalescer.h>
+
+using namespace mrw::can;
+
+OccupationCoalescer::OccupationCoalescer(
+	const Dispatch & dispatch_callback,
+	const Schedule & schedule_callback) :
+	dispatch(dispatch_callback),
+	schedule(schedule_callback)
+{
+}
+
+void OccupationCoalescer::process(const MrwMessage & message)
+{
+	if (isOccupation(message))
+	{
+		coalesce(message);
+	}
+	else
+	{
+		// Keep strict ordering: All pending occupations were received
+		// before this message.
+		flush();
+		dispatch(message);
+	}
+}
+
+bool OccupationCoalescer::isOccupation(const MrwMessage & message) noexcept
+{
+	return
+		message.isResponse() &&
+		(message.sid() == CAN_GATEWAY_ID) &&
+		(message.command() == GETRBS) &&
+		(message.response() == Response::MSG_OK) &&
+		(message.size() > 0);
+}
+
+void OccupationCoalescer::coalesce(const MrwMessage & message)
+{
+	size_t & index = occupation_index.slot(message.eid(), message.unitNo());
+
+	// The index is one based so zero marks a section without pending
+	// occupation.
+	if ((index > 0) && (occupations[index - 1][0] == message[0]))
+	{
+		// Same occupation state as the pending one: Superseded.
+		counters.coalesced++;
+		return;
+	}
+
+	if (occupations.empty())
+	{
+		schedule();
+	}
+
+	// A changed occupation state is kept in order since the route
+	// statecharts depend on each transition.
+	occupations.push_back(message);
+	index = occupations.size();
+}
+
+void OccupationCoalescer::flush()
+{
+	// The cursor is a member since dispatching may append further
+	// occupations or flush reentrantly.
+	while (next < occupations.size())
+	{
+		const MrwMessage message = occupations[next++];
+
+		occupation_index.slot(message.eid(), message.unitNo()) = 0;
+		counters.delivered++;
+		dispatch(message);
+	}
+	occupations.clear();
+	next = 0;
+}
+
+size_t OccupationCoalescer::pending() const noexcept
+{
+	return occupations.size() - next;
+}
+
+const OccupationCoalescer::Statistics & OccupationCoalescer::statistics() const noexcept
+{
+	return counters;
+}
@@ -0,0 +1,106 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_CAN_OCCUPATIONCOALESCER_H
+#define MRW_CAN_OCCUPATIONCOALESCER_H
+
+#include <cinttypes>
+#include <functional>
+#include <vector>
+
+#include <can/devicetable.h>
+#include <can/mrwmessage.h>
+
+namespace mrw::can
+{
+	/**
+	 * This class coalesces the GETRBS occupation responses of the sections.
+	 * A received occupation response is kept pending until flush() is
+	 * called. A further response of the same section with the same
+	 * occupation state as the last pending one is superseded and dropped.
+	 * A changed state is appended so every transition is delivered in
+	 * order. Any other message flushes all pending occupations before it is
+	 * delivered. So the strict reception ordering is kept.
+	 *
+	 * The schedule callback is called when the first occupation becomes
+	 * pending. It has to arrange a deferred call of flush(), e.g. by
+	 * queueing it into the event loop.
+	 */
+	class OccupationCoalescer
+	{
+	public:
+		/** The callback delivering a MrwMessage. */
+		using Dispatch = std::function<void(const MrwMessage & message)>;
+
+		/** The callback arranging a deferred flush(). */
+		using Schedule = std::function<void()>;
+
+		/**
+		 * The counters of the coalescing stage. Each received occupation
+		 * response is either coalesced or delivered.
+		 */
+		struct Statistics
+		{
+			uint64_t coalesced = 0; ///< Occupation responses dropped as superseded.
+			uint64_t delivered = 0; ///< Occupation responses delivered.
+		};
+
+		OccupationCoalescer() = delete;
+		explicit OccupationCoalescer(
+			const Dispatch & dispatch_callback,
+			const Schedule & schedule_callback);
+
+		/**
+		 * This method either coalesces an occupation response or flushes
+		 * the pending occupations and delivers the given MrwMessage.
+		 *
+		 * @param message The received MrwMessage.
+		 */
+		void process(const MrwMessage & message);
+
+		/**
+		 * This method delivers all pending occupations in order.
+		 * Occupations appended while flushing are delivered, too.
+		 */
+		void flush();
+
+		/**
+		 * This method returns the amount of not yet delivered occupations.
+		 *
+		 * @return The amount of pending occupations.
+		 */
+		size_t pending() const noexcept;
+
+		/**
+		 * This method returns the coalescing counters.
+		 *
+		 * @return The coalescing counters.
+		 */
+		const Statistics & statistics() const noexcept;
+
+		/**
+		 * This method returns true if the given MrwMessage is an occupation
+		 * response of a section.
+		 *
+		 * @param message The MrwMessage to classify.
+		 * @return True if the MrwMessage may be coalesced.
+		 */
+		static bool isOccupation(const MrwMessage & message) noexcept;
+
+	private:
+		void coalesce(const MrwMessage & message);
+
+		const Dispatch          dispatch;
+		const Schedule          schedule;
+		std::vector<MrwMessage> occupations;
+		size_t                  next = 0;
+		DeviceTable<size_t>     occupation_index;
+		Statistics              counters;
+	};
+}
+
+#endif
@@ -0,0 +1,37 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <can/wiremessage.h>
+#include <can/mrwmessage.h>
+
+using namespace mrw::can;
+
+WireMessage::WireMessage(const QCanBusFrame & frame) noexcept :
+	can_id(frame.frameId()),
+	extended(frame.hasExtendedFrameFormat())
+{
+	// The payload is implicitly shared so reading it does not copy.
+	const QByteArray  & bytes = frame.payload();
+	const std::size_t   size  = bytes.size();
+
+	len = std::uint8_t(size < MAX_PAYLOAD ? size : MAX_PAYLOAD);
+	for (std::size_t i = 0; i < len; i++)
+	{
+		payload[i] = std::uint8_t(bytes[qsizetype(i)]);
+	}
+}
+
+WireMessage::operator QCanBusFrame() const noexcept
+{
+	QCanBusFrame frame(can_id, QByteArray(reinterpret_cast<const char *>(payload), len));
+
+	frame.setExtendedFrameFormat(extended);
+	return frame;
+}
+
+QString WireMessage::toString() const
+{
+	return MrwMessage(*this).toString();
+}
@@ -0,0 +1,317 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_CAN_WIREMESSAGE_H
+#define MRW_CAN_WIREMESSAGE_H
+
+#include <cinttypes>
+#include <type_traits>
+
+#include <QCanBusFrame>
+#include <QString>
+
+#include <can/commands.h>
+
+namespace mrw::can
+{
+	static constexpr std::uint16_t CAN_SID_MASK         = 0x07ff;
+	static constexpr std::uint16_t CAN_EID_UNITNO_MASK  = 0xffff;
+	static constexpr std::size_t   CAN_SID_SHIFT        = 18;
+
+	/**
+	 * This class is the compact wire representation of a MrwMessage. It
+	 * stores the raw CAN identifier, the frame format and the classic CAN
+	 * payload only. All fields of the model railway protocol are encoded
+	 * and decoded on demand by constexpr methods. So this class is
+	 * trivially copyable, has no virtual methods and never allocates
+	 * memory except when converting into a QCanBusFrame which owns its
+	 * payload.
+	 *
+	 * The encoding and decoding rules are the same as those of the
+	 * MrwMessage. So both classes may be used side by side.
+	 *
+	 * @see MrwMessage
+	 */
+	class WireMessage
+	{
+	public:
+		/** The maximum payload size of a classic CAN frame. */
+		static constexpr std::size_t MAX_PAYLOAD = 8;
+
+	private:
+		static constexpr std::size_t COMMAND_SIZE  = 1;
+		static constexpr std::size_t RESPONSE_SIZE = 4;
+
+		quint32       can_id                = 0;
+		std::uint8_t  len                   = 0;
+		bool          extended              = false;
+		std::uint8_t  payload[MAX_PAYLOAD]  = {};
+
+	public:
+		constexpr WireMessage() noexcept = default;
+
+		/**
+		 * This constructor encodes a command using a basic frame format
+		 * to address a specific mrw::model::Controller or all controllers
+		 * using the broadcast id @c CAN_BROADCAST_ID.
+		 *
+		 * @param command The Command to send.
+		 * @param id The mrw::model::Controller to address by its ID.
+		 */
+		constexpr explicit WireMessage(
+			const Command      command,
+			const ControllerId id = CAN_BROADCAST_ID) noexcept :
+			can_id(id & CAN_SID_MASK),
+			len(COMMAND_SIZE),
+			payload{ std::uint8_t(command) }
+		{
+		}
+
+		/**
+		 * This constructor encodes a command using an extended frame
+		 * format to address a specific mrw::model::Device.
+		 *
+		 * @param command The Command to send.
+		 * @param id The mrw::model::Controller to address by its ID.
+		 * @param no The mrw::model::Device to address by its unit number.
+		 */
+		constexpr explicit WireMessage(
+			const Command      command,
+			const ControllerId id,
+			const UnitNo       no) noexcept :
+			can_id((quint32(id & CAN_SID_MASK) << CAN_SID_SHIFT) | no),
+			len(COMMAND_SIZE),
+			extended(true),
+			payload{ std::uint8_t(command) }
+		{
+		}
+
+		/**
+		 * This constructor encodes a response using always an extended
+		 * frame format.
+		 *
+		 * @param id The addressed mrw::model::Controller, mostly the CAN
+		 * gateway ID.
+		 * @param no The sending mrw::model::Device unit number.
+		 * @param command The processed Command.
+		 * @param code The Response code.
+		 */
+		constexpr explicit WireMessage(
+			const ControllerId id,
+			const UnitNo       no,
+			const Command      command,
+			const Response     code) noexcept :
+			can_id((quint32(CAN_GATEWAY_ID) << CAN_SID_SHIFT) | id),
+			len(RESPONSE_SIZE),
+			extended(true),
+			payload{
+				std::uint8_t(command | CMD_RESPONSE),
+				std::uint8_t(code),
+				std::uint8_t(no & 0xff),
+				std::uint8_t(no >> 8) }
+		{
+		}
+
+		/**
+		 * This constructor decodes a raw CAN frame. Payload bytes exceeding
+		 * the classic CAN payload size are ignored.
+		 *
+		 * @param id The raw CAN identifier.
+		 * @param extended_format True if the frame uses the extended frame
+		 * format.
+		 * @param data The payload bytes.
+		 * @param size The amount of payload bytes.
+		 */
+		constexpr explicit WireMessage(
+			const quint32        id,
+			const bool           extended_format,
+			const std::uint8_t * data,
+			const std::size_t    size) noexcept :
+			can_id(id),
+			len(std::uint8_t(size < MAX_PAYLOAD ? size : MAX_PAYLOAD)),
+			extended(extended_format)
+		{
+			for (std::size_t i = 0; i < len; i++)
+			{
+				payload[i] = data[i];
+			}
+		}
+
+		/**
+		 * This constructor decodes a received QCanBusFrame without any
+		 * heap allocation.
+		 *
+		 * @param frame The CAN frame to decode.
+		 */
+		explicit WireMessage(const QCanBusFrame & frame) noexcept;
+
+		/**
+		 * This cast operator converts this WireMessage into a CAN bus frame
+		 * ready for sending.
+		 *
+		 * @return The converted CAN bus frame.
+		 */
+		operator QCanBusFrame() const noexcept;
+
+		/**
+		 * This method appends a byte to the payload.
+		 *
+		 * @param input The byte to append.
+		 * @return True if the payload had space left.
+		 */
+		constexpr bool append(const std::uint8_t input) noexcept
+		{
+			if (len >= MAX_PAYLOAD)
+			{
+				return false;
+			}
+			payload[len++] = input;
+			return true;
+		}
+
+		constexpr quint32 frameId() const noexcept
+		{
+			return can_id;
+		}
+
+		constexpr bool isExtended() const noexcept
+		{
+			return extended;
+		}
+
+		/**
+		 * This method returns the length of the raw CAN payload.
+		 *
+		 * @return The CAN frame payload length.
+		 */
+		constexpr std::size_t length() const noexcept
+		{
+			return len;
+		}
+
+		/**
+		 * This method returns the transmission time of this frame on a
+		 * CAN bus including worst case bit stuffing and the interframe
+		 * space.
+		 *
+		 * @param bitrate The bitrate of the CAN bus in bit/s.
+		 * @return The transmission time in microseconds rounded up.
+		 */
+		constexpr std::uint64_t transmissionTime(const unsigned bitrate) const noexcept
+		{
+			// Header, DLC, data and CRC are subject to bit stuffing.
+			const std::uint64_t stuffed = (extended ? 54 : 34) + 8 * len;
+			const std::uint64_t bits    = stuffed + (stuffed - 1) / 4 + 13;
+
+			return (bits * 1000000 + bitrate - 1) / bitrate;
+		}
+
+		/**
+		 * This method returns the raw CAN payload.
+		 *
+		 * @return The CAN frame payload.
+		 */
+		constexpr const std::uint8_t * data() const noexcept
+		{
+			return payload;
+		}
+
+		constexpr bool isResponse() const noexcept
+		{
+			return (len >= COMMAND_SIZE) && ((payload[0] & CMD_RESPONSE) != 0);
+		}
+
+		constexpr bool valid() const noexcept
+		{
+			return isResponse() ?
+				extended && (len >= RESPONSE_SIZE) :
+				len >= COMMAND_SIZE;
+		}
+
+		/**
+		 * This method returns the Command with the response flag cleared.
+		 *
+		 * @return The Command or @c CMD_ILLEGAL on an empty payload.
+		 */
+		constexpr Command command() const noexcept
+		{
+			return len >= COMMAND_SIZE ? Command(payload[0] & CMD_MASK) : CMD_ILLEGAL;
+		}
+
+		constexpr Response response() const noexcept
+		{
+			return isResponse() && (len >= RESPONSE_SIZE) ?
+				Response(payload[1]) :
+				Response::MSG_NO_RESPONSE;
+		}
+
+		/**
+		 * This method returns the standard identifier part which is the
+		 * addressed mrw::model::Controller ID.
+		 *
+		 * @return The standard identifier.
+		 */
+		constexpr std::uint16_t sid() const noexcept
+		{
+			return extended ? can_id >> CAN_SID_SHIFT : can_id & CAN_SID_MASK;
+		}
+
+		/**
+		 * This method returns the extended identifier part which is the
+		 * unit number of a command or the sender of a response.
+		 *
+		 * @return The extended identifier or @c NO_UNITNO in basic frame
+		 * format.
+		 */
+		constexpr std::uint16_t eid() const noexcept
+		{
+			return extended ? can_id & CAN_EID_UNITNO_MASK : NO_UNITNO;
+		}
+
+		/**
+		 * This method returns the mrw::model::Device unit number which is
+		 * part of the payload of a response and part of the identifier of
+		 * a command.
+		 *
+		 * @return The unit number.
+		 */
+		constexpr UnitNo unitNo() const noexcept
+		{
+			if (isResponse())
+			{
+				return len >= RESPONSE_SIZE ?
+					UnitNo(payload[2] | (payload[3] << 8)) :
+					NO_UNITNO;
+			}
+			return eid();
+		}
+
+		/**
+		 * This method returns the offset of the MRW payload inside the raw
+		 * CAN payload.
+		 *
+		 * @return The MRW payload offset.
+		 */
+		constexpr std::size_t start() const noexcept
+		{
+			return isResponse() ? RESPONSE_SIZE : COMMAND_SIZE;
+		}
+
+		/**
+		 * This method formats this WireMessage the same way as the
+		 * MrwMessage does. Call it only if the output is really needed.
+		 *
+		 * @return The human readable representation.
+		 */
+		QString toString() const;
+	};
+
+	static_assert(std::is_trivially_copyable_v<WireMessage>);
+	static_assert(sizeof(WireMessage) <= 16);
+}
+
+#endif
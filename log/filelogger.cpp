@@ -5,6 +5,7 @@
 
 #include <QDateTime>
 
+#include <log/loggerservice.h>
 #include <log/filelogger.h>
 
 using namespace mrw::log;
@@ -16,9 +17,18 @@ FileLogger::FileLogger(const QString & filename) : file(filename)
 
 FileLogger::~FileLogger()
 {
+	LoggerService::instance().unregisterLogger(this);
 	file.close();
 }
 
+void FileLogger::flush() const
+{
+	if (is_open)
+	{
+		file.flush();
+	}
+}
+
 void FileLogger::write(const char * message) const
 {
 	if (is_open)
@@ -29,7 +39,6 @@ void FileLogger::write(const char * message) const
 		file.write(" ");
 		file.write(message);
 		file.write("\n");
-		file.flush();
 	}
 }
 
@@ -26,6 +26,8 @@ namespace mrw::log
 		explicit FileLogger(const QString & filename = "application.log");
 		~FileLogger();
 
+		void flush() const override;
+
 	protected:
 		void write(const char * message) const override;
 	};
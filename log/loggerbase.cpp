@@ -12,14 +12,22 @@
 using namespace mrw::util;
 using namespace mrw::log;
 
+thread_local qint64 LoggerBase::record_time = 0;
+
 LoggerBase::~LoggerBase()
 {
 	LoggerService::instance().unregisterLogger(this);
 }
 
+void LoggerBase::flush() const
+{
+}
+
 QString LoggerBase::timeStamp() noexcept
 {
-	const QDateTime now = QDateTime::currentDateTime();
+	const QDateTime now = record_time != 0 ?
+		QDateTime::fromMSecsSinceEpoch(record_time) :
+		QDateTime::currentDateTime();
 
 	return now.toString(Duration::TIME_STAMP_FORMAT);
 }
@@ -15,9 +15,18 @@ namespace mrw::log
 	/**
 	 * This class provides an interface for logging messages into different
 	 * drains. The callbacks are already sorted accoring to the QtMsgType.
+	 *
+	 * @note Derived classes have to unregister themselves in their own
+	 * destructor. Otherwise the asynchronous writer thread of the
+	 * LoggerService may call a partially destroyed instance.
 	 */
 	class LoggerBase
 	{
+		friend class LoggerService;
+
+		/** The time stamp of the message written by the calling thread. */
+		static thread_local qint64 record_time;
+
 	public:
 		virtual ~LoggerBase();
 
@@ -61,11 +70,19 @@ namespace mrw::log
 		 */
 		virtual void fatal(const char * message) const = 0;
 
+		/**
+		 * This method is called after one or more messages were written.
+		 * Overload to flush buffered output of your drain.
+		 */
+		virtual void flush() const;
+
 	protected:
 		/**
-		 * This method creates a time stamp of the actual date time for logging.
+		 * This method creates a time stamp for logging. If the message was
+		 * queued by the LoggerService this is the time of queuing.
+		 * Otherwise it is the actual date time.
 		 *
-		 * @return The actual date time as QString.
+		 * @return The time stamp as QString.
 		 */
 		static QString timeStamp() noexcept;
 	};
@@ -3,6 +3,13 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <QCoreApplication>
+#include <QDateTime>
+
 #include <util/duration.h>
 #include <log/loggerservice.h>
 
@@ -15,67 +22,317 @@ LoggerService::LoggerService()
 	default_handler = qInstallMessageHandler(log);
 }
 
+LoggerService::~LoggerService()
+{
+	setAsynchronous(false);
+	qInstallMessageHandler(default_handler);
+}
+
 void LoggerService::registerLogger(LoggerBase * logger)
 {
+	std::lock_guard guard(list_mutex);
+
 	logger_list.push_back(logger);
 }
 
 void LoggerService::unregisterLogger(LoggerBase * logger)
 {
+	// Write all messages queued for this logger before removing it.
+	flush();
+
+	std::lock_guard guard(list_mutex);
+
 	logger_list.remove(logger);
 }
 
+void LoggerService::setAsynchronous(const bool enable)
+{
+	if (enable == running.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	if (enable)
+	{
+		if (!ring)
+		{
+			ring = std::make_unique<Ring>();
+		}
+		running.store(true, std::memory_order_release);
+		writer = std::thread(&LoggerService::run, this);
+		async.store(true, std::memory_order_release);
+
+		if (QCoreApplication::instance() != nullptr)
+		{
+			// A TermHandler quits the application so write everything
+			// before the event loop ends. The flush() is a no-op while
+			// disabled so connecting once is sufficient.
+			std::call_once(quit_flag, []()
+			{
+				QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, []()
+				{
+					LoggerService::instance().flush();
+				});
+			});
+		}
+	}
+	else
+	{
+		// New messages are written synchronously from now on.
+		async.store(false, std::memory_order_release);
+		running.store(false, std::memory_order_release);
+		wakeup.fetch_add(1, std::memory_order_release);
+		wakeup.notify_one();
+		writer.join();
+
+		// A producer may have pushed a record while the writer exited.
+		while (drain() > 0)
+		{
+			// Intentionally do nothing!
+		}
+	}
+}
+
+bool LoggerService::isAsynchronous() const noexcept
+{
+	return async.load(std::memory_order_acquire);
+}
+
+void LoggerService::flush()
+{
+	if (!running.load(std::memory_order_acquire) || (std::this_thread::get_id() == writer.get_id()))
+	{
+		return;
+	}
+
+	const uint64_t target = produced.load(std::memory_order_acquire);
+
+	wakeup.fetch_add(1, std::memory_order_release);
+	wakeup.notify_one();
+
+	for (uint64_t done = consumed.load(std::memory_order_acquire);
+		done < target;
+		done = consumed.load(std::memory_order_acquire))
+	{
+		consumed.wait(done, std::memory_order_acquire);
+	}
+}
+
+LoggerService::Statistics LoggerService::statistics() const noexcept
+{
+	Statistics result;
+
+	result.queued    = produced.load(std::memory_order_relaxed);
+	result.dropped   = dropped.load(std::memory_order_relaxed);
+	result.truncated = truncated.load(std::memory_order_relaxed);
+	result.batches   = batches.load(std::memory_order_relaxed);
+	result.peak      = peak.load(std::memory_order_relaxed);
+
+	return result;
+}
+
 void LoggerService::log(
 	QtMsgType                  type,
 	const QMessageLogContext & context,
 	const QString       &      input)
 {
-	const std::list<LoggerBase *> & logger_list = LoggerService::instance().logger_list;
+	LoggerService & service = LoggerService::instance();
+
+	if (service.async.load(std::memory_order_acquire) && (type != QtFatalMsg))
+	{
+		service.enqueue(type, qFormatLogMessage(type, context, input));
+		return;
+	}
+
+	// Keep the order of already queued messages.
+	service.flush();
 
-	if (logger_list.empty())
+	const LoggerList & list = service.loggers();
+
+	if (list.empty())
 	{
-		LoggerService::instance().default_handler(type, context, input);
+		service.default_handler(type, context, input);
 		return;
 	}
 
 	const std::string & formatted = qFormatLogMessage(type, context, input).toStdString();
-	const char     *     msg      = formatted.c_str();
 
+	dispatch(list, type, formatted.c_str());
+	sync(list);
+}
+
+void LoggerService::enqueue(const QtMsgType type, const QString & message)
+{
+	const QByteArray & utf8 = message.toUtf8();
+	Record             record;
+
+	record.time   = QDateTime::currentMSecsSinceEpoch();
+	record.type   = type;
+	record.length = uint16_t(truncate(utf8, sizeof(record.text) - 1));
+	std::memcpy(record.text, utf8.constData(), record.length);
+	record.text[record.length] = 0;
+
+	if (size_t(utf8.size()) > record.length)
+	{
+		truncated.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (ring->push(record))
+	{
+		produced.fetch_add(1, std::memory_order_release);
+		wakeup.fetch_add(1, std::memory_order_release);
+		wakeup.notify_one();
+	}
+	else
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void LoggerService::run()
+{
+	for (;;)
+	{
+		const uint32_t seen = wakeup.load(std::memory_order_acquire);
+
+		if (drain() == 0)
+		{
+			if (!running.load(std::memory_order_acquire))
+			{
+				break;
+			}
+			wakeup.wait(seen, std::memory_order_acquire);
+		}
+	}
+	LoggerBase::record_time = 0;
+}
+
+size_t LoggerService::drain()
+{
+	const LoggerList & list  = loggers();
+	const uint64_t     lost  = dropped.load(std::memory_order_relaxed);
+	const bool         warn  = lost != reported;
+	size_t             count = 0;
+
+	peak.store(std::max(peak.load(std::memory_order_relaxed), ring->size()), std::memory_order_relaxed);
+	while (count < BATCH)
+	{
+		const std::optional<Record> record = ring->pop();
+
+		if (!record.has_value())
+		{
+			break;
+		}
+
+		LoggerBase::record_time = record->time;
+		if (list.empty())
+		{
+			fprintf(stderr, "%s\n", record->text);
+		}
+		else
+		{
+			dispatch(list, record->type, record->text);
+		}
+		count++;
+	}
+
+	if (warn)
+	{
+		const QByteArray & warning = QString::asprintf(
+				"W - Logging: %llu messages dropped!",
+				static_cast<unsigned long long>(lost - reported)).toUtf8();
+
+		LoggerBase::record_time = 0;
+		dispatch(list, QtWarningMsg, warning.constData());
+		reported = lost;
+	}
+
+	if ((count > 0) || warn)
+	{
+		sync(list);
+	}
+	if (count > 0)
+	{
+		batches.fetch_add(1, std::memory_order_relaxed);
+		consumed.fetch_add(count, std::memory_order_release);
+		consumed.notify_all();
+	}
+	return count;
+}
+
+LoggerService::LoggerList LoggerService::loggers()
+{
+	std::lock_guard guard(list_mutex);
+
+	return LoggerList(logger_list.begin(), logger_list.end());
+}
+
+size_t LoggerService::truncate(const QByteArray & utf8, const size_t limit)
+{
+	size_t length = size_t(utf8.size());
+
+	if (length > limit)
+	{
+		length = limit;
+
+		// Do not split a multi byte character. Continuation bytes
+		// match 10xxxxxx so step back to the leading byte.
+		while ((length > 0) && ((utf8[length] & 0xc0) == 0x80))
+		{
+			length--;
+		}
+	}
+	return length;
+}
+
+void LoggerService::dispatch(
+	const LoggerList & list,
+	const QtMsgType    type,
+	const char    *    message)
+{
 	switch (type)
 	{
 	case QtDebugMsg:
-		for (LoggerBase * logger : logger_list)
+		for (LoggerBase * logger : list)
 		{
-			logger->debug(msg);
+			logger->debug(message);
 		}
 		break;
 
 	case QtInfoMsg:
-		for (LoggerBase * logger : logger_list)
+		for (LoggerBase * logger : list)
 		{
-			logger->info(msg);
+			logger->info(message);
 		}
 		break;
 
 	case QtWarningMsg:
-		for (LoggerBase * logger : logger_list)
+		for (LoggerBase * logger : list)
 		{
-			logger->warn(msg);
+			logger->warn(message);
 		}
 		break;
 
 	case QtCriticalMsg:
-		for (LoggerBase * logger : logger_list)
+		for (LoggerBase * logger : list)
 		{
-			logger->critical(msg);
+			logger->critical(message);
 		}
 		break;
 
 	case QtFatalMsg:
-		for (LoggerBase * logger : logger_list)
+		for (LoggerBase * logger : list)
 		{
-			logger->fatal(msg);
+			logger->fatal(message);
 		}
 		break;
 	}
 }
+
+void LoggerService::sync(const LoggerList & list)
+{
+	for (LoggerBase * logger : list)
+	{
+		logger->flush();
+	}
+}
@@ -8,11 +8,17 @@
 #ifndef MRW_LOG_LOGGERSERVICE_H
 #define MRW_LOG_LOGGERSERVICE_H
 
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <QtDebug>
 
 #include <util/singleton.h>
+#include <util/mpscring.h>
 #include <log/loggerbase.h>
 
 /**
@@ -30,16 +36,93 @@ namespace mrw::log
 	 * The LoggerBase instances are collected into a list and each of the
 	 * instances are called according to the QtMsgType. The constructor also
 	 * calls mrw::util::Method::pattern() for time stamping.
+	 *
+	 * In asynchronous mode the logging thread only formats the message into
+	 * a fixed size Record and pushes it into a lock free MpscRing. A writer
+	 * thread pops the records in batches and calls the LoggerBase instances.
+	 * Each LoggerBase instance is flushed once per batch. So the file and
+	 * console I/O does not block the GUI or the CAN processing. If the ring
+	 * is full the message is dropped and counted. Messages longer than a
+	 * Record are truncated at a UTF-8 character boundary. The LoggerBase
+	 * instances are called from a copy of the logger list so a LoggerBase
+	 * may log itself without deadlocking the service. Fatal messages are always written synchronously
+	 * after draining the ring since the application aborts afterwards.
 	 */
 	class LoggerService : public mrw::util::Singleton<LoggerService>
 	{
-		QtMessageHandler        default_handler;
-		std::list<LoggerBase *> logger_list;
+	public:
+		friend class Singleton<LoggerService>;
+
+		/** The size of one queued log message including its header. */
+		static constexpr size_t RECORD_SIZE = 512;
+
+		/** The maximum amount of queued log messages. */
+		static constexpr size_t CAPACITY    = 2048;
+
+		/** The maximum amount of log messages written in one batch. */
+		static constexpr size_t BATCH       = 64;
+
+		/**
+		 * This struct contains the counters of the asynchronous writer.
+		 */
+		struct Statistics
+		{
+			/** The amount of queued messages. */
+			uint64_t queued    = 0;
+
+			/** The amount of messages dropped due to a full ring. */
+			uint64_t dropped   = 0;
+
+			/** The amount of truncated messages. */
+			uint64_t truncated = 0;
+
+			/** The amount of written batches. */
+			uint64_t batches   = 0;
+
+			/** The maximum amount of messages found in the ring. */
+			size_t   peak      = 0;
+		};
+
+	private:
+		/**
+		 * A formatted log message with its time stamp.
+		 */
+		struct Record
+		{
+			qint64    time;
+			QtMsgType type;
+			uint16_t  length;
+			char      text[RECORD_SIZE - 16];
+		};
+
+		static_assert(sizeof(Record) == RECORD_SIZE, "Unexpected record padding!");
+
+		using Ring = mrw::util::MpscRing<Record, CAPACITY>;
+
+		using LoggerList = std::vector<LoggerBase *>;
+
+		QtMessageHandler           default_handler;
+		std::list<LoggerBase *>    logger_list;
+		std::mutex                 list_mutex;
+		std::once_flag             quit_flag;
+
+		std::unique_ptr<Ring>      ring;
+		std::thread                writer;
+		std::atomic<bool>          async{false};
+		std::atomic<bool>          running{false};
+		std::atomic<uint32_t>      wakeup{0};
+		std::atomic<uint64_t>      produced{0};
+		std::atomic<uint64_t>      consumed{0};
+		std::atomic<uint64_t>      dropped{0};
+		std::atomic<uint64_t>      truncated{0};
+		std::atomic<uint64_t>      batches{0};
+		std::atomic<size_t>        peak{0};
+		uint64_t                   reported = 0;
 
 		LoggerService();
+		~LoggerService();
 
 	public:
-		friend class Singleton<LoggerService>;
 
 		/**
 		 * This method registers a LoggerBase instance.
@@ -55,6 +138,39 @@ namespace mrw::log
 		 */
 		void unregisterLogger(LoggerBase * logger);
 
+		/**
+		 * This method switches between synchronous and asynchronous
+		 * logging. Enabling starts the writer thread. Disabling drains the
+		 * queued messages and stops the writer thread.
+		 *
+		 * @param enable True to write the log messages asynchronously.
+		 */
+		void setAsynchronous(const bool enable);
+
+		/**
+		 * This method returns true if the log messages are written
+		 * asynchronously.
+		 *
+		 * @return True in asynchronous mode.
+		 */
+		[[nodiscard]]
+		bool isAsynchronous() const noexcept;
+
+		/**
+		 * This method blocks until all messages queued so far are written
+		 * and flushed. It returns immediately in synchronous mode or if
+		 * called by the writer thread itself.
+		 */
+		void flush();
+
+		/**
+		 * This method returns a snapshot of the writer counters.
+		 *
+		 * @return The writer counters.
+		 */
+		[[nodiscard]]
+		Statistics statistics() const noexcept;
+
 	private:
 		/**
 		 * This is the message handler installed into this service. If the
@@ -72,6 +188,15 @@ namespace mrw::log
 			QtMsgType                  type,
 			const QMessageLogContext & context,
 			const QString       &      input);
+
+		void enqueue(const QtMsgType type, const QString & message);
+		void run();
+		size_t drain();
+		LoggerList loggers();
+
+		static size_t truncate(const QByteArray & utf8, const size_t limit);
+		static void dispatch(const LoggerList & list, const QtMsgType type, const char * message);
+		static void sync(const LoggerList & list);
 	};
 }
 
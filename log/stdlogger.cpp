@@ -3,10 +3,16 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <log/loggerservice.h>
 #include <log/stdlogger.h>
 
 using namespace mrw::log;
 
+StdLogger::~StdLogger()
+{
+	LoggerService::instance().unregisterLogger(this);
+}
+
 void StdLogger::debug(const char * message) const
 {
 	write(stdout, message);
@@ -32,10 +38,15 @@ void StdLogger::fatal(const char * message) const
 	write(stderr, message);
 }
 
+void StdLogger::flush() const
+{
+	fflush(stdout);
+	fflush(stderr);
+}
+
 void StdLogger::write(FILE * file, const char * message)
 {
 	const std::string & now = timeStamp().toStdString();
 
 	fprintf(file, "%s %s\n", now.c_str(), message);
-	fflush(file);
 }
@@ -21,11 +21,14 @@ namespace mrw::log
 	class StdLogger : public LoggerBase
 	{
 	public:
+		virtual ~StdLogger();
+
 		virtual void debug(const char * message) const override;
 		virtual void info(const char * message) const override;
 		virtual void warn(const char * message) const override;
 		virtual void critical(const char * message) const override;
 		virtual void fatal(const char * message) const override;
+		virtual void flush() const override;
 
 	protected:
 		/**
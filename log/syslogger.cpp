@@ -3,6 +3,7 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <log/loggerservice.h>
 #include <log/syslogger.h>
 
 #include <syslog.h>
@@ -16,6 +17,7 @@ SysLogger::SysLogger(const char * application)
 
 SysLogger::~SysLogger()
 {
+	LoggerService::instance().unregisterLogger(this);
 	closelog();
 }
 
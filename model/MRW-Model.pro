@@ -15,26 +15,32 @@ SOURCES += \
 	crossing.cpp \
 	device.cpp \
 	doublecrossswitch.cpp \
+	emfpath.cpp \
 	formsignal.cpp \
 	light.cpp \
 	lightmodule.cpp \
 	lightsignal.cpp \
 	modelrailway.cpp \
 	modelrepository.cpp \
+	modelsnapshot.cpp \
 	module.cpp \
 	multiplexconnection.cpp \
+	partregistry.cpp \
 	position.cpp \
 	profilelight.cpp \
 	rail.cpp \
+	railgraph.cpp \
 	railpart.cpp \
 	region.cpp \
 	regularswitch.cpp \
 	route.cpp \
+	routecost.cpp \
 	section.cpp \
 	sectionmodule.cpp \
 	signal.cpp \
 	switchmodule.cpp \
-	switchmodulereference.cpp
+	switchmodulereference.cpp \
+	xmielement.cpp
 
 HEADERS += \
 	abstractswitch.h \
@@ -43,25 +49,31 @@ HEADERS += \
 	crossing.h \
 	device.h \
 	doublecrossswitch.h \
+	emfpath.h \
 	formsignal.h \
 	light.h \
 	lightmodule.h \
 	lightsignal.h \
 	modelrailway.h \
 	modelrepository.h \
+	modelsnapshot.h \
 	module.h \
 	multiplexconnection.h \
+	partregistry.h \
 	position.h \
 	profilelight.h \
 	rail.h \
+	railgraph.h \
 	railpart.h \
 	region.h \
 	regularswitch.h \
 	route.h \
+	routecost.h \
 	section.h \
 	sectionmodule.h \
 	signal.h \
 	switchmodule.h \
-	switchmodulereference.h
+	switchmodulereference.h \
+	xmielement.h
 
 QMAKE_CLEAN         += $$TARGET
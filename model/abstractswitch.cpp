@@ -14,7 +14,7 @@ using namespace mrw::model;
 AbstractSwitch::AbstractSwitch(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	RailPart(model_railway, model_section, element),
 	SwitchModuleReference(
 		model_railway, element, ModelRailway::boolean(element, "neu"))
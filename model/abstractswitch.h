@@ -75,7 +75,7 @@ namespace mrw::model
 		explicit AbstractSwitch(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		// Implementations from Device
 		const QString    &   name()         const noexcept override;
@@ -165,6 +165,43 @@ namespace mrw::model
 			const RailPart * prev,
 			const RailPart * succ) const noexcept = 0;
 
+		/**
+		 * This method returns true if the switch motor has to move to
+		 * connect the given neighbours. The internal switch state is not
+		 * changed.
+		 *
+		 * @note Both pointers need to be non @c nullptr.
+		 *
+		 * @param prev The previous RailPart in Route order.
+		 * @param succ The successive RailPart in Route order.
+		 * @return True if a turn command is needed.
+		 * @exception std::invalid_argument one of the RailPart pointer is not
+		 * a neighbour.
+		 */
+		[[nodiscard]]
+		virtual bool needsTurn(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept = 0;
+
+		/**
+		 * This method returns true if the leg connecting the given
+		 * neighbours is a curved or branched one. The internal switch
+		 * state is not changed.
+		 *
+		 * @note Both pointers need to be non @c nullptr.
+		 *
+		 * @param prev The previous RailPart in Route order.
+		 * @param succ The successive RailPart in Route order.
+		 * @return True if the leg is curved.
+		 * @exception std::invalid_argument one of the RailPart pointer is not
+		 * a neighbour.
+		 * @see isCurved()
+		 */
+		[[nodiscard]]
+		virtual bool isCurvedLeg(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept = 0;
+
 		/**
 		 * This method returns the CAN command corresponding to the internal
 		 * switch State.
@@ -8,10 +8,7 @@
 #ifndef MRW_MODEL_ASSEMBLYPART_H
 #define MRW_MODEL_ASSEMBLYPART_H
 
-#include <regex>
-
-#include <QDomElement>
-
+#include <model/xmielement.h>
 #include <util/stringutil.h>
 
 namespace mrw::model
@@ -28,19 +25,17 @@ namespace mrw::model
 	{
 		friend class Section;
 
-		static const std::regex path_regex;
-
 	protected:
 		const QString      part_name;
 		ModelRailway   *   part_model   = nullptr;
 		Section      *     part_section = nullptr;
-		const QDomElement  reference;
+		XmiElement         reference;
 
 	public:
 		explicit AssemblyPart(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~AssemblyPart() = default;
 
 		/**
@@ -76,6 +71,13 @@ namespace mrw::model
 		 */
 		Region * region() const;
 
+		/**
+		 * This method returns the ModelRailway this AssemblyPart belongs to.
+		 *
+		 * @return The owning ModelRailway.
+		 */
+		ModelRailway * model() const;
+
 	protected:
 		/**
 		 * This method links all elements needed for the implementation.
@@ -3,7 +3,6 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
-#include <QDomDocument>
 #include <QDebug>
 
 #include "model/modelrailway.h"
@@ -22,58 +21,54 @@ using namespace mrw::model;
 
 Controller::Controller(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	controller_id(ModelRailway::value(element, "id")),
 	model(model_railway)
 {
-	const QDomNodeList & child_nodes = element.childNodes();
+}
+
+XmiContainer * Controller::create(const XmiElement & child)
+{
+	const QString & node_name = child.nodeName();
+	const QString   type      = ModelRailway::type(child);
 
-	modules.reserve(child_nodes.count());
-	connections.reserve(child_nodes.count());
-	for (int n = 0; n < child_nodes.count(); ++n)
+	if (node_name == "module")
 	{
-		const QDomNode & node = child_nodes.at(n);
+		Module * module = nullptr;
+
+		if (type == "Gleismodul")
+		{
+			module = new SectionModule(model, child);
+		}
+		else if (type == "Impulsmodul")
+		{
+			module = new SwitchModule(model, child);
+		}
+		else if (type == "Beleuchtungsmodul")
+		{
+			LightModule * light_module = new LightModule(model, this, child);
 
-		if (node.isElement())
+			modules.push_back(light_module);
+			return light_module;
+		}
+		else
 		{
-			const QDomElement & child     = node.toElement();
-			const QString   &   node_name = child.nodeName();
-			const QString       type      = ModelRailway::type(child);
-
-			if (node_name == "module")
-			{
-				Module * module = nullptr;
-
-				if (type == "Gleismodul")
-				{
-					module = new SectionModule(model, child);
-				}
-				else if (type == "Impulsmodul")
-				{
-					module = new SwitchModule(model, child);
-				}
-				else if (type == "Beleuchtungsmodul")
-				{
-					module = new LightModule(model, this, child);
-				}
-				else
-				{
-					model->error("Unknown module type: " + type);
-				}
-				modules.push_back(module);
-			}
-			else if (node_name == "anschluesse")
-			{
-				MultiplexConnection * connection = new MultiplexConnection(model, this, child);
-
-				connections.push_back(connection);
-			}
-			else
-			{
-				model->error("Unknown controller element: " + node_name);
-			}
+			model->error("Unknown module type: " + type);
 		}
+		modules.push_back(module);
+	}
+	else if (node_name == "anschluesse")
+	{
+		MultiplexConnection * connection = new MultiplexConnection(model, this, child);
+
+		connections.push_back(connection);
+		return connection;
+	}
+	else
+	{
+		model->error("Unknown controller element: " + node_name);
 	}
+	return nullptr;
 }
 
 bool Controller::valid() const noexcept
@@ -147,6 +142,7 @@ void Controller::link()
 		if (module != nullptr)
 		{
 			module->link();
+			module->reference.clear();
 		}
 	}
 
@@ -155,6 +151,7 @@ void Controller::link()
 		if (connection != nullptr)
 		{
 			connection->link();
+			connection->reference.clear();
 		}
 	}
 }
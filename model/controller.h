@@ -10,11 +10,10 @@
 
 #include <cinttypes>
 
-#include <QDomElement>
-
 #include <can/types.h>
 #include <model/module.h>
 #include <model/multiplexconnection.h>
+#include <model/xmielement.h>
 #include <util/cleanvector.h>
 #include <util/stringutil.h>
 
@@ -40,7 +39,7 @@ namespace mrw::model
 	 * the behaviour is depending on commands sent vie CAN bus to the
 	 * controller.
 	 */
-	class Controller : public mrw::util::String
+	class Controller : public XmiContainer, public mrw::util::String
 	{
 		const mrw::can::ControllerId                 controller_id;
 		ModelRailway                *                model = nullptr;
@@ -55,7 +54,7 @@ namespace mrw::model
 	public:
 		explicit Controller(
 			ModelRailway * model_railway,
-			const QDomElement & element);
+			const XmiElement  & element);
 		virtual ~Controller() = default;
 
 		/**
@@ -140,6 +139,8 @@ namespace mrw::model
 		virtual QString toString() const override;
 
 	private:
+		XmiContainer * create(const XmiElement & child) override;
+
 		/**
 		 * This method links all elements needed for the implementation.
 		 */
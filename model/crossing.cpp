@@ -13,7 +13,7 @@ using namespace mrw::model;
 Crossing::Crossing(
 	ModelRailway     *    model_railway,
 	Controller      *     controller,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	Device(model_railway, element),
 	crx_controller(controller),
 	crx_name(ModelRailway::string(element, "name"))
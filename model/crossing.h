@@ -31,7 +31,7 @@ namespace mrw::model
 		explicit Crossing(
 			ModelRailway     *    model_railway,
 			Controller      *     controller,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~Crossing() = default;
 
 		void add(Section * section);
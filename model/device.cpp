@@ -24,7 +24,7 @@ const ConstantEnumerator<LockState>  Device::lock_map
 
 Device::Device(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	unit_no(ModelRailway::value(element, "unit_no"))
 {
 	if (unit_no == 0)
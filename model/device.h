@@ -53,7 +53,7 @@ namespace mrw::model
 
 		explicit Device(
 			ModelRailway     *    model_railway,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		/**
 		 * This method returns the unit number which is part of the CAN
@@ -26,7 +26,7 @@ const ConstantEnumerator<State>  DoubleCrossSwitch::state_map
 DoubleCrossSwitch::DoubleCrossSwitch(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	AbstractSwitch(model_railway, model_section, element),
 	ad_branch(ModelRailway::boolean(element, "adIstAbzweig")),
 	bc_branch(ModelRailway::boolean(element, "bcIstAbzweig"))
@@ -131,6 +131,21 @@ bool DoubleCrossSwitch::isSwitchable(
 	return (lock() == LockState::UNLOCKED) || (isCurved(state) == isCurved(switch_state));
 }
 
+bool DoubleCrossSwitch::needsTurn(
+	const RailPart * prev,
+	const RailPart * succ) const noexcept
+{
+	// There is only one motor switching between straight and curved.
+	return isCurved(computeState(prev, succ)) != isCurved(switch_state);
+}
+
+bool DoubleCrossSwitch::isCurvedLeg(
+	const RailPart * prev,
+	const RailPart * succ) const noexcept
+{
+	return isCurved(computeState(prev, succ));
+}
+
 State DoubleCrossSwitch::computeState(
 	const RailPart * prev,
 	const RailPart * succ) const
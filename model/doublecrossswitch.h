@@ -66,7 +66,7 @@ namespace mrw::model
 		explicit DoubleCrossSwitch(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		/**
 		 * This method returns the internal state of this DoubleCrossSwitch. As
@@ -111,6 +111,16 @@ namespace mrw::model
 			const RailPart * prev,
 			const RailPart * succ) const noexcept override;
 
+		[[nodiscard]]
+		bool needsTurn(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept override;
+
+		[[nodiscard]]
+		bool isCurvedLeg(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept override;
+
 		/**
 		 * This method returns the clear text QString of the State this
 		 * DoubleCrossSwitch is set to.
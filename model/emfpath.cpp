@@ -0,0 +1,76 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <limits>
+
+#include "model/emfpath.h"
+
+using namespace mrw::model;
+
+bool EmfPath::root(const QStringView path, qsizetype & pos) noexcept
+{
+	// The path starts with a double slash. The second one is consumed by
+	// the first segment.
+	if ((path.size() > pos) && (path[pos] == u'/'))
+	{
+		pos++;
+		return true;
+	}
+	return false;
+}
+
+bool EmfPath::segment(
+	const QStringView    path,
+	qsizetype      &     pos,
+	const char     *     name,
+	unsigned       &     index) noexcept
+{
+	static constexpr unsigned LIMIT = std::numeric_limits<unsigned>::max() / 10;
+
+	const qsizetype size = path.size();
+
+	// Segment prefix "/@".
+	if (((pos + 2) > size) || (path[pos] != u'/') || (path[pos + 1] != u'@'))
+	{
+		return false;
+	}
+	pos += 2;
+
+	// Segment name.
+	while (*name != 0)
+	{
+		if ((pos >= size) || (path[pos] != QLatin1Char(*name)))
+		{
+			return false;
+		}
+		pos++;
+		name++;
+	}
+
+	// Index separator.
+	if ((pos >= size) || (path[pos] != u'.'))
+	{
+		return false;
+	}
+	pos++;
+
+	// Index with at least one digit.
+	const qsizetype start = pos;
+
+	index = 0;
+	while ((pos < size) && (path[pos] >= u'0') && (path[pos] <= u'9'))
+	{
+		const unsigned digit = path[pos].unicode() - u'0';
+
+		if ((index > LIMIT) || ((index == LIMIT) &&
+				(digit > std::numeric_limits<unsigned>::max() % 10)))
+		{
+			return false;
+		}
+		index = index * 10 + digit;
+		pos++;
+	}
+	return pos > start;
+}
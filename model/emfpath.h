@@ -0,0 +1,112 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_EMFPATH_H
+#define MRW_MODEL_EMFPATH_H
+
+#include <array>
+#include <optional>
+
+#include <QStringView>
+
+namespace mrw::model
+{
+	/**
+	 * This class tokenizes the cross reference paths of the EMF/XMI
+	 * notation. A path consists of segments each containing the element
+	 * name and the zero based index of the element inside its container:
+	 *
+	 * @verbatim
+//@gruppe.0/@abschnitt.19/@bauelement.1
+//@controller.7/@anschluesse.1/@crossing.2
+@endverbatim
+	 *
+	 * The tokenizer works directly on a QStringView so neither a
+	 * std::string conversion nor a regular expression match allocates any
+	 * memory. The resulting indices are returned as a tuple like
+	 * std::array which may be decomposed using structured bindings:
+	 *
+	 * @code
+const auto indices = EmfPath::match(reference, EmfPath::ASSEMBLY_PART);
+
+if (indices)
+{
+	const auto [region_idx, section_idx, part_idx] = *indices;
+}
+@endcode
+	 */
+	class EmfPath
+	{
+	public:
+		template<size_t N> using Segments = std::array<const char *, N>;
+		template<size_t N> using Indices  = std::array<unsigned, N>;
+
+		/** The path of an AssemblyPart: //@gruppe.N/@abschnitt.N/@bauelement.N */
+		static constexpr Segments<3> ASSEMBLY_PART { "gruppe", "abschnitt", "bauelement" };
+
+		/** The path of a Section: //@gruppe.N/@abschnitt.N */
+		static constexpr Segments<2> SECTION       { "gruppe", "abschnitt" };
+
+		/** The path of a Module: //@controller.N/@module.N */
+		static constexpr Segments<2> MODULE        { "controller", "module" };
+
+		/** The path of a MultiplexConnection: //@controller.N/@anschluesse.N */
+		static constexpr Segments<2> CONNECTION    { "controller", "anschluesse" };
+
+		/** The path of a Crossing: //@controller.N/@anschluesse.N/@crossing.N */
+		static constexpr Segments<3> CROSSING      { "controller", "anschluesse", "crossing" };
+
+		EmfPath() = delete;
+
+		/**
+		 * This method matches the complete given path against the given
+		 * segment names and extracts the index of each segment.
+		 *
+		 * @param path The EMF path to tokenize.
+		 * @param segments The expected segment names.
+		 * @return The segment indices or std::nullopt if the path does not
+		 * match.
+		 */
+		template<size_t N>
+		[[nodiscard]]
+		static std::optional<Indices<N>> match(
+			const QStringView    path,
+			const Segments<N> &  segments) noexcept
+		{
+			Indices<N> indices{};
+			qsizetype  pos = 0;
+
+			if (!root(path, pos))
+			{
+				return std::nullopt;
+			}
+
+			for (size_t i = 0; i < N; i++)
+			{
+				if (!segment(path, pos, segments[i], indices[i]))
+				{
+					return std::nullopt;
+				}
+			}
+			if (pos != path.size())
+			{
+				return std::nullopt;
+			}
+			return indices;
+		}
+
+	private:
+		static bool root(const QStringView path, qsizetype & pos) noexcept;
+		static bool segment(
+			const QStringView    path,
+			qsizetype      &     pos,
+			const char     *     name,
+			unsigned       &     index) noexcept;
+	};
+}
+
+#endif
@@ -14,7 +14,7 @@ using namespace mrw::model;
 FormSignal::FormSignal(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element,
+	const XmiElement   &  element,
 	const SignalType      type) :
 	Signal(model_railway, model_section, element, type),
 	SwitchModuleReference(model_railway, element, false)
@@ -8,8 +8,6 @@
 #ifndef MRW_MODEL_FORMSIGNAL_H
 #define MRW_MODEL_FORMSIGNAL_H
 
-#include <regex>
-
 #include <model/signal.h>
 #include <model/switchmodulereference.h>
 
@@ -39,7 +37,7 @@ namespace mrw::model
 		explicit FormSignal(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element,
+			const XmiElement   &  element,
 			const SignalType      is_main);
 
 		// Implementations from Device
@@ -13,7 +13,7 @@ using namespace mrw::model;
 Light::Light(
 	ModelRailway     *    model_railway,
 	Controller      *     controller,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	Device(model_railway, element),
 	light_controller(controller),
 	light_name(ModelRailway::string(element, "name")),
@@ -8,10 +8,9 @@
 #ifndef MRW_MODEL_LIGHT_H
 #define MRW_MODEL_LIGHT_H
 
-#include <QDomElement>
-
 #include <model/module.h>
 #include <model/device.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -38,7 +37,7 @@ namespace mrw::model
 		explicit Light(
 			ModelRailway     *    model_railway,
 			Controller      *     controller,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~Light() = default;
 
 		uint8_t threshold() const;
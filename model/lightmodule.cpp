@@ -13,32 +13,27 @@ using namespace mrw::model;
 LightModule::LightModule(
 	ModelRailway     *    model_railway,
 	Controller      *     controller,
-	const QDomElement  &  element) : Module(model_railway, element)
+	const XmiElement   &  element) :
+	Module(model_railway, element),
+	light_controller(controller)
 {
-	const QDomNodeList & child_nodes = element.childNodes();
-
-	profile_lights.reserve(child_nodes.count());
-	for (int n = 0; n < child_nodes.count(); ++n)
-	{
-		const QDomNode & node = child_nodes.at(n);
+}
 
-		if (node.isElement())
-		{
-			const QDomElement & child     = node.toElement();
-			const QString   &   node_name = child.nodeName();
+XmiContainer * LightModule::create(const XmiElement & child)
+{
+	const QString & node_name = child.nodeName();
 
-			if (node_name == "lampen")
-			{
-				ProfileLight * light = new ProfileLight(model, controller, child);
+	if (node_name == "lampen")
+	{
+		ProfileLight * light = new ProfileLight(model, light_controller, child);
 
-				profile_lights.push_back(light);
-			}
-			else
-			{
-				model->error("Unknown light module element: " + node_name);
-			}
-		}
+		profile_lights.push_back(light);
+	}
+	else
+	{
+		model->error("Unknown light module element: " + node_name);
 	}
+	return nullptr;
 }
 
 bool LightModule::valid() const
@@ -8,9 +8,8 @@
 #ifndef MRW_MODEL_LIGHTMODEL_H
 #define MRW_MODEL_LIGHTMODEL_H
 
-#include <QDomElement>
-
 #include <model/module.h>
+#include <model/xmielement.h>
 #include <util/cleanvector.h>
 
 namespace mrw::model
@@ -27,9 +26,10 @@ namespace mrw::model
 	 *
 	 * @see https://github.com/stmork/mrw/wiki/LichtProfile
 	 */
-	class LightModule : public Module
+	class LightModule : public Module, public XmiContainer
 	{
 		mrw::util::CleanVector<ProfileLight> profile_lights;
+		Controller              *            light_controller = nullptr;
 
 		static constexpr size_t MAX_LIGHTS = 8;
 
@@ -37,7 +37,7 @@ namespace mrw::model
 		explicit LightModule(
 			ModelRailway     *    model_railway,
 			Controller      *     controller,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~LightModule() = default;
 
 		inline size_t ports() const override
@@ -50,6 +50,8 @@ namespace mrw::model
 		const std::vector<ProfileLight *> & lights() const;
 
 	private:
+		XmiContainer * create(const XmiElement & child) override;
+
 		void link() override;
 		void configure(
 			std::vector<mrw::can::MrwMessage> & messages,
@@ -6,37 +6,15 @@
 #include <can/mrwmessage.h>
 #include <model/modelrailway.h>
 #include <model/lightsignal.h>
+#include <model/emfpath.h>
 
 using namespace mrw::can;
 using namespace mrw::model;
 
-/**
- * Regular expression prolog:
- * \d matches one digit.
- * \s whitespace character
- * \w matches one digit or case insensitive letter.
- * "." matches one character.
- * \d+ matches a number with at least one digit
- * (\d+) marks a matching group
- *
- * Since we use C++11 raw string literals we do not need to escape the '\' char
- * to "\\".
- *
- * There is a nice regular expression test site where you can build a regular
- * expression and test it against multiple test patterns: https://regex101.com/
- *
- * The following test patterns may be used:
- * @verbatim
-//@controller.9/@anschluesse.1
-//@controller.11/@anschluesse.0
-@endverbatim
- */
-const std::regex  LightSignal::path_regex(R"(^\/\/@controller\.(\d+)\/@anschluesse\.(\d+))");
-
 LightSignal::LightSignal(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element,
+	const XmiElement   &  element,
 	const SignalType      type,
 	const unsigned        light_count) :
 	Signal(
@@ -44,15 +22,11 @@ LightSignal::LightSignal(
 	Device(model_railway, element),
 	lights(light_count)
 {
-	const std::string & path = reference.attribute("anschluss").toStdString();
-	std::smatch         matcher;
+	const auto indices = EmfPath::match(reference.attribute("anschluss"), EmfPath::CONNECTION);
 
-	if (std::regex_match(path, matcher, path_regex))
+	if (indices)
 	{
-		Q_ASSERT(matcher.size() >= 3);
-
-		const unsigned controller_idx = std::stoul(matcher[1]);
-		const unsigned conn_idx       = std::stoul(matcher[2]);
+		const auto [controller_idx, conn_idx] = *indices;
 
 		signal_controller = part_model->controller(controller_idx);
 		mux_connection    = part_model->connection(controller_idx, conn_idx);
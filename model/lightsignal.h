@@ -8,8 +8,6 @@
 #ifndef MRW_MODEL_LIGHTSIGNAL_H
 #define MRW_MODEL_LIGHTSIGNAL_H
 
-#include <regex>
-
 #include <model/module.h>
 #include <model/signal.h>
 #include <model/device.h>
@@ -37,8 +35,6 @@ namespace mrw::model
 	{
 		friend class Section;
 
-		static const std::regex path_regex;
-
 		const size_t            lights;
 
 		Controller       *      signal_controller = nullptr;
@@ -48,7 +44,7 @@ namespace mrw::model
 		explicit LightSignal(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element,
+			const XmiElement   &  element,
 			const SignalType      type,
 			const unsigned        light_count);
 
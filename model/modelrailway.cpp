@@ -3,11 +3,21 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
+
 #include <QFile>
 #include <QDomElement>
+#include <QXmlStreamReader>
 
 #include "util/method.h"
+#include "util/phaseprofile.h"
 #include "model/modelrailway.h"
+#include "model/modelsnapshot.h"
 #include "model/assemblypart.h"
 #include "model/abstractswitch.h"
 #include "model/signal.h"
@@ -15,41 +25,130 @@
 using namespace mrw::can;
 using namespace mrw::model;
 
+using mrw::util::PhaseProfile;
 using SignalType = Signal::SignalType;
 
 Q_LOGGING_CATEGORY(mrw::model::log, "mrw.model")
 
-ModelRailway::ModelRailway(const QString & filename)
+thread_local std::vector<ModelRailway::Diagnostic> * ModelRailway::diagnostics = nullptr;
+thread_local ModelRailway::LinkTable               * ModelRailway::link_table  = nullptr;
+unsigned                                             ModelRailway::link_threads = 0;
+
+ModelRailway::ModelRailway(
+	const QString           & filename,
+	const bool                keep_xml,
+	ModelSnapshot::Recorder * recorder) :
+	snapshot_recorder(recorder)
 {
 	QFile file(filename);
 
 	if (file.open(QIODevice::ReadOnly))
 	{
-		xml_doc.setContent(&file);
-		file.close();
+		{
+			PhaseProfile::Scope phase("create");
+
+			if (keep_xml)
+			{
+				xml_doc.setContent(&file);
+				file.close();
+
+				create(xml_doc.documentElement());
+			}
+			else
+			{
+				stream(file);
+				file.close();
+			}
+		}
+
+		if (snapshot_recorder != nullptr)
+		{
+			link_tables.resize(controllers.size() + regions.size());
+		}
 
-		create();
 		link();
 		initStatistics();
+
+		if (snapshot_recorder != nullptr)
+		{
+			for (LinkTable & table : link_tables)
+			{
+				snapshot_recorder->links.emplace_back(std::move(table.indices));
+			}
+		}
+	}
+	link_tables.clear();
+	snapshot_recorder = nullptr;
+}
+
+ModelRailway::ModelRailway(const ModelSnapshot & snapshot)
+{
+	__METHOD__;
+
+	std::vector<std::vector<uint32_t>> tables;
+
+	{
+		PhaseProfile::Scope phase("replay");
+
+		name = snapshot.modelName();
+		snapshot.replay(this);
+		snapshot.links(tables);
 	}
+	qCDebug(log) << *this;
+
+	// Missing tables result in unresolved references which are detected
+	// by ModelSnapshot::matches().
+	link_tables.resize(controllers.size() + regions.size());
+	for (size_t i = 0; i < link_tables.size(); i++)
+	{
+		if (i < tables.size())
+		{
+			link_tables[i].indices = std::move(tables[i]);
+		}
+		link_tables[i].replay = true;
+	}
+
+	link();
+
+	links_replayed =
+		(tables.size() == link_tables.size()) &&
+		std::all_of(link_tables.begin(), link_tables.end(), std::mem_fn(&LinkTable::complete));
+	link_tables.clear();
+
+	// The stored statistics include the warnings and errors of the XML load
+	// which are partially reported again while replaying.
+	model_statistics = snapshot.statistics();
 }
 
 void ModelRailway::xml() const
 {
-	xml(xml_doc.documentElement());
+	if (xml_doc.isNull())
+	{
+		qCDebug(log, "No XML document kept while loading the model.");
+	}
+	else
+	{
+		xml(xml_doc.documentElement());
+	}
 }
 
-void ModelRailway::create()
+void ModelRailway::create(const QDomElement & model)
 {
 	__METHOD__;
 
-	const QDomElement  & model = xml_doc.documentElement();
-	const QDomNodeList & child_nodes = model.childNodes();
-
 	name = model.attribute("name");
+	create(this, model);
+
+	qCDebug(log) << *this;
+}
+
+void ModelRailway::create(
+	XmiContainer      * container,
+	const QDomElement & parent,
+	const uint32_t      depth)
+{
+	const QDomNodeList & child_nodes = parent.childNodes();
 
-	controllers.reserve(child_nodes.count());
-	regions.reserve(child_nodes.count());
 	for (int n = 0; n < child_nodes.count(); ++n)
 	{
 		const QDomNode & node = child_nodes.at(n);
@@ -57,54 +156,329 @@ void ModelRailway::create()
 		if (node.isElement())
 		{
 			const QDomElement & child = node.toElement();
-			const QString   &   node_name = child.nodeName();
+			XmiContainer    *   sub   = announce(container, XmiElement(child), depth);
 
-			if (node_name == "controller")
+			if (sub != nullptr)
 			{
-				Controller * controller = new Controller(this, child.toElement());
+				create(sub, child, depth + 1);
+			}
+		}
+	}
+}
 
-				add(controller);
+void ModelRailway::stream(QIODevice & device)
+{
+	__METHOD__;
 
-				qCDebug(log).noquote() << *controller;
-			}
-			else if (node_name == "gruppe")
-			{
-				Region * region = new Region(this, child.toElement(), type(child) == "Bahnhof");
+	QXmlStreamReader            reader(&device);
+	std::vector<XmiContainer *> containers;
 
-				regions.push_back(region);
-				qCDebug(log).noquote() << *region;
+	// Each open element has its container on the stack. A nullptr marks an
+	// element whose children are not of interest.
+	while (!reader.atEnd())
+	{
+		switch (reader.readNext())
+		{
+		case QXmlStreamReader::StartElement:
+			if (containers.empty())
+			{
+				name = reader.attributes().value("name").toString();
+				containers.push_back(this);
 			}
 			else
 			{
-				error("Unknown node name: " + child.nodeName());
+				XmiContainer * parent = containers.back();
+
+				containers.push_back(parent != nullptr ?
+					announce(parent, XmiElement(reader), containers.size()) : nullptr);
 			}
+			break;
+
+		case QXmlStreamReader::EndElement:
+			containers.pop_back();
+			break;
+
+		default:
+			// Text, comments and processing instructions are not modelled.
+			break;
 		}
 	}
+
+	if (reader.hasError())
+	{
+		error(QString("XML error in line %1: %2").
+			arg(reader.lineNumber()).arg(reader.errorString()));
+	}
 	qCDebug(log) << *this;
 }
 
-void ModelRailway::link()
+XmiContainer * ModelRailway::create(const XmiElement & child)
 {
-	std::vector<AbstractSwitch *> switches;
+	const QString & node_name = child.nodeName();
 
-	for (Controller * controller : controllers)
+	if (node_name == "controller")
+	{
+		Controller * controller = new Controller(this, child);
+
+		add(controller);
+
+		qCDebug(log).noquote() << *controller;
+		return controller;
+	}
+	else if (node_name == "gruppe")
 	{
-		controller->link();
+		Region * region = new Region(this, child, type(child) == "Bahnhof");
+
+		regions.push_back(region);
+		qCDebug(log).noquote() << *region;
+		return region;
 	}
+	else
+	{
+		error("Unknown node name: " + node_name);
+	}
+	return nullptr;
+}
+
+void ModelRailway::link()
+{
+	PhaseProfile::Scope           phase("link");
+	std::vector<AbstractSwitch *> switches;
+
+	linkTasks();
+
+	part_registry.clear();
 	for (Region * region : regions)
 	{
-		region->link();
+		part_registry.add(region->part_registry);
 	}
+	part_registry.shrink();
 
 	parts<AbstractSwitch>(switches);
 	for (AbstractSwitch * as : switches)
 	{
 		as->collectFlankSwitches();
 	}
+
+	rail_graph.build(part_registry.get<RailPart>());
+}
+
+XmiContainer * ModelRailway::announce(
+	XmiContainer     * container,
+	const XmiElement & child,
+	const uint32_t     depth)
+{
+	if (snapshot_recorder != nullptr)
+	{
+		snapshot_recorder->add(depth, child);
+	}
+	return container->create(child);
+}
+
+template<size_t N>
+std::optional<EmfPath::Indices<N>> ModelRailway::match(
+	const QString              & path,
+	const EmfPath::Segments<N> & segments)
+{
+	if (link_table == nullptr)
+	{
+		return EmfPath::match(path, segments);
+	}
+
+	LinkTable     &     table = *link_table;
+	EmfPath::Indices<N> indices{};
+
+	if (table.replay)
+	{
+		if ((table.indices.size() - table.pos) < N)
+		{
+			table.failed = true;
+			table.pos    = table.indices.size();
+			return std::nullopt;
+		}
+
+		for (size_t i = 0; i < N; i++)
+		{
+			indices[i] = table.indices[table.pos++];
+		}
+		if (indices[0] == ModelSnapshot::NONE)
+		{
+			return std::nullopt;
+		}
+		return indices;
+	}
+
+	const auto result = EmfPath::match(path, segments);
+
+	for (size_t i = 0; i < N; i++)
+	{
+		table.indices.push_back(result ? (*result)[i] : ModelSnapshot::NONE);
+	}
+	return result;
+}
+
+AssemblyPart * ModelRailway::linkPart(const QString & path) const
+{
+	const auto indices = match(path, EmfPath::ASSEMBLY_PART);
+
+	if (indices)
+	{
+		const auto [region_idx, section_idx, part_idx] = *indices;
+
+		if ((link_table != nullptr) && link_table->replay)
+		{
+			const Section * found = findSection(region_idx, section_idx);
+
+			if ((found != nullptr) && (part_idx < found->assemblyPartCount()))
+			{
+				return found->assemblyPart(part_idx);
+			}
+			link_table->failed = true;
+			return nullptr;
+		}
+		return assemblyPart(region_idx, section_idx, part_idx);
+	}
+	return nullptr;
+}
+
+Section * ModelRailway::linkSection(const QString & path) const
+{
+	const auto indices = match(path, EmfPath::SECTION);
+
+	if (indices)
+	{
+		const auto [region_idx, section_idx] = *indices;
+
+		if ((link_table != nullptr) && link_table->replay)
+		{
+			Section * found = findSection(region_idx, section_idx);
+
+			link_table->failed |= found == nullptr;
+			return found;
+		}
+		return section(region_idx, section_idx);
+	}
+	return nullptr;
+}
+
+Section * ModelRailway::findSection(
+	const size_t region_idx,
+	const size_t section_idx) const noexcept
+{
+	if ((region_idx < regions.size()) && (section_idx < regions[region_idx]->sections.size()))
+	{
+		return regions[region_idx]->sections[section_idx];
+	}
+	return nullptr;
+}
+
+bool ModelRailway::LinkTable::complete() const noexcept
+{
+	return !failed && (pos == indices.size());
+}
+
+void ModelRailway::linkTasks()
+{
+	const size_t                         count = controllers.size() + regions.size();
+	std::vector<std::vector<Diagnostic>> buffers(count);
+	std::vector<std::exception_ptr>      exceptions(count);
+	std::vector<std::thread>             threads;
+	std::atomic<size_t>                  next(0);
+
+	// Controllers and regions only write their own state while linking and
+	// read the other model elements by index so they may be linked
+	// concurrently.
+	auto worker = [&]()
+	{
+		for (size_t i = next++; i < count; i = next++)
+		{
+			diagnostics = &buffers[i];
+			link_table  = link_tables.empty() ? nullptr : &link_tables[i];
+			try
+			{
+				if (i < controllers.size())
+				{
+					controllers[i]->link();
+				}
+				else
+				{
+					regions[i - controllers.size()]->link();
+				}
+			}
+			catch (...)
+			{
+				exceptions[i] = std::current_exception();
+			}
+			diagnostics = nullptr;
+			link_table  = nullptr;
+		}
+	};
+
+	const size_t workers = linkThreads(count);
+
+	threads.reserve(workers - 1);
+	try
+	{
+		while ((threads.size() + 1) < workers)
+		{
+			threads.emplace_back(worker);
+		}
+	}
+	catch (const std::system_error & e)
+	{
+		qCWarning(log).noquote() << "Linking with" << threads.size() + 1 << "threads:" << e.what();
+	}
+	worker();
+	for (std::thread & thread : threads)
+	{
+		thread.join();
+	}
+
+	// Replay in task order which is the order of a sequential link.
+	for (size_t i = 0; i < count; i++)
+	{
+		for (const Diagnostic & diagnostic : buffers[i])
+		{
+			if (diagnostic.is_error)
+			{
+				error(diagnostic.message);
+			}
+			else
+			{
+				warning(diagnostic.message);
+			}
+		}
+
+		if (exceptions[i])
+		{
+			std::rethrow_exception(exceptions[i]);
+		}
+	}
+}
+
+size_t ModelRailway::linkThreads(const size_t tasks)
+{
+	static constexpr size_t TASKS_PER_THREAD = 16;
+
+	size_t threads = link_threads;
+
+	if (threads == 0)
+	{
+		threads = std::min<size_t>(
+				std::thread::hardware_concurrency(),
+				tasks / TASKS_PER_THREAD);
+	}
+	return std::clamp<size_t>(threads, 1, std::max<size_t>(tasks, 1));
+}
+
+void ModelRailway::setLinkThreads(const unsigned threads)
+{
+	link_threads = threads;
 }
 
 void ModelRailway::initStatistics()
 {
+	PhaseProfile::Scope           phase("initStatistics");
 	std::vector<AbstractSwitch *> switches;
 	std::vector<Signal *>         signal_s;
 
@@ -191,7 +565,7 @@ Controller * ModelRailway::controller(const std::size_t index) const
 	return controllers.at(index);
 }
 
-QString ModelRailway::type(const QDomElement & element)
+QString ModelRailway::type(const XmiElement & element)
 {
 	const QStringList type_list = element.attribute("xsi:type").split(":");
 
@@ -205,7 +579,7 @@ QString ModelRailway::type(const QDomElement & element)
 }
 
 unsigned ModelRailway::value(
-	const QDomElement  &  node,
+	const XmiElement   &  node,
 	const char      *     attr,
 	const unsigned        default_value)
 {
@@ -213,7 +587,7 @@ unsigned ModelRailway::value(
 }
 
 QString ModelRailway::string(
-	const QDomElement  &  node,
+	const XmiElement   &  node,
 	const char      *     attr)
 {
 	return node.attribute(attr);
@@ -221,12 +595,24 @@ QString ModelRailway::string(
 
 void ModelRailway::warning(const QString & message)
 {
+	if (diagnostics != nullptr)
+	{
+		diagnostics->push_back(Diagnostic{false, message});
+		return;
+	}
+
 	model_statistics.warnings++;
 	qCWarning(log).noquote() << message;
 }
 
 void ModelRailway::error(const QString & message)
 {
+	if (diagnostics != nullptr)
+	{
+		diagnostics->push_back(Diagnostic{true, message});
+		return;
+	}
+
 	model_statistics.errors++;
 	qCCritical(log).noquote() << message;
 }
@@ -256,16 +642,16 @@ void ModelRailway::add(Controller * controller)
 
 void ModelRailway::add(Device * device)
 {
-	const DeviceId id = DeviceId(device);
-	const auto   it = device_map.find(id);
+	const DeviceId id   = DeviceId(device);
+	Device     *   & slot = device_table.slot(id);
 
-	if (it == device_map.end())
+	if (slot == nullptr)
 	{
-		device_map.emplace(id, device);
+		slot = device;
 	}
 	else
 	{
-		Device * other = it->second;
+		Device * other = slot;
 
 		error(QString("Devices %1 and %2/%3 have both the same unit no: %2!").
 			arg(other->name()).arg(id.first).arg(id.second));
@@ -284,7 +670,12 @@ const MrwStatistic & ModelRailway::statistics() const
 	return model_statistics;
 }
 
-bool ModelRailway::boolean(const QDomElement & node, const char * attr, const bool default_value)
+const RailGraph & ModelRailway::railGraph() const
+{
+	return rail_graph;
+}
+
+bool ModelRailway::boolean(const XmiElement & node, const char * attr, const bool default_value)
 {
 	return node.attribute(attr, default_value ? "true" : "false") == "true";
 }
@@ -329,9 +720,7 @@ Device * ModelRailway::deviceById(
 	const ControllerId id,
 	const UnitNo       unit_no) const
 {
-	auto it = device_map.find(DeviceKey(id, unit_no));
-
-	return it != device_map.end() ? it->second : nullptr;
+	return device_table.get(id, unit_no);
 }
 
 size_t ModelRailway::controllerCount() const
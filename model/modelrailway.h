@@ -9,14 +9,23 @@
 #define MRW_MODEL_MODELRAILWAY_H
 
 #include <QDomDocument>
+#include <QIODevice>
 #include <QLoggingCategory>
 #include <QString>
 
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
+#include <can/devicetable.h>
 #include <model/controller.h>
+#include <model/emfpath.h>
+#include <model/modelsnapshot.h>
+#include <model/partregistry.h>
+#include <model/railgraph.h>
 #include <model/region.h>
 #include <model/section.h>
+#include <model/xmielement.h>
 #include <util/cleanvector.h>
 #include <util/method.h>
 #include <util/stringutil.h>
@@ -84,6 +93,8 @@ namespace mrw::model
 
 		/** Number of errors during model load. */
 		size_t errors             = 0;
+
+		bool operator==(const MrwStatistic & other) const noexcept = default;
 	};
 
 	/**
@@ -120,7 +131,7 @@ namespace mrw::model
 	 * This class contains the complete data structure referring to a
 	 * model railway. It is parsed from a modelrailway EMF/XMI file.
 	 */
-	class ModelRailway : public mrw::util::String
+	class ModelRailway : public XmiContainer, public mrw::util::String
 	{
 		friend class Controller;
 		friend class Module;
@@ -139,19 +150,90 @@ namespace mrw::model
 		friend class ProfileLight;
 		friend class Signal;
 		friend class Crossing;
+		friend class SectionModule;
+		friend class ModelSnapshot;
 
 		std::unordered_map<mrw::can::ControllerId, Controller *>     controller_map;
-		std::unordered_map<mrw::can::DeviceKey, Device *, DeviceId>  device_map;
+		mrw::can::DeviceTable<Device *>                              device_table;
 
 		QDomDocument                        xml_doc;
 		QString                             name;
 		mrw::util::CleanVector<Controller>  controllers;
 		mrw::util::CleanVector<Region>      regions;
+		PartRegistry                        part_registry;
+		RailGraph                           rail_graph;
 
 		MrwStatistic                        model_statistics;
 
+		/**
+		 * A warning or error reported while linking concurrently. It is
+		 * buffered per link task and replayed in task order afterwards.
+		 */
+		struct Diagnostic
+		{
+			bool    is_error = false;
+			QString message;
+		};
+
+		/**
+		 * The resolved link references of one link task as indices. While
+		 * loading from XML with a ModelSnapshot::Recorder they are recorded
+		 * and while loading from a ModelSnapshot they are consumed instead
+		 * of resolving the EMF paths again.
+		 */
+		struct LinkTable
+		{
+			std::vector<uint32_t> indices;
+			size_t                pos    = 0;
+			bool                  replay = false;
+			bool                  failed = false;
+
+			[[nodiscard]]
+			bool complete() const noexcept;
+		};
+
+		static thread_local std::vector<Diagnostic> * diagnostics;
+		static thread_local LinkTable               * link_table;
+		static unsigned                               link_threads;
+
+		std::vector<LinkTable>                        link_tables;
+		ModelSnapshot::Recorder                     * snapshot_recorder = nullptr;
+		bool                                          links_replayed    = false;
+
 	public:
-		explicit ModelRailway(const QString & filename);
+		/**
+		 * This constructor loads the modelrailway file. By default the file
+		 * is parsed using a QXmlStreamReader which creates all model
+		 * elements in one pass and frees all parser state afterwards. If
+		 * the XML document is needed for dumping purposes a QDomDocument
+		 * is used instead which is kept during lifetime.
+		 *
+		 * If a ModelSnapshot::Recorder is given all created XMI elements
+		 * and all resolved link references are recorded so that a
+		 * ModelSnapshot can be written afterwards.
+		 *
+		 * @param filename The filename of the modelrailway file.
+		 * @param keep_xml True if the QDomDocument should be kept.
+		 * @param recorder The optional ModelSnapshot::Recorder to fill.
+		 * @see xml()
+		 * @see ModelSnapshot::write()
+		 */
+		explicit ModelRailway(
+			const QString           & filename,
+			const bool                keep_xml = false,
+			ModelSnapshot::Recorder * recorder = nullptr);
+
+		/**
+		 * This constructor creates the model railway from a precompiled
+		 * and already validated ModelSnapshot. The snapshot replays all
+		 * XMI elements and rebuilds the link references from the stored
+		 * indices. The statistics are taken from the snapshot. Use
+		 * ModelSnapshot::matches() to verify the result.
+		 *
+		 * @param snapshot The valid ModelSnapshot to load from.
+		 * @see ModelSnapshot::valid()
+		 */
+		explicit ModelRailway(const ModelSnapshot & snapshot);
 
 		// Copy not allowed.
 		ModelRailway(const ModelRailway & other) = delete;
@@ -160,7 +242,10 @@ namespace mrw::model
 		virtual ~ModelRailway() = default;
 
 		/**
-		 * This method dumps the parsed EMF/XMI nodes and attributes.
+		 * This method dumps the parsed EMF/XMI nodes and attributes. This is
+		 * only possible if the XML document was kept during construction.
+		 *
+		 * @see ModelRailway()
 		 */
 		void xml() const;
 
@@ -335,19 +420,37 @@ namespace mrw::model
 		 *
 		 * @param result The result vector collecting the AssembyPart elements
 		 * of type T.
-		 * @param guard A lamda to fine-select if the type T should added to
-		 * the result vector.
+		 * @param guard Any invocable to fine-select if the type T should
+		 * added to the result vector.
+		 * @see Section::parts()
 		 */
-		template <class T> void parts(
-			std::vector<T *>          &         result,
-			std::function<bool(const T * part)> guard = &mrw::util::Method::always<T>)
+		template <class T, class G = decltype(&mrw::util::Method::always<T>)>
+		void parts(
+			std::vector<T *> & result,
+			G                  guard = &mrw::util::Method::always<T>) const
 		{
-			for (Region * sub : regions)
+			if constexpr (PartRegistry::contains<T>)
+			{
+				part_registry.collect(result, guard);
+			}
+			else
 			{
-				sub->parts<T>(result, guard);
+				for (Region * sub : regions)
+				{
+					sub->parts<T>(result, guard);
+				}
 			}
 		}
 
+		/**
+		 * This method returns the static topology of all RailPart elements
+		 * computed after linking.
+		 *
+		 * @return The RailGraph of this model railway.
+		 * @see Route::append()
+		 */
+		const RailGraph & railGraph() const;
+
 		/**
 		 * This method returns statistics about the loaded model railway.
 		 *
@@ -355,18 +458,54 @@ namespace mrw::model
 		 */
 		const MrwStatistic & statistics() const;
 
+		/**
+		 * This method sets the amount of threads used to link the
+		 * Controller and Region instances after loading. A value of zero
+		 * selects the thread count automatically depending on the model
+		 * size and the available cores. A value of one links sequentially.
+		 *
+		 * @param threads The amount of link threads.
+		 */
+		static void setLinkThreads(const unsigned threads);
+
 	private:
-		static QString  type(const QDomElement & node);
-		static bool     boolean(const QDomElement & node, const char * attr, const bool default_value = false);
-		static unsigned value(const QDomElement & node, const char * attr, const unsigned default_value = 0);
-		static QString  string(const QDomElement & node, const char * attr);
+		static QString  type(const XmiElement & node);
+		static bool     boolean(const XmiElement & node, const char * attr, const bool default_value = false);
+		static unsigned value(const XmiElement & node, const char * attr, const unsigned default_value = 0);
+		static QString  string(const XmiElement & node, const char * attr);
 
 		/**
 		* This method initializes the model structure from the XML document by
 		* parsing all top-level nodes and instantiating Controller and Region
 		* objects.
+		*
+		* @param model The document element of the XML document.
 		*/
-		void create();
+		void create(const QDomElement & model);
+
+		/**
+		* This method walks recursively through the XML document and
+		* announces every child element to the given container.
+		*
+		* @param container The XmiContainer of the parent element.
+		* @param parent The parent DOM element.
+		*/
+		void create(
+			XmiContainer      * container,
+			const QDomElement & parent,
+			const uint32_t      depth = 1);
+
+		/**
+		* This method initializes the model structure in one pass using a
+		* QXmlStreamReader. The elements are announced to the same
+		* XmiContainer instances as the QDomDocument based loader does so
+		* both loaders result in the same model.
+		*
+		* @param device The opened QIODevice to read from.
+		*/
+		void stream(QIODevice & device);
+
+		XmiContainer * create(const XmiElement & child) override;
 
 		/**
 		* Adds the given Controller to the internal model structure.
@@ -386,10 +525,88 @@ namespace mrw::model
 
 		/**
 		* This method links the internal object structure after creation,
-		* especially to resolve cross-references like flank switches.
+		* especially to resolve cross-references like flank switches. At
+		* last the RailGraph is computed.
 		*/
 		void link();
 
+		/**
+		* This method announces the given child element to its container
+		* and records it if a ModelSnapshot::Recorder is in use.
+		*
+		* @param container The XmiContainer of the child element.
+		* @param child The child XmiElement.
+		* @param depth The depth of the child below the root element.
+		* @return The created XmiContainer or @c nullptr.
+		*/
+		XmiContainer * announce(
+			XmiContainer     * container,
+			const XmiElement & child,
+			const uint32_t     depth);
+
+		/**
+		* This method resolves an EMF path into its indices. If the
+		* actual link task replays a ModelSnapshot the indices are read
+		* from its LinkTable instead. If the link task records, the
+		* resolved indices are appended to its LinkTable.
+		*
+		* @param path The EMF path to resolve.
+		* @param segments The expected EMF path segments.
+		* @return The resolved indices.
+		*/
+		template<size_t N>
+		static std::optional<EmfPath::Indices<N>> match(
+			const QString              & path,
+			const EmfPath::Segments<N> & segments);
+
+		/**
+		* This method resolves an EMF path to an AssemblyPart while
+		* linking.
+		*
+		* @param path The EMF path to the AssemblyPart.
+		* @return The resolved AssemblyPart or @c nullptr.
+		* @see AssemblyPart::resolve()
+		*/
+		AssemblyPart * linkPart(const QString & path) const;
+
+		/**
+		* This method resolves an EMF path to a Section while linking.
+		*
+		* @param path The EMF path to the Section.
+		* @return The resolved Section or @c nullptr.
+		*/
+		Section * linkSection(const QString & path) const;
+
+		/**
+		* This method looks up a Section without throwing exceptions. It
+		* is used for indices read from a ModelSnapshot.
+		*
+		* @param region_idx The Region index.
+		* @param section_idx The Section index inside the Region.
+		* @return The Section or @c nullptr if the indices are out of range.
+		*/
+		Section * findSection(
+			const size_t region_idx,
+			const size_t section_idx) const noexcept;
+
+		/**
+		* This method links all Controller and Region instances as
+		* independent tasks distributed over a set of threads. Warnings and
+		* errors are buffered per task and reported in Controller and
+		* Region order afterwards so the statistics and the log output are
+		* identical to a sequential link.
+		*/
+		void linkTasks();
+
+		/**
+		* This method computes the amount of link threads for the given
+		* task count.
+		*
+		* @param tasks The amount of link tasks.
+		* @return The amount of threads including the calling thread.
+		*/
+		static size_t linkThreads(const size_t tasks);
+
 		/**
 		* This method calculates statistical data (counts of regions, switches,
 		* signals, and signal groups) and stores it in the MrwStatistic struct.
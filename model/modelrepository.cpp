@@ -3,12 +3,18 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <exception>
+
 #include <QCoreApplication>
 #include <QDirIterator>
 
+#include <util/phaseprofile.h>
+#include <util/properties.h>
+
 #include <model/signal.h>
 #include <model/railpart.h>
 #include <model/modelrepository.h>
+#include <model/modelsnapshot.h>
 
 using namespace mrw::util;
 using namespace mrw::model;
@@ -33,16 +39,14 @@ ModelRepository::ModelRepository(
 	filename += modelname + ".modelrailway";
 	filter << filename;
 
+	prepareHost();
 	if (prepareModel())
 	{
 		SettingsGroup group(&settings_host, MODEL_GROUP);
 
-		model = new ModelRailway(model_filename);
-
-		readMaps();
+		loadModel();
 		settings_host.setValue("modelname", modelname);
 	}
-	prepareHost();
 
 	if ((model != nullptr) && use_positions)
 	{
@@ -82,6 +86,26 @@ const QString & ModelRepository::interface() const
 	return settings_host.interface();
 }
 
+bool ModelRepository::threaded() const
+{
+	return settings_host.threaded();
+}
+
+bool ModelRepository::virtualTime() const
+{
+	return use_virtual;
+}
+
+const QString & ModelRepository::traceFilename() const
+{
+	return trace_filename;
+}
+
+size_t ModelRepository::traceSize() const
+{
+	return trace_size;
+}
+
 void ModelRepository::save()
 {
 	qCInfo(log, "Saving positions.");
@@ -144,13 +168,103 @@ bool ModelRepository::prepareModel()
 	return true;
 }
 
-void ModelRepository::readMaps()
+void ModelRepository::loadModel()
+{
+	const QStringList & sources =
+	{
+		model_filename, region_filename, signal_filename, railpart_filename
+	};
+	const QString & snapshot_filename = ModelSnapshot::filename(model_filename);
+
+	if (use_snapshot && !dump_xml && loadSnapshot(snapshot_filename, sources))
+	{
+		return;
+	}
+
+	ModelSnapshot::Recorder recorder;
+
+	model = new ModelRailway(model_filename, dump_xml, use_snapshot ? &recorder : nullptr);
+	readPositions();
+
+	if (use_snapshot &&
+		!ModelSnapshot::write(snapshot_filename, sources, *model, recorder, positions))
+	{
+		qCWarning(log).noquote() << "Cannot write snapshot" << snapshot_filename;
+	}
+}
+
+bool ModelRepository::loadSnapshot(
+	const QString     & snapshot_filename,
+	const QStringList & sources)
 {
+	const ModelSnapshot snapshot(snapshot_filename);
+
+	if (!snapshot.valid(sources))
+	{
+		return false;
+	}
+
+	qCDebug(log).noquote() << "Loading snapshot" << snapshot_filename;
+	try
+	{
+		model = new ModelRailway(snapshot);
+	}
+	catch (const std::exception & e)
+	{
+		qCWarning(log).noquote() << "Cannot load snapshot:" << e.what();
+		return false;
+	}
+
+	if (!snapshot.matches(*model))
+	{
+		qCWarning(log, "Snapshot does not match model, loading XML file.");
+		delete model;
+		model = nullptr;
+		return false;
+	}
+
+	snapshot.positions(positions);
+	return true;
+}
+
+void ModelRepository::readPositions()
+{
+	PhaseProfile::Scope     phase("readPositions");
+	Properties              region_map(region_filename);
+	Properties              signal_map(signal_filename);
+	Properties              railpart_map(railpart_filename);
+	std::vector<RailPart *> parts;
+
 	qCDebug(log, "Reading position maps...");
 
-	region_map.read(region_filename);
-	signal_map.read(signal_filename);
-	railpart_map.read(railpart_filename);
+	positions = ModelSnapshot::Positions();
+	for (size_t r = 0; r < model->regionCount(); r++)
+	{
+		Region        *       region     = model->region(r);
+		QString               region_key = region->key();
+		std::vector<Signal *> region_signals;
+
+		positions.regions.push_back(QString::fromStdString(
+			region_map.lookup(prepareKey(region_key).toStdString())));
+
+		region->parts<Signal>(region_signals);
+		for (Signal * signal : region_signals)
+		{
+			QString prep = region_key + signal->partName();
+
+			positions.signal_values.push_back(QString::fromStdString(
+				signal_map.lookup(prepareKey(prep).toStdString())));
+		}
+	}
+
+	model->parts<RailPart>(parts);
+	for (RailPart * part : parts)
+	{
+		QString prep = part->key();
+
+		positions.rail_parts.push_back(QString::fromStdString(
+			railpart_map.lookup(prepareKey(prep).toStdString())));
+	}
 }
 
 ModelRepository::operator bool() const
@@ -232,81 +346,66 @@ void ModelRepository::prepareHost()
 {
 	SettingsGroup group (settings_host);
 
-	dump_result = settings_host.value("dump", dump_result).toBool();
-	dump_xml    = settings_host.value("xml",  dump_xml).toBool();
+	dump_result  = settings_host.value("dump",     dump_result).toBool();
+	dump_xml     = settings_host.value("xml",      dump_xml).toBool();
+	use_snapshot = settings_host.value("snapshot", use_snapshot).toBool();
+	use_virtual  = settings_host.value("virtualtime", use_virtual).toBool();
+
+	trace_filename = settings_host.value("trace",     trace_filename).toString();
+	trace_size     = settings_host.value("tracesize", qulonglong(trace_size)).toULongLong();
 
 	qCDebug(log).noquote().nospace() << "Using CAN: " << plugin() << "/" << interface();
 }
 
 void ModelRepository::prepareRegions()
 {
+	PhaseProfile::Scope phase("prepareRegions");
+	size_t              signal_index = 0;
+
 	for (size_t r = 0; r < model->regionCount(); r++)
 	{
 		Region * region = model->region(r);
 
-		try
 		{
-			SettingsGroup       group(&settings_model, REGION_GROUP);
-			QString             prep  = region->key();
-			const std::string & key   = prepareKey(prep).toStdString();
-			const std::string & value = region_map.lookup(key);
+			SettingsGroup   group(&settings_model, REGION_GROUP);
+			const QString & value = r < positions.regions.size() ? positions.regions[r] : QString();
 
 			// Values stored as invert direction flag.
 			region->parse(settings_model, value != "true");
 		}
-		catch (std::out_of_range & e)
-		{
-			qCWarning(log).noquote() << "No direction found for " << *region << e.what();
-		}
-		prepareSignals(region);
+		prepareSignals(region, signal_index);
 	}
 }
 
 void ModelRepository::prepareRailParts()
 {
+	PhaseProfile::Scope     phase("prepareRailParts");
 	SettingsGroup           group(&settings_model, POSITION_GROUP);
 	std::vector<RailPart *> parts;
 
 	model->parts<RailPart>(parts);
-	for (RailPart * part : parts)
+	for (size_t p = 0; p < parts.size(); p++)
 	{
-		try
-		{
-			QString             prep  = part->key();
-			const std::string & key   = prepareKey(prep).toStdString();
-			const std::string & value = railpart_map.lookup(key);
+		const QString & value = p < positions.rail_parts.size() ? positions.rail_parts[p] : QString();
 
-			part->parse(settings_model, QString(value.c_str()));
-		}
-		catch (std::out_of_range & e)
-		{
-			qCWarning(log) << "No coordinate found for " << *part;
-		}
+		parts[p]->parse(settings_model, value);
 	}
 }
 
-void ModelRepository::prepareSignals(Region * region)
+void ModelRepository::prepareSignals(Region * region, size_t & index)
 {
+	PhaseProfile::Scope   phase("prepareSignals");
 	SettingsGroup         group(&settings_model, POSITION_GROUP);
-	QString               region_key = region->key();
 	std::vector<Signal *> region_signals;
 
 	region->parts<Signal>(region_signals);
-
 	for (Signal * signal : region_signals)
 	{
-		try
-		{
-			QString             prep  = region_key + signal->partName();
-			const std::string & key   = prepareKey(prep).toStdString();
-			const std::string & value = signal_map.lookup(key);
+		const QString & value = index < positions.signal_values.size() ?
+			positions.signal_values[index] : QString();
 
-			signal->parse(settings_model, QString(value.c_str()));
-		}
-		catch (std::out_of_range & e)
-		{
-			qCWarning(log) << "No coordinate found for " << *signal;
-		}
+		signal->parse(settings_model, value);
+		index++;
 	}
 }
 
@@ -13,10 +13,11 @@
 
 #include <QDir>
 
-#include <util/properties.h>
 #include <util/settings.h>
+#include <util/tracerecorder.h>
 #include <can/cansettings.h>
 #include <model/modelrailway.h>
+#include <model/modelsnapshot.h>
 #include <model/region.h>
 
 namespace mrw::model
@@ -46,6 +47,12 @@ namespace mrw::model
 	 *
 	 * This class also maintain per hostname CAN bus configuration. So it is
 	 * possible to make different CAN configuration available on specific hosts.
+	 *
+	 * To speed up startup the linked model and the resolved position values
+	 * may be cached inside a ModelSnapshot file next to the modelrailway
+	 * file. The snapshot is used as long as none of the source files
+	 * changed. It is disabled by default and can be enabled per host by
+	 * setting &lt;hostname&gt;/snapshot to @c true.
 	 */
 	class ModelRepository
 	{
@@ -75,11 +82,13 @@ namespace mrw::model
 		bool                         dump_result   = false;
 		bool                         dump_xml      = false;
 		bool                         use_positions = false;
+		bool                         use_snapshot  = false;
+		bool                         use_virtual   = false;
+		QString                      trace_filename;
+		size_t                       trace_size    = mrw::util::TraceRecorder::DEFAULT_CAPACITY;
 
 		ModelRailway        *        model         = nullptr;
-		mrw::util::Properties        region_map;
-		mrw::util::Properties        signal_map;
-		mrw::util::Properties        railpart_map;
+		ModelSnapshot::Positions     positions;
 
 	public:
 		/**
@@ -142,6 +151,50 @@ namespace mrw::model
 		 */
 		const QString & interface() const;
 
+		/**
+		 * This method returns true if the CAN bus should use its own I/O
+		 * thread. The mode is configured inside the &lt;modelname&gt;.conf
+		 * file under the value &lt;hostname&gt;/threaded. The default is
+		 * false.
+		 *
+		 * @return True if the CAN bus should use its own I/O thread.
+		 * @see mrw::can::MrwBusService
+		 */
+		bool threaded() const;
+
+		/**
+		 * This method returns true if timers should run in virtual time
+		 * instead of wall clock time. The mode is configured inside the
+		 * &lt;modelname&gt;.conf file under the value
+		 * &lt;hostname&gt;/virtualtime. The default is false. The
+		 * applications driving statecharts apply it on startup.
+		 *
+		 * @return True if virtual time should be used.
+		 * @see mrw::statechart::TimerService::setVirtualTime()
+		 */
+		bool virtualTime() const;
+
+		/**
+		 * This method returns the filename of the binary trace. The
+		 * filename is configured inside the &lt;modelname&gt;.conf file
+		 * under the value &lt;hostname&gt;/trace. The default is empty
+		 * which disables tracing.
+		 *
+		 * @return The trace filename or an empty string.
+		 * @see mrw::util::TraceRecorder
+		 */
+		const QString & traceFilename() const;
+
+		/**
+		 * This method returns the amount of records of the binary trace
+		 * ring. The amount is configured inside the &lt;modelname&gt;.conf
+		 * file under the value &lt;hostname&gt;/tracesize.
+		 *
+		 * @return The amount of trace records.
+		 * @see mrw::util::TraceRecorder
+		 */
+		size_t traceSize() const;
+
 		/**
 		 * This method saves the Position data into the model named QSettings.
 		 */
@@ -160,7 +213,8 @@ namespace mrw::model
 		/**
 		 * This method dumps the XML/XMI data if this is enabled in the model
 		 * named QSettings. Inside the &lt;modelname&gt;.conf file the value
-		 * &lt;hostname&gt;/xml has to be set to @c true.
+		 * &lt;hostname&gt;/xml has to be set to @c true. In that case the
+		 * model is loaded using a QDomDocument which is kept in memory.
 		 *
 		 * @see ModelRailway::xml();
 		 */
@@ -187,7 +241,11 @@ namespace mrw::model
 
 	private:
 		bool        prepareModel();
-		void        readMaps();
+		void        loadModel();
+		bool        loadSnapshot(
+			const QString     & snapshot_filename,
+			const QStringList & sources);
+		void        readPositions();
 		QString     lookup();
 		QStringList lookupProperties(const QString & base);
 		void        setFilenames();
@@ -195,7 +253,7 @@ namespace mrw::model
 		void        prepareHost();
 		void        prepareRegions();
 		void        prepareRailParts();
-		void        prepareSignals(Region * region);
+		void        prepareSignals(Region * region, size_t & index);
 
 		void        storeRegions();
 		void        storePositions();
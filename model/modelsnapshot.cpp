@@ -0,0 +1,701 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include "model/modelrailway.h"
+#include "model/modelsnapshot.h"
+
+using namespace mrw::model;
+
+/*************************************************************************
+**                                                                      **
+**       Snapshot compiler                                              **
+**                                                                      **
+*************************************************************************/
+
+namespace
+{
+	/**
+	 * This helper collects the payload of a ModelSnapshot. Strings are
+	 * deduplicated so the many equal attribute names are stored once.
+	 */
+	class SnapshotWriter
+	{
+		QHash<QString, uint32_t> string_index;
+		std::vector<QByteArray>  strings;
+		QByteArray               body;
+
+	public:
+		uint32_t add(const QString & text)
+		{
+			auto it = string_index.find(text);
+
+			if (it != string_index.end())
+			{
+				return it.value();
+			}
+
+			const uint32_t index = strings.size();
+
+			string_index.insert(text, index);
+			strings.push_back(text.toUtf8());
+			return index;
+		}
+
+		void append(const uint32_t value)
+		{
+			body.append(reinterpret_cast<const char *>(&value), sizeof(value));
+		}
+
+		void append(const uint64_t value)
+		{
+			append(uint32_t(value));
+			append(uint32_t(value >> 32));
+		}
+
+		void append(const std::vector<QString> & values)
+		{
+			append(uint32_t(values.size()));
+			for (const QString & value : values)
+			{
+				append(add(value));
+			}
+		}
+
+		QByteArray payload() const
+		{
+			QByteArray result;
+			QByteArray text;
+			uint32_t   offset = 0;
+
+			for (const QByteArray & s : strings)
+			{
+				text.append(s);
+			}
+
+			const uint32_t count = strings.size();
+			const uint32_t size  = text.size();
+
+			result.append(reinterpret_cast<const char *>(&count), sizeof(count));
+			result.append(reinterpret_cast<const char *>(&size),  sizeof(size));
+			for (const QByteArray & s : strings)
+			{
+				result.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+				offset += s.size();
+			}
+			result.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+			while ((text.size() % sizeof(uint32_t)) != 0)
+			{
+				text.append('\0');
+			}
+			result.append(text);
+			result.append(body);
+
+			return result;
+		}
+	};
+
+	/**
+	 * This helper returns the size and the modification time of a source
+	 * file. A missing file results in an invalid modification time.
+	 */
+	void sourceInfo(const QString & source, uint64_t & size, uint64_t & mtime)
+	{
+		const QFileInfo info(source);
+
+		size  = info.exists() ? info.size() : 0;
+		mtime = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+	}
+}
+
+const char * ModelSnapshot::SUFFIX = ".snapshot";
+
+void ModelSnapshot::Recorder::add(const uint32_t depth, const XmiElement & element)
+{
+	elements.push_back(Element{depth, element});
+}
+
+bool ModelSnapshot::write(
+	const QString      & filename,
+	const QStringList  & sources,
+	const ModelRailway & model,
+	const Recorder     & recorder,
+	const Positions    & positions)
+{
+	SnapshotWriter writer;
+
+	// Sources
+	writer.append(uint32_t(sources.size()));
+	for (const QString & source : sources)
+	{
+		uint64_t source_size;
+		uint64_t source_mtime;
+
+		sourceInfo(source, source_size, source_mtime);
+		writer.append(writer.add(source));
+		writer.append(source_size);
+		writer.append(source_mtime);
+	}
+
+	// Model name and shape
+	const Shape & written_shape = shape(model);
+
+	writer.append(writer.add(model.name));
+	writer.append(written_shape.controllers);
+	writer.append(written_shape.regions);
+	writer.append(written_shape.sections);
+	writer.append(written_shape.parts);
+
+	// XMI elements
+	writer.append(uint32_t(recorder.elements.size()));
+	for (const Recorder::Element & element : recorder.elements)
+	{
+		const QXmlStreamAttributes & attributes = element.element.attributes();
+
+		writer.append(element.depth);
+		writer.append(writer.add(element.element.nodeName()));
+		writer.append(uint32_t(attributes.size()));
+		for (const QXmlStreamAttribute & attribute : attributes)
+		{
+			writer.append(writer.add(attribute.qualifiedName().toString()));
+			writer.append(writer.add(attribute.value().toString()));
+		}
+	}
+
+	// Resolved link references per link task
+	writer.append(uint32_t(recorder.links.size()));
+	for (const std::vector<uint32_t> & table : recorder.links)
+	{
+		writer.append(uint32_t(table.size()));
+		for (const uint32_t index : table)
+		{
+			writer.append(index);
+		}
+	}
+
+	// Statistics
+	const MrwStatistic & statistics = model.statistics();
+
+	writer.append(uint32_t(statistics.region_count));
+	writer.append(uint32_t(statistics.device_count));
+	writer.append(uint32_t(statistics.section_count));
+	writer.append(uint32_t(statistics.switch_count));
+	writer.append(uint32_t(statistics.signal_count));
+	writer.append(uint32_t(statistics.main_signal_count));
+	writer.append(uint32_t(statistics.signal_group_count));
+	writer.append(uint32_t(statistics.warnings));
+	writer.append(uint32_t(statistics.errors));
+
+	// Positions
+	writer.append(positions.regions);
+	writer.append(positions.signal_values);
+	writer.append(positions.rail_parts);
+
+	const QByteArray & payload     = writer.payload();
+	const QByteArray & source_hash = hash(sources);
+	Header             head{};
+
+	head.magic         = MAGIC;
+	head.version       = VERSION;
+	head.byte_order    = BYTE_ORDER;
+	head.payload_size  = payload.size();
+	head.checksum      = checksum(reinterpret_cast<const uchar *>(payload.constData()), payload.size());
+	std::memcpy(head.source_hash, source_hash.constData(), HASH_SIZE);
+
+	// Write atomically so a concurrently starting application never maps a
+	// half written snapshot.
+	QSaveFile out(filename);
+
+	if (out.open(QIODevice::WriteOnly))
+	{
+		out.write(reinterpret_cast<const char *>(&head), sizeof(head));
+		out.write(payload);
+
+		return out.commit();
+	}
+	return false;
+}
+
+QString ModelSnapshot::filename(const QString & model_filename)
+{
+	return model_filename + SUFFIX;
+}
+
+QByteArray ModelSnapshot::hash(const QStringList & sources)
+{
+	QCryptographicHash sha(QCryptographicHash::Sha256);
+
+	for (const QString & source : sources)
+	{
+		QFile source_file(source);
+
+		sha.addData(source.toUtf8());
+		if (source_file.open(QIODevice::ReadOnly))
+		{
+			sha.addData(&source_file);
+		}
+	}
+	return sha.result();
+}
+
+ModelSnapshot::Shape ModelSnapshot::shape(const ModelRailway & model)
+{
+	Shape result;
+
+	result.controllers = model.controllers.size();
+	result.regions     = model.regions.size();
+	for (const Region * region : model.regions)
+	{
+		result.sections += region->sectionCount();
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			result.parts += region->section(s)->assemblyPartCount();
+		}
+	}
+	return result;
+}
+
+uint64_t ModelSnapshot::checksum(const uchar * begin, const size_t length) noexcept
+{
+	// FNV-1a is sufficient to detect a corrupted payload and much cheaper
+	// than a cryptographic hash on every start.
+	uint64_t result = 0xcbf29ce484222325;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		result ^= begin[i];
+		result *= 0x100000001b3;
+	}
+	return result;
+}
+
+/*************************************************************************
+**                                                                      **
+**       Snapshot loader                                                **
+**                                                                      **
+*************************************************************************/
+
+ModelSnapshot::ModelSnapshot(const QString & filename) : file(filename)
+{
+	if (file.open(QIODevice::ReadOnly))
+	{
+		size = file.size();
+		if (size >= qint64(sizeof(Header)))
+		{
+			data = file.map(0, size);
+		}
+		if (data != nullptr)
+		{
+			std::memcpy(&header, data, sizeof(header));
+			intact = index();
+		}
+	}
+}
+
+ModelSnapshot::~ModelSnapshot()
+{
+	if (data != nullptr)
+	{
+		file.unmap(const_cast<uchar *>(data));
+	}
+}
+
+bool ModelSnapshot::index()
+{
+	if ((header.magic != MAGIC) ||
+		(header.version != VERSION) ||
+		(header.byte_order != BYTE_ORDER) ||
+		((header.payload_size % sizeof(uint32_t)) != 0) ||
+		(qint64(sizeof(Header) + header.payload_size) != size))
+	{
+		return false;
+	}
+
+	const uchar * payload = data + sizeof(Header);
+
+	if (checksum(payload, header.payload_size) != header.checksum)
+	{
+		qCWarning(log, "Model snapshot is corrupted.");
+		return false;
+	}
+
+	Cursor it = cursor(payload);
+
+	if (!indexStrings(it))
+	{
+		return false;
+	}
+
+	// Sources
+	source_section = it.position();
+	source_count   = it.next();
+	for (uint32_t s = 0; (s < source_count) && !it.failed(); s++)
+	{
+		if (!isString(it.next()) || !it.skip(4))
+		{
+			return false;
+		}
+	}
+
+	// Model name and shape
+	name_index              = it.next();
+	model_shape.controllers = it.next();
+	model_shape.regions     = it.next();
+	model_shape.sections    = it.next();
+	model_shape.parts       = it.next();
+	if (!isString(name_index))
+	{
+		return false;
+	}
+
+	// XMI elements. An element may only be one level deeper than its
+	// predecessor so the replay always finds its container.
+	uint32_t previous = 0;
+
+	element_section = it.position();
+	element_count   = it.next();
+	for (uint32_t e = 0; (e < element_count) && !it.failed(); e++)
+	{
+		const uint32_t depth      = it.next();
+		const uint32_t node_name  = it.next();
+		const uint64_t attr_words = uint64_t(it.next()) * 2;
+
+		if ((depth == 0) || (depth > (previous + 1)) || !isString(node_name))
+		{
+			return false;
+		}
+		previous = depth;
+
+		for (uint64_t a = 0; (a < attr_words) && !it.failed(); a++)
+		{
+			if (!isString(it.next()))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Resolved link references
+	link_section = it.position();
+	table_count  = it.next();
+	for (uint32_t t = 0; (t < table_count) && !it.failed(); t++)
+	{
+		if (!it.skip(it.next()))
+		{
+			return false;
+		}
+	}
+
+	// Statistics
+	stats_section = it.position();
+	it.skip(9);
+
+	// Positions
+	position_section = it.position();
+	for (int list = 0; list < 3; list++)
+	{
+		const uint32_t count = it.next();
+
+		for (uint32_t p = 0; (p < count) && !it.failed(); p++)
+		{
+			if (!isString(it.next()))
+			{
+				return false;
+			}
+		}
+	}
+
+	return !it.failed() && (it.position() == (data + size));
+}
+
+bool ModelSnapshot::indexStrings(Cursor & it)
+{
+	string_count = it.next();
+	text_size    = it.next();
+	offsets      = it.position();
+
+	if (!it.skip(size_t(string_count) + 1))
+	{
+		return false;
+	}
+
+	// The offsets have to be ascending and inside the text block.
+	uint32_t previous = 0;
+
+	for (size_t s = 0; s <= string_count; s++)
+	{
+		const uint32_t offset = qFromUnaligned<uint32_t>(offsets + s * sizeof(uint32_t));
+
+		if ((offset < previous) || (offset > text_size) || ((s == 0) && (offset != 0)))
+		{
+			return false;
+		}
+		previous = offset;
+	}
+
+	text = it.position();
+	return (previous == text_size) && it.skip((size_t(text_size) + 3) / sizeof(uint32_t));
+}
+
+bool ModelSnapshot::valid(const QStringList & sources) const
+{
+	if (!intact)
+	{
+		return false;
+	}
+
+	if (sourcesUnchanged(sources))
+	{
+		return true;
+	}
+
+	const QByteArray & source_hash = hash(sources);
+
+	if (std::memcmp(header.source_hash, source_hash.constData(), HASH_SIZE) != 0)
+	{
+		qCInfo(log, "Model sources changed since snapshot was written.");
+		return false;
+	}
+	qCInfo(log, "Model sources touched but unchanged since snapshot was written.");
+	return true;
+}
+
+bool ModelSnapshot::sourcesUnchanged(const QStringList & sources) const
+{
+	if (qsizetype(source_count) != sources.size())
+	{
+		return false;
+	}
+
+	Cursor it = cursor(source_section);
+
+	it.skip(1);
+	for (const QString & source : sources)
+	{
+		uint64_t source_size;
+		uint64_t source_mtime;
+
+		sourceInfo(source, source_size, source_mtime);
+
+		const QString  & path     = string(it.next());
+		const uint64_t   size_lo  = it.next();
+		const uint64_t   size_hi  = it.next();
+		const uint64_t   mtime_lo = it.next();
+		const uint64_t   mtime_hi = it.next();
+
+		if ((path != source) ||
+			(((size_hi << 32) | size_lo) != source_size) ||
+			(((mtime_hi << 32) | mtime_lo) != source_mtime))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ModelSnapshot::matches(const ModelRailway & model) const
+{
+	if (!intact)
+	{
+		return false;
+	}
+	if (!model.links_replayed)
+	{
+		qCWarning(log, "Model snapshot link references do not match.");
+		return false;
+	}
+	if (shape(model) != model_shape)
+	{
+		qCWarning(log, "Model snapshot shape does not match.");
+		return false;
+	}
+	return true;
+}
+
+QString ModelSnapshot::modelName() const
+{
+	return string(name_index);
+}
+
+void ModelSnapshot::replay(XmiContainer * root) const
+{
+	if (!intact)
+	{
+		return;
+	}
+
+	Cursor                      it = cursor(element_section);
+	std::vector<XmiContainer *> containers{ root };
+
+	// The stack contains the container of each open element. A nullptr
+	// marks an element whose children are not of interest. The depths
+	// were checked while indexing so the stack never runs empty.
+	it.skip(1);
+	for (uint32_t e = 0; e < element_count; e++)
+	{
+		const uint32_t       depth      = it.next();
+		const QString        name       = string(it.next());
+		const uint32_t       attr_count = it.next();
+		QXmlStreamAttributes attributes;
+
+		attributes.reserve(attr_count);
+		for (uint32_t a = 0; a < attr_count; a++)
+		{
+			const QString key   = string(it.next());
+			const QString value = string(it.next());
+
+			attributes.append(key, value);
+		}
+
+		containers.resize(depth);
+
+		XmiContainer * parent = containers.back();
+
+		containers.push_back(parent != nullptr ?
+			parent->create(XmiElement(name, attributes)) : nullptr);
+	}
+}
+
+void ModelSnapshot::links(std::vector<std::vector<uint32_t>> & tables) const
+{
+	Cursor it = cursor(link_section);
+
+	tables.clear();
+	if (!intact)
+	{
+		return;
+	}
+
+	it.skip(1);
+	tables.resize(table_count);
+	for (std::vector<uint32_t> & table : tables)
+	{
+		table.resize(it.next());
+		for (uint32_t & index : table)
+		{
+			index = it.next();
+		}
+	}
+}
+
+MrwStatistic ModelSnapshot::statistics() const
+{
+	Cursor       it = cursor(stats_section);
+	MrwStatistic result;
+
+	if (intact)
+	{
+		result.region_count       = it.next();
+		result.device_count       = it.next();
+		result.section_count      = it.next();
+		result.switch_count       = it.next();
+		result.signal_count       = it.next();
+		result.main_signal_count  = it.next();
+		result.signal_group_count = it.next();
+		result.warnings           = it.next();
+		result.errors             = it.next();
+	}
+	return result;
+}
+
+void ModelSnapshot::positions(Positions & result) const
+{
+	Cursor it = cursor(position_section);
+
+	result = Positions();
+	if (intact)
+	{
+		strings(it, result.regions);
+		strings(it, result.signal_values);
+		strings(it, result.rail_parts);
+	}
+}
+
+void ModelSnapshot::strings(Cursor & it, std::vector<QString> & values) const
+{
+	values.resize(it.next());
+	for (QString & value : values)
+	{
+		value = string(it.next());
+	}
+}
+
+bool ModelSnapshot::isString(const uint32_t index) const noexcept
+{
+	return index < string_count;
+}
+
+QString ModelSnapshot::string(const uint32_t index) const
+{
+	if (!isString(index))
+	{
+		return "";
+	}
+
+	const uint32_t begin = qFromUnaligned<uint32_t>(offsets + index * sizeof(uint32_t));
+	const uint32_t end   = qFromUnaligned<uint32_t>(offsets + (index + 1) * sizeof(uint32_t));
+
+	return QString::fromUtf8(reinterpret_cast<const char *>(text + begin), end - begin);
+}
+
+ModelSnapshot::Cursor ModelSnapshot::cursor(const uchar * begin) const noexcept
+{
+	return Cursor(begin, data + size);
+}
+
+ModelSnapshot::Cursor::Cursor(const uchar * begin, const uchar * limit) :
+	pos(begin), end(limit)
+{
+}
+
+uint32_t ModelSnapshot::Cursor::next() noexcept
+{
+	if (size_t(end - pos) < sizeof(uint32_t))
+	{
+		pos       = end;
+		is_failed = true;
+		return 0;
+	}
+
+	const uint32_t value = qFromUnaligned<uint32_t>(pos);
+
+	pos += sizeof(uint32_t);
+	return value;
+}
+
+bool ModelSnapshot::Cursor::skip(const size_t words) noexcept
+{
+	const size_t available = size_t(end - pos) / sizeof(uint32_t);
+
+	if (words > available)
+	{
+		pos       = end;
+		is_failed = true;
+	}
+	else
+	{
+		pos += words * sizeof(uint32_t);
+	}
+	return !is_failed;
+}
+
+bool ModelSnapshot::Cursor::failed() const noexcept
+{
+	return is_failed;
+}
+
+const uchar * ModelSnapshot::Cursor::position() const noexcept
+{
+	return pos;
+}
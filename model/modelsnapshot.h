@@ -0,0 +1,318 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_MODELSNAPSHOT_H
+#define MRW_MODEL_MODELSNAPSHOT_H
+
+#include <cinttypes>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+#include <model/xmielement.h>
+
+namespace mrw::model
+{
+	class  ModelRailway;
+	struct MrwStatistic;
+
+	/**
+	 * This class represents a precompiled binary snapshot of a linked
+	 * modelrailway file including the resolved position values. The
+	 * snapshot is written next to the modelrailway file and is memory
+	 * mapped on the next start. So neither the XML file nor the properties
+	 * files have to be parsed again and no link reference has to be
+	 * resolved from its EMF path again.
+	 *
+	 * The snapshot contains a deduplicated string table, the XMI elements
+	 * which created a model element, the resolved link references as
+	 * region, section, part or device indices, the statistics, the shape
+	 * of the model and the position values in model order. While loading
+	 * the model elements are created from the elements and the references
+	 * are rebuilt from the indices. Only the flank switches and the
+	 * RailGraph are computed again since they are derived from the linked
+	 * references.
+	 *
+	 * The snapshot is valid as long as the size and the modification time
+	 * of all source files are unchanged. If they differ the content hash
+	 * of the source files decides. Every offset read from the file is
+	 * bounds checked so a truncated or corrupted snapshot is rejected and
+	 * the caller has to fall back to the XML file.
+	 *
+	 * @see ModelRailway::ModelRailway(const ModelSnapshot &)
+	 */
+	class ModelSnapshot
+	{
+	public:
+		/** The magic number "MRWS" in host byte order. */
+		static constexpr uint32_t MAGIC      = 0x5357524d;
+
+		/** The actual version of the snapshot layout. */
+		static constexpr uint16_t VERSION    = 2;
+
+		/** The marker to detect a snapshot written in foreign byte order. */
+		static constexpr uint16_t BYTE_ORDER = 0x1234;
+
+		/** The size of the used SHA-256 hashes. */
+		static constexpr size_t   HASH_SIZE  = 32;
+
+		/** The index marking an unresolved link reference. */
+		static constexpr uint32_t NONE       = UINT32_MAX;
+
+		/** The file name suffix appended to the modelrailway file name. */
+		static const char    *    SUFFIX;
+
+		/**
+		 * The position values of the model elements in model order. The
+		 * region values are in Region order, the signal values in Region
+		 * order and inside a Region in the order of Region::parts() and
+		 * the rail part values in the order of ModelRailway::parts().
+		 */
+		struct Positions
+		{
+			std::vector<QString> regions;
+			std::vector<QString> signal_values;
+			std::vector<QString> rail_parts;
+		};
+
+		/**
+		 * This class collects the XMI elements and the resolved link
+		 * references while loading a modelrailway file from XML. So a
+		 * snapshot can be written without parsing the XML file again.
+		 *
+		 * @see ModelRailway::ModelRailway(const QString &, const bool, Recorder *)
+		 */
+		class Recorder
+		{
+			friend class ModelRailway;
+			friend class ModelSnapshot;
+
+			struct Element
+			{
+				uint32_t   depth;
+				XmiElement element;
+			};
+
+			std::vector<Element>               elements;
+			std::vector<std::vector<uint32_t>> links;
+
+		public:
+			/**
+			 * This method records an XMI element announced to its
+			 * container.
+			 *
+			 * @param depth The depth of the element below the root element.
+			 * @param element The announced XmiElement.
+			 */
+			void add(const uint32_t depth, const XmiElement & element);
+		};
+
+		/**
+		 * The constructor opens and memory maps the given snapshot file
+		 * and checks its layout. All sections are indexed while checking
+		 * so reading them later is cheap.
+		 *
+		 * @param filename The file name of the snapshot.
+		 * @see valid()
+		 */
+		explicit ModelSnapshot(const QString & filename);
+		ModelSnapshot() = delete;
+		ModelSnapshot(const ModelSnapshot & other) = delete;
+		ModelSnapshot & operator=(const ModelSnapshot & other) = delete;
+
+		/**
+		 * The destructor unmaps the snapshot file.
+		 */
+		virtual ~ModelSnapshot();
+
+		/**
+		 * This method verifies that the mapped snapshot has the correct
+		 * magic number, version and byte order, the payload is not
+		 * corrupted and all given source files are unchanged since the
+		 * snapshot was written. The source files are compared by size and
+		 * modification time. Only if these differ the source files are
+		 * hashed.
+		 *
+		 * @param sources The source files the snapshot was written from.
+		 * @return True if the snapshot is usable.
+		 */
+		[[nodiscard]]
+		bool valid(const QStringList & sources) const;
+
+		/**
+		 * This method verifies that the given ModelRailway created from
+		 * this snapshot has the same shape as the model the snapshot was
+		 * written from and all link references were rebuilt from the
+		 * stored indices.
+		 *
+		 * @param model The ModelRailway loaded from this snapshot.
+		 * @return True if the model matches the snapshot.
+		 */
+		[[nodiscard]]
+		bool matches(const ModelRailway & model) const;
+
+		/**
+		 * This method returns the name of the stored modelrailway.
+		 *
+		 * @return The model railway name.
+		 */
+		[[nodiscard]]
+		QString modelName() const;
+
+		/**
+		 * This method announces all stored XMI elements to the given root
+		 * container in the same way the loaders of the ModelRailway do.
+		 *
+		 * @param root The root XmiContainer which is the ModelRailway.
+		 */
+		void replay(XmiContainer * root) const;
+
+		/**
+		 * This method returns the resolved link references of each link
+		 * task.
+		 *
+		 * @param tables The link references per link task to fill.
+		 */
+		void links(std::vector<std::vector<uint32_t>> & tables) const;
+
+		/**
+		 * This method returns the statistics of the model the snapshot
+		 * was written from.
+		 *
+		 * @return The stored statistics.
+		 */
+		[[nodiscard]]
+		MrwStatistic statistics() const;
+
+		/**
+		 * This method returns the stored position values.
+		 *
+		 * @param positions The Positions to fill.
+		 */
+		void positions(Positions & positions) const;
+
+		/**
+		 * This method writes the given linked ModelRailway into a binary
+		 * snapshot file.
+		 *
+		 * @param filename The file name of the snapshot to write.
+		 * @param sources All source files which make up the snapshot.
+		 * @param model The ModelRailway loaded using the given Recorder.
+		 * @param recorder The Recorder filled while loading the model.
+		 * @param positions The position values in model order.
+		 * @return True on success.
+		 */
+		static bool write(
+			const QString      & filename,
+			const QStringList  & sources,
+			const ModelRailway & model,
+			const Recorder     & recorder,
+			const Positions    & positions);
+
+		/**
+		 * This method returns the snapshot file name belonging to the
+		 * given modelrailway file name.
+		 *
+		 * @param model_filename The modelrailway file name.
+		 * @return The snapshot file name.
+		 */
+		static QString filename(const QString & model_filename);
+
+		/**
+		 * This method computes a hash over the names and the contents of
+		 * all given source files.
+		 *
+		 * @param sources The source files to hash.
+		 * @return The SHA-256 hash.
+		 */
+		static QByteArray hash(const QStringList & sources);
+
+	private:
+		struct Header
+		{
+			uint32_t magic;
+			uint16_t version;
+			uint16_t byte_order;
+			uint32_t payload_size;
+			uint32_t reserved;
+			uint64_t checksum;
+			char     source_hash[HASH_SIZE];
+		};
+
+		/**
+		 * The counts of the model elements the snapshot was written from.
+		 */
+		struct Shape
+		{
+			uint32_t controllers = 0;
+			uint32_t regions     = 0;
+			uint32_t sections    = 0;
+			uint32_t parts       = 0;
+
+			bool operator==(const Shape & other) const noexcept = default;
+		};
+
+		/**
+		 * This class reads 32 bit words from the mapped payload. Reading
+		 * beyond the given limit results in zero values and marks the
+		 * Cursor as failed.
+		 */
+		class Cursor
+		{
+			const uchar * pos;
+			const uchar * end;
+			bool          is_failed = false;
+
+		public:
+			explicit Cursor(const uchar * begin, const uchar * limit);
+
+			uint32_t      next() noexcept;
+			bool          skip(const size_t words) noexcept;
+			bool          failed() const noexcept;
+			const uchar * position() const noexcept;
+		};
+
+		QFile         file;
+		const uchar * data    = nullptr;
+		qint64        size    = 0;
+		Header        header  = {};
+		bool          intact  = false;
+
+		uint32_t      string_count = 0;
+		const uchar * offsets      = nullptr;
+		const uchar * text         = nullptr;
+		uint32_t      text_size    = 0;
+
+		const uchar * source_section   = nullptr;
+		const uchar * element_section  = nullptr;
+		const uchar * link_section     = nullptr;
+		const uchar * stats_section    = nullptr;
+		const uchar * position_section = nullptr;
+
+		uint32_t      source_count  = 0;
+		uint32_t      element_count = 0;
+		uint32_t      table_count   = 0;
+		uint32_t      name_index    = NONE;
+		Shape         model_shape;
+
+		bool          index();
+		bool          indexStrings(Cursor & it);
+		bool          isString(const uint32_t index) const noexcept;
+		bool          sourcesUnchanged(const QStringList & sources) const;
+		QString       string(const uint32_t index) const;
+		Cursor        cursor(const uchar * begin) const noexcept;
+		void          strings(Cursor & it, std::vector<QString> & values) const;
+
+		static Shape    shape(const ModelRailway & model);
+		static uint64_t checksum(const uchar * begin, const size_t length) noexcept;
+	};
+}
+
+#endif
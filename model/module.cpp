@@ -13,7 +13,7 @@ using namespace mrw::model;
 
 Module::Module(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	module_id(ModelRailway::value(element, "nummer")),
 	model(model_railway),
 	reference(element)
@@ -11,9 +11,8 @@
 #include <cinttypes>
 #include <vector>
 
-#include <QDomElement>
-
 #include <can/mrwmessage.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -45,10 +44,11 @@ namespace mrw::model
 		ModelRailway    *   model = nullptr;
 
 		/**
-		 * The XML-DOM element representing this instance. It contains the
-		 * path top down to another element to be resolved.
+		 * The XMI element representing this instance. It contains the
+		 * path top down to another element to be resolved. It is cleared
+		 * after linking.
 		 */
-		const QDomElement   reference;
+		XmiElement          reference;
 
 	public:
 		/** The maximum pins per port. */
@@ -56,7 +56,7 @@ namespace mrw::model
 
 		explicit Module(
 			ModelRailway    *   model_railway,
-			const QDomElement & element);
+			const XmiElement  & element);
 		virtual ~Module() = default;
 
 		/**
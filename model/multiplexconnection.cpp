@@ -17,41 +17,35 @@ using namespace mrw::model;
 MultiplexConnection::MultiplexConnection(
 	ModelRailway     *    model_railway,
 	Controller      *     controller,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	model(model_railway),
+	mux_controller(controller),
 	reference(element),
 	connection_id(ModelRailway::value(element, "nummer"))
 {
-	const QDomNodeList & child_nodes = element.childNodes();
+}
+
+XmiContainer * MultiplexConnection::create(const XmiElement & child)
+{
+	const QString & node_name = child.nodeName();
 
-	simple_light_vector.reserve(child_nodes.count());
-	for (int n = 0; n < child_nodes.count(); ++n)
+	if (node_name == "lichter")
 	{
-		const QDomNode & node = child_nodes.at(n);
+		Light * light = new Light(model, mux_controller, child);
 
-		if (node.isElement())
-		{
-			const QDomElement & child     = node.toElement();
-			const QString   &   node_name = child.nodeName();
-
-			if (node_name == "lichter")
-			{
-				Light * light = new Light(model, controller, child);
-
-				simple_light_vector.push_back(light);
-			}
-			else if (node_name == "crossing")
-			{
-				Crossing * crossing = new Crossing(model, controller, child);
-
-				crossing_vector.push_back(crossing);
-			}
-			else
-			{
-				model->error("Unknown multiplex element: " + node_name);
-			}
-		}
+		simple_light_vector.push_back(light);
+	}
+	else if (node_name == "crossing")
+	{
+		Crossing * crossing = new Crossing(model, mux_controller, child);
+
+		crossing_vector.push_back(crossing);
+	}
+	else
+	{
+		model->error("Unknown multiplex element: " + node_name);
 	}
+	return nullptr;
 }
 
 bool MultiplexConnection::valid() const
@@ -30,13 +30,14 @@ namespace mrw::model
 	 * @see LightSignal
 	 * @see Light
 	 */
-	class MultiplexConnection
+	class MultiplexConnection : public XmiContainer
 	{
 		friend class Controller;
 
-		ModelRailway           *          model = nullptr;
+		ModelRailway           *          model          = nullptr;
+		Controller           *            mux_controller = nullptr;
 
-		const QDomElement                 reference;
+		XmiElement                        reference;
 		const ModuleId                    connection_id;
 
 		std::vector<LightSignal *>        light_signal_vector;
@@ -50,7 +51,7 @@ namespace mrw::model
 		explicit MultiplexConnection(
 			ModelRailway     *    model_railway,
 			Controller      *     controller,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~MultiplexConnection() = default;
 
 		/**
@@ -97,6 +98,8 @@ namespace mrw::model
 		const std::vector<Crossing *> & crossings() const;
 
 	private:
+		XmiContainer * create(const XmiElement & child) override;
+
 		void link();
 		void configure(
 			std::vector<mrw::can::MrwMessage> & messages,
@@ -0,0 +1,68 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include "model/partregistry.h"
+#include "model/assemblypart.h"
+#include "model/rail.h"
+#include "model/regularswitch.h"
+#include "model/doublecrossswitch.h"
+#include "model/lightsignal.h"
+#include "model/formsignal.h"
+
+using namespace mrw::model;
+
+void PartRegistry::add(AssemblyPart * part)
+{
+	if (part == nullptr)
+	{
+		return;
+	}
+
+	std::apply([part](auto & ... vectors)
+	{
+		([part](auto & vector)
+		{
+			using T = typename std::remove_reference_t<decltype(vector)>::value_type;
+
+			T element = dynamic_cast<T>(part);
+
+			if (element != nullptr)
+			{
+				vector.push_back(element);
+			}
+		}(vectors), ...);
+	}, registry);
+}
+
+void PartRegistry::add(const PartRegistry & other)
+{
+	std::apply([&other](auto & ... vectors)
+	{
+		([&other](auto & vector)
+		{
+			using V = std::remove_reference_t<decltype(vector)>;
+
+			const V & source = std::get<V>(other.registry);
+
+			vector.insert(vector.end(), source.begin(), source.end());
+		}(vectors), ...);
+	}, registry);
+}
+
+void PartRegistry::clear() noexcept
+{
+	std::apply([](auto & ... vectors)
+	{
+		(vectors.clear(), ...);
+	}, registry);
+}
+
+void PartRegistry::shrink()
+{
+	std::apply([](auto & ... vectors)
+	{
+		(vectors.shrink_to_fit(), ...);
+	}, registry);
+}
@@ -0,0 +1,133 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_PARTREGISTRY_H
+#define MRW_MODEL_PARTREGISTRY_H
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace mrw::model
+{
+	class AssemblyPart;
+	class RailPart;
+	class Rail;
+	class AbstractSwitch;
+	class RegularSwitch;
+	class DoubleCrossSwitch;
+	class Signal;
+	class LightSignal;
+	class FormSignal;
+	class Device;
+	class Position;
+
+	/**
+	 * This class holds one contiguous vector per frequently queried
+	 * AssemblyPart type. The vectors are filled once after linking so
+	 * type queries do not need to dynamic_cast every AssemblyPart again.
+	 * Each vector keeps the insertion order of the AssemblyPart elements
+	 * and contains the already casted pointers. So multiple inherited
+	 * interfaces like Device or Position are ready to use.
+	 *
+	 * Types not registered here have to be looked up using a
+	 * dynamic_cast scan. Use the contains constant to decide at compile
+	 * time.
+	 */
+	class PartRegistry
+	{
+		template <class ... T> using Vectors = std::tuple<std::vector<T *>...>;
+
+		using Registry = Vectors<
+			AssemblyPart,
+			RailPart, Rail,
+			AbstractSwitch, RegularSwitch, DoubleCrossSwitch,
+			Signal, LightSignal, FormSignal,
+			Device, Position>;
+
+		template <class T, class R> struct Contains;
+
+		template <class T, class ... U>
+		struct Contains<T, std::tuple<std::vector<U *>...>> :
+			std::disjunction<std::is_same<T, U>...>
+		{
+		};
+
+		Registry registry;
+
+	public:
+		/**
+		 * This constant is true if the type T has its own vector.
+		 */
+		template <class T>
+		static constexpr bool contains = Contains<std::remove_cv_t<T>, Registry>::value;
+
+		/**
+		 * This method returns all registered elements of type T.
+		 *
+		 * @return The vector of all registered elements of type T.
+		 */
+		template <class T>
+		[[nodiscard]]
+		const std::vector<T *> & get() const noexcept
+		{
+			static_assert(contains<T>, "Type is not registered.");
+
+			return std::get<std::vector<T *>>(registry);
+		}
+
+		/**
+		 * This method appends all registered elements of type T into the
+		 * given result vector for which the guard returns true.
+		 *
+		 * @param result The result vector collecting the elements of type T.
+		 * @param guard Any invocable accepting a pointer to T and returning
+		 * a bool convertible value.
+		 */
+		template <class T, class G>
+		void collect(std::vector<T *> & result, G && guard) const
+		{
+			for (T * element : get<T>())
+			{
+				if (std::invoke(guard, element))
+				{
+					result.push_back(element);
+				}
+			}
+		}
+
+		/**
+		 * This method registers the given AssemblyPart into all vectors
+		 * of matching types.
+		 *
+		 * @param part The AssemblyPart to register.
+		 */
+		void add(AssemblyPart * part);
+
+		/**
+		 * This method appends all registered elements of the given other
+		 * PartRegistry. It is used to aggregate the Section registries
+		 * into the Region and ModelRailway registries.
+		 *
+		 * @param other The other PartRegistry to append.
+		 */
+		void add(const PartRegistry & other);
+
+		/**
+		 * This method removes all registered elements.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * This method releases unused capacity after registration.
+		 */
+		void shrink();
+	};
+}
+
+#endif
@@ -13,7 +13,7 @@ using namespace mrw::model;
 ProfileLight::ProfileLight(
 	ModelRailway     *    model_railway,
 	Controller      *     controller,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	Light(model_railway, controller, element),
 	light_profile(ModelRailway::value(element, "typ"))
 {
@@ -31,7 +31,7 @@ namespace mrw::model
 		explicit ProfileLight(
 			ModelRailway     *    model_railway,
 			Controller      *     controller,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		uint8_t profile() const;
 
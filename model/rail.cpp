@@ -11,7 +11,7 @@ using namespace mrw::model;
 Rail::Rail(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	RailPart(model_railway, model_section, element),
 	is_main(  ModelRailway::boolean(element, "istHauptgleis")),
 	is_curve(ModelRailway::boolean(element, "istAbzweig"))
@@ -52,7 +52,7 @@ namespace mrw::model
 		explicit Rail(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		bool        valid()    const noexcept override;
 		bool        isCurved() const noexcept override;
@@ -0,0 +1,125 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include "model/railgraph.h"
+#include "model/railpart.h"
+
+using namespace mrw::model;
+
+void RailGraph::build(const std::vector<RailPart *> & parts)
+{
+	clear();
+
+	index_map.reserve(parts.size());
+	for (std::uint32_t i = 0; i < parts.size(); i++)
+	{
+		index_map.emplace(parts[i], i);
+	}
+	row_words = (parts.size() + WORD_BITS - 1) / WORD_BITS;
+
+	for (const bool dir : { false, true })
+	{
+		Adjacency & adjacency = graph[dir];
+
+		adjacency.offsets.reserve(parts.size() + 1);
+		adjacency.offsets.push_back(0);
+		for (const RailPart * part : parts)
+		{
+			for (const RailInfo & info : part->advance(dir))
+			{
+				auto it = index_map.find(static_cast<const RailPart *>(info));
+
+				if (it != index_map.end())
+				{
+					adjacency.successors.push_back(it->second);
+				}
+			}
+			adjacency.offsets.push_back(adjacency.successors.size());
+		}
+		adjacency.successors.shrink_to_fit();
+		closure(adjacency);
+	}
+}
+
+void RailGraph::closure(Adjacency & adjacency) const
+{
+	const std::uint32_t        count = adjacency.offsets.size() - 1;
+	std::vector<std::uint32_t> stack;
+
+	adjacency.reach.assign(count * row_words, 0);
+	stack.reserve(count);
+
+	// The reach row of each start node doubles as visited set of its
+	// depth first search.
+	for (std::uint32_t start = 0; start < count; start++)
+	{
+		Word * row = &adjacency.reach[start * row_words];
+
+		stack.push_back(start);
+		while (!stack.empty())
+		{
+			const std::uint32_t node = stack.back();
+
+			stack.pop_back();
+			for (std::uint32_t e = adjacency.offsets[node]; e < adjacency.offsets[node + 1]; e++)
+			{
+				const std::uint32_t succ = adjacency.successors[e];
+				const Word          bit  = Word(1) << (succ % WORD_BITS);
+
+				if ((row[succ / WORD_BITS] & bit) == 0)
+				{
+					row[succ / WORD_BITS] |= bit;
+					stack.push_back(succ);
+				}
+			}
+		}
+	}
+}
+
+bool RailGraph::contains(const RailPart * part) const noexcept
+{
+	return index_map.find(part) != index_map.end();
+}
+
+bool RailGraph::reachable(
+	const RailPart * from,
+	const RailPart * to,
+	const bool       dir) const noexcept
+{
+	auto from_it = index_map.find(from);
+	auto to_it   = index_map.find(to);
+
+	if ((from_it == index_map.end()) || (to_it == index_map.end()))
+	{
+		return false;
+	}
+
+	const Word * row = &graph[dir].reach[from_it->second * row_words];
+	const size_t col = to_it->second;
+
+	return (row[col / WORD_BITS] & (Word(1) << (col % WORD_BITS))) != 0;
+}
+
+size_t RailGraph::size() const noexcept
+{
+	return index_map.size();
+}
+
+size_t RailGraph::edgeCount(const bool dir) const noexcept
+{
+	return graph[dir].successors.size();
+}
+
+void RailGraph::clear() noexcept
+{
+	index_map.clear();
+	row_words = 0;
+	for (Adjacency & adjacency : graph)
+	{
+		adjacency.offsets.clear();
+		adjacency.successors.clear();
+		adjacency.reach.clear();
+	}
+}
@@ -0,0 +1,122 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_RAILGRAPH_H
+#define MRW_MODEL_RAILGRAPH_H
+
+#include <cinttypes>
+#include <unordered_map>
+#include <vector>
+
+namespace mrw::model
+{
+	class RailPart;
+
+	/**
+	 * This class contains the static topology of all RailPart elements of
+	 * a ModelRailway. It is computed once after linking and never changes
+	 * afterwards since the connectors of a RailPart are fixed.
+	 *
+	 * For each counting direction the successors given by
+	 * RailPart::advance() are stored as a compact adjacency list (CSR
+	 * format) indexed by a dense RailPart number. Based on that the
+	 * transitive closure is stored as one bit row per RailPart. So the
+	 * question whether a target RailPart can be reached at all from a
+	 * given RailPart is answered by a single bit test.
+	 *
+	 * The reachability ignores all dynamic conditions like reservation,
+	 * occupation or lock state. So a negative answer is definitive whereas
+	 * a positive answer still needs the Route search to find a usable
+	 * track. A next hop table is not stored since a successor is on a
+	 * possible track to the target exactly if it is the target itself or
+	 * the target is reachable from it.
+	 *
+	 * @see Route::append()
+	 */
+	class RailGraph
+	{
+		using Word = std::uint64_t;
+
+		static constexpr size_t WORD_BITS = sizeof(Word) * 8;
+
+		struct Adjacency
+		{
+			std::vector<std::uint32_t> offsets;
+			std::vector<std::uint32_t> successors;
+			std::vector<Word>          reach;
+		};
+
+		std::unordered_map<const RailPart *, std::uint32_t> index_map;
+		size_t                                               row_words = 0;
+		Adjacency                                            graph[2];
+
+	public:
+		/**
+		 * This method (re-)computes the adjacency and the reachability of
+		 * the given RailPart elements in both counting directions.
+		 * Successors not contained in the given collection are ignored.
+		 *
+		 * @param parts All RailPart elements of the ModelRailway.
+		 */
+		void build(const std::vector<RailPart *> & parts);
+
+		/**
+		 * This method returns true if the given RailPart is known by this
+		 * RailGraph.
+		 *
+		 * @param part The RailPart to look up.
+		 * @return True if the RailPart has an index.
+		 */
+		[[nodiscard]]
+		bool contains(const RailPart * part) const noexcept;
+
+		/**
+		 * This method returns true if the target RailPart can be reached
+		 * from the given start RailPart by following the connectors in
+		 * the given counting direction using at least one step. Unknown
+		 * RailPart elements are never reachable.
+		 *
+		 * @param from The start RailPart.
+		 * @param to The target RailPart.
+		 * @param dir The counting direction to follow.
+		 * @return True if a static path exists.
+		 */
+		[[nodiscard]]
+		bool reachable(
+			const RailPart * from,
+			const RailPart * to,
+			const bool       dir) const noexcept;
+
+		/**
+		 * This method returns the amount of known RailPart elements.
+		 *
+		 * @return The RailPart count.
+		 */
+		[[nodiscard]]
+		size_t size() const noexcept;
+
+		/**
+		 * This method returns the amount of connector edges in the given
+		 * counting direction.
+		 *
+		 * @param dir The counting direction.
+		 * @return The edge count.
+		 */
+		[[nodiscard]]
+		size_t edgeCount(const bool dir) const noexcept;
+
+		/**
+		 * This method removes all computed data.
+		 */
+		void clear() noexcept;
+
+	private:
+		void closure(Adjacency & adjacency) const;
+	};
+}
+
+#endif
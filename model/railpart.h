@@ -9,14 +9,13 @@
 #define MRW_MODEL_RAILPART_H
 
 #include <cstdint>
-#include <regex>
 #include <set>
 
-#include <QDomElement>
 #include <QPoint>
 
 #include <model/assemblypart.h>
 #include <model/position.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -93,9 +92,6 @@ namespace mrw::model
 	 */
 	class RailPart : public AssemblyPart, public Position
 	{
-		static const std::regex path_regex;
-
-
 	protected:
 		/** All connectors in counting direction. */
 		std::set<RailInfo>      rail_forward;
@@ -116,7 +112,7 @@ namespace mrw::model
 		explicit RailPart(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~RailPart() = default;
 
 		/**
@@ -13,34 +13,28 @@ using namespace mrw::model;
 
 Region::Region(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element,
+	const XmiElement   &  element,
 	const bool            station) :
 	model(model_railway),
 	region_name(element.attribute("name")),
 	is_station(station)
 {
-	const QDomNodeList & child_nodes = element.childNodes();
+}
 
-	for (int n = 0; n < child_nodes.count(); ++n)
+XmiContainer * Region::create(const XmiElement & child)
+{
+	if (child.nodeName() == "abschnitt")
+	{
+		Section * section = new Section(model, this, child);
+
+		add(section);
+		return section;
+	}
+	else
 	{
-		const QDomNode & node = child_nodes.at(n);
-
-		if (node.isElement())
-		{
-			const QDomElement & child = node.toElement();
-
-			if (node.nodeName() == "abschnitt")
-			{
-				Section * section = new Section(model, this, child);
-
-				add(section);
-			}
-			else
-			{
-				model->error("Unknown group region element: " + node.nodeName());
-			}
-		}
+		model->error("Unknown group region element: " + child.nodeName());
 	}
+	return nullptr;
 }
 
 Section * Region::section(const size_t index) const
@@ -75,10 +69,13 @@ void Region::add(Section * section) noexcept
 
 void Region::link() noexcept
 {
+	part_registry.clear();
 	for (Section * section : sections)
 	{
 		section->link();
+		part_registry.add(section->part_registry);
 	}
+	part_registry.shrink();
 }
 
 QString Region::toString() const noexcept
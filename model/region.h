@@ -8,9 +8,9 @@
 #ifndef MRW_MODEL_REGION_H
 #define MRW_MODEL_REGION_H
 
-#include <QDomElement>
-
 #include <model/section.h>
+#include <model/partregistry.h>
+#include <model/xmielement.h>
 #include <util/cleanvector.h>
 #include <util/method.h>
 #include <util/stringutil.h>
@@ -26,13 +26,14 @@ namespace mrw::model
 	 * outside rail region. You can use station region for shunting inside
 	 * whereas on the free rail region no shunting is allowed.
 	 */
-	class Region : public mrw::util::String
+	class Region : public XmiContainer, public mrw::util::String
 	{
 		friend class ModelRailway;
 
 		ModelRailway          *          model = nullptr;
 		const QString                    region_name;
 		mrw::util::CleanVector<Section>  sections;
+		PartRegistry                     part_registry;
 		const bool                       is_station;
 		bool                             direction_view = true;
 
@@ -40,7 +41,7 @@ namespace mrw::model
 	public:
 		explicit Region(
 			ModelRailway     *    model_railway,
-			const QDomElement  &  element,
+			const XmiElement   &  element,
 			const bool            station);
 		virtual ~Region() = default;
 
@@ -105,16 +106,25 @@ namespace mrw::model
 		 *
 		 * @param result The result vector collecting the AssembyPart elements
 		 * of type T.
-		 * @param guard A lamda to fine select if the type T should added to
-		 * the result vector.
+		 * @param guard Any invocable to fine select if the type T should
+		 * added to the result vector.
+		 * @see Section::parts()
 		 */
-		template <class T> constexpr void parts(
-			std::vector<T *>          &         result,
-			std::function<bool(const T * part)> guard = &mrw::util::Method::always<T>) noexcept
+		template <class T, class G = decltype(&mrw::util::Method::always<T>)>
+		constexpr void parts(
+			std::vector<T *> & result,
+			G                  guard = &mrw::util::Method::always<T>) const noexcept
 		{
-			for (Section * sub : sections)
+			if constexpr (PartRegistry::contains<T>)
+			{
+				part_registry.collect(result, guard);
+			}
+			else
 			{
-				sub->parts<T>(result, guard);
+				for (Section * sub : sections)
+				{
+					sub->parts<T>(result, guard);
+				}
 			}
 		}
 
@@ -129,6 +139,8 @@ namespace mrw::model
 		QString toString() const noexcept override;
 
 	private:
+		XmiContainer * create(const XmiElement & child) override;
+
 		void add(Section * section) noexcept;
 		void link() noexcept;
 	};
@@ -24,7 +24,7 @@ const ConstantEnumerator<State>  RegularSwitch::state_map
 RegularSwitch::RegularSwitch(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	AbstractSwitch(model_railway, model_section, element),
 	left_branch( ModelRailway::boolean(element, "bIstAbzweig", false)),
 	right_branch(ModelRailway::boolean(element, "cIstAbzweig", false)),
@@ -124,6 +124,20 @@ bool RegularSwitch::isSwitchable(
 	return (lock() == LockState::UNLOCKED) || (state == switch_state);
 }
 
+bool RegularSwitch::needsTurn(
+	const RailPart * prev,
+	const RailPart * succ) const noexcept
+{
+	return computeState(prev, succ) != switch_state;
+}
+
+bool RegularSwitch::isCurvedLeg(
+	const RailPart * prev,
+	const RailPart * succ) const noexcept
+{
+	return right_branch == (computeState(prev, succ) == State::AC);
+}
+
 bool RegularSwitch::setState(
 	const RailPart * prev,
 	const RailPart * succ)
@@ -69,7 +69,7 @@ namespace mrw::model
 		explicit RegularSwitch(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		bool isCurved() const noexcept override;
 
@@ -102,6 +102,16 @@ namespace mrw::model
 			const RailPart * prev,
 			const RailPart * succ) const noexcept override;
 
+		[[nodiscard]]
+		bool needsTurn(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept override;
+
+		[[nodiscard]]
+		bool isCurvedLeg(
+			const RailPart * prev,
+			const RailPart * succ) const noexcept override;
+
 		/**
 		 * This method computes the RegularSwitch::State value depending on the
 		 * given neighbour RaiPart pointers. The RailPart pointer are
@@ -3,7 +3,15 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+
 #include <util/method.h>
+#include <model/modelrailway.h>
 #include <model/rail.h>
 #include <model/abstractswitch.h>
 #include <model/regularswitch.h>
@@ -13,6 +21,81 @@ using namespace mrw::model;
 
 using LockState = Device::LockState;
 
+namespace
+{
+	/**
+	 * The search state of the planner: The previous and the actual
+	 * RailPart.
+	 */
+	using Hop = std::pair<RailPart *, RailPart *>;
+
+	struct HopHash
+	{
+		size_t operator()(const Hop & hop) const noexcept
+		{
+			const std::hash<const RailPart *> hasher;
+
+			return hasher(hop.first) * 31 + hasher(hop.second);
+		}
+	};
+
+	struct Visit
+	{
+		unsigned cost;
+		size_t   depth;
+		Hop      parent;
+		bool     closed = false;
+	};
+
+	struct Candidate
+	{
+		unsigned estimate;
+		unsigned cost;
+		Hop      hop;
+
+		bool operator>(const Candidate & other) const noexcept
+		{
+			return estimate > other.estimate;
+		}
+	};
+
+	/**
+	 * The memory of the planner containers shared by all Route instances
+	 * of a thread. The buffer grows to the size needed by the largest
+	 * layout up to Route::SCRATCH_LIMIT and is never value initialized. Each search releases the
+	 * memory of the previous one. If a search nevertheless exceeds the
+	 * buffer the monotonic resource falls back to the heap until the next
+	 * search releases it.
+	 */
+	class PlannerArena
+	{
+		std::unique_ptr<std::byte[]>                       buffer;
+		size_t                                             capacity = 0;
+		std::optional<std::pmr::monotonic_buffer_resource> resource;
+
+	public:
+		std::pmr::memory_resource * acquire(const size_t needed)
+		{
+			if (capacity < needed)
+			{
+				resource.reset();
+				buffer   = std::make_unique_for_overwrite<std::byte[]>(needed);
+				capacity = needed;
+				resource.emplace(buffer.get(), capacity);
+			}
+			else
+			{
+				// All containers of a previous search are gone so its
+				// memory may be reused.
+				resource->release();
+			}
+			return &*resource;
+		}
+	};
+
+	thread_local PlannerArena planner_arena;
+}
+
 Route::Route(
 	const bool         dir,
 	const SectionState wanted_state,
@@ -78,8 +161,16 @@ bool Route::append(RailPart * target)
 
 	last_valid_part    = track.back();
 
+	if (!leadsTo(last_valid_part, target))
+	{
+		qCInfo(log).noquote() << "## Target not reachable.";
+		return false;
+	}
+
 	Region * search_region = findSearchRegion(target);
-	bool     success       = append(last_valid_part, target, search_region);
+	bool     success       =
+		plan(last_valid_part, target, search_region) ||
+		append(last_valid_part, target, search_region);
 
 	if (success)
 	{
@@ -110,6 +201,19 @@ Region * Route::findSearchRegion(const RailPart * target) const
 }
 
 bool Route::append(RailPart * rail, RailPart * target, Region * search_region)
+{
+	path.clear();
+	if (!search(rail, target, search_region))
+	{
+		return false;
+	}
+
+	track.insert(track.end(), path.begin(), path.end());
+	path.clear();
+	return true;
+}
+
+bool Route::search(RailPart * rail, RailPart * target, Region * search_region)
 {
 	if (rail == target)
 	{
@@ -121,22 +225,30 @@ bool Route::append(RailPart * rail, RailPart * target, Region * search_region)
 	{
 		RailPart * next = info;
 
-		if (qualified(next, search_region))
+		if (!leadsTo(next, target))
 		{
+			continue;
+		}
+
+		if (qualified(next, search_region) && path.push(next))
+		{
+			const size_t depth = path.size();
+
 			next->reserve();
-			track.push_back(next);
-			if (append(next, target, search_region))
+			if (search(next, target, search_region))
 			{
-				if (hasFlankProtection(rail, next))
+				const RailPart * succ = depth < path.size() ? path[depth] : nullptr;
+
+				if (hasFlankProtection(rail, next, succ))
 				{
 					return true;
 				}
 				else
 				{
-					unreserveTail(next);
+					unwind(depth);
 				}
 			}
-			track.remove(next);
+			path.pop();
 			next->reserve(false);
 		}
 	}
@@ -144,39 +256,197 @@ bool Route::append(RailPart * rail, RailPart * target, Region * search_region)
 	return false;
 }
 
+void Route::unwind(const size_t depth) noexcept
+{
+	while (path.size() > depth)
+	{
+		path.back()->reserve(false);
+		path.pop();
+	}
+}
+
+bool Route::leadsTo(
+	const RailPart * rail,
+	const RailPart * target) const noexcept
+{
+	if (rail == target)
+	{
+		return true;
+	}
+
+	const ModelRailway * model = rail->model();
+
+	if (model == nullptr)
+	{
+		return true;
+	}
+
+	const RailGraph & graph = model->railGraph();
+
+	// Parts unknown to the graph cannot be judged so do not prune them.
+	return
+		!graph.contains(rail) ||
+		!graph.contains(target) ||
+		graph.reachable(rail, target, direction);
+}
+
+bool Route::plan(RailPart * rail, RailPart * target, Region * search_region)
+{
+	if ((cost_model == nullptr) || (rail == target))
+	{
+		return false;
+	}
+
+	using Visits = std::pmr::unordered_map<Hop, Visit, HopHash>;
+	using Queue  = std::priority_queue<Candidate, std::pmr::vector<Candidate>, std::greater<Candidate>>;
+
+	const ModelRailway * model  = rail->model();
+	const size_t         parts  = model != nullptr ? model->railGraph().size() : 0;
+	const size_t         needed = std::clamp(parts * SCRATCH_PER_PART, SCRATCH_SIZE, SCRATCH_LIMIT);
+
+	std::pmr::memory_resource * scratch = planner_arena.acquire(needed);
+
+	RailPart  * prev = track.size() > 1 ? *std::next(track.rbegin()) : nullptr;
+	const Hop   start(track.back() == rail ? prev : nullptr, rail);
+	Visits      visits(scratch);
+	Queue       queue(std::greater<Candidate>(), std::pmr::vector<Candidate>(scratch));
+
+	visits.emplace(start, Visit{0, 0, start});
+	queue.push(Candidate{cost_model->estimate(rail, target), 0, start});
+
+	while (!queue.empty())
+	{
+		const Candidate candidate = queue.top();
+		Visit     &     visit     = visits.at(candidate.hop);
+
+		queue.pop();
+		if (visit.closed || (candidate.cost != visit.cost))
+		{
+			// Outdated queue entry.
+			continue;
+		}
+		visit.closed = true;
+
+		auto [from, actual] = candidate.hop;
+
+		if (actual == target)
+		{
+			std::pmr::vector<RailPart *> reverse(scratch);
+
+			for (Hop hop = candidate.hop; hop.second != rail; hop = visits.at(hop).parent)
+			{
+				reverse.push_back(hop.second);
+			}
+
+			path.clear();
+			for (auto part = reverse.rbegin(); part != reverse.rend(); ++part)
+			{
+				// The search state allows passing a RailPart twice which a
+				// Route must not do. Leave this rare case to the depth first
+				// search.
+				if ((*part)->reserved() || !path.push(*part))
+				{
+					qCDebug(log).noquote() << "      Planned track is not unique.";
+					unwind(0);
+					return false;
+				}
+				(*part)->reserve();
+			}
+
+			const RailPart * previous = rail;
+
+			for (size_t i = 0; i < path.size(); i++)
+			{
+				const RailPart * succ = (i + 1) < path.size() ? path[i + 1] : nullptr;
+
+				if (!hasFlankProtection(previous, path[i], succ))
+				{
+					unwind(0);
+					return false;
+				}
+				previous = path[i];
+			}
+
+			track.insert(track.end(), path.begin(), path.end());
+			path.clear();
+			qCDebug(log).noquote() << "      Planned track costs:" << visit.cost;
+			return true;
+		}
+
+		if ((track.size() + visit.depth) > MAX_DEPTH)
+		{
+			continue;
+		}
+
+		for (const RailInfo & info : actual->advance(direction))
+		{
+			RailPart * next = info;
+
+			if (!leadsTo(next, target) || !qualified(next, search_region))
+			{
+				continue;
+			}
+
+			const unsigned step = cost_model->cost(from, actual, next);
+
+			if (step == RouteCost::IMPASSABLE)
+			{
+				continue;
+			}
+
+			const Hop      hop(actual, next);
+			const unsigned cost = visit.cost + step;
+			const Visit    successor{cost, visit.depth + 1, candidate.hop};
+			auto [entry, inserted] = visits.try_emplace(hop, successor);
+
+			if (inserted || (!entry->second.closed && (cost < entry->second.cost)))
+			{
+				entry->second = successor;
+				queue.push(Candidate{cost + cost_model->estimate(next, target), cost, hop});
+			}
+		}
+	}
+
+	return false;
+}
+
+void Route::setCostModel(const RouteCost * model) noexcept
+{
+	cost_model = model;
+}
+
 bool Route::hasFlankProtection(
 	const RailPart * prev,
-	const RailPart * rail) const
+	const RailPart * rail,
+	const RailPart * succ) const
 {
 	const AbstractSwitch * actual_switch = dynamic_cast<const AbstractSwitch *>(rail);
 
-	if ((state == SectionState::TOUR) && (actual_switch != nullptr))
+	if ((state == SectionState::TOUR) && (actual_switch != nullptr) && (succ != nullptr))
 	{
-		const QString                indent(track.size(), ' ');
-		auto                         it   = std::find(track.begin(), track.end(), rail);
-		const RailPart       *       succ = *(++it);
-		std::vector<RegularSwitch *> flank_switch_candidates;
+		// Reuse the candidate vector to avoid an allocation per switch.
+		flank_candidates.clear();
 
 		// Collect flank switches depending on wanted switch state. Do not turn
 		// neither this switch nor flank switches. Flank switches not in correct
 		// state will not counted as return parameter. So if return value and
 		// result vector size differ any flank switch has to be turned later.
-		const size_t  count = actual_switch->flankCandidates(flank_switch_candidates, prev, succ);
+		const size_t  count = actual_switch->flankCandidates(flank_candidates, prev, succ);
 
 		// Count unlocked flank switches.
 		const size_t  unlock_count = std::count_if(
-				flank_switch_candidates.begin(), flank_switch_candidates.end(),
-				[this](RegularSwitch * flank_switch)
+				flank_candidates.begin(), flank_candidates.end(),
+				[](const RegularSwitch * flank_switch)
 		{
 			return flank_switch->lock() == LockState::UNLOCKED;
 		});
 
 		// If all flank switches are unlocked everything is fine. Otherwise the
 		// switch state has to be corrected.
-		if ((unlock_count != flank_switch_candidates.size()) &&
-			(count != flank_switch_candidates.size()))
+		if ((unlock_count != flank_candidates.size()) &&
+			(count != flank_candidates.size()))
 		{
-			qCDebug(log).noquote() << indent << "      Flank protection not granted:";
+			qCDebug(log).noquote() << indent() << "      Flank protection not granted:";
 			return false;
 		}
 	}
@@ -188,37 +458,36 @@ bool Route::qualified(
 	const RailPart * rail,
 	const Region  *  search_region) const
 {
-	const QString   indent(track.size(), ' ');
 	const Section * section = rail->section();
 	const Device  * device  = dynamic_cast<const Device *>(rail);
 
-	qCDebug(log).noquote() << indent << rail->toString();
+	qCDebug(log).noquote() << indent() << rail->toString();
 
 	if ((device != nullptr) && (device->lock() == LockState::FAIL))
 	{
-		qCDebug(log).noquote() << indent << "      Rail in failed state.";
+		qCDebug(log).noquote() << indent() << "      Rail in failed state.";
 		return false;
 	}
 	if (rail->reserved())
 	{
-		qCDebug(log).noquote() << indent << "      Rail already reserved.";
+		qCDebug(log).noquote() << indent() << "      Rail already reserved.";
 		return false;
 	}
-	if (track.size() > MAX_DEPTH)
+	if ((track.size() + path.size()) > MAX_DEPTH)
 	{
-		qCDebug(log).noquote() << indent << "      Recursion depth reached.";
+		qCDebug(log).noquote() << indent() << "      Recursion depth reached.";
 		return false;
 	}
 	if (section != first_section)
 	{
 		if ((search_region != nullptr) && (section->region() != search_region))
 		{
-			qCDebug(log).noquote() << indent << "      Shunting left region.";
+			qCDebug(log).noquote() << indent() << "      Shunting left region.";
 			return false;
 		}
 		else if (section->occupation())
 		{
-			qCDebug(log).noquote() << indent << "      Section occupied.";
+			qCDebug(log).noquote() << indent() << "      Section occupied.";
 			return false;
 		}
 	}
@@ -228,16 +497,18 @@ bool Route::qualified(
 
 void Route::unreserveTail(const RailPart * actual)
 {
-	auto                    it = std::find(track.begin(), track.end(), actual);
-	std::vector<RailPart *> removables(++it, track.end());
-
-	for (RailPart * part : removables)
+	while (!track.empty() && (track.back() != actual))
 	{
-		part->reserve(false);
-		track.remove(part);
+		track.back()->reserve(false);
+		track.pop_back();
 	}
 }
 
+QString Route::indent() const
+{
+	return QString(track.size() + path.size(), ' ');
+}
+
 bool Route::prepare()
 {
 	__METHOD__;
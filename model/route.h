@@ -8,13 +8,16 @@
 #ifndef MRW_MODEL_ROUTE_H
 #define MRW_MODEL_ROUTE_H
 
+#include <cstddef>
 #include <list>
 #include <unordered_set>
 
 #include <QObject>
 
+#include <util/fixedstack.h>
 #include <model/section.h>
 #include <model/railpart.h>
+#include <model/routecost.h>
 
 namespace mrw::model
 {
@@ -54,6 +57,15 @@ namespace mrw::model
 	 * When returning successfully from recursion a further condition tests
 	 * the flank protection. This is only required when using a tour route.
 	 *
+	 * RailPart elements from which the target cannot be reached at all are
+	 * skipped before any of the conditions above are evaluated. This
+	 * information is looked up in the precomputed RailGraph of the
+	 * ModelRailway.
+	 *
+	 * If a RouteCost model is set the track is planned first by a least
+	 * cost search under the same conditions. The depth first search is the
+	 * fallback if no such track was found.
+	 *
 	 * @see RailPart::reserve()
 	 * @see RailPart::advance()
 	 * @see SectionState
@@ -93,6 +105,20 @@ namespace mrw::model
 		[[nodiscard]]
 		bool append(RailPart * target);
 
+		/**
+		 * This method sets the RouteCost model used to plan the least cost
+		 * track when prolonging this Route. If no RouteCost model is set
+		 * or the planner does not find a track the depth first search is
+		 * used.
+		 *
+		 * @note The RouteCost model is not owned by this Route.
+		 *
+		 * @param model The RouteCost model or @c nullptr to disable the
+		 * planner.
+		 * @see append(RailPart *)
+		 */
+		void setCostModel(const RouteCost * model) noexcept;
+
 		/**
 		 * This method tries to find a RailPart track from the given RailPart
 		 * rail to the target parameter. If the search_region is not @c nullptr
@@ -111,6 +137,28 @@ namespace mrw::model
 			RailPart * target,
 			Region  *  search_region);
 
+		/**
+		 * This method plans the least cost RailPart track from the given
+		 * RailPart rail to the target parameter using the RouteCost model.
+		 * The search regards the same conditions as the depth first search
+		 * but expands the cheapest partial track first. Since the cost of
+		 * passing a switch depends on its predecessor the search state is
+		 * the pair of the previous and the actual RailPart.
+		 *
+		 * @param rail The starting point which is the last RailPart of the
+		 * track.
+		 * @param target The end point.
+		 * @param search_region The Region where to search the track. May be
+		 * @c nullptr.
+		 * @return True if a track was successfully prolonged.
+		 * @see setCostModel()
+		 */
+		[[nodiscard]]
+		bool plan(
+			RailPart * rail,
+			RailPart * target,
+			Region  *  search_region);
+
 		/**
 		 * This method deallocates all contained Section and RailPart from
 		 * this instance.
@@ -175,6 +223,9 @@ namespace mrw::model
 		 */
 		const bool              auto_unblock = false;
 
+		/** The optional RouteCost model of the planner. */
+		const RouteCost    *    cost_model = nullptr;
+
 		/**
 		 * The collection of flank switches along the route. The content
 		 * changes while a train drives through the route.
@@ -201,6 +252,64 @@ namespace mrw::model
 		virtual void prepareFlank();
 
 	private:
+		/** The minimum size of the planner memory in bytes. */
+		static constexpr size_t SCRATCH_SIZE     = 8192;
+
+		/**
+		 * The maximum size of the planner memory in bytes. A larger search
+		 * allocates the exceeding memory from the heap and releases it
+		 * afterwards. So a big layout pins at most this size per thread.
+		 */
+		static constexpr size_t SCRATCH_LIMIT    = 1024 * 1024;
+
+		/**
+		 * The estimated planner memory per RailPart of the layout. The
+		 * planner memory is shared by all Route instances of a thread. It
+		 * covers the visited hops into a RailPart, their hash buckets and
+		 * queue entries including the abandoned storage of grown
+		 * containers.
+		 */
+		static constexpr size_t SCRATCH_PER_PART = 256;
+
+		/** The RailPart elements found by the running search. */
+		mrw::util::FixedStack<RailPart *, MAX_DEPTH + 1> path;
+
+		/** The reused flank switch candidates of hasFlankProtection(). */
+		mutable std::vector<RegularSwitch *>             flank_candidates;
+
+		/**
+		 * This method does the recursive depth first search. The found
+		 * RailPart elements are collected on the path stack.
+		 *
+		 * @param rail The actual RailPart.
+		 * @param target The end point.
+		 * @param search_region The Region where to search the track. May be
+		 * @c nullptr.
+		 * @return True if the target was reached.
+		 */
+		[[nodiscard]]
+		bool search(
+			RailPart * rail,
+			RailPart * target,
+			Region  *  search_region);
+
+		/**
+		 * This method unreserves and removes all RailPart elements of the
+		 * path stack above the given depth.
+		 *
+		 * @param depth The path stack size to keep.
+		 */
+		void unwind(const size_t depth) noexcept;
+
+		/**
+		 * This method returns the indentation for debug logs depending on
+		 * the search depth. Call it only inside the log statement so it is
+		 * not computed if debug logging is disabled.
+		 *
+		 * @return The indentation.
+		 */
+		QString indent() const;
+
 		[[nodiscard]]
 		Region   *   findSearchRegion(const RailPart * target) const;
 
@@ -215,14 +324,34 @@ namespace mrw::model
 		 * @note If the route state is not SectionState::TOUR everything is
 		 * also fine.
 		 *
+		 * @note If there is no successive RailPart everything is also fine.
+		 *
 		 * @param prev The previous RailPart of the actual RailPart.
 		 * @param actual The actual RailPart to be checked.
+		 * @param succ The successive RailPart of the actual RailPart. May be
+		 * @c nullptr.
 		 * @return True if flank protection is available.
 		 */
 		[[nodiscard]]
 		bool         hasFlankProtection(
 			const RailPart * prev,
-			const RailPart * actual) const;
+			const RailPart * actual,
+			const RailPart * succ) const;
+
+		/**
+		 * This method returns true if the target may be reached from the
+		 * given RailPart in drive direction using the static RailGraph.
+		 * A false result is definitive so the search may skip this
+		 * RailPart completely.
+		 *
+		 * @param rail The RailPart to start from.
+		 * @param target The RailPart to reach.
+		 * @return True if a track to the target may exist.
+		 */
+		[[nodiscard]]
+		bool         leadsTo(
+			const RailPart * rail,
+			const RailPart * target) const noexcept;
 
 		/**
 		 * This method checks if a given RailPart is qualified to be used in
@@ -0,0 +1,86 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <vector>
+
+#include <model/section.h>
+#include <model/regularswitch.h>
+#include <model/routecost.h>
+
+using namespace mrw::model;
+
+using LockState = Device::LockState;
+
+unsigned RouteCost::estimate(
+	const RailPart * rail,
+	const RailPart * target) const
+{
+	Q_UNUSED(rail);
+	Q_UNUSED(target);
+
+	return 0;
+}
+
+SwitchingCost::SwitchingCost(const Weights & input) : cost_weights(input)
+{
+}
+
+unsigned SwitchingCost::cost(
+	const RailPart * prev,
+	const RailPart * rail,
+	const RailPart * succ) const
+{
+	const AbstractSwitch * actual_switch = dynamic_cast<const AbstractSwitch *>(rail);
+	unsigned               result        = cost_weights.part;
+
+	if (succ->section() != rail->section())
+	{
+		result += cost_weights.section;
+	}
+
+	if ((actual_switch == nullptr) && rail->isCurved())
+	{
+		result += cost_weights.curved;
+	}
+
+	if ((actual_switch != nullptr) && (prev != nullptr))
+	{
+		if (!actual_switch->isSwitchable(prev, succ))
+		{
+			return IMPASSABLE;
+		}
+		if (actual_switch->needsTurn(prev, succ))
+		{
+			result += cost_weights.turn;
+		}
+		if (actual_switch->isCurvedLeg(prev, succ))
+		{
+			result += cost_weights.curved;
+		}
+
+		std::vector<RegularSwitch *> flank_switches;
+		const size_t                 correct = actual_switch->flankCandidates(flank_switches, prev, succ);
+
+		if (correct != flank_switches.size())
+		{
+			const size_t locked = std::count_if(
+					flank_switches.begin(), flank_switches.end(),
+					[](const RegularSwitch * flank_switch)
+			{
+				return flank_switch->lock() != LockState::UNLOCKED;
+			});
+
+			result += (flank_switches.size() - correct) * cost_weights.flank;
+			result += locked * cost_weights.locked;
+		}
+	}
+	return result;
+}
+
+const SwitchingCost::Weights & SwitchingCost::weights() const noexcept
+{
+	return cost_weights;
+}
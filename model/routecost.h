@@ -0,0 +1,122 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_ROUTECOST_H
+#define MRW_MODEL_ROUTECOST_H
+
+#include <limits>
+
+namespace mrw::model
+{
+	class RailPart;
+
+	/**
+	 * This interface computes the costs a Route planner uses to select the
+	 * best track to a target RailPart. The planner sums up the costs of
+	 * passing each RailPart. So implementations can prefer tracks which
+	 * need less switch motors to move, less curved legs or less sections.
+	 *
+	 * @see Route::setCostModel()
+	 */
+	class RouteCost
+	{
+	public:
+		/** The cost marking a RailPart which must not be passed. */
+		static constexpr unsigned IMPASSABLE = std::numeric_limits<unsigned>::max();
+
+		virtual ~RouteCost() = default;
+
+		/**
+		 * This method returns the cost of passing the given RailPart from
+		 * the previous RailPart to the successive RailPart.
+		 *
+		 * @param prev The previous RailPart in Route order. It may be
+		 * @c nullptr at the front of a Route.
+		 * @param rail The RailPart to pass.
+		 * @param succ The successive RailPart in Route order.
+		 * @return The cost or @c IMPASSABLE if this RailPart cannot be
+		 * passed this way.
+		 */
+		[[nodiscard]]
+		virtual unsigned cost(
+			const RailPart * prev,
+			const RailPart * rail,
+			const RailPart * succ) const = 0;
+
+		/**
+		 * This method returns a lower bound of the remaining costs from
+		 * the given RailPart to the target. The planner acts as an A*
+		 * search using this estimation. The default implementation returns
+		 * zero so the planner acts as a Dijkstra search.
+		 *
+		 * @param rail The actual RailPart.
+		 * @param target The target RailPart.
+		 * @return The lower bound of the remaining costs.
+		 */
+		[[nodiscard]]
+		virtual unsigned estimate(
+			const RailPart * rail,
+			const RailPart * target) const;
+	};
+
+	/**
+	 * This is the default RouteCost implementation. Each passed RailPart
+	 * counts a base cost. Every Section change, every curved Rail, every
+	 * curved leg, every switch or flank switch to turn and every flank
+	 * switch locked by another Route adds its weight. A switch locked in a
+	 * wrong state is impassable.
+	 *
+	 * An instance is stateless so it may be shared between routes and
+	 * threads.
+	 */
+	class SwitchingCost : public RouteCost
+	{
+	public:
+		/**
+		 * This struct contains the weights of the cost criteria.
+		 */
+		struct Weights
+		{
+			/** The base cost of each passed RailPart. */
+			unsigned part    = 1;
+
+			/** The cost of entering a new Section. */
+			unsigned section = 4;
+
+			/** The cost of a curved Rail or a branched leg. */
+			unsigned curved  = 2;
+
+			/** The cost of each switch motor to move. */
+			unsigned turn    = 8;
+
+			/** The cost of each flank switch motor to move. */
+			unsigned flank   = 8;
+
+			/** The cost of each locked flank switch in wrong state. */
+			unsigned locked  = 32;
+		};
+
+		explicit SwitchingCost(const Weights & input = Weights());
+
+		unsigned cost(
+			const RailPart * prev,
+			const RailPart * rail,
+			const RailPart * succ) const override;
+
+		/**
+		 * This method returns the used cost weights.
+		 *
+		 * @return The cost weights.
+		 */
+		const Weights & weights() const noexcept;
+
+	private:
+		const Weights                        cost_weights;
+	};
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <can/mrwmessage.h>
 #include <model/modelrailway.h>
 #include <model/section.h>
+#include <model/emfpath.h>
 #include <model/sectionmodule.h>
 #include <model/rail.h>
 #include <model/regularswitch.h>
@@ -21,50 +22,6 @@ using namespace mrw::model;
 
 using SignalType = Signal::SignalType;
 
-/**
- * Regular expression prolog:
- * \d matches one digit.
- * \s whitespace character
- * \w matches one digit or case insensitive letter.
- * "." matches one character.
- * \d+ matches a number with at least one digit
- * (\d+) marks a matching group
- *
- * Since we use C++11 raw string literals we do not need to escape the '\' char to "\\".
- *
- * There is a nice regular expression test site where you can build a regular expression and test it agai
- * multiple test patterns: https://regex101.com/
- *
- * The following test patterns may be used:
- * @verbatim
-//@controller.3/@module.0
-//@controller.7/@module.1
-@endverbatim
- */
-const std::regex  Section::module_path_regex(R"(^\/\/@controller\.(\d+)\/@module\.(\d+))");
-
-/**
- * Regular expression prolog:
- * \d matches one digit.
- * \s whitespace character
- * \w matches one digit or case insensitive letter.
- * "." matches one character.
- * \d+ matches a number with at least one digit
- * (\d+) marks a matching group
- *
- * Since we use C++11 raw string literals we do not need to escape the '\' char to "\\".
- *
- * There is a nice regular expression test site where you can build a regular expression and test it agai
- * multiple test patterns: https://regex101.com/
- *
- * The following test patterns may be used:
- * @verbatim
-//@controller.3/@anschluesse.0/@crossing.0
-//@controller.7/@anschluesse.1/@crossing.2
-@endverbatim
- */
-const std::regex  Section::crossing_path_regex(R"(^\/\/@controller\.(\d+)\/@anschluesse\.(\d+)\/@crossing\.(\d+))");
-
 const ConstantEnumerator<SectionState>  Section::state_map
 {
 	{ SectionState::FREE,     "FREE"},
@@ -77,108 +34,85 @@ const ConstantEnumerator<SectionState>  Section::state_map
 Section::Section(
 	ModelRailway     *    model_railway,
 	Region        *       region,
-	const QDomElement  &  element) :
+	const XmiElement   &  element) :
 	Device(model_railway, element),
 	section_name(ModelRailway::string(element, "name")),
 	model(model_railway),
 	section_region(region)
 {
-	const QDomNodeList & child_nodes = element.childNodes();
-
-	assembly_parts.reserve(child_nodes.count());
-	for (int n = 0; n < child_nodes.count(); ++n)
-	{
-		const QDomNode & node = child_nodes.at(n);
-
-		if (node.isElement())
-		{
-			const QDomElement & child = node.toElement();
-			const QString       type  = ModelRailway::type(child);
-
-			if (node.nodeName() == "bauelement")
-			{
-				AssemblyPart * rail_part = nullptr;
-
-				if (type == "Gleis")
-				{
-					rail_part = new Rail(model, this, child);
-				}
-				else if (type == "Weiche")
-				{
-					rail_part = new RegularSwitch(model, this,  child);
-				}
-				else if (type == "DKW")
-				{
-					rail_part = new DoubleCrossSwitch(model, this, child);
-				}
-				else if (type == "Gleissperrsignal")
-				{
-					rail_part = new LightSignal(model, this, child, SignalType::SHUNT_SIGNAL, 2);
-				}
-				else if (type == "Vorsignal")
-				{
-					rail_part = new LightSignal(model, this, child, SignalType::DISTANT_SIGNAL, 4);
-				}
-				else if (type == "Blocksignal")
-				{
-					rail_part = new LightSignal(model, this, child, SignalType::MAIN_SIGNAL, 2);
-				}
-				else if (type == "Einfahrsignal")
-				{
-					rail_part = new LightSignal(model, this, child, SignalType::MAIN_SIGNAL, 3);
-				}
-				else if (type == "Ausfahrsignal")
-				{
-					rail_part = new LightSignal(model, this, child, SignalType::MAIN_SHUNT_SIGNAL, 5);
-				}
-				else if (type == "Formgleissperrsignal")
-				{
-					rail_part = new FormSignal(model, this, child, SignalType::SHUNT_SIGNAL);
-				}
-				else if (type == "Formvorsignal")
-				{
-					rail_part = new FormSignal(model, this, child, SignalType::DISTANT_SIGNAL);
-				}
-				else if (type == "Formhauptsignal")
-				{
-					rail_part = new FormSignal(model, this, child, SignalType::MAIN_SIGNAL);
-				}
-				else
-				{
-					model->warning("Unknown rail type: " + type);
-				}
-				add(rail_part);
-			}
-			else
-			{
-				model->error("Unknown rail part: " + node.nodeName());
-			}
-		}
-	}
-
-	section_module   = resolveModule(ModelRailway::string(element, "modul").toStdString());
-	section_crossing = resolveCrossing(ModelRailway::string(element, "crossing").toStdString());
+	section_module   = resolveModule(ModelRailway::string(element, "modul"));
+	section_crossing = resolveCrossing(ModelRailway::string(element, "crossing"));
 
 	if (section_crossing != nullptr)
 	{
 		section_crossing->add(this);
 	}
 	model->add(this);
+}
 
-	forward_signals.reserve(3);
-	parts<Signal>(forward_signals, [&](const Signal * signal)
-	{
-		return signal->direction();
-	});
+XmiContainer * Section::create(const XmiElement & child)
+{
+	const QString type = ModelRailway::type(child);
 
-	backward_signals.reserve(3);
-	parts<Signal>(backward_signals, [&](const Signal * signal)
+	if (child.nodeName() == "bauelement")
 	{
-		return !signal->direction();
-	});
+		AssemblyPart * rail_part = nullptr;
 
-	std::sort(forward_signals.begin(),  forward_signals.end(),  Signal::less);
-	std::sort(backward_signals.begin(), backward_signals.end(), Signal::less);
+		if (type == "Gleis")
+		{
+			rail_part = new Rail(model, this, child);
+		}
+		else if (type == "Weiche")
+		{
+			rail_part = new RegularSwitch(model, this,  child);
+		}
+		else if (type == "DKW")
+		{
+			rail_part = new DoubleCrossSwitch(model, this, child);
+		}
+		else if (type == "Gleissperrsignal")
+		{
+			rail_part = new LightSignal(model, this, child, SignalType::SHUNT_SIGNAL, 2);
+		}
+		else if (type == "Vorsignal")
+		{
+			rail_part = new LightSignal(model, this, child, SignalType::DISTANT_SIGNAL, 4);
+		}
+		else if (type == "Blocksignal")
+		{
+			rail_part = new LightSignal(model, this, child, SignalType::MAIN_SIGNAL, 2);
+		}
+		else if (type == "Einfahrsignal")
+		{
+			rail_part = new LightSignal(model, this, child, SignalType::MAIN_SIGNAL, 3);
+		}
+		else if (type == "Ausfahrsignal")
+		{
+			rail_part = new LightSignal(model, this, child, SignalType::MAIN_SHUNT_SIGNAL, 5);
+		}
+		else if (type == "Formgleissperrsignal")
+		{
+			rail_part = new FormSignal(model, this, child, SignalType::SHUNT_SIGNAL);
+		}
+		else if (type == "Formvorsignal")
+		{
+			rail_part = new FormSignal(model, this, child, SignalType::DISTANT_SIGNAL);
+		}
+		else if (type == "Formhauptsignal")
+		{
+			rail_part = new FormSignal(model, this, child, SignalType::MAIN_SIGNAL);
+		}
+		else
+		{
+			model->warning("Unknown rail type: " + type);
+		}
+		add(rail_part);
+	}
+	else
+	{
+		model->error("Unknown rail part: " + child.nodeName());
+	}
+	return nullptr;
 }
 
 bool Section::valid() const noexcept
@@ -218,15 +152,8 @@ bool Section::enabled() const noexcept
 
 bool Section::isUnlockable() const noexcept
 {
-	std::vector<RailPart *> reserved_parts;
-
-	parts<RailPart>(reserved_parts, [](const RailPart * part)
-	{
-		return part->reserved();
-	});
-
 	return
-		(reserved_parts.size() == 0) &&
+		!anyReserved() &&
 		(section_state == SectionState::FREE);
 }
 
@@ -287,11 +214,34 @@ void Section::add(AssemblyPart * part) noexcept
 
 void Section::link() noexcept
 {
+	part_registry.clear();
+	for (AssemblyPart * part : assembly_parts)
+	{
+		part_registry.add(part);
+	}
+	part_registry.shrink();
+
+	forward_signals.reserve(3);
+	parts<Signal>(forward_signals, [&](const Signal * signal)
+	{
+		return signal->direction();
+	});
+
+	backward_signals.reserve(3);
+	parts<Signal>(backward_signals, [&](const Signal * signal)
+	{
+		return !signal->direction();
+	});
+
+	std::sort(forward_signals.begin(),  forward_signals.end(),  Signal::less);
+	std::sort(backward_signals.begin(), backward_signals.end(), Signal::less);
+
 	for (AssemblyPart * part : assembly_parts)
 	{
 		if (part != nullptr)
 		{
 			part->link();
+			part->reference.clear();
 		}
 	}
 }
@@ -312,14 +262,9 @@ QString Section::toString() const
 
 void Section::free() noexcept
 {
-	for (AssemblyPart * part : assembly_parts)
+	for (RailPart * rail_part : part_registry.get<RailPart>())
 	{
-		RailPart * rail_part = dynamic_cast<RailPart *>(part);
-
-		if (rail_part != nullptr)
-		{
-			rail_part->reserve(false);
-		}
+		rail_part->reserve(false);
 	}
 	setState(SectionState::FREE);
 }
@@ -343,13 +288,12 @@ QString Section::key() const noexcept
 
 bool Section::anyReserved() const noexcept
 {
-	std::vector<RailPart *> rails;
+	const std::vector<RailPart *> & rails = part_registry.get<RailPart>();
 
-	parts<RailPart>(rails, [](const RailPart * part)
+	return std::any_of(rails.begin(), rails.end(), [](const RailPart * part)
 	{
 		return part->reserved();
 	});
-	return rails.size() > 0;
 }
 
 QString Section::get(const SectionState & state) noexcept
@@ -362,16 +306,13 @@ const std::vector<Signal *> & Section::getSignals(const bool view) const noexcep
 	return view ? forward_signals : backward_signals;
 }
 
-SectionModule * Section::resolveModule(const std::string & path) noexcept
+SectionModule * Section::resolveModule(const QString & path) noexcept
 {
-	std::smatch matcher;
+	const auto indices = EmfPath::match(path, EmfPath::MODULE);
 
-	if (std::regex_match(path, matcher, module_path_regex))
+	if (indices)
 	{
-		Q_ASSERT(matcher.size() >= 3);
-
-		const unsigned controller_idx = std::stoul(matcher[1]);
-		const unsigned module_idx     = std::stoul(matcher[2]);
+		const auto [controller_idx, module_idx] = *indices;
 
 		section_controller = model->controller(controller_idx);
 		return dynamic_cast<SectionModule *>(model->module(controller_idx, module_idx));
@@ -379,17 +320,13 @@ SectionModule * Section::resolveModule(const std::string & path) noexcept
 	return nullptr;
 }
 
-Crossing * Section::resolveCrossing(const std::string & path) noexcept
+Crossing * Section::resolveCrossing(const QString & path) noexcept
 {
-	std::smatch matcher;
+	const auto indices = EmfPath::match(path, EmfPath::CROSSING);
 
-	if (std::regex_match(path, matcher, crossing_path_regex))
+	if (indices)
 	{
-		Q_ASSERT(matcher.size() >= 4);
-
-		const unsigned controller_idx = std::stoul(matcher[1]);
-		const unsigned connection_idx = std::stoul(matcher[2]);
-		const unsigned crossing_idx   = std::stoul(matcher[3]);
+		const auto [controller_idx, connection_idx, crossing_idx] = *indices;
 
 		const MultiplexConnection * mux = model->connection(controller_idx, connection_idx);
 
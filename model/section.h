@@ -9,16 +9,15 @@
 #define MRW_MODEL_SECTION_H
 
 #include <cstdint>
-#include <regex>
 #include <functional>
 #include <type_traits>
 
-#include <QDomElement>
-
 #include <model/assemblypart.h>
 #include <model/module.h>
+#include <model/partregistry.h>
 #include <model/device.h>
 #include <model/position.h>
+#include <model/xmielement.h>
 #include <util/cleanvector.h>
 #include <util/constantenumerator.h>
 #include <util/method.h>
@@ -78,12 +77,14 @@ namespace mrw::model
 	 * collection. It may also manage several Signal instances. The Section
 	 * is controlled by a SectionModule.
 	 */
-	class Section : public Device, public Position, public mrw::util::String
+	class Section :
+		public Device,
+		public Position,
+		public XmiContainer,
+		public mrw::util::String
 	{
 		friend class Region;
 
-		static const std::regex                                   module_path_regex;
-		static const std::regex                                   crossing_path_regex;
 		static const mrw::util::ConstantEnumerator<SectionState>  state_map;
 
 		const QString                         section_name;
@@ -96,6 +97,7 @@ namespace mrw::model
 		bool                                  section_enabled    = false;
 		bool                                  section_occupied   = false;
 		mrw::util::CleanVector<AssemblyPart>  assembly_parts;
+		PartRegistry                          part_registry;
 		std::vector<Signal *>                 forward_signals;
 		std::vector<Signal *>                 backward_signals;
 
@@ -103,7 +105,7 @@ namespace mrw::model
 		explicit Section(
 			ModelRailway     *    model_railway,
 			Region        *       region,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 		virtual ~Section() = default;
 
 		// Implementations from Device
@@ -239,23 +241,35 @@ namespace mrw::model
 		/**
 		 * This template class returns all AssemblyPart elements of the given
 		 * type T. The found elements are stored into the given std::vector.
+		 * Types registered in the PartRegistry are served from a prebuilt
+		 * vector. Other types need a dynamic_cast scan.
 		 *
 		 * @param result The result vector collecting the AssembyPart elements
 		 * of type T.
-		 * @param guard A lamda to fine select if the type T should added to
-		 * the result vector.
+		 * @param guard Any invocable like a lambda, a function or a member
+		 * function pointer to fine select if the type T should added to the
+		 * result vector.
+		 * @see PartRegistry
 		 */
-		template <class T> constexpr void parts(
+		template <class T, class G = decltype(&mrw::util::Method::always<T>)>
+		constexpr void parts(
 			std::vector<T *> & result,
-			std::function<bool(const T * part)> guard = &mrw::util::Method::always<T>) const noexcept
+			G                  guard = &mrw::util::Method::always<T>) const noexcept
 		{
-			for (AssemblyPart * part : assembly_parts)
+			if constexpr (PartRegistry::contains<T>)
 			{
-				T * element = dynamic_cast<T *>(part);
-
-				if ((element != nullptr) && guard(element))
+				part_registry.collect(result, guard);
+			}
+			else
+			{
+				for (AssemblyPart * part : assembly_parts)
 				{
-					result.push_back(element);
+					T * element = dynamic_cast<T *>(part);
+
+					if ((element != nullptr) && std::invoke(guard, element))
+					{
+						result.push_back(element);
+					}
 				}
 			}
 		}
@@ -322,10 +336,11 @@ namespace mrw::model
 		const std::vector<Signal *> & getSignals(const bool view) const noexcept;
 
 	private:
+		XmiContainer  * create(const XmiElement & child) override;
 		void            add(AssemblyPart * rail_part) noexcept;
 		void            link() noexcept;
-		SectionModule * resolveModule(const std::string & path) noexcept;
-		Crossing    *   resolveCrossing(const std::string & path) noexcept;
+		SectionModule * resolveModule(const QString & path) noexcept;
+		Crossing    *   resolveCrossing(const QString & path) noexcept;
 	};
 }
 
@@ -9,11 +9,9 @@
 #define MRW_MODEL_SECTIONMODULE_H
 
 #include <vector>
-#include <regex>
-
-#include <QDomElement>
 
 #include <model/module.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -30,8 +28,6 @@ namespace mrw::model
 	 */
 	class SectionModule : public Module
 	{
-		static const std::regex path_regex;
-
 		std::vector<Section *> sections;
 
 		static constexpr size_t MAX_SECTIONS = 4;
@@ -39,7 +35,7 @@ namespace mrw::model
 	public:
 		SectionModule(
 			ModelRailway     *    model_railway,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		inline size_t ports() const override
 		{
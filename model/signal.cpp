@@ -35,7 +35,7 @@ const ConstantEnumerator<Symbol>  Signal::symbol_map
 Signal::Signal(
 	ModelRailway     *    model_railway,
 	Section       *       model_section,
-	const QDomElement  &  element,
+	const XmiElement   &  element,
 	const SignalType      type) :
 	AssemblyPart(model_railway, model_section, element),
 	signal_type(type),
@@ -137,7 +137,7 @@ namespace mrw::model
 		explicit Signal(
 			ModelRailway     *    model_railway,
 			Section       *       model_section,
-			const QDomElement  &  element,
+			const XmiElement   &  element,
 			const SignalType      type);
 
 		/**
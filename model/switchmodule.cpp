@@ -15,7 +15,7 @@ using namespace mrw::model;
 
 SwitchModule::SwitchModule(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element) : Module(model_railway, element)
+	const XmiElement   &  element) : Module(model_railway, element)
 {
 }
 
@@ -10,9 +10,8 @@
 
 #include <vector>
 
-#include <QDomElement>
-
 #include <model/module.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -37,7 +36,7 @@ namespace mrw::model
 	public:
 		explicit SwitchModule(
 			ModelRailway     *    model_railway,
-			const QDomElement  &  element);
+			const XmiElement   &  element);
 
 		size_t ports() const override;
 
@@ -8,49 +8,24 @@
 #include "model/modelrailway.h"
 #include "model/switchmodule.h"
 #include "model/switchmodulereference.h"
+#include "model/emfpath.h"
 
 using namespace mrw::can;
 using namespace mrw::model;
 
-/**
- * Regular expression prolog:
- * \d matches one digit.
- * \s whitespace character
- * \w matches one digit or case insensitive letter.
- * "." matches one character.
- * \d+ matches a number with at least one digit
- * (\d+) marks a matching group
- *
- * Since we use C++11 raw string literals we do not need to escape the '\' char to "\\".
- *
- * There is a nice regular expression test site where you can build a regular expression and test it agai
- * multiple test patterns: https://regex101.com/
- *
- * The following test patterns may be used:
- * @verbatim
-//@controller.3/@module.0
-//@controller.7/@module.1
-@endverbatim
- */
-const std::regex  SwitchModuleReference::path_regex(R"(^\/\/@controller\.(\d+)\/@module\.(\d+))");
-
 SwitchModuleReference::SwitchModuleReference(
 	ModelRailway     *    model_railway,
-	const QDomElement  &  element,
+	const XmiElement   &  element,
 	const bool            cutoff) :
 	Device(model_railway, element),
 	inductor_count(model_railway->value(element, "spulen", 2)),
 	has_cut_off(cutoff)
 {
-	std::string path = ModelRailway::string(element, "modul").toStdString();
-	std::smatch matcher;
+	const auto indices = EmfPath::match(ModelRailway::string(element, "modul"), EmfPath::MODULE);
 
-	if (std::regex_match(path, matcher, path_regex))
+	if (indices)
 	{
-		Q_ASSERT(matcher.size() >= 3);
-
-		const unsigned constroller_idx = std::stoul(matcher[1]);
-		const unsigned module_idx      = std::stoul(matcher[2]);
+		const auto [constroller_idx, module_idx] = *indices;
 
 		switch_controller = model_railway->controller(constroller_idx);
 		switch_module     = dynamic_cast<SwitchModule *>(
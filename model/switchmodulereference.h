@@ -8,11 +8,8 @@
 #ifndef MRW_MODEL_SWITCHMODULEREFERENCE_H
 #define MRW_MODEL_SWITCHMODULEREFERENCE_H
 
-#include <regex>
-
-#include <QDomElement>
-
 #include <model/device.h>
+#include <model/xmielement.h>
 
 namespace mrw::model
 {
@@ -30,8 +27,6 @@ namespace mrw::model
 	 */
 	class SwitchModuleReference : public Device
 	{
-		static const std::regex  path_regex;
-
 		const unsigned inductor_count;
 		const bool     has_cut_off;
 
@@ -41,7 +36,7 @@ namespace mrw::model
 	public:
 		explicit SwitchModuleReference(
 			ModelRailway     *    model_railway,
-			const QDomElement  &  element,
+			const XmiElement   &  element,
 			const bool            cutoff = true);
 
 		/**
@@ -0,0 +1,64 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QDomNamedNodeMap>
+
+#include "model/xmielement.h"
+
+using namespace mrw::model;
+
+XmiElement::XmiElement(const QDomElement & element) :
+	node_name(element.nodeName())
+{
+	const QDomNamedNodeMap & attributes = element.attributes();
+
+	node_attributes.reserve(attributes.size());
+	for (int a = 0; a < attributes.size(); a++)
+	{
+		const QDomAttr & attribute = attributes.item(a).toAttr();
+
+		node_attributes.append(attribute.name(), attribute.value());
+	}
+}
+
+XmiElement::XmiElement(const QXmlStreamReader & reader) :
+	node_name(reader.qualifiedName().toString()),
+	node_attributes(reader.attributes())
+{
+}
+
+XmiElement::XmiElement(
+	const QString              & name,
+	const QXmlStreamAttributes & attributes) :
+	node_name(name),
+	node_attributes(attributes)
+{
+}
+
+const QString & XmiElement::nodeName() const noexcept
+{
+	return node_name;
+}
+
+const QXmlStreamAttributes & XmiElement::attributes() const noexcept
+{
+	return node_attributes;
+}
+
+QString XmiElement::attribute(
+	const QString & name,
+	const QString & default_value) const
+{
+	return node_attributes.hasAttribute(name) ?
+		node_attributes.value(name).toString() :
+		default_value;
+}
+
+void XmiElement::clear() noexcept
+{
+	node_name.clear();
+	node_attributes.clear();
+	node_attributes.squeeze();
+}
@@ -0,0 +1,120 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_MODEL_XMIELEMENT_H
+#define MRW_MODEL_XMIELEMENT_H
+
+#include <QDomElement>
+#include <QXmlStreamAttributes>
+#include <QXmlStreamReader>
+#include <QString>
+
+namespace mrw::model
+{
+	/**
+	 * This class holds the node name and the attributes of one EMF/XMI
+	 * element without its child nodes. It decouples the model classes from
+	 * the parser in use. So the same constructors serve the QDomDocument
+	 * based loader and the streaming QXmlStreamReader based loader. Since
+	 * it does not reference any parser state the parser may be freed after
+	 * loading while model elements still keep their link paths until they
+	 * are resolved.
+	 */
+	class XmiElement
+	{
+		QString              node_name;
+		QXmlStreamAttributes node_attributes;
+
+	public:
+		XmiElement() = default;
+
+		/**
+		 * This constructor copies the node name and all attributes from the
+		 * given DOM element.
+		 *
+		 * @param element The QDomElement to copy from.
+		 */
+		explicit XmiElement(const QDomElement & element);
+
+		/**
+		 * This constructor copies the node name and all attributes from the
+		 * actual start element the QXmlStreamReader points to.
+		 *
+		 * @param reader The QXmlStreamReader positioned on a start element.
+		 */
+		explicit XmiElement(const QXmlStreamReader & reader);
+
+		/**
+		 * This constructor initializes the node name and the attributes
+		 * directly. It is used when replaying a precompiled ModelSnapshot.
+		 *
+		 * @param name The qualified node name.
+		 * @param attributes The attributes of the node.
+		 */
+		explicit XmiElement(
+			const QString              & name,
+			const QXmlStreamAttributes & attributes);
+
+		/**
+		 * This method returns the qualified node name of this element.
+		 *
+		 * @return The qualified node name.
+		 */
+		const QString & nodeName() const noexcept;
+
+		/**
+		 * This method returns all attributes of this element. It is used
+		 * when recording a ModelSnapshot.
+		 *
+		 * @return The attributes of this element.
+		 */
+		const QXmlStreamAttributes & attributes() const noexcept;
+
+		/**
+		 * This method returns the value of the attribute with the given
+		 * qualified name.
+		 *
+		 * @param name The qualified attribute name.
+		 * @param default_value The value returned if the attribute does not
+		 * exist.
+		 * @return The attribute value.
+		 */
+		QString attribute(
+			const QString & name,
+			const QString & default_value = QString()) const;
+
+		/**
+		 * This method releases all node data after the referring model
+		 * element has resolved its links.
+		 */
+		void clear() noexcept;
+	};
+
+	/**
+	 * This interface is implemented by all model classes which contain
+	 * child elements inside the EMF/XMI file. The loaders announce each
+	 * child element to its container which creates the corresponding model
+	 * instance.
+	 */
+	class XmiContainer
+	{
+	public:
+		virtual ~XmiContainer() = default;
+
+		/**
+		 * This method creates the model element for the given child
+		 * element.
+		 *
+		 * @param child The child XmiElement to create a model element from.
+		 * @return The created model element as XmiContainer if it may
+		 * contain child elements itself or @c nullptr otherwise.
+		 */
+		virtual XmiContainer * create(const XmiElement & child) = 0;
+	};
+}
+
+#endif
@@ -21,6 +21,7 @@ SOURCES += \
 	SwitchStatechart.cpp \
 	TrackerStatechart.cpp \
 	UpdateStatechart.cpp \
+	statecharttracer.cpp \
 	timerservice.cpp
 
 HEADERS += \
@@ -38,6 +39,7 @@ HEADERS += \
 	common/sc_statemachine.h \
 	common/sc_timer.h \
 	common/sc_types.h \
+	statecharttracer.h \
 	timerservice.h
 
 QMAKE_CLEAN += $$TARGET
@@ -0,0 +1,100 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QMetaMethod>
+
+#include <util/tracerecorder.h>
+#include <statecharts/statecharttracer.h>
+
+using namespace mrw::statechart;
+using namespace mrw::util;
+
+void StatechartTracer::attach(QObject * statechart, const Label & label)
+{
+	TraceRecorder & recorder = TraceRecorder::instance();
+
+	if (!recorder.isOpen())
+	{
+		return;
+	}
+
+	const QMetaObject * meta = statechart->metaObject();
+	const QMetaMethod   slot = metaObject()->method(metaObject()->indexOfSlot("traced()"));
+
+	if (timeout_name == TraceRecorder::NO_NAME)
+	{
+		timeout_name = recorder.name("timeout");
+	}
+	sources.insert(statechart, Source{ label, TraceRecorder::NO_NAME });
+
+	for (int i = meta->methodOffset(); i < meta->methodCount(); i++)
+	{
+		const QMetaMethod method = meta->method(i);
+
+		if (method.methodType() == QMetaMethod::Signal)
+		{
+			connect(statechart, method, this, slot, Qt::DirectConnection);
+		}
+	}
+
+	connect(statechart, &QObject::destroyed, this, [this] (QObject * object)
+	{
+		sources.remove(object);
+	});
+}
+
+void StatechartTracer::timeout(const QObject * statechart, const sc::eventid event)
+{
+	if (sources.contains(statechart))
+	{
+		TraceRecorder::instance().event(
+			TraceType::TIMEOUT, source(statechart), timeout_name, std::uint32_t(event));
+	}
+}
+
+void StatechartTracer::rename(const QObject * statechart)
+{
+	auto it = sources.find(statechart);
+
+	if (it != sources.end())
+	{
+		it->name = TraceRecorder::instance().name(it->label());
+	}
+}
+
+void StatechartTracer::traced()
+{
+	const QObject * statechart = sender();
+	const int       index      = senderSignalIndex();
+
+	if ((statechart == nullptr) || !sources.contains(statechart))
+	{
+		return;
+	}
+
+	const EventKey key{ statechart->metaObject(), index };
+	auto           it = event_names.find(key);
+
+	if (it == event_names.end())
+	{
+		const QString name = QString::fromLatin1(statechart->metaObject()->method(index).name());
+
+		it = event_names.emplace(key, TraceRecorder::instance().name(name)).first;
+	}
+
+	TraceRecorder::instance().event(TraceType::EVENT, source(statechart), it->second);
+}
+
+std::uint16_t StatechartTracer::source(const QObject * statechart)
+{
+	Source & entry = sources[statechart];
+
+	// The name of a controller is not known during its construction.
+	if (entry.name == TraceRecorder::NO_NAME)
+	{
+		entry.name = TraceRecorder::instance().name(entry.label());
+	}
+	return entry.name;
+}
@@ -0,0 +1,109 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_STATECHART_STATECHARTTRACER_H
+#define MRW_STATECHART_STATECHARTTRACER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+
+#include <util/singleton.h>
+#include <util/tracerecorder.h>
+
+#include <statecharts/common/sc_types.h>
+
+namespace mrw::statechart
+{
+	/**
+	 * This singleton writes the events of attached statecharts into the
+	 * mrw::util::TraceRecorder. Every out event of a statechart is a Qt
+	 * signal so all signals of an attached statechart are connected to
+	 * this tracer. The time events are reported by the TimerService.
+	 *
+	 * The event source is named by a label callback since the name of a
+	 * controller may not be known during construction. The callback is
+	 * called once on the first traced event. The resulting name index is
+	 * cached until rename() is called. The names of the events are taken
+	 * from the Qt meta object of the statechart.
+	 *
+	 * @note Nothing is traced if the trace file is not open while
+	 * attaching.
+	 *
+	 * @see mrw::util::TraceRecorder
+	 */
+	class StatechartTracer :
+		public QObject,
+		public mrw::util::Singleton<StatechartTracer>
+	{
+		Q_OBJECT
+
+	public:
+		friend class mrw::util::Singleton<StatechartTracer>;
+
+		/** The callback returning the name of an event source. */
+		typedef std::function<QString()> Label;
+
+		/**
+		 * This method traces all out events of the given statechart. The
+		 * statechart is detached automatically on its destruction.
+		 *
+		 * @param statechart The QObject based statechart to trace.
+		 * @param label The callback returning the name of the event
+		 * source.
+		 */
+		void attach(QObject * statechart, const Label & label);
+
+		/**
+		 * This method records a time event raised by the TimerService.
+		 * Time events of statecharts not attached are ignored.
+		 *
+		 * @param statechart The statechart raising the time event.
+		 * @param event The time event ID.
+		 */
+		void timeout(const QObject * statechart, const sc::eventid event);
+
+		/**
+		 * This method refreshes the cached name of an attached statechart
+		 * by calling its label callback again. Statecharts not attached
+		 * are ignored.
+		 *
+		 * @param statechart The statechart whose event source was renamed.
+		 */
+		void rename(const QObject * statechart);
+
+	private slots:
+		void traced();
+
+	private:
+		/**
+		 * An attached event source with its cached name index.
+		 */
+		struct Source
+		{
+			Label         label;
+			std::uint16_t name = mrw::util::TraceRecorder::NO_NAME;
+		};
+
+		typedef std::pair<const QMetaObject *, int> EventKey;
+
+		StatechartTracer() = default;
+
+		std::uint16_t source(const QObject * statechart);
+
+		QHash<const QObject *, Source>      sources;
+		std::map<EventKey, std::uint16_t>   event_names;
+		std::uint16_t                       timeout_name = mrw::util::TraceRecorder::NO_NAME;
+	};
+}
+
+#endif
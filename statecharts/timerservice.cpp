@@ -3,20 +3,30 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <chrono>
+
 #include <statecharts/timerservice.h>
+#include <statecharts/statecharttracer.h>
 #include <util/method.h>
+#include <util/log.h>
+#include <util/tracerecorder.h>
 
 using namespace mrw::statechart;
 using namespace mrw::util;
 using namespace sc::timer;
 
 using Qt::TimerType::PreciseTimer;
-using Qt::TimerType::CoarseTimer;
+using Handle = TimerWheel::Handle;
 
 TimerService::TimerService() :
 	QObject(nullptr),
 	self(this, &Method::noop<TimerService>)
 {
+	clock.start();
+	timer.setTimerType(PreciseTimer);
+	timer.setSingleShot(true);
+	connect(&timer, &QTimer::timeout, this, &TimerService::expire);
 }
 
 void TimerService::setTimer(
@@ -25,65 +35,216 @@ void TimerService::setTimer(
 	sc::time                        time_ms,
 	bool                            is_periodic)
 {
-	QTimer  *  timer          = getTimer(statemachine, event);
-	const bool high_precision = (time_ms % 1000) != 0;
+	const Handle handle = getTimer(statemachine, event);
 
 	// armor the timer
-	timer->setTimerType(high_precision ? PreciseTimer : CoarseTimer);
-	timer->setInterval(time_ms);
-	timer->setSingleShot(!is_periodic);
-	timer->start();
+	wheel.start(handle, now(), time_ms, is_periodic ? time_ms : 0);
+	schedule();
 }
 
 void TimerService::unsetTimer(
 	std::shared_ptr<TimedInterface> statemachine,
 	sc::eventid                     event)
 {
-	QTimer * timer = this->getTimer(statemachine, event);
+	const TimerKey key{ statemachine.get(), event };
+	const auto     it = chart_map.find(key);
 
-	timer->stop();
+	if (it != chart_map.end())
+	{
+		wheel.stop(*it);
+		schedule();
+	}
 }
 
 void TimerService::unsetTimerRaw(
 	TimedInterface * statemachine,
 	sc::eventid      event)
 {
-	TimerKey key{ statemachine, event };
+	const TimerKey key{ statemachine, event };
+	const auto     it = chart_map.find(key);
 
-	if (chart_map.contains(key))
+	if (it != chart_map.end())
 	{
-		QTimer * timer = chart_map[key];
+		const Handle handle = *it;
 
-		Q_ASSERT(timer != nullptr);
-		timer->stop();
-		chart_map.remove(key);
-		delete timer;
+		chart_map.erase(it);
+		wheel.destroy(handle);
+		events[handle] = TimeEvent();
+		schedule();
 	}
 }
 
-QTimer * TimerService::getTimer(
+const TimerWheel::Statistics & TimerService::statistics() const noexcept
+{
+	return wheel.statistics();
+}
+
+void TimerService::info() const
+{
+	const TimerWheel::Statistics & stats = wheel.statistics();
+
+	qCInfo(mrw::util::log, "Timers: %zu active, %zu peak, %zu allocated, %llu fired, %llu cascaded.",
+		stats.active, stats.peak, size_t(chart_map.size()),
+		(unsigned long long)stats.fired, (unsigned long long)stats.cascaded);
+	qCInfo(mrw::util::log, "  >=      ms lateness    timers");
+	for (size_t i = 0; i < Histogram::BUCKETS; i++)
+	{
+		if ((stats.lateness[i] != 0) || (stats.timers[i] != 0))
+		{
+			qCInfo(mrw::util::log, "  %8llu %10llu %10llu",
+				(unsigned long long)Histogram::bucketFloor(i),
+				(unsigned long long)stats.lateness[i],
+				(unsigned long long)stats.timers[i]);
+		}
+	}
+}
+
+void TimerService::setVirtualTime(const bool enable)
+{
+	if (enable != use_virtual)
+	{
+		const uint64_t current = now();
+
+		use_virtual  = enable;
+		virtual_now  = current;
+		clock_offset = int64_t(current) - clock.elapsed();
+		timer.stop();
+		schedule();
+	}
+}
+
+bool TimerService::isVirtualTime() const noexcept
+{
+	return use_virtual;
+}
+
+void TimerService::singleShot(const sc::time time_ms, std::function<void()> callback)
+{
+	const Handle handle = wheel.create();
+
+	if (handle >= events.size())
+	{
+		events.resize(handle + 1);
+	}
+	events[handle] = TimeEvent{ nullptr, 0, std::move(callback) };
+
+	wheel.start(handle, now(), time_ms);
+	schedule();
+}
+
+void TimerService::singleShot(
+	const sc::time              time_ms,
+	const std::weak_ptr<void> & owner,
+	std::function<void()>       callback)
+{
+	singleShot(time_ms, [owner, callback = std::move(callback)]()
+	{
+		if (!owner.expired())
+		{
+			callback();
+		}
+	});
+}
+
+void TimerService::expire()
+{
+	size_t fired = 0;
+
+	expiring = true;
+	do
+	{
+		if (use_virtual)
+		{
+			// Jump to the next deadline. This may only cascade timers.
+			virtual_now = std::max(virtual_now, wheel.nextDeadline().value_or(virtual_now));
+		}
+
+		fired = wheel.advance(now(), [this](const Handle handle)
+		{
+			// Copy since the statechart may destroy its timer.
+			const TimeEvent time_event = events[handle];
+
+			if (time_event.callback)
+			{
+				events[handle] = TimeEvent();
+				wheel.destroy(handle);
+				time_event.callback();
+			}
+			else
+			{
+				if (TraceRecorder::instance().isOpen())
+				{
+					StatechartTracer::instance().timeout(
+						dynamic_cast<const QObject *>(time_event.statemachine.get()), time_event.event);
+				}
+				time_event.statemachine->raiseTimeEvent(time_event.event);
+			}
+		});
+	}
+	while (use_virtual && (fired == 0) && wheel.nextDeadline().has_value());
+	expiring = false;
+	schedule();
+}
+
+Handle TimerService::getTimer(
 	std::shared_ptr<TimedInterface> & statemachine,
 	sc::eventid                       event)
 {
 	Q_ASSERT(statemachine);
 
-	TimerKey   key{ statemachine.get(), event };
-	QTimer  *  timer = nullptr;
+	const TimerKey key{ statemachine.get(), event };
+	const auto     it = chart_map.find(key);
+
+	if (it != chart_map.end())
+	{
+		return *it;
+	}
+
+	const Handle handle = wheel.create();
 
-	if (chart_map.contains(key))
+	if (handle >= events.size())
 	{
-		timer = chart_map[key];
+		events.resize(handle + 1);
 	}
-	else
+	events[handle] = TimeEvent{ statemachine, event };
+	chart_map.insert(key, handle);
+
+	return handle;
+}
+
+void TimerService::schedule()
+{
+	if (expiring)
 	{
-		timer = new QTimer(this);
+		// Rescheduled once after all due time events are raised.
+		return;
+	}
+
+	const std::optional<uint64_t> deadline = wheel.nextDeadline();
 
-		chart_map.insert(key, timer);
-		connect(timer, &QTimer::timeout, [statemachine, event]()
+	if (!deadline.has_value())
+	{
+		timer.stop();
+	}
+	else if (use_virtual)
+	{
+		// Wake up after all pending events are processed.
+		if (!timer.isActive())
 		{
-			statemachine->raiseTimeEvent(event);
-		});
+			scheduled = *deadline;
+			timer.start(0);
+		}
+	}
+	else if (!timer.isActive() || (*deadline != scheduled))
+	{
+		const uint64_t current = now();
+
+		scheduled = *deadline;
+		timer.start(std::chrono::milliseconds(scheduled > current ? scheduled - current : 0));
 	}
-	Q_ASSERT(timer != nullptr);
-	return timer;
+}
+
+uint64_t TimerService::now() const
+{
+	return use_virtual ? virtual_now : uint64_t(clock.elapsed() + clock_offset);
 }
@@ -9,23 +9,41 @@
 #define MRW_STATECHART_TIMERSERVICE_H
 
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QHash>
 
 #include <util/self.h>
 #include <util/singleton.h>
+#include <util/timerwheel.h>
 
 #include <statecharts/common/sc_timer.h>
 
 namespace mrw::statechart
 {
 	/**
-	 * This class simply implements an example statemachine for testing the
-	 * C++ timer service. It is implemented as singleton.
+	 * This class implements the timer service of all statecharts. It is
+	 * implemented as singleton.
+	 *
+	 * All time events are managed by one mrw::util::TimerWheel with a
+	 * resolution of one millisecond. A single precise QTimer wakes up at
+	 * the next deadline of the wheel so the amount of timers registered at
+	 * the Qt event dispatcher does not depend on the amount of
+	 * statecharts.
+	 *
+	 * In virtual time mode the service does not use the wall clock. As
+	 * soon as the Qt event loop has processed all pending events the
+	 * service time jumps straight to the next deadline and the due time
+	 * events are raised. So a scenario runs as fast as possible while the
+	 * order of the time events is the same as using the wall clock.
 	 *
 	 * @see mrw::util::Singleton
+	 * @see mrw::util::TimerWheel
 	 */
 	class TimerService :
 		public QObject,
@@ -44,6 +62,72 @@ namespace mrw::statechart
 			return self;
 		}
 
+		/**
+		 * This method switches between wall clock time and virtual time.
+		 * The service time continues from the current time so running
+		 * timers keep their remaining delays.
+		 *
+		 * @param enable True if virtual time should be used.
+		 */
+		void setVirtualTime(const bool enable);
+
+		/**
+		 * This method returns true if the service uses virtual time.
+		 *
+		 * @return True if using virtual time.
+		 */
+		[[nodiscard]]
+		bool isVirtualTime() const noexcept;
+
+		/**
+		 * This method calls the given function once after the given delay
+		 * using the service time. It replaces QTimer::singleShot() for
+		 * code which should follow the virtual time mode.
+		 *
+		 * @param time_ms The delay in milliseconds.
+		 * @param callback The function to call after the delay.
+		 */
+		void singleShot(const sc::time time_ms, std::function<void()> callback);
+
+		/**
+		 * This method calls the given function once after the given delay
+		 * if the owner still exists. An owner which may be destroyed
+		 * before its pending callbacks expire passes a weak reference to
+		 * a shared token it owns.
+		 *
+		 * @param time_ms The delay in milliseconds.
+		 * @param owner The token of the owner.
+		 * @param callback The function to call after the delay.
+		 */
+		void singleShot(
+			const sc::time              time_ms,
+			const std::weak_ptr<void> & owner,
+			std::function<void()>       callback);
+
+		/**
+		 * This method returns the milliseconds since the service started.
+		 * In virtual time mode this is the virtual time.
+		 *
+		 * @return The current service time in milliseconds.
+		 */
+		[[nodiscard]]
+		uint64_t now() const;
+
+		/**
+		 * This method returns the statistics of the underlying timer wheel
+		 * containing the amount of active timers and the histograms of the
+		 * expiry lateness and the timer count.
+		 *
+		 * @return The timer wheel statistics.
+		 */
+		[[nodiscard]]
+		const mrw::util::TimerWheel::Statistics & statistics() const noexcept;
+
+		/**
+		 * This method logs the timer statistics.
+		 */
+		void info() const;
+
 	private:
 		TimerService();
 
@@ -59,6 +143,13 @@ namespace mrw::statechart
 			sc::timer::TimedInterface * statemachine,
 			sc::eventid                 event) override;
 
+	private slots:
+		/**
+		 * This slot expires all due time events and reschedules the
+		 * QTimer.
+		 */
+		void expire();
+
 	private:
 		/**
 		 * This method lookups a timer for a specified statemachine. If the
@@ -66,29 +157,73 @@ namespace mrw::statechart
 		 *
 		 * @param machine The statechart which owns the timer.
 		 * @param event The timer ID of that statechart.
-		 * @return The QTimer instance.
+		 * @return The timer wheel handle.
 		 */
 		[[nodiscard]]
-		QTimer * getTimer(
+		mrw::util::TimerWheel::Handle getTimer(
 			std::shared_ptr<sc::timer::TimedInterface> & statemachine,
 			sc::eventid                                  event);
 
 		/**
-		 * This is the two dimensional key for finding a QTimer instance.
+		 * This method starts the QTimer at the next deadline of the timer
+		 * wheel or stops it if no time event is pending.
+		 */
+		void schedule();
+
+		/**
+		 * This is the two dimensional key for finding a timer.
 		 */
 		typedef std::pair<sc::timer::TimedInterface *, sc::eventid> TimerKey;
 
 		/**
-		 * This defines a map from a two dimensional key to a concrete
-		 * QTimer instance.
+		 * This defines a map from a two dimensional key to a timer wheel
+		 * handle.
 		 */
-		typedef QHash<TimerKey, QTimer *>                           TimerMap;
+		typedef QHash<TimerKey, mrw::util::TimerWheel::Handle>      TimerMap;
+
+		/**
+		 * The time event to raise on expiry of a timer wheel handle. A
+		 * single shot timer uses a callback instead of a statechart.
+		 */
+		struct TimeEvent
+		{
+			std::shared_ptr<sc::timer::TimedInterface> statemachine;
+			sc::eventid                                event = 0;
+			std::function<void()>                      callback;
+		};
 
 		/**
 		 * The map from all statemachines and their IDs to all existing timers.
 		 */
 		TimerMap                                                    chart_map;
 
+		/** The time events indexed by their timer wheel handle. */
+		std::vector<TimeEvent>                                      events;
+
+		/** The timer wheel containing all time events. */
+		mrw::util::TimerWheel                                       wheel;
+
+		/** The single QTimer waking up at the next deadline. */
+		QTimer                                                      timer;
+
+		/** The time base of the timer wheel. */
+		QElapsedTimer                                               clock;
+
+		/** The offset of the wall clock to the service time. */
+		int64_t                                                     clock_offset = 0;
+
+		/** The virtual time in milliseconds. */
+		uint64_t                                                    virtual_now  = 0;
+
+		/** True if virtual time is used. */
+		bool                                                        use_virtual  = false;
+
+		/** The deadline the QTimer is scheduled for. */
+		uint64_t                                                    scheduled = 0;
+
+		/** True while raising the due time events. */
+		bool                                                        expiring  = false;
+
 		/** This instance as shared pointer. */
 		std::shared_ptr<TimerServiceInterface>                      self;
 	};
@@ -11,8 +11,10 @@ include(../common.pri)
 SOURCES += \
 	collections.cpp \
 	main.cpp \
+	testbussimulator.cpp \
 	testcan.cpp \
 	testcanservice.cpp \
+	testconfigpipeline.cpp \
 	testcrossing.cpp \
 	testdoublecrossswitchwidget.cpp \
 	testflankswitch.cpp \
@@ -21,18 +23,31 @@ SOURCES += \
 	testnumbering.cpp \
 	testrailwidget.cpp \
 	testregularswitchwidget.cpp \
+	testreplay.cpp \
 	testrouting.cpp \
 	testsignalwidget.cpp \
 	testunknown.cpp \
 	testswitch.cpp \
 	testlight.cpp \
-	testutil.cpp
+	testtimerservice.cpp \
+	testtrainengine.cpp \
+	testutil.cpp \
+	../track-control/log.cpp \
+	../track-control/mrwmessagedispatcher.cpp \
+	../track-control/ctrl/controllerregistrand.cpp \
+	../track-control/ctrl/controllerregistry.cpp \
+	../tools/config/configpipeline.cpp \
+	../tools/replay/recording.cpp \
+	../tools/sim/bussimulator.cpp \
+	../tools/tracker/trainengine.cpp
 
 HEADERS += \
 	collections.h \
 	testbase.h \
+	testbussimulator.h \
 	testcan.h \
 	testcanservice.h \
+	testconfigpipeline.h \
 	testcrossing.h \
 	testdef.h \
 	testdoublecrossswitchwidget.h \
@@ -42,14 +57,25 @@ HEADERS += \
 	testnumbering.h \
 	testrailwidget.h \
 	testregularswitchwidget.h \
+	testreplay.h \
 	testroute.h \
 	testrouting.h \
 	testsignalwidget.h \
 	testunknown.h \
 	testswitch.h \
 	testlight.h \
-	testutil.h
+	testtimerservice.h \
+	testtrainengine.h \
+	testutil.h \
+	../track-control/mrwmessagedispatcher.h \
+	../track-control/ctrl/controllerregistry.h \
+	../tools/config/configpipeline.h \
+	../tools/replay/recording.h \
+	../tools/sim/bussimulator.h \
+	../tools/tracker/trainengine.h
 
-LIBS            += -lMRW-UI -lMRW-Ctrl -lMRW-CtrlMock -lMRW-Model -lMRW-Can -lMRW-Util
+INCLUDEPATH     += ../track-control ../tools/config ../tools/replay ../tools/sim ../tools/tracker
+
+LIBS            += -lMRW-UI -lMRW-Ctrl -lMRW-CtrlMock -lMRW-Model -lMRW-Can -lMRW-Statecharts -lMRW-Log -lMRW-Util
 
 QMAKE_CLEAN     += $$TARGET qtest*.xml
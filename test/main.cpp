@@ -9,10 +9,17 @@
 
 #include <util/stringutil.h>
 #include <util/clockservice.h>
+#include <util/appsupport.h>
+#include <util/settings.h>
+#include <statecharts/timerservice.h>
 
 #include "testutil.h"
 #include "testcan.h"
 #include "testcanservice.h"
+#include "testbussimulator.h"
+#include "testconfigpipeline.h"
+#include "testtrainengine.h"
+#include "testreplay.h"
 #include "testmodel.h"
 #include "testswitch.h"
 #include "testlight.h"
@@ -21,6 +28,7 @@
 #include "testunknown.h"
 #include "testrouting.h"
 #include "testcrossing.h"
+#include "testtimerservice.h"
 
 #include "testrailwidget.h"
 #include "testsignalwidget.h"
@@ -30,6 +38,8 @@
 using namespace mrw::test;
 using namespace mrw::util;
 
+using mrw::statechart::TimerService;
+
 static int testUtil()
 {
 	TestUtil    test;
@@ -63,6 +73,50 @@ static int testCanService()
 	return QTest::qExec(&test, args);
 }
 
+static int testBusSimulator()
+{
+	TestBusSimulator test;
+	QStringList      args
+	{
+		"MRW-Test", "-o", "qtest-bussimulator.xml", "-xml"
+	};
+
+	return QTest::qExec(&test, args);
+}
+
+static int testConfigPipeline()
+{
+	TestConfigPipeline test;
+	QStringList        args
+	{
+		"MRW-Test", "-o", "qtest-configpipeline.xml", "-xml"
+	};
+
+	return QTest::qExec(&test, args);
+}
+
+static int testTrainEngine()
+{
+	TestTrainEngine test;
+	QStringList     args
+	{
+		"MRW-Test", "-o", "qtest-trainengine.xml", "-xml"
+	};
+
+	return QTest::qExec(&test, args);
+}
+
+static int testReplay()
+{
+	TestReplay  test;
+	QStringList args
+	{
+		"MRW-Test", "-o", "qtest-replay.xml", "-xml"
+	};
+
+	return QTest::qExec(&test, args);
+}
+
 static int testModel()
 {
 	TestModel   test("Test-Railway");
@@ -151,6 +205,17 @@ static int testCrossing()
 	return QTest::qExec(&test, args);
 }
 
+static int testTimerService()
+{
+	TestTimerService test;
+	QStringList      args
+	{
+		"MRW-Test", "-o", "qtest-timerservice.xml", "-xml"
+	};
+
+	return QTest::qExec(&test, args);
+}
+
 static int testRailWidget()
 {
 	TestRailWidget  test;
@@ -195,15 +260,30 @@ static int testRegularSwitchWidget()
 	return QTest::qExec(&test, args);
 }
 
+static void initTimerService()
+{
+	Settings      settings("test");
+	SettingsGroup group (&settings, AppSupport::instance().hostname());
+
+	// Run the statechart timers of all tests in virtual time if configured.
+	TimerService::instance().setVirtualTime(settings.value("virtualtime", false).toBool());
+}
+
 int main(int argc, char * argv[])
 {
 	QApplication  app(argc, argv);
 
 	int status = 0;
 
+	initTimerService();
+
 	status += testUtil();
 	status += testCan();
 	status += testCanService();
+	status += testBusSimulator();
+	status += testConfigPipeline();
+	status += testTrainEngine();
+	status += testReplay();
 	status += testModel();
 	status += testSimpleSwitch();
 	status += testSimpleLight();
@@ -212,6 +292,7 @@ int main(int argc, char * argv[])
 	status += testFlankSwitch();
 	status += testRouting();
 	status += testCrossing();
+	status += testTimerService();
 
 	status += testRailWidget();
 	status += testSignalWidget();
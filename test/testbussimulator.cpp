@@ -0,0 +1,212 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QCanBusDevice>
+#include <QList>
+#include <QTest>
+
+#include "can/mrwbusservice.h"
+#include "can/mrwmessage.h"
+#include "util/appsupport.h"
+#include "util/settings.h"
+#include "bussimulator.h"
+
+#include "testbussimulator.h"
+
+using namespace mrw::test;
+using namespace mrw::can;
+using namespace mrw::util;
+
+using Distribution = BusSimulator::Distribution;
+using Latency      = BusSimulator::Latency;
+
+/*************************************************************************
+**                                                                      **
+**       Test implementation of MrwBusService                           **
+**                                                                      **
+*************************************************************************/
+
+class CaptureBusService : public MrwBusService
+{
+	QList<MrwMessage> messages;
+
+public:
+	explicit CaptureBusService(
+		const QString & iface,
+		const QString & plugin) :
+		MrwBusService(iface, plugin, nullptr, false)
+	{
+		can_device->setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, true);
+		connectDevice();
+	}
+
+	void process(const MrwMessage & message) override
+	{
+		messages.append(message);
+	}
+
+	int counted() const
+	{
+		return messages.size();
+	}
+
+	const QList<MrwMessage> & list() const
+	{
+		return messages;
+	}
+};
+
+/*************************************************************************
+**                                                                      **
+**       Test class                                                     **
+**                                                                      **
+*************************************************************************/
+
+TestBusSimulator::TestBusSimulator(QObject * parent) : QObject(parent)
+{
+	Settings      settings("test");
+	SettingsGroup group (&settings, AppSupport::instance().hostname());
+
+	can_iface  = settings.value("interface", "vcan0").toString();
+	can_plugin = settings.value("plugin",    "socketcan").toString();
+}
+
+void TestBusSimulator::testLatencyParse()
+{
+	bool    ok = false;
+	Latency latency;
+
+	latency = Latency::parse("fixed:2", ok);
+	QVERIFY(ok);
+	QCOMPARE(latency.distribution, Distribution::FIXED);
+	QCOMPARE(latency.first, 2.0);
+
+	latency = Latency::parse("uniform:2:8", ok);
+	QVERIFY(ok);
+	QCOMPARE(latency.distribution, Distribution::UNIFORM);
+	QCOMPARE(latency.first,  2.0);
+	QCOMPARE(latency.second, 8.0);
+
+	latency = Latency::parse(" Normal:5.5:1.5", ok);
+	QVERIFY(ok);
+	QCOMPARE(latency.distribution, Distribution::NORMAL);
+	QCOMPARE(latency.first,  5.5);
+	QCOMPARE(latency.second, 1.5);
+
+	latency = Latency::parse("exponential:3", ok);
+	QVERIFY(ok);
+	QCOMPARE(latency.distribution, Distribution::EXPONENTIAL);
+	QCOMPARE(latency.first, 3.0);
+
+	// The string representation can be read back.
+	for (const QString & input : { "fixed:0.5", "uniform:1:4", "normal:3:0.25", "exponential:7" })
+	{
+		const Latency parsed = Latency::parse(input, ok);
+
+		QVERIFY(ok);
+		QCOMPARE(parsed.toString(), input);
+	}
+}
+
+void TestBusSimulator::testLatencyMalformed()
+{
+	static const QStringList inputs
+	{
+		"",
+		":1",
+		"gauss:1",
+		"fixed:abc",
+		"fixed:-1",
+		"fixed:1:x",
+		"uniform:8:2",
+		"uniform:1:2:3",
+		"normal:5",
+		"normal:5:0",
+		"exponential:0",
+		"exponential:-2"
+	};
+
+	const Latency fallback;
+
+	for (const QString & input : inputs)
+	{
+		bool          ok     = true;
+		const Latency result = Latency::parse(input, ok);
+
+		QVERIFY2(!ok, qPrintable(input));
+		QCOMPARE(result.distribution, fallback.distribution);
+		QCOMPARE(result.first,        fallback.first);
+		QCOMPARE(result.second,       fallback.second);
+	}
+}
+
+void TestBusSimulator::testPriority()
+{
+	// A lower base identifier wins.
+	QVERIFY(BusSimulator::priority(MrwMessage(GETVER, 5)) <
+		BusSimulator::priority(MrwMessage(GETVER, 6)));
+
+	// A basic frame wins against an extended frame with the same base
+	// identifier.
+	QVERIFY(BusSimulator::priority(MrwMessage(GETVER, 5)) <
+		BusSimulator::priority(MrwMessage(SETLFT, 5, 1)));
+
+	// The base identifier is compared before the frame format.
+	QVERIFY(BusSimulator::priority(MrwMessage(SETLFT, 4, 0x3ff)) <
+		BusSimulator::priority(MrwMessage(GETVER, 5)));
+
+	// The identifier extension decides between extended frames.
+	QVERIFY(BusSimulator::priority(MrwMessage(SETLFT, 5, 1)) <
+		BusSimulator::priority(MrwMessage(SETLFT, 5, 2)));
+
+	// Responses addressing the gateway win against all requests and the
+	// lower controller ID wins between responses.
+	QVERIFY(BusSimulator::priority(MrwMessage(100, 1, GETVER, Response::MSG_OK)) <
+		BusSimulator::priority(MrwMessage(GETVER, 1)));
+	QVERIFY(BusSimulator::priority(MrwMessage(3, 1, GETVER, Response::MSG_OK)) <
+		BusSimulator::priority(MrwMessage(7, 1, GETVER, Response::MSG_OK)));
+}
+
+void TestBusSimulator::testArbitration()
+{
+	static const std::vector<ControllerId> ids{ 20, 5, 12 };
+
+	CaptureBusService     service(can_iface, can_plugin);
+	BusSimulator::Options options;
+	bool                  delivered = false;
+
+	QTest::qWait(50);
+	QVERIFY(service.valid());
+
+	options.enabled = true;
+	options.latency = Latency{ Distribution::FIXED, 0.0, 0.0 };
+
+	BusSimulator simulator(service, options);
+
+	// The host request occupies the bus while all responses get ready.
+	simulator.request(MrwMessage(GETVER, CAN_BROADCAST_ID), [&]()
+	{
+		delivered = true;
+	});
+	for (const ControllerId id : ids)
+	{
+		simulator.respond(id, MrwMessage(id, NO_UNITNO, GETVER, Response::MSG_OK));
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(service.counted(), int(ids.size()), 2000);
+	QVERIFY(delivered);
+
+	const QList<MrwMessage> & list = service.list();
+
+	QCOMPARE(list.at(0).eid(), ControllerId(5));
+	QCOMPARE(list.at(1).eid(), ControllerId(12));
+	QCOMPARE(list.at(2).eid(), ControllerId(20));
+
+	const BusSimulator::Statistics & statistics = simulator.statistics();
+
+	QCOMPARE(statistics.requests,   uint64_t(1));
+	QCOMPARE(statistics.responses,  uint64_t(ids.size()));
+	QCOMPARE(statistics.peak_queue, ids.size() + 1);
+}
@@ -0,0 +1,33 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_TEST_TESTBUSSIMULATOR_H
+#define MRW_TEST_TESTBUSSIMULATOR_H
+
+#include <QObject>
+
+namespace mrw::test
+{
+	class TestBusSimulator : public QObject
+	{
+		Q_OBJECT
+
+		QString can_iface;
+		QString can_plugin;
+
+	public:
+		explicit TestBusSimulator(QObject * parent = nullptr);
+
+	private slots:
+		void testLatencyParse();
+		void testLatencyMalformed();
+		void testPriority();
+		void testArbitration();
+	};
+}
+
+#endif
@@ -3,11 +3,15 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <vector>
+
 #include <QCanBusFrame>
 #include <QTest>
 #include <QList>
 
 #include "can/mrwmessage.h"
+#include "can/occupationcoalescer.h"
+#include "can/wiremessage.h"
 
 #include "testbase.h"
 #include "testcan.h"
@@ -352,3 +356,215 @@ void TestCan::testCopyResponse()
 		}
 	}
 }
+
+void TestCan::testWireMessage()
+{
+	static constexpr WireMessage broadcast(PING);
+	static constexpr WireMessage command(SETLFT, TEST_CTRL_ID, TEST_UNIT_NO);
+	static constexpr WireMessage response(TEST_CTRL_ID, TEST_UNIT_NO, SETLFT, Response::MSG_OK);
+
+	// Encoding and decoding is available at compile time.
+	static_assert(broadcast.valid());
+	static_assert(broadcast.sid()     == CAN_BROADCAST_ID);
+	static_assert(broadcast.eid()     == NO_UNITNO);
+	static_assert(command.frameId()   == TEST_ID);
+	static_assert(command.unitNo()    == TEST_UNIT_NO);
+	static_assert(command.command()   == SETLFT);
+	static_assert(response.isResponse());
+	static_assert(response.sid()      == CAN_GATEWAY_ID);
+	static_assert(response.eid()      == TEST_CTRL_ID);
+	static_assert(response.unitNo()   == TEST_UNIT_NO);
+	static_assert(response.response() == Response::MSG_OK);
+	static_assert(!WireMessage().valid());
+
+	for (const WireMessage & wire : { broadcast, command, response })
+	{
+		const QCanBusFrame frame(wire);
+		const WireMessage  decoded(frame);
+		const MrwMessage   message(wire);
+		const QCanBusFrame converted(message);
+
+		QCOMPARE(frame.frameId(),               wire.frameId());
+		QCOMPARE(frame.hasExtendedFrameFormat(), wire.isExtended());
+		QCOMPARE(decoded.frameId(),             wire.frameId());
+		QCOMPARE(decoded.length(),              wire.length());
+		QCOMPARE(decoded.command(),             wire.command());
+		QCOMPARE(decoded.response(),            wire.response());
+		QCOMPARE(decoded.unitNo(),              wire.unitNo());
+
+		QCOMPARE(message.sid(),      wire.sid());
+		QCOMPARE(message.eid(),      wire.eid());
+		QCOMPARE(message.command(),  wire.command());
+		QCOMPARE(message.response(), wire.response());
+		QCOMPARE(message.unitNo(),   wire.unitNo());
+		QCOMPARE(converted.frameId(), frame.frameId());
+		QCOMPARE(converted.payload(), frame.payload());
+		QCOMPARE(wire.toString(),     message.toString());
+	}
+
+	WireMessage signal(SETSGN, TEST_CTRL_ID, TEST_UNIT_NO);
+
+	QVERIFY(signal.append(std::underlying_type_t<SignalAspect>(SignalAspect::SIGNAL_HP0)));
+	QVERIFY(signal.toString().contains("Hp0"));
+	QCOMPARE(MrwMessage(signal).size(), size_t(1));
+	QVERIFY(MrwMessage(signal).wire().length() == signal.length());
+}
+
+void TestCan::testWireTransmissionTime()
+{
+	static constexpr WireMessage command(SETLFT, TEST_CTRL_ID, TEST_UNIT_NO);
+	static constexpr WireMessage response(TEST_CTRL_ID, TEST_UNIT_NO, SETLFT, Response::MSG_OK);
+
+	// 54 + 8 bits data + 15 stuff bits + 13 bits trailer at 125 kbit/s.
+	static_assert(command.length() == 1);
+	static_assert(command.transmissionTime(125000) == 720);
+
+	// 54 + 32 bits data + 21 stuff bits + 13 bits trailer.
+	static_assert(response.length() == 4);
+	QCOMPARE(response.transmissionTime(125000), uint64_t(960));
+	QCOMPARE(response.transmissionTime(1000000), uint64_t(120));
+	QCOMPARE(response.transmissionTime(1000001), uint64_t(120));
+}
+
+MrwMessage TestCan::occupation(const UnitNo no, const bool occupied)
+{
+	MrwMessage message(TEST_CTRL_ID, no, GETRBS, Response::MSG_OK);
+
+	message.append(occupied);
+	return message;
+}
+
+void TestCan::testCoalesceIdentical()
+{
+	QList<MrwMessage>   delivered;
+	unsigned            scheduled = 0;
+	OccupationCoalescer coalescer([&](const MrwMessage & message)
+	{
+		delivered.append(message);
+	}, [&]()
+	{
+		scheduled++;
+	});
+
+	QVERIFY(OccupationCoalescer::isOccupation(occupation(1, true)));
+	QVERIFY(!OccupationCoalescer::isOccupation(MrwMessage(TEST_CTRL_ID, 1, GETRBS, Response::MSG_OK)));
+
+	coalescer.process(occupation(1, true));
+	coalescer.process(occupation(1, true));
+	coalescer.process(occupation(1, true));
+	coalescer.process(occupation(2, false));
+	coalescer.process(occupation(2, false));
+
+	QCOMPARE(scheduled, 1u);
+	QCOMPARE(coalescer.pending(), size_t(2));
+	QVERIFY(delivered.isEmpty());
+
+	coalescer.flush();
+	QCOMPARE(coalescer.pending(), size_t(0));
+	QCOMPARE(delivered.size(), 2);
+	QCOMPARE(delivered.at(0).unitNo(), UnitNo(1));
+	QCOMPARE(delivered.at(1).unitNo(), UnitNo(2));
+	QCOMPARE(coalescer.statistics().coalesced, uint64_t(3));
+	QCOMPARE(coalescer.statistics().delivered, uint64_t(2));
+
+	// A section without pending occupation is delivered again.
+	coalescer.process(occupation(1, true));
+	QCOMPARE(scheduled, 2u);
+	QCOMPARE(coalescer.pending(), size_t(1));
+}
+
+void TestCan::testCoalesceAlternating()
+{
+	QList<MrwMessage>   delivered;
+	OccupationCoalescer coalescer([&](const MrwMessage & message)
+	{
+		delivered.append(message);
+	}, []()
+	{
+	});
+	const std::vector<MrwMessage> messages
+	{
+		occupation(1, true),
+		occupation(1, false),
+		occupation(2, true),
+		occupation(1, true),
+		occupation(2, false)
+	};
+
+	for (const MrwMessage & message : messages)
+	{
+		coalescer.process(message);
+	}
+	coalescer.flush();
+
+	QCOMPARE(size_t(delivered.size()), messages.size());
+	for (size_t i = 0; i < messages.size(); i++)
+	{
+		QCOMPARE(delivered.at(i).unitNo(), messages[i].unitNo());
+		QCOMPARE(delivered.at(i)[0],       messages[i][0]);
+	}
+	QCOMPARE(coalescer.statistics().coalesced, uint64_t(0));
+	QCOMPARE(coalescer.statistics().delivered, uint64_t(messages.size()));
+}
+
+void TestCan::testCoalesceFlushOrder()
+{
+	QList<MrwMessage>   delivered;
+	OccupationCoalescer coalescer([&](const MrwMessage & message)
+	{
+		delivered.append(message);
+	}, []()
+	{
+	});
+	const MrwMessage    other(TEST_CTRL_ID, TEST_UNIT_NO, SETLFT, Response::MSG_OK);
+
+	coalescer.process(occupation(1, true));
+	coalescer.process(occupation(2, true));
+	coalescer.process(other);
+
+	// The non occupation message flushed the pending occupations first.
+	QCOMPARE(coalescer.pending(), size_t(0));
+	QCOMPARE(delivered.size(), 3);
+	QCOMPARE(delivered.at(0).unitNo(),  UnitNo(1));
+	QCOMPARE(delivered.at(1).unitNo(),  UnitNo(2));
+	QCOMPARE(delivered.at(2).command(), SETLFT);
+	QCOMPARE(coalescer.statistics().coalesced, uint64_t(0));
+	QCOMPARE(coalescer.statistics().delivered, uint64_t(2));
+}
+
+void TestCan::testCoalesceReentrant()
+{
+	QList<MrwMessage>     delivered;
+	unsigned              scheduled = 0;
+	OccupationCoalescer * pointer   = nullptr;
+	OccupationCoalescer   coalescer([&](const MrwMessage & message)
+	{
+		delivered.append(message);
+		if (delivered.size() == 1)
+		{
+			// Appended while flushing.
+			pointer->process(occupation(3, true));
+			pointer->process(occupation(1, false));
+			pointer->process(occupation(2, true));
+		}
+	}, [&]()
+	{
+		scheduled++;
+	});
+
+	pointer = &coalescer;
+	coalescer.process(occupation(1, true));
+	coalescer.process(occupation(2, true));
+	coalescer.flush();
+
+	QCOMPARE(scheduled, 1u);
+	QCOMPARE(coalescer.pending(), size_t(0));
+	QCOMPARE(delivered.size(), 4);
+	QCOMPARE(delivered.at(0).unitNo(), UnitNo(1));
+	QCOMPARE(delivered.at(1).unitNo(), UnitNo(2));
+	QCOMPARE(delivered.at(2).unitNo(), UnitNo(3));
+	QCOMPARE(delivered.at(3).unitNo(), UnitNo(1));
+	QCOMPARE(delivered.at(3)[0],       uint8_t(false));
+	QCOMPARE(coalescer.statistics().coalesced, uint64_t(1));
+	QCOMPARE(coalescer.statistics().delivered, uint64_t(4));
+}
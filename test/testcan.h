@@ -46,6 +46,17 @@ namespace mrw::test
 		void testResponsePayload();
 		void testCopyRequest();
 		void testCopyResponse();
+		void testWireMessage();
+		void testWireTransmissionTime();
+		void testCoalesceIdentical();
+		void testCoalesceAlternating();
+		void testCoalesceFlushOrder();
+		void testCoalesceReentrant();
+
+	private:
+		static mrw::can::MrwMessage occupation(
+			const mrw::can::UnitNo no,
+			const bool             occupied);
 	};
 }
 
@@ -3,20 +3,27 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <chrono>
+
 #include <QCanBusFrame>
+#include <QFile>
 #include <QTest>
 #include <QSignalSpy>
 #include <QList>
 
 #include "can/mrwbusservice.h"
 #include "can/mrwmessage.h"
+#include "model/modelrailway.h"
 #include "util/appsupport.h"
 #include "util/settings.h"
+#include "mrwmessagedispatcher.h"
 
 #include "testcanservice.h"
 
 using namespace mrw::test;
 using namespace mrw::can;
+using namespace mrw::model;
 using namespace mrw::util;
 
 /*************************************************************************
@@ -66,6 +73,74 @@ public:
 	}
 };
 
+class ThreadedCanService : public MrwBusService
+{
+	QList<MrwMessage> messages;
+
+public:
+	explicit ThreadedCanService(
+		const QString & iface,
+		const QString & plugin) :
+		MrwBusService(iface, plugin, nullptr, false, true)
+	{
+		// The CAN device lives in the I/O thread.
+		QMetaObject::invokeMethod(can_device, [this] ()
+		{
+			can_device->setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, true);
+		}, Qt::BlockingQueuedConnection);
+
+		connectDevice();
+	}
+
+	void disconnect()
+	{
+		disconnectDevice();
+	}
+
+	void process(const MrwMessage & message) override
+	{
+		MrwBusService::process(message);
+		messages.append(message);
+	}
+
+	int counted() const
+	{
+		return messages.size();
+	}
+};
+
+class CaptureDispatcher : public MrwMessageDispatcher
+{
+	QList<MrwMessage> messages;
+
+public:
+	explicit CaptureDispatcher(
+		ModelRailway  * model_railway,
+		const QString & iface,
+		const QString & plugin) :
+		MrwMessageDispatcher(model_railway, iface, plugin)
+	{
+		can_device->setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, true);
+		connectDevice();
+	}
+
+	void process(const MrwMessage & message) override
+	{
+		// Only record the own frames in their transmission order.
+		messages.append(message);
+	}
+
+	int counted() const
+	{
+		return messages.size();
+	}
+
+	const QList<MrwMessage> & list() const
+	{
+		return messages;
+	}
+};
+
 /*************************************************************************
 **                                                                      **
 **       Test class                                                     **
@@ -155,3 +230,193 @@ void TestCanService::testReadWrite()
 	QCOMPARE(message.sid(),      CAN_BROADCAST_ID);
 	QCOMPARE(message.eid(),      NO_UNITNO);
 }
+
+void TestCanService::testThreadedReadWrite()
+{
+	static constexpr int COUNT = 16;
+
+	ThreadedCanService service(can_iface, can_plugin);
+
+	QVERIFY(service.isThreaded());
+	QTest::qWait(50);
+	QVERIFY(service.valid());
+
+	for (int i = 0; i < COUNT; i++)
+	{
+		QVERIFY(service.write(MrwMessage(PING)));
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(service.counted(), COUNT, 2000);
+
+	const MrwBusService::Statistics & statistics = service.statistics();
+
+	QCOMPARE(statistics.tx_sent,    uint64_t(COUNT));
+	QCOMPARE(statistics.tx_dropped, uint64_t(0));
+	QCOMPARE(statistics.rx_dropped, uint64_t(0));
+	QCOMPARE(statistics.rx_depth,   size_t(0));
+	QCOMPARE(statistics.tx_depth,   size_t(0));
+
+	service.disconnect();
+	QVERIFY(!service.valid());
+	QVERIFY(!service.write(MrwMessage(PING)));
+}
+
+void TestCanService::testPriorityQueue()
+{
+	static constexpr int COUNT = 300;
+
+	QCOMPARE(MrwBusService::priorityOf(SETROF), MrwBusService::Priority::EMERGENCY);
+	QCOMPARE(MrwBusService::priorityOf(RESET),  MrwBusService::Priority::EMERGENCY);
+	QCOMPARE(MrwBusService::priorityOf(SETSGN), MrwBusService::Priority::CONTROL);
+	QCOMPARE(MrwBusService::priorityOf(PING),   MrwBusService::Priority::CONTROL);
+	QCOMPARE(MrwBusService::priorityOf(CFGRAI), MrwBusService::Priority::BULK);
+	QCOMPARE(MrwBusService::priorityOf(CFGEND), MrwBusService::Priority::BULK);
+
+	ManualCanService service(true, can_iface, can_plugin);
+
+	QTest::qWait(50);
+	QVERIFY(service.valid());
+
+	// A burst must not block and must not lose any frame.
+	for (int i = 0; i < COUNT; i++)
+	{
+		QVERIFY(service.write(MrwMessage(SETROF, i + 1)));
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(service.counted(), COUNT, 5000);
+
+	const MrwBusService::Statistics & statistics = service.statistics();
+
+	QCOMPARE(statistics.tx_queued,  uint64_t(COUNT));
+	QCOMPARE(statistics.tx_sent,    uint64_t(COUNT));
+	QCOMPARE(statistics.tx_dropped, uint64_t(0));
+	QCOMPARE(statistics.tx_depth,   size_t(0));
+
+	// The emergency frame queued last overtakes all queued frames and
+	// control frames overtake bulk frames.
+	static constexpr int QUEUED = 4;
+
+	{
+		MrwBusService::Burst burst(&service);
+
+		for (int i = 0; i < QUEUED; i++)
+		{
+			QVERIFY(service.write(MrwMessage(CFGRAI, 1, i + 1)));
+			QVERIFY(service.write(MrwMessage(SETSGN, 1, i + 1)));
+		}
+		QVERIFY(service.write(MrwMessage(SETROF, 2)));
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(service.counted(), COUNT + 2 * QUEUED + 1, 2000);
+
+	const QList<MrwMessage> & list = service.list();
+
+	QCOMPARE(list.at(COUNT).command(), SETROF);
+	for (int i = 0; i < QUEUED; i++)
+	{
+		QCOMPARE(list.at(COUNT + 1 + i).command(),          SETSGN);
+		QCOMPARE(list.at(COUNT + 1 + QUEUED + i).command(), CFGRAI);
+	}
+}
+
+void TestCanService::testEmergencyStop()
+{
+	static constexpr int QUEUED = 4;
+
+	QString filename("Test-Railway.modelrailway");
+
+	if (!QFile::exists(filename))
+	{
+		filename = "test/" + filename;
+	}
+
+	ModelRailway model(filename);
+	size_t       sections = 0;
+
+	for (size_t r = 0; r < model.regionCount(); r++)
+	{
+		const Region * region = model.region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			sections += Device::hasController(region->section(s));
+		}
+	}
+	QVERIFY(sections > 0);
+
+	CaptureDispatcher dispatcher(&model, can_iface, can_plugin);
+
+	QTest::qWait(50);
+	QVERIFY(dispatcher.valid());
+
+	const auto start = std::chrono::steady_clock::now();
+
+	{
+		MrwBusService::Burst burst(&dispatcher);
+
+		// Pending configuration and control traffic which must be
+		// overtaken.
+		for (int i = 0; i < QUEUED; i++)
+		{
+			QVERIFY(dispatcher.write(MrwMessage(CFGBGN, i + 1)));
+			QVERIFY(dispatcher.write(MrwMessage(SETSGN, 1, i + 1)));
+		}
+		dispatcher.emergencyStop();
+	}
+
+	const int total = int(sections) + 2 * QUEUED;
+
+	QTRY_COMPARE_WITH_TIMEOUT(dispatcher.counted(), total, 2000);
+
+	const auto                elapsed = std::chrono::steady_clock::now() - start;
+	const QList<MrwMessage> & list    = dispatcher.list();
+
+	for (int i = 0; i < int(sections); i++)
+	{
+		QCOMPARE(list.at(i).command(), SETROF);
+	}
+	for (int i = 0; i < QUEUED; i++)
+	{
+		QCOMPARE(list.at(int(sections) + i).command(),          SETSGN);
+		QCOMPARE(list.at(int(sections) + QUEUED + i).command(), CFGBGN);
+	}
+
+	qInfo("Emergency stop of %zu sections took %lld µs.", sections,
+		(long long)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+void TestCanService::testBurstWrite()
+{
+	ManualCanService service(true, can_iface, can_plugin);
+
+	QTest::qWait(50);
+	QVERIFY(service.valid());
+
+	{
+		MrwBusService::Burst burst(&service);
+
+		QVERIFY(service.write(MrwMessage(PING)));
+		QVERIFY(service.write(MrwMessage(SETROF, 1)));
+
+		// Nothing is transmitted until the burst ends.
+		QCOMPARE(service.statistics().tx_depth, size_t(2));
+		QCOMPARE(service.statistics().tx_sent,  uint64_t(0));
+	}
+	QCOMPARE(service.statistics().tx_sent, uint64_t(2));
+
+	const std::vector<MrwMessage> messages
+	{
+		MrwMessage(CFGBGN, 1),
+		MrwMessage(CFGRAI, 1, 1),
+		MrwMessage(CFGEND, 1)
+	};
+	bool results[3] = { false, false, false };
+
+	QCOMPARE(service.write(messages, results), size_t(3));
+	QVERIFY(results[0]);
+	QVERIFY(results[1]);
+	QVERIFY(results[2]);
+
+	QTRY_COMPARE_WITH_TIMEOUT(service.counted(), 5, 2000);
+	QCOMPARE(service.statistics().tx_sent, uint64_t(5));
+}
@@ -31,6 +31,10 @@ namespace mrw::test
 		void testInvalidService();
 		void testManualConnectService();
 		void testReadWrite();
+		void testThreadedReadWrite();
+		void testPriorityQueue();
+		void testEmergencyStop();
+		void testBurstWrite();
 	};
 }
 
@@ -0,0 +1,317 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QCanBusDevice>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTest>
+
+#include "can/mrwbusservice.h"
+#include "can/mrwmessage.h"
+#include "statecharts/timerservice.h"
+#include "util/appsupport.h"
+#include "util/settings.h"
+#include "configpipeline.h"
+
+#include "testconfigpipeline.h"
+
+using namespace mrw::test;
+using namespace mrw::can;
+using namespace mrw::model;
+using namespace mrw::util;
+
+using mrw::statechart::TimerService;
+
+using State = ConfigPipeline::State;
+
+/*************************************************************************
+**                                                                      **
+**       Test implementation of MrwBusService                           **
+**                                                                      **
+*************************************************************************/
+
+class FakeBusService : public MrwBusService
+{
+public:
+	explicit FakeBusService(
+		const QString & iface,
+		const QString & plugin) :
+		MrwBusService(iface, plugin, nullptr, true)
+	{
+	}
+
+	void process(const MrwMessage & message) override
+	{
+		// The test answers the requests itself.
+		Q_UNUSED(message);
+	}
+};
+
+static MrwMessage configured(const ControllerId id, const uint8_t devices)
+{
+	MrwMessage message(id, NO_UNITNO, CFGEND, Response::MSG_OK);
+
+	message.append(devices);
+
+	return message;
+}
+
+/*************************************************************************
+**                                                                      **
+**       Test class                                                     **
+**                                                                      **
+*************************************************************************/
+
+TestConfigPipeline::TestConfigPipeline(QObject * parent) :
+	TestModelBase("Test-Railway", parent)
+{
+	Settings      settings("test");
+	SettingsGroup group (&settings, AppSupport::instance().hostname());
+
+	can_iface  = settings.value("interface", "vcan0").toString();
+	can_plugin = settings.value("plugin",    "socketcan").toString();
+}
+
+void TestConfigPipeline::init()
+{
+	controllers.clear();
+	for (size_t c = 0; c < model->controllerCount(); c++)
+	{
+		controllers.push_back(model->controller(c));
+	}
+	QVERIFY(controllers.size() >= 3);
+
+	was_virtual = TimerService::instance().isVirtualTime();
+	TimerService::instance().setVirtualTime(true);
+}
+
+void TestConfigPipeline::cleanup()
+{
+	TimerService::instance().setVirtualTime(was_virtual);
+}
+
+void TestConfigPipeline::answer(ConfigPipeline & pipeline, const ControllerId silent) const
+{
+	bool changed = false;
+
+	// Answer everything before the virtual time may continue so no
+	// timeout expires.
+	do
+	{
+		changed = false;
+		for (const Controller * controller : controllers)
+		{
+			const ControllerId id = controller->id();
+
+			if (id == silent)
+			{
+				continue;
+			}
+
+			switch (pipeline.state(id))
+			{
+			case State::CONFIGURING:
+				pipeline.process(configured(id, 1));
+				changed = true;
+				break;
+
+			case State::BOOTING:
+				pipeline.process(MrwMessage(id, NO_UNITNO, RESET, Response::MSG_BOOTED));
+				changed = true;
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+	while (changed);
+}
+
+void TestConfigPipeline::run(
+	ConfigPipeline   &   pipeline,
+	const bool     &     done,
+	const ControllerId   silent) const
+{
+	QElapsedTimer wall;
+
+	wall.start();
+	while (!done && (wall.elapsed() < 10000))
+	{
+		answer(pipeline, silent);
+		QCoreApplication::processEvents();
+	}
+}
+
+void TestConfigPipeline::testParallel()
+{
+	FakeBusService          bus(can_iface, can_plugin);
+	ConfigPipeline::Options options;
+	bool                    done    = false;
+	bool                    success = false;
+
+	QTest::qWait(50);
+	QVERIFY(bus.valid());
+
+	options.enabled     = true;
+	options.bitrate     = 1000000;
+	options.utilisation = 1.0;
+	options.parallel    = 2;
+
+	ConfigPipeline pipeline(bus, controllers, options, [&](const bool ok)
+	{
+		done    = true;
+		success = ok;
+	});
+
+	pipeline.start();
+	QCOMPARE(pipeline.state(controllers[0]->id()), State::CONFIGURING);
+	QCOMPARE(pipeline.state(controllers[1]->id()), State::CONFIGURING);
+	QCOMPARE(pipeline.state(controllers[2]->id()), State::WAITING);
+
+	// Completing one configuration lets the next controller configure.
+	pipeline.process(configured(controllers[0]->id(), 1));
+	QCOMPARE(pipeline.state(controllers[0]->id()), State::BOOTING);
+	QCOMPARE(pipeline.state(controllers[2]->id()), State::CONFIGURING);
+
+	run(pipeline, done);
+	QVERIFY(done);
+	QVERIFY(success);
+	QCOMPARE(pipeline.configured(), controllers.size());
+}
+
+void TestConfigPipeline::testUtilisation()
+{
+	FakeBusService          bus(can_iface, can_plugin);
+	ConfigPipeline::Options options;
+	bool                    done     = false;
+	bool                    success  = false;
+	uint64_t                previous = 0;
+	QElapsedTimer           wall;
+
+	QTest::qWait(50);
+	QVERIFY(bus.valid());
+
+	// A slow bus so each burst costs more than the bucket holds.
+	options.enabled     = true;
+	options.bitrate     = 10000;
+	options.utilisation = 0.1;
+
+	ConfigPipeline pipeline(bus, controllers, options, [&](const bool ok)
+	{
+		done    = true;
+		success = ok;
+	});
+
+	pipeline.start();
+	wall.start();
+	while (!done && (wall.elapsed() < 10000))
+	{
+		const uint64_t spent = pipeline.busTime();
+
+		if (spent != previous)
+		{
+			// The bus time written before the new bursts never exceeds
+			// the configured share plus the bucket.
+			QVERIFY(previous <= uint64_t(pipeline.elapsed() * 1000 * options.utilisation) +
+				ConfigPipeline::BUCKET_US);
+			previous = spent;
+		}
+
+		answer(pipeline);
+		QCoreApplication::processEvents();
+	}
+
+	QVERIFY(done);
+	QVERIFY(success);
+
+	// The bursts did not fit into the bucket so they were throttled in
+	// virtual time.
+	QVERIFY(pipeline.busTime() > ConfigPipeline::BUCKET_US);
+	QVERIFY(pipeline.elapsed() * 1000 > pipeline.busTime());
+	QVERIFY(wall.elapsed() < 5000);
+}
+
+void TestConfigPipeline::testRetries()
+{
+	FakeBusService          bus(can_iface, can_plugin);
+	ConfigPipeline::Options options;
+	bool                    done    = false;
+	bool                    success = true;
+	const ControllerId      silent  = controllers.front()->id();
+
+	QTest::qWait(50);
+	QVERIFY(bus.valid());
+
+	options.enabled     = true;
+	options.utilisation = 1.0;
+	options.retries     = 2;
+
+	ConfigPipeline pipeline(bus, controllers, options, [&](const bool ok)
+	{
+		done    = true;
+		success = ok;
+	});
+
+	pipeline.start();
+	run(pipeline, done, silent);
+
+	QVERIFY(done);
+	QVERIFY(!success);
+	QCOMPARE(pipeline.state(silent),    State::FAILED);
+	QCOMPARE(pipeline.attempts(silent), options.retries + 1);
+	for (size_t i = 1; i < controllers.size(); i++)
+	{
+		QCOMPARE(pipeline.state(controllers[i]->id()),    State::BOOTED);
+		QCOMPARE(pipeline.attempts(controllers[i]->id()), 1u);
+	}
+
+	// No further attempt is made after failing.
+	const uint64_t queued = bus.statistics().tx_queued;
+
+	QTest::qWait(10);
+	QCOMPARE(pipeline.attempts(silent), options.retries + 1);
+	QCOMPARE(bus.statistics().tx_queued, queued);
+}
+
+void TestConfigPipeline::testLateReply()
+{
+	FakeBusService          bus(can_iface, can_plugin);
+	ConfigPipeline::Options options;
+	unsigned                calls   = 0;
+	bool                    done    = false;
+	const ControllerId      silent  = controllers.front()->id();
+
+	QTest::qWait(50);
+	QVERIFY(bus.valid());
+
+	options.enabled     = true;
+	options.utilisation = 1.0;
+	options.retries     = 0;
+
+	ConfigPipeline pipeline(bus, controllers, options, [&](const bool ok)
+	{
+		Q_UNUSED(ok);
+
+		done = true;
+		calls++;
+	});
+
+	pipeline.start();
+	run(pipeline, done, silent);
+
+	QVERIFY(done);
+	QCOMPARE(pipeline.state(silent), State::FAILED);
+
+	const size_t devices = pipeline.configured();
+
+	// The controller answers after its timeout expired.
+	pipeline.process(configured(silent, 1));
+	pipeline.process(MrwMessage(silent, NO_UNITNO, RESET, Response::MSG_BOOTED));
+
+	QCOMPARE(pipeline.state(silent), State::FAILED);
+	QCOMPARE(pipeline.configured(),  devices);
+	QCOMPARE(calls, 1u);
+}
@@ -0,0 +1,49 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_TEST_TESTCONFIGPIPELINE_H
+#define MRW_TEST_TESTCONFIGPIPELINE_H
+
+#include <vector>
+
+#include <can/types.h>
+#include <model/controller.h>
+
+#include "testmodelbase.h"
+
+class ConfigPipeline;
+
+namespace mrw::test
+{
+	class TestConfigPipeline : public TestModelBase
+	{
+		Q_OBJECT
+
+		QString                               can_iface;
+		QString                               can_plugin;
+		std::vector<mrw::model::Controller *> controllers;
+		bool                                  was_virtual = false;
+
+	public:
+		explicit TestConfigPipeline(QObject * parent = nullptr);
+
+	private slots:
+		void init();
+		void cleanup();
+
+		void testParallel();
+		void testUtilisation();
+		void testRetries();
+		void testLateReply();
+
+	private:
+		void answer(ConfigPipeline & pipeline, const mrw::can::ControllerId silent = 0) const;
+		void run(ConfigPipeline & pipeline, const bool & done, const mrw::can::ControllerId silent = 0) const;
+	};
+}
+
+#endif
@@ -551,3 +551,15 @@ void TestFlankSwitch::testFlankProtectionDifferentRegion()
 	QCOMPARE(s24->switchState(), SwitchState::SWITCH_STATE_RIGHT);
 	QCOMPARE(s31->switchState(), SwitchState::SWITCH_STATE_LEFT);
 }
+
+void TestFlankSwitch::testMainRails()
+{
+	std::vector<Rail *> main_rails;
+
+	model->parts<Rail>(main_rails, &Rail::isMain);
+	QCOMPARE(main_rails.size(), 2u);
+	for (const Rail * rail : main_rails)
+	{
+		QVERIFY(Rail::isMain(rail));
+	}
+}
@@ -44,6 +44,8 @@ namespace mrw::test
 		void testFlankProtectionRhombusRouteRL();
 		void testFlankProtectionFar();
 		void testFlankProtectionDifferentRegion();
+
+		void testMainRails();
 	};
 }
 
@@ -3,10 +3,19 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <QDateTime>
+#include <QFile>
 #include <QTest>
 #include <QStringLiteral>
+#include <QTemporaryDir>
+#include <QtEndian>
 
 #include <can/mrwmessage.h>
+#include <can/devicetable.h>
 #include <model/switchmodulereference.h>
 #include <model/lightmodule.h>
 #include <model/controller.h>
@@ -17,6 +26,9 @@
 #include <model/doublecrossswitch.h>
 #include <model/switchmodule.h>
 #include <model/profilelight.h>
+#include <model/modelsnapshot.h>
+#include <model/emfpath.h>
+#include <model/railgraph.h>
 
 #include "testbase.h"
 #include "testmodel.h"
@@ -847,6 +859,267 @@ void TestModel::testStatistics()
 	QVERIFY(statistics.section_count > 0);
 }
 
+void TestModel::testLoader()
+{
+	ModelRailway         dom_model(filename, true);
+	const MrwStatistic & expected = dom_model.statistics();
+	const MrwStatistic & actual   = model->statistics();
+
+	QCOMPARE(actual.region_count,       expected.region_count);
+	QCOMPARE(actual.device_count,       expected.device_count);
+	QCOMPARE(actual.section_count,      expected.section_count);
+	QCOMPARE(actual.switch_count,       expected.switch_count);
+	QCOMPARE(actual.signal_count,       expected.signal_count);
+	QCOMPARE(actual.main_signal_count,  expected.main_signal_count);
+	QCOMPARE(actual.signal_group_count, expected.signal_group_count);
+	QCOMPARE(actual.warnings,           expected.warnings);
+	QCOMPARE(actual.errors,             expected.errors);
+
+	QCOMPARE(model->controllerCount(), dom_model.controllerCount());
+	QCOMPARE(model->regionCount(),     dom_model.regionCount());
+	QCOMPARE(model->valid(),           dom_model.valid());
+
+	for (size_t r = 0; r < dom_model.regionCount(); r++)
+	{
+		const Region * region = dom_model.region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			const Section * expected_section = region->section(s);
+			const Section * actual_section   = model->section(r, s);
+
+			QCOMPARE(actual_section->name(),              expected_section->name());
+			QCOMPARE(actual_section->unitNo(),            expected_section->unitNo());
+			QCOMPARE(actual_section->assemblyPartCount(), expected_section->assemblyPartCount());
+			QCOMPARE(actual_section->getSignals(true).size(),  expected_section->getSignals(true).size());
+			QCOMPARE(actual_section->getSignals(false).size(), expected_section->getSignals(false).size());
+		}
+	}
+
+	dom_model.xml();
+}
+
+static QStringList neighbours(const RailPart * part, const bool dir)
+{
+	QStringList names;
+
+	for (const RailInfo & info : part->advance(dir))
+	{
+		const RailPart * next = info;
+
+		names << next->partName();
+	}
+	names.sort();
+	return names;
+}
+
+static void patch(QByteArray & content, const qsizetype word, const uint32_t value)
+{
+	static constexpr qsizetype HEADER_SIZE     = 56;
+	static constexpr qsizetype CHECKSUM_OFFSET = 16;
+
+	// Patch a payload word and recompute the FNV-1a checksum so only the
+	// bounds checks are able to reject the snapshot.
+	uint64_t checksum = 0xcbf29ce484222325;
+
+	std::memcpy(content.data() + HEADER_SIZE + word * sizeof(uint32_t), &value, sizeof(value));
+	for (qsizetype i = HEADER_SIZE; i < content.size(); i++)
+	{
+		checksum ^= uchar(content[i]);
+		checksum *= 0x100000001b3;
+	}
+	std::memcpy(content.data() + CHECKSUM_OFFSET, &checksum, sizeof(checksum));
+}
+
+void TestModel::testSnapshot()
+{
+	QTemporaryDir            dir;
+	const QString            snapshot_filename = dir.filePath("test.snapshot");
+	ModelSnapshot::Recorder  recorder;
+	ModelRailway             xml_model(filename, false, &recorder);
+	ModelSnapshot::Positions written;
+	ModelSnapshot::Positions read;
+
+	written.regions       = { "true", "" };
+	written.signal_values = { "1,2,0" };
+	written.rail_parts    = { "\u00c4nderung", "3,4,1" };
+
+	QVERIFY(dir.isValid());
+	QVERIFY(ModelSnapshot::write(snapshot_filename, { filename }, xml_model, recorder, written));
+
+	const ModelSnapshot snapshot(snapshot_filename);
+
+	QVERIFY(snapshot.valid({ filename }));
+	QVERIFY(!snapshot.valid({ filename, snapshot_filename }));
+	QVERIFY(!snapshot.modelName().isEmpty());
+
+	snapshot.positions(read);
+	QCOMPARE(read.regions,       written.regions);
+	QCOMPARE(read.signal_values, written.signal_values);
+	QCOMPARE(read.rail_parts,    written.rail_parts);
+
+	ModelRailway snapshot_model(snapshot);
+
+	QVERIFY(snapshot.matches(snapshot_model));
+	QVERIFY(!snapshot.matches(xml_model));
+	QVERIFY(snapshot_model.statistics() == xml_model.statistics());
+	QCOMPARE(snapshot_model.toString(),        xml_model.toString());
+	QCOMPARE(snapshot_model.controllerCount(), xml_model.controllerCount());
+	QCOMPARE(snapshot_model.regionCount(),     xml_model.regionCount());
+	QCOMPARE(snapshot_model.valid(),           xml_model.valid());
+
+	for (size_t r = 0; r < xml_model.regionCount(); r++)
+	{
+		const Region * region = xml_model.region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			const Section * expected_section = region->section(s);
+			const Section * actual_section   = snapshot_model.section(r, s);
+
+			QCOMPARE(actual_section->name(),              expected_section->name());
+			QCOMPARE(actual_section->unitNo(),            expected_section->unitNo());
+			QCOMPARE(actual_section->assemblyPartCount(), expected_section->assemblyPartCount());
+			QCOMPARE(actual_section->getSignals(true).size(),  expected_section->getSignals(true).size());
+			QCOMPARE(actual_section->getSignals(false).size(), expected_section->getSignals(false).size());
+		}
+	}
+
+	// The links rebuilt from the stored indices result in the same rail
+	// network.
+	std::vector<RailPart *> expected_parts;
+	std::vector<RailPart *> actual_parts;
+
+	xml_model.parts<RailPart>(expected_parts);
+	snapshot_model.parts<RailPart>(actual_parts);
+	QCOMPARE(actual_parts.size(), expected_parts.size());
+	QCOMPARE(snapshot_model.railGraph().size(), xml_model.railGraph().size());
+
+	for (const bool dir : { false, true })
+	{
+		QCOMPARE(snapshot_model.railGraph().edgeCount(dir), xml_model.railGraph().edgeCount(dir));
+		for (size_t p = 0; p < expected_parts.size(); p++)
+		{
+			QCOMPARE(actual_parts[p]->partName(), expected_parts[p]->partName());
+			QCOMPARE(neighbours(actual_parts[p], dir), neighbours(expected_parts[p], dir));
+		}
+	}
+
+	QVERIFY(!ModelSnapshot(dir.filePath("missing.snapshot")).valid({ filename }));
+}
+
+void TestModel::testSnapshotSources()
+{
+	QTemporaryDir           dir;
+	const QString           source            = dir.filePath("copy.modelrailway");
+	const QString           snapshot_filename = ModelSnapshot::filename(source);
+	ModelSnapshot::Recorder recorder;
+
+	QVERIFY(dir.isValid());
+	QVERIFY(QFile::copy(filename, source));
+
+	ModelRailway xml_model(source, false, &recorder);
+
+	QVERIFY(ModelSnapshot::write(snapshot_filename, { source, "" }, xml_model, recorder, {}));
+	QVERIFY(ModelSnapshot(snapshot_filename).valid({ source, "" }));
+
+	// A touched but unchanged source falls back to the content hash.
+	QFile touched(source);
+
+	QVERIFY(touched.open(QIODevice::ReadWrite));
+	QVERIFY(touched.setFileTime(
+			QDateTime::currentDateTime().addSecs(3600), QFileDevice::FileModificationTime));
+	touched.close();
+	QVERIFY(ModelSnapshot(snapshot_filename).valid({ source, "" }));
+
+	// A changed source invalidates the snapshot.
+	QVERIFY(touched.open(QIODevice::Append));
+	touched.write("\n");
+	touched.close();
+	QVERIFY(!ModelSnapshot(snapshot_filename).valid({ source, "" }));
+	QVERIFY(!ModelSnapshot(snapshot_filename).valid({ source }));
+}
+
+void TestModel::testSnapshotCorrupt()
+{
+	QTemporaryDir           dir;
+	const QString           snapshot_filename = dir.filePath("test.snapshot");
+	const QString           corrupt_filename  = dir.filePath("corrupt.snapshot");
+	ModelSnapshot::Recorder recorder;
+	ModelRailway            xml_model(filename, false, &recorder);
+	QFile                   file(snapshot_filename);
+
+	QVERIFY(dir.isValid());
+	QVERIFY(ModelSnapshot::write(snapshot_filename, { filename }, xml_model, recorder, {}));
+	QVERIFY(file.open(QIODevice::ReadOnly));
+
+	const QByteArray content = file.readAll();
+
+	auto valid = [&](const QByteArray & data)
+	{
+		QFile corrupt(corrupt_filename);
+
+		if (!corrupt.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		{
+			return true;
+		}
+		corrupt.write(data);
+		corrupt.close();
+
+		const ModelSnapshot snapshot(corrupt_filename);
+		ModelRailway        snapshot_model(snapshot);
+
+		// Even a rejected snapshot must not read out of range.
+		return snapshot.valid({ filename }) && snapshot.matches(snapshot_model);
+	};
+
+	QVERIFY(valid(content));
+
+	// Truncated snapshots
+	for (const qsizetype length : { qsizetype(0), qsizetype(20), qsizetype(56), content.size() / 2, content.size() - 4 })
+	{
+		QVERIFY(!valid(content.left(length)));
+	}
+
+	// Corrupted payload
+	QByteArray flipped = content;
+
+	flipped[flipped.size() / 2] = flipped[flipped.size() / 2] ^ 0x55;
+	QVERIFY(!valid(flipped));
+
+	// Bad string table with a valid checksum
+	const uint32_t string_count = qFromUnaligned<uint32_t>(content.constData() + 56);
+	const uint32_t text_size    = qFromUnaligned<uint32_t>(content.constData() + 60);
+	QByteArray     bad;
+
+	bad = content;
+	patch(bad, 0, UINT32_MAX);
+	QVERIFY(!valid(bad));
+
+	bad = content;
+	patch(bad, 1, text_size + 4);
+	QVERIFY(!valid(bad));
+
+	bad = content;
+	patch(bad, 3, UINT32_MAX);
+	QVERIFY(!valid(bad));
+
+	bad = content;
+	patch(bad, 2 + string_count, text_size - 1);
+	QVERIFY(!valid(bad));
+
+	// Bad source string index and source count behind the string table
+	const qsizetype sources = 2 + string_count + 1 + (text_size + 3) / 4;
+
+	bad = content;
+	patch(bad, sources, UINT32_MAX);
+	QVERIFY(!valid(bad));
+
+	bad = content;
+	patch(bad, sources + 1, string_count);
+	QVERIFY(!valid(bad));
+}
+
 void TestModel::testSection(Region * region, Section * section)
 {
 	QVERIFY(section != nullptr);
@@ -1038,3 +1311,197 @@ bool TestModel::hasCutOff(const AbstractSwitch * part)
 {
 	return part->hasCutOff();
 }
+
+template <class T> void TestModel::checkPartRegistry(const Section * section)
+{
+	std::vector<T *> expected;
+	std::vector<T *> actual;
+
+	for (size_t i = 0; i < section->assemblyPartCount(); i++)
+	{
+		T * part = dynamic_cast<T *>(section->assemblyPart(i));
+
+		if (part != nullptr)
+		{
+			expected.push_back(part);
+		}
+	}
+
+	section->parts<T>(actual);
+	QVERIFY(actual == expected);
+}
+
+void TestModel::testPartRegistry()
+{
+	std::vector<RailPart *>              expected;
+	std::vector<RailPart *>              actual;
+	std::vector<Rail *>                  rails;
+	std::vector<Rail *>                  filtered_rails;
+	std::vector<Rail *>                  main_rails;
+	std::vector<Rail *>                  guarded_rails;
+	std::vector<SwitchModuleReference *> switch_references;
+	std::vector<AbstractSwitch *>        switches;
+	std::vector<FormSignal *>            form_signals;
+
+	for (size_t r = 0; r < model->regionCount(); r++)
+	{
+		const Region * region = model->region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			const Section * section = region->section(s);
+
+			checkPartRegistry<AssemblyPart>(section);
+			checkPartRegistry<RailPart>(section);
+			checkPartRegistry<Rail>(section);
+			checkPartRegistry<AbstractSwitch>(section);
+			checkPartRegistry<RegularSwitch>(section);
+			checkPartRegistry<DoubleCrossSwitch>(section);
+			checkPartRegistry<Signal>(section);
+			checkPartRegistry<LightSignal>(section);
+			checkPartRegistry<FormSignal>(section);
+			checkPartRegistry<Device>(section);
+			checkPartRegistry<Position>(section);
+
+			section->parts<RailPart>(expected);
+		}
+	}
+
+	model->parts<RailPart>(actual);
+	QVERIFY(actual == expected);
+
+	model->parts<Rail>(rails);
+	std::copy_if(rails.begin(), rails.end(), std::back_inserter(filtered_rails), &Rail::isMain);
+	model->parts<Rail>(main_rails, &Rail::isMain);
+	model->parts<Rail>(guarded_rails, [](const Rail * rail)
+	{
+		return rail->isMain();
+	});
+	QVERIFY(main_rails == filtered_rails);
+	QVERIFY(main_rails == guarded_rails);
+
+	// Not registered types use the dynamic_cast scan.
+	QVERIFY(!PartRegistry::contains<SwitchModuleReference>);
+	model->parts<SwitchModuleReference>(switch_references);
+	model->parts<AbstractSwitch>(switches);
+	model->parts<FormSignal>(form_signals);
+	QCOMPARE(switch_references.size(), switches.size() + form_signals.size());
+}
+
+void TestModel::testRailGraph()
+{
+	const RailGraph    &    graph = model->railGraph();
+	std::vector<RailPart *> rail_parts;
+
+	model->parts<RailPart>(rail_parts);
+	QCOMPARE(graph.size(), rail_parts.size());
+
+	for (const bool dir : { false, true })
+	{
+		size_t edges = 0;
+
+		for (const RailPart * from : rail_parts)
+		{
+			std::set<const RailPart *>    visited;
+			std::vector<const RailPart *> stack{ from };
+
+			QVERIFY(graph.contains(from));
+
+			// Compare the closure against a plain depth first search.
+			while (!stack.empty())
+			{
+				const RailPart * part = stack.back();
+
+				stack.pop_back();
+				for (const RailInfo & info : part->advance(dir))
+				{
+					const RailPart * next = info;
+
+					if (visited.insert(next).second)
+					{
+						stack.push_back(next);
+					}
+				}
+			}
+
+			for (const RailPart * to : rail_parts)
+			{
+				QCOMPARE(graph.reachable(from, to, dir), visited.count(to) > 0);
+			}
+			edges += from->advance(dir).size();
+		}
+		QCOMPARE(graph.edgeCount(dir), edges);
+		QVERIFY(!graph.reachable(nullptr, nullptr, dir));
+	}
+}
+
+void TestModel::testDeviceTable()
+{
+	DeviceTable<Device *>  table;
+	std::vector<Device *>  devices;
+
+	QVERIFY(table.get(1, 1) == nullptr);
+
+	model->parts<Device>(devices);
+	for (Device * device : devices)
+	{
+		table.slot(DeviceId(device)) = device;
+	}
+
+	for (Device * device : devices)
+	{
+		const ControllerId id      = device->controller()->id();
+		const UnitNo       unit_no = device->unitNo();
+
+		QCOMPARE(table.get(id, unit_no), device);
+		QCOMPARE(table.get(id, unit_no), model->deviceById(id, unit_no));
+	}
+
+	// Insert below and above the existing range of a row.
+	table.clear();
+	table.slot(5, 100) = devices.front();
+	table.slot(5,  90) = devices.back();
+	table.slot(5, 120) = devices.front();
+
+	QCOMPARE(table.get(5, 100), devices.front());
+	QCOMPARE(table.get(5,  90), devices.back());
+	QCOMPARE(table.get(5, 120), devices.front());
+	QVERIFY(table.get(5,  95) == nullptr);
+	QVERIFY(table.get(5,  89) == nullptr);
+	QVERIFY(table.get(5, 121) == nullptr);
+	QVERIFY(table.get(4, 100) == nullptr);
+	QVERIFY(table.get(CAN_BROADCAST_ID, 100) == nullptr);
+}
+
+void TestModel::testEmfPath()
+{
+	const auto part = EmfPath::match(u"//@gruppe.2/@abschnitt.10/@bauelement.0", EmfPath::ASSEMBLY_PART);
+
+	QVERIFY(part.has_value());
+	QCOMPARE((*part)[0],  2u);
+	QCOMPARE((*part)[1], 10u);
+	QCOMPARE((*part)[2],  0u);
+
+	const auto crossing = EmfPath::match(u"//@controller.7/@anschluesse.1/@crossing.2", EmfPath::CROSSING);
+
+	QVERIFY(crossing.has_value());
+	QCOMPARE((*crossing)[0], 7u);
+	QCOMPARE((*crossing)[1], 1u);
+	QCOMPARE((*crossing)[2], 2u);
+
+	QVERIFY(EmfPath::match(u"//@controller.11/@anschluesse.0",     EmfPath::CONNECTION).has_value());
+	QVERIFY(EmfPath::match(u"//@controller.3/@module.0",           EmfPath::MODULE).has_value());
+	QVERIFY(EmfPath::match(u"//@gruppe.31/@abschnitt.15",          EmfPath::SECTION).has_value());
+	QVERIFY(EmfPath::match(u"//@controller.4294967295/@module.0",  EmfPath::MODULE).has_value());
+
+	QVERIFY(!EmfPath::match(u"",                                   EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"/@controller.3/@module.0",           EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.3/@module.",           EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.3/@module.0x",         EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.3/@module.0/",         EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.3/@modul.0",           EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.3/@anschluesse.0",     EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.-3/@module.0",         EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@controller.4294967296/@module.0", EmfPath::MODULE).has_value());
+	QVERIFY(!EmfPath::match(u"//@gruppe.0/@abschnitt.19",          EmfPath::ASSEMBLY_PART).has_value());
+}
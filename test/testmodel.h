@@ -42,6 +42,8 @@ namespace mrw::test
 			const std::set<mrw::model::RailInfo>::iterator & it);
 		static bool hasCutOff(const mrw::model::AbstractSwitch * part);
 
+		template <class T> void checkPartRegistry(const model::Section * section);
+
 	private slots:
 		void init();
 
@@ -71,6 +73,14 @@ namespace mrw::test
 		void testSimpleLightConfig();
 		void testCrossingConfig();
 		void testStatistics();
+		void testLoader();
+		void testSnapshot();
+		void testSnapshotSources();
+		void testSnapshotCorrupt();
+		void testPartRegistry();
+		void testRailGraph();
+		void testDeviceTable();
+		void testEmfPath();
 	};
 }
 
@@ -0,0 +1,190 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <util/tracerecorder.h>
+#include <util/tracefile.h>
+#include <can/mrwmessage.h>
+
+#include "recording.h"
+
+#include "testreplay.h"
+
+using namespace mrw::test;
+using namespace mrw::can;
+using namespace mrw::util;
+
+/** The quiet time separating two activations in milliseconds. */
+static constexpr unsigned GAP_MS = 20;
+
+TestReplay::TestReplay(QObject * parent) : QObject(parent)
+{
+}
+
+std::vector<WireMessage> TestReplay::session()
+{
+	WireMessage occupied(2, 3, GETRBS, Response::MSG_OK);
+
+	occupied.append(1);
+
+	// The first three frames form a route activation. The occupation
+	// after the gap forms the second activation.
+	return
+	{
+		WireMessage(SETLFT, 1, 5),
+		WireMessage(1, 5, SETLFT, Response::MSG_OK),
+		WireMessage(SETRON, 1, 7),
+		occupied,
+		WireMessage(SETSGN, 2, 4)
+	};
+}
+
+bool TestReplay::same(const WireMessage & left, const WireMessage & right)
+{
+	return
+		(left.frameId()    == right.frameId()) &&
+		(left.isExtended() == right.isExtended()) &&
+		(left.length()     == right.length()) &&
+		std::equal(left.data(), left.data() + left.length(), right.data());
+}
+
+void TestReplay::testTraceRoundTrip()
+{
+	const std::vector<WireMessage> frames = session();
+
+	QTemporaryDir   dir;
+	const QString   filename = dir.filePath("replay.trace");
+	TraceRecorder & recorder = TraceRecorder::instance();
+
+	// Record the frames the same way the MrwBusService does. The
+	// responses are received, the commands are sent.
+	QVERIFY(recorder.open(filename, 16));
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const WireMessage & wire = frames[i];
+
+		if (i == 3)
+		{
+			QTest::qSleep(GAP_MS * 3);
+		}
+		recorder.frame(
+			wire.isResponse() ? TraceType::CAN_RX : TraceType::CAN_TX,
+			wire.frameId(), wire.isExtended(), wire.data(), wire.length());
+		recorder.event(TraceType::EVENT, recorder.name("Test"), recorder.name("frame"), i);
+	}
+	recorder.close();
+
+	Recording recording(GAP_MS);
+
+	QVERIFY(recording.load(filename, false));
+	QCOMPARE(recording.frames(), frames.size());
+	QCOMPARE(recording.activations(), 2u);
+	QVERIFY(recording.isRoute(0));
+	QVERIFY(!recording.isRoute(1));
+
+	const std::vector<Recording::Step> & steps = recording.steps();
+
+	QCOMPARE(steps.size(), 3u);
+
+	QVERIFY(!steps[0].has_input);
+	QCOMPARE(steps[0].time_ns, 0u);
+	QCOMPARE(steps[0].expected.size(), 1u);
+	QVERIFY(same(steps[0].expected[0], frames[0]));
+
+	QVERIFY(steps[1].has_input);
+	QVERIFY(same(steps[1].input, frames[1]));
+	QCOMPARE(steps[1].expected.size(), 1u);
+	QVERIFY(same(steps[1].expected[0], frames[2]));
+	QCOMPARE(steps[1].activation, 0u);
+
+	QVERIFY(steps[2].has_input);
+	QVERIFY(same(steps[2].input, frames[3]));
+	QCOMPARE(MrwMessage(steps[2].input)[0], 1u);
+	QCOMPARE(steps[2].expected.size(), 1u);
+	QVERIFY(same(steps[2].expected[0], frames[4]));
+	QCOMPARE(steps[2].activation, 1u);
+	QVERIFY(steps[2].time_ns >= uint64_t(GAP_MS) * 3000000);
+}
+
+void TestReplay::testCandumpRoundTrip()
+{
+	const std::vector<WireMessage> frames = session();
+
+	QTemporaryDir dir;
+	const QString filename = dir.filePath("replay.log");
+	QFile         file(filename);
+
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const WireMessage & wire    = frames[i];
+		const QByteArray    payload(reinterpret_cast<const char *>(wire.data()), wire.length());
+		const unsigned      usec    = i < 3 ? i * 1000 : 500000 + i * 1000;
+
+		// Use both the candump -l and the candump -ta format.
+		if ((i % 2) == 0)
+		{
+			file.write(QString("(1436509052.%1) vcan0 %2#%3\n").
+				arg(usec, 6, 10, QChar('0')).
+				arg(wire.frameId(), wire.isExtended() ? 8 : 3, 16, QChar('0')).
+				arg(QString(payload.toHex().toUpper())).toLatin1());
+		}
+		else
+		{
+			file.write(QString("(1436509052.%1)  vcan0  %2   [%3]  %4\n").
+				arg(usec, 6, 10, QChar('0')).
+				arg(wire.frameId(), wire.isExtended() ? 8 : 3, 16, QChar('0')).
+				arg(wire.length()).
+				arg(QString(payload.toHex(' ').toUpper())).toLatin1());
+		}
+	}
+	file.close();
+
+	Recording responses(GAP_MS);
+
+	QVERIFY(responses.load(filename, false));
+	QCOMPARE(responses.frames(), frames.size());
+	QCOMPARE(responses.activations(), 2u);
+	QCOMPARE(responses.steps().size(), 3u);
+	QVERIFY(same(responses.steps()[1].input, frames[1]));
+	QVERIFY(same(responses.steps()[2].input, frames[3]));
+	QCOMPARE(responses.steps()[2].time_ns, 500000000u + 3000000u);
+
+	// Injecting the requests reverses the direction.
+	Recording requests(GAP_MS);
+
+	QVERIFY(requests.load(filename, true));
+	QCOMPARE(requests.steps().size(), 4u);
+	QVERIFY(same(requests.steps()[0].input, frames[0]));
+	QCOMPARE(requests.steps()[0].expected.size(), 1u);
+	QVERIFY(same(requests.steps()[0].expected[0], frames[1]));
+	QVERIFY(same(requests.steps()[1].input, frames[2]));
+	QVERIFY(!requests.steps()[2].has_input);
+	QVERIFY(same(requests.steps()[2].expected[0], frames[3]));
+	QVERIFY(same(requests.steps()[3].input, frames[4]));
+}
+
+void TestReplay::testInvalid()
+{
+	QTemporaryDir   dir;
+	const QString   filename = dir.filePath("events.trace");
+	TraceRecorder & recorder = TraceRecorder::instance();
+	Recording       recording(GAP_MS);
+
+	QVERIFY(!recording.load(dir.filePath("missing.log"), false));
+
+	// A trace file without any frames cannot be replayed.
+	QVERIFY(recorder.open(filename, 4));
+	recorder.batch(1, 0);
+	recorder.close();
+	QVERIFY(TraceFile(filename).valid());
+	QVERIFY(!recording.load(filename, false));
+	QCOMPARE(recording.frames(), 0u);
+}
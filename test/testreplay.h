@@ -0,0 +1,39 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_TEST_TESTREPLAY_H
+#define MRW_TEST_TESTREPLAY_H
+
+#include <vector>
+
+#include <QObject>
+
+#include <can/wiremessage.h>
+
+namespace mrw::test
+{
+	class TestReplay : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		explicit TestReplay(QObject * parent = nullptr);
+
+	private slots:
+		void testTraceRoundTrip();
+		void testCandumpRoundTrip();
+		void testInvalid();
+
+	private:
+		static std::vector<mrw::can::WireMessage> session();
+		static bool same(
+			const mrw::can::WireMessage & left,
+			const mrw::can::WireMessage & right);
+	};
+}
+
+#endif
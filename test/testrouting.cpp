@@ -10,6 +10,7 @@
 #include <model/rail.h>
 #include <model/regularswitch.h>
 #include <model/doublecrossswitch.h>
+#include <model/routecost.h>
 
 #include "testbase.h"
 #include "testrouting.h"
@@ -430,6 +431,59 @@ void TestRouting::testFirstReserved()
 	MRW_THROWS_EXCEPTION(Route(true, SectionState::SHUNTING, r11), std::invalid_argument);
 }
 
+void TestRouting::testPlanner()
+{
+	Rail * r11 = dynamic_cast<Rail *>(parts[0]);
+	Rail * r21 = dynamic_cast<Rail *>(parts[1]);
+	Rail * rr3 = dynamic_cast<Rail *>(parts[12]);
+	Rail * r16 = dynamic_cast<Rail *>(parts[19]);
+
+	QVERIFY(r11 != nullptr);
+	QVERIFY(r21 != nullptr);
+	QVERIFY(rr3 != nullptr);
+	QVERIFY(r16 != nullptr);
+
+	SwitchingCost            cost;
+	Route                    route(true, SectionState::SHUNTING, r21);
+	const Route::RailTrack & reserved = route;
+
+	route.setCostModel(&cost);
+	rr3->section()->setOccupation();
+
+	QVERIFY(!route.append(r11));
+	QCOMPARE(reserved.size(), 1u);
+	QVERIFY(verify(route));
+
+	QVERIFY(route.append(r16));
+	QVERIFY(verify(route));
+	QVERIFY(reserved.back() == r16);
+	QVERIFY(std::find(reserved.begin(), reserved.end(), rr3) == reserved.end());
+
+	const SwitchingCost::Weights & weights = cost.weights();
+	const std::vector<RailPart *>  track(reserved.begin(), reserved.end());
+
+	for (size_t i = 1; (i + 1) < track.size(); i++)
+	{
+		const RailPart * rail = track[i];
+		const RailPart * succ = track[i + 1];
+
+		if (dynamic_cast<const Rail *>(rail) != nullptr)
+		{
+			const unsigned expected =
+				weights.part +
+				(succ->section() != rail->section() ? weights.section : 0) +
+				(rail->isCurved() ? weights.curved : 0);
+
+			QCOMPARE(cost.cost(track[i - 1], rail, succ), expected);
+		}
+	}
+
+	route.clear();
+	QVERIFY(verify(route));
+	QCOMPARE(reserved.size(), 0u);
+	QVERIFY(empty());
+}
+
 bool TestRouting::verify(const Route & route, const bool verify_lock) const
 {
 	return verify( { & route }, verify_lock);
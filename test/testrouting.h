@@ -36,6 +36,7 @@ namespace mrw::test
 		void testFlank();
 		void testFlankLocked();
 		void testFirstReserved();
+		void testPlanner();
 
 	private:
 		bool verify(const model::Route & route, const bool verify_lock = true) const;
@@ -0,0 +1,279 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QTest>
+#include <QElapsedTimer>
+
+#include <statecharts/timerservice.h>
+
+#include "testtimerservice.h"
+
+using namespace mrw::test;
+using namespace mrw::statechart;
+
+using TimeEvent = std::pair<sc::eventid, uint64_t>;
+
+/*************************************************************************
+**                                                                      **
+**       Test implementation of a timed statechart                      **
+**                                                                      **
+*************************************************************************/
+
+class TimedChart : public sc::timer::TimedInterface
+{
+	std::shared_ptr<sc::timer::TimerServiceInterface> timer_service;
+	std::vector<TimeEvent>                            raised;
+
+public:
+	std::function<void(const sc::eventid event)>      reaction;
+
+	void setTimerService(std::shared_ptr<sc::timer::TimerServiceInterface> service) override
+	{
+		timer_service = service;
+	}
+
+	std::shared_ptr<sc::timer::TimerServiceInterface> getTimerService() override
+	{
+		return timer_service;
+	}
+
+	void raiseTimeEvent(sc::eventid event) override
+	{
+		raised.emplace_back(event, TimerService::instance().now());
+		if (reaction)
+		{
+			reaction(event);
+		}
+	}
+
+	sc::integer getNumberOfParallelTimeEvents() override
+	{
+		return 3;
+	}
+
+	const std::vector<TimeEvent> & events() const
+	{
+		return raised;
+	}
+};
+
+/*************************************************************************
+**                                                                      **
+**       Test class                                                     **
+**                                                                      **
+*************************************************************************/
+
+TestTimerService::TestTimerService(QObject * parent) : QObject(parent)
+{
+}
+
+void TestTimerService::init()
+{
+	was_virtual = TimerService::instance().isVirtualTime();
+}
+
+void TestTimerService::cleanup()
+{
+	TimerService::instance().setVirtualTime(was_virtual);
+}
+
+void TestTimerService::testWallTime()
+{
+	TimerService & service = TimerService::instance();
+	QElapsedTimer  wall;
+	bool           fired = false;
+
+	service.setVirtualTime(false);
+	QVERIFY(!service.isVirtualTime());
+
+	wall.start();
+	service.singleShot(50, [&]()
+	{
+		fired = true;
+	});
+
+	QTRY_VERIFY(fired);
+	QVERIFY(wall.elapsed() >= 50);
+}
+
+void TestTimerService::testVirtualTime()
+{
+	TimerService     & service = TimerService::instance();
+	std::vector<int>   order;
+	QElapsedTimer      wall;
+
+	service.setVirtualTime(true);
+	QVERIFY(service.isVirtualTime());
+
+	const uint64_t start = service.now();
+
+	wall.start();
+	service.singleShot(3600000, [&]()
+	{
+		order.push_back(3600000);
+	});
+	service.singleShot(750, [&]()
+	{
+		order.push_back(750);
+	});
+	service.singleShot(100, [&]()
+	{
+		order.push_back(100);
+		service.singleShot(100, [&]()
+		{
+			order.push_back(200);
+		});
+	});
+
+	QTRY_COMPARE(order.size(), size_t(4));
+	QCOMPARE(order, std::vector<int>({ 100, 200, 750, 3600000 }));
+	QCOMPARE(service.now() - start, uint64_t(3600000));
+	QVERIFY(wall.elapsed() < 1000);
+
+	service.setVirtualTime(false);
+	QVERIFY(!service.isVirtualTime());
+	QVERIFY(service.now() >= start + 3600000);
+}
+
+void TestTimerService::testStatechartTimer()
+{
+	TimerService                                      & service = TimerService::instance();
+	std::shared_ptr<sc::timer::TimerServiceInterface> & timers  = service;
+	std::shared_ptr<TimedChart>                         chart   = std::make_shared<TimedChart>();
+	QElapsedTimer                                       wall;
+
+	service.setVirtualTime(true);
+	chart->setTimerService(service);
+
+	// The periodic time event stops itself on its third expiry.
+	chart->reaction = [&](const sc::eventid event)
+	{
+		if ((event == 1) && (chart->events().size() >= 3))
+		{
+			timers->unsetTimer(chart, 1);
+		}
+	};
+
+	const uint64_t start = service.now();
+
+	wall.start();
+	timers->setTimer(chart, 0, 60000, false);
+	timers->setTimer(chart, 1, 1000,  true);
+	timers->setTimer(chart, 2, 2500,  false);
+	timers->unsetTimer(chart, 2);
+
+	QTRY_COMPARE(chart->events().size(), size_t(4));
+	QCOMPARE(chart->events(), std::vector<TimeEvent>(
+	{
+		{ 1, start +  1000 },
+		{ 1, start +  2000 },
+		{ 1, start +  3000 },
+		{ 0, start + 60000 }
+	}));
+	QVERIFY(wall.elapsed() < 1000);
+
+	// Nothing is raised after the last time event.
+	QTest::qWait(10);
+	QCOMPARE(chart->events().size(), size_t(4));
+
+	timers->unsetTimerRaw(chart.get(), 0);
+	timers->unsetTimerRaw(chart.get(), 1);
+	timers->unsetTimerRaw(chart.get(), 2);
+}
+
+void TestTimerService::testStatechartRearm()
+{
+	TimerService                                      & service = TimerService::instance();
+	std::shared_ptr<sc::timer::TimerServiceInterface> & timers  = service;
+	std::shared_ptr<TimedChart>                         first   = std::make_shared<TimedChart>();
+	std::shared_ptr<TimedChart>                         second  = std::make_shared<TimedChart>();
+
+	service.setVirtualTime(true);
+
+	const uint64_t start = service.now();
+
+	// Setting a running time event again restarts it with the new delay.
+	timers->setTimer(first,  0, 500, false);
+	timers->setTimer(second, 0, 300, false);
+	timers->setTimer(first,  0, 100, false);
+
+	// A statechart may start its next time event while handling one.
+	first->reaction = [&](const sc::eventid event)
+	{
+		if (event == 0)
+		{
+			timers->setTimer(first, 1, 750, false);
+		}
+	};
+
+	QTRY_COMPARE(first->events().size(), size_t(2));
+	QCOMPARE(first->events(), std::vector<TimeEvent>(
+	{
+		{ 0, start + 100 },
+		{ 1, start + 850 }
+	}));
+	QCOMPARE(second->events(), std::vector<TimeEvent>({ { 0, start + 300 } }));
+
+	timers->unsetTimerRaw(first.get(),  0);
+	timers->unsetTimerRaw(first.get(),  1);
+	timers->unsetTimerRaw(second.get(), 0);
+}
+
+void TestTimerService::testStatechartUnsetRaw()
+{
+	TimerService                                      & service = TimerService::instance();
+	std::shared_ptr<sc::timer::TimerServiceInterface> & timers  = service;
+	std::shared_ptr<TimedChart>                         gone    = std::make_shared<TimedChart>();
+	std::shared_ptr<TimedChart>                         alive   = std::make_shared<TimedChart>();
+
+	service.setVirtualTime(true);
+
+	const uint64_t start = service.now();
+
+	// A destroyed statechart removes its pending time events.
+	timers->setTimer(gone,  0, 200, false);
+	timers->setTimer(gone,  1, 100, true);
+	timers->setTimer(alive, 0, 400, false);
+	timers->unsetTimerRaw(gone.get(), 0);
+	timers->unsetTimerRaw(gone.get(), 1);
+
+	QTRY_COMPARE(alive->events().size(), size_t(1));
+	QCOMPARE(alive->events().front(), TimeEvent(0, start + 400));
+	QVERIFY(gone->events().empty());
+
+	timers->unsetTimerRaw(alive.get(), 0);
+}
+
+void TestTimerService::testOwner()
+{
+	TimerService          & service = TimerService::instance();
+	std::shared_ptr<bool>   owner   = std::make_shared<bool>();
+	std::vector<int>        order;
+
+	service.setVirtualTime(true);
+
+	// Pending callbacks of a destroyed owner are dropped.
+	service.singleShot(100, owner, [&]()
+	{
+		order.push_back(100);
+		owner.reset();
+	});
+	service.singleShot(200, owner, [&]()
+	{
+		order.push_back(200);
+	});
+	service.singleShot(300, [&]()
+	{
+		order.push_back(300);
+	});
+
+	QTRY_COMPARE(order.size(), size_t(2));
+	QCOMPARE(order, std::vector<int>({ 100, 300 }));
+}
@@ -0,0 +1,37 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_TEST_TESTTIMERSERVICE_H
+#define MRW_TEST_TESTTIMERSERVICE_H
+
+#include <QObject>
+
+namespace mrw::test
+{
+	class TestTimerService : public QObject
+	{
+		Q_OBJECT
+
+		bool was_virtual = false;
+
+	public:
+		explicit TestTimerService(QObject * parent = nullptr);
+
+	private slots:
+		void init();
+		void cleanup();
+
+		void testWallTime();
+		void testVirtualTime();
+		void testStatechartTimer();
+		void testStatechartRearm();
+		void testStatechartUnsetRaw();
+		void testOwner();
+	};
+}
+
+#endif
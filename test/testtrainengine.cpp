@@ -0,0 +1,216 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <memory>
+#include <vector>
+
+#include <QCanBusDevice>
+#include <QList>
+#include <QTest>
+
+#include "can/mrwbusservice.h"
+#include "can/mrwmessage.h"
+#include "model/controller.h"
+#include "model/modelrailway.h"
+#include "model/region.h"
+#include "util/appsupport.h"
+#include "util/settings.h"
+#include "trainengine.h"
+
+#include "testtrainengine.h"
+
+using namespace mrw::test;
+using namespace mrw::can;
+using namespace mrw::model;
+using namespace mrw::util;
+
+/*************************************************************************
+**                                                                      **
+**       Test implementation of MrwBusService                           **
+**                                                                      **
+*************************************************************************/
+
+class OccupationBus : public MrwBusService
+{
+	QList<DeviceKey> entered;
+
+public:
+	explicit OccupationBus(
+		const QString & iface,
+		const QString & plugin) :
+		MrwBusService(iface, plugin, nullptr, false)
+	{
+		can_device->setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, true);
+		connectDevice();
+	}
+
+	void process(const MrwMessage & message) override
+	{
+		// Record the sections in the order a train entered them.
+		if (message.isResponse() && (message.command() == GETRBS) &&
+			(message.size() >= 1) && (message[0] != 0))
+		{
+			entered.append(DeviceKey(message.eid(), message.unitNo()));
+		}
+	}
+
+	int counted() const
+	{
+		return entered.size();
+	}
+
+	const QList<DeviceKey> & list() const
+	{
+		return entered;
+	}
+};
+
+/*************************************************************************
+**                                                                      **
+**       Test class                                                     **
+**                                                                      **
+*************************************************************************/
+
+TestTrainEngine::TestTrainEngine(QObject * parent) :
+	TestModelBase("Test-Railway", parent)
+{
+	Settings      settings("test");
+	SettingsGroup group (&settings, AppSupport::instance().hostname());
+
+	can_iface  = settings.value("interface", "vcan0").toString();
+	can_plugin = settings.value("plugin",    "socketcan").toString();
+}
+
+Section * TestTrainEngine::section(const ModelRailway * model, const QString & name)
+{
+	for (size_t r = 0; r < model->regionCount(); r++)
+	{
+		const Region * region = model->region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			if (region->section(s)->name() == name)
+			{
+				return region->section(s);
+			}
+		}
+	}
+	return nullptr;
+}
+
+RegularSwitch * TestTrainEngine::regularSwitch(const ModelRailway * model, const QString & name)
+{
+	std::vector<RegularSwitch *> switches;
+
+	model->parts<RegularSwitch>(switches);
+	for (RegularSwitch * part : switches)
+	{
+		if (part->name() == name)
+		{
+			return part;
+		}
+	}
+	return nullptr;
+}
+
+void TestTrainEngine::enable(
+	TrainEngine    &    engine,
+	const Section   *   section,
+	const bool          enable)
+{
+	engine.process(MrwMessage(
+			section->controller()->id(), section->unitNo(),
+			enable ? SETRON : SETROF, Response::MSG_OK));
+}
+
+void TestTrainEngine::testWalk()
+{
+	// From West Station track 2 over Switch 1, Rail South and Switch 4
+	// into East Station track 1.
+	static const QStringList names
+	{
+		"W2", "WS", "West out", "Rail South", "East in", "ES", "E1"
+	};
+
+	std::unique_ptr<ModelRailway> tracked = std::make_unique<ModelRailway>(filename);
+	OccupationBus                 bus(can_iface, can_plugin);
+	TrainEngine::Options          options;
+	std::vector<Section *>        track;
+
+	for (const QString & name : names)
+	{
+		Section * part = section(tracked.get(), name);
+
+		QVERIFY2(part != nullptr, qPrintable(name));
+		track.push_back(part);
+	}
+
+	options.trains = 1;
+	options.length = 1;
+	options.step   = 20;
+	options.start  = 20;
+	options.dwell  = 60000;
+
+	TrainEngine engine(bus, tracked.get(), options);
+
+	// The switch states are confirmed by the controllers. The commands
+	// are taken from the switches of the test model.
+	RegularSwitch * s1 = regularSwitch(model, "Switch 1");
+	RegularSwitch * s4 = regularSwitch(model, "Switch 4");
+
+	QVERIFY(s1 != nullptr);
+	QVERIFY(s4 != nullptr);
+	s1->setState(RegularSwitch::State::AC, true);
+	s4->setState(RegularSwitch::State::AB, true);
+	engine.process(MrwMessage(s1->controller()->id(), s1->unitNo(), s1->commandState(), Response::MSG_OK));
+	engine.process(MrwMessage(s4->controller()->id(), s4->unitNo(), s4->commandState(), Response::MSG_OK));
+	QCOMPARE(regularSwitch(tracked.get(), "Switch 1")->state(), RegularSwitch::State::AC);
+	QCOMPARE(regularSwitch(tracked.get(), "Switch 4")->state(), RegularSwitch::State::AB);
+
+	// Enable in reverse driving order. The destination stays disabled.
+	const size_t count = track.size();
+
+	for (size_t i = count - 1; i > 0; i--)
+	{
+		enable(engine, track[i - 1], true);
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(bus.counted(), int(count), 5000);
+	for (size_t i = 0; i < count; i++)
+	{
+		QCOMPARE(bus.list().at(i), DeviceKey(track[i]->controller()->id(), track[i]->unitNo()));
+	}
+	QCOMPARE(engine.count(), size_t(1));
+	QVERIFY(track.back()->occupation());
+
+	// Release the route while the train waits at its destination.
+	for (size_t i = 0; i < count - 1; i++)
+	{
+		enable(engine, track[i], false);
+	}
+
+	// The returning route starts at the occupied destination so the
+	// train reverses its driving direction.
+	for (size_t i = 1; i < count; i++)
+	{
+		enable(engine, track[i], true);
+	}
+
+	QTRY_COMPARE_WITH_TIMEOUT(bus.counted(), int(2 * count - 1), 5000);
+	for (size_t i = 0; i < count - 1; i++)
+	{
+		const Section * expected = track[count - 2 - i];
+
+		QCOMPARE(bus.list().at(count + i), DeviceKey(expected->controller()->id(), expected->unitNo()));
+	}
+	QVERIFY(track.front()->occupation());
+
+	const TrainEngine::Statistics & statistics = engine.statistics();
+
+	QCOMPARE(statistics.started,  uint64_t(1));
+	QCOMPARE(statistics.extended, uint64_t(1));
+	QCOMPARE(statistics.rejected, uint64_t(0));
+	QCOMPARE(statistics.stalls,   uint64_t(0));
+}
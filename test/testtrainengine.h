@@ -0,0 +1,47 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_TEST_TESTTRAINENGINE_H
+#define MRW_TEST_TESTTRAINENGINE_H
+
+#include <model/section.h>
+#include <model/regularswitch.h>
+
+#include "testmodelbase.h"
+
+class TrainEngine;
+
+namespace mrw::test
+{
+	class TestTrainEngine : public TestModelBase
+	{
+		Q_OBJECT
+
+		QString can_iface;
+		QString can_plugin;
+
+	public:
+		explicit TestTrainEngine(QObject * parent = nullptr);
+
+	private slots:
+		void testWalk();
+
+	private:
+		static mrw::model::Section * section(
+			const mrw::model::ModelRailway * model,
+			const QString          &         name);
+		static mrw::model::RegularSwitch * regularSwitch(
+			const mrw::model::ModelRailway * model,
+			const QString          &         name);
+		static void enable(
+			TrainEngine            &         engine,
+			const mrw::model::Section *      section,
+			const bool                       enable);
+	};
+}
+
+#endif
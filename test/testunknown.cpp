@@ -4,6 +4,7 @@
 //
 
 #include <QTest>
+#include <QStringList>
 
 #include <can/mrwmessage.h>
 #include <model/regularswitch.h>
@@ -16,6 +17,18 @@ using namespace mrw::test;
 using namespace mrw::can;
 using namespace mrw::model;
 
+static QStringList messages;
+
+static void collect(QtMsgType type, const QMessageLogContext & context, const QString & message)
+{
+	Q_UNUSED(context);
+
+	if ((type == QtWarningMsg) || (type == QtCriticalMsg) || (type == QtFatalMsg))
+	{
+		messages.append(message);
+	}
+}
+
 TestUnknown::TestUnknown() : TestModelBase("Test-Unknown")
 {
 }
@@ -49,3 +62,26 @@ void TestUnknown::testMuxConnection()
 	QVERIFY(!model->connection(2, 0)->valid());
 	QVERIFY(!model->connection(3, 0)->valid());
 }
+
+void TestUnknown::testLinkThreads()
+{
+	const QtMessageHandler handler = qInstallMessageHandler(collect);
+
+	messages.clear();
+	ModelRailway::setLinkThreads(1);
+	ModelRailway sequential(filename);
+	const QStringList sequential_messages = messages;
+
+	messages.clear();
+	ModelRailway::setLinkThreads(4);
+	ModelRailway parallel(filename);
+	const QStringList parallel_messages = messages;
+
+	ModelRailway::setLinkThreads(0);
+	qInstallMessageHandler(handler);
+
+	QVERIFY(sequential.statistics().errors > 0);
+	QVERIFY(sequential.statistics() == parallel.statistics());
+	QCOMPARE(parallel_messages, sequential_messages);
+	QCOMPARE(parallel.valid(), sequential.valid());
+}
@@ -24,6 +24,7 @@ namespace mrw::test
 		void testController();
 		void testModule();
 		void testMuxConnection();
+		void testLinkThreads();
 	};
 }
 
@@ -3,10 +3,18 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <unistd.h>
 
+#include <QTemporaryDir>
 #include <QTest>
 #include <QSignalSpy>
 
@@ -25,12 +33,23 @@
 #include <util/self.h>
 #include <util/hexline.h>
 #include <util/cleanvector.h>
+#include <util/spscring.h>
+#include <util/mpscring.h>
+#include <util/fixedstack.h>
+#include <util/histogram.h>
+#include <util/phaseprofile.h>
+#include <util/timerwheel.h>
+#include <util/tracerecorder.h>
+#include <util/tracefile.h>
+#include <log/loggerservice.h>
+#include <log/loggerbase.h>
 
 #include "testbase.h"
 #include "testutil.h"
 
 using namespace mrw::test;
 using namespace mrw::util;
+using namespace mrw::log;
 
 const ConstantEnumerator<int> TestUtil::int_map
 {
@@ -80,6 +99,154 @@ public:
 	}
 };
 
+class CaptureLogger : public LoggerBase
+{
+	mutable std::mutex                mutex;
+	mutable std::vector<std::string>  lines;
+
+public:
+	mutable std::atomic<unsigned>     flushes{0};
+	mutable std::atomic<bool>         hold{false};
+	mutable std::atomic<bool>         holding{false};
+
+	CaptureLogger()
+	{
+		LoggerService::instance().registerLogger(this);
+	}
+
+	~CaptureLogger()
+	{
+		LoggerService::instance().unregisterLogger(this);
+	}
+
+	void debug(const char * message) const override
+	{
+		capture(message);
+	}
+
+	void info(const char * message) const override
+	{
+		capture(message);
+	}
+
+	void warn(const char * message) const override
+	{
+		capture(message);
+	}
+
+	void critical(const char * message) const override
+	{
+		capture(message);
+	}
+
+	void fatal(const char * message) const override
+	{
+		capture(message);
+	}
+
+	void flush() const override
+	{
+		flushes++;
+	}
+
+	std::vector<std::string> captured() const
+	{
+		std::lock_guard guard(mutex);
+
+		return lines;
+	}
+
+	size_t count(const char * text) const
+	{
+		std::lock_guard guard(mutex);
+
+		return std::count_if(lines.begin(), lines.end(), [text](const std::string & line)
+		{
+			return line.find(text) != std::string::npos;
+		});
+	}
+
+	void block()
+	{
+		// Keep the writer thread inside the next written message.
+		hold = true;
+		qInfo("Logger blocked");
+		while (!holding)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	void capture(const char * message) const
+	{
+		holding = true;
+		while (hold)
+		{
+			std::this_thread::yield();
+		}
+		holding = false;
+
+		std::lock_guard guard(mutex);
+
+		lines.emplace_back(message);
+	}
+};
+
+class ForwardLogger : public LoggerBase
+{
+public:
+	ForwardLogger()
+	{
+		LoggerService::instance().registerLogger(this);
+	}
+
+	~ForwardLogger()
+	{
+		LoggerService::instance().unregisterLogger(this);
+	}
+
+	void debug(const char * message) const override
+	{
+		forward(message);
+	}
+
+	void info(const char * message) const override
+	{
+		forward(message);
+	}
+
+	void warn(const char * message) const override
+	{
+		forward(message);
+	}
+
+	void critical(const char * message) const override
+	{
+		forward(message);
+	}
+
+	void fatal(const char * message) const override
+	{
+		forward(message);
+	}
+
+private:
+	void forward(const char * message) const
+	{
+		// Log again from another thread while this message is dispatched.
+		if (std::string(message).find("Forward outer") != std::string::npos)
+		{
+			std::thread inner([]()
+			{
+				qInfo("Forward inner");
+			});
+
+			inner.join();
+		}
+	}
+};
+
 /*************************************************************************
 **                                                                      **
 **       Test case implementation                                       **
@@ -649,3 +816,614 @@ void TestUtil::testHostname()
 	QVERIFY(!hostname.isEmpty());
 	QVERIFY(!hostname.contains("."));
 }
+
+void TestUtil::testSpscRing()
+{
+	SpscRing<std::string, 4> ring;
+
+	QVERIFY(ring.empty());
+	QCOMPARE(ring.capacity(), size_t(4));
+	QVERIFY(!ring.pop().has_value());
+
+	QVERIFY(ring.push("1"));
+	QVERIFY(ring.push("2"));
+	QVERIFY(ring.push("3"));
+	QVERIFY(ring.push("4"));
+	QVERIFY(!ring.push("5"));
+	QCOMPARE(ring.size(), size_t(4));
+
+	QVERIFY(ring.pop() == "1");
+	QVERIFY(ring.push("5"));
+	QVERIFY(ring.pop() == "2");
+	QVERIFY(ring.pop() == "3");
+	QVERIFY(ring.pop() == "4");
+	QVERIFY(ring.pop() == "5");
+	QVERIFY(!ring.pop().has_value());
+	QVERIFY(ring.empty());
+}
+
+void TestUtil::testSpscRingThreaded()
+{
+	static constexpr unsigned COUNT = 100000;
+
+	SpscRing<unsigned, 64> ring;
+	unsigned               expected = 0;
+	bool                   ordered  = true;
+
+	std::thread producer([&ring] ()
+	{
+		for (unsigned i = 0; i < COUNT; i++)
+		{
+			while (!ring.push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	while (expected < COUNT)
+	{
+		const std::optional<unsigned> value = ring.pop();
+
+		if (value.has_value())
+		{
+			ordered &= *value == expected;
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	QVERIFY(ordered);
+	QVERIFY(ring.empty());
+}
+
+void TestUtil::testTraceRecorder()
+{
+	static const std::uint8_t payload[] = { 0x01, 0x02, 0x03 };
+
+	QTemporaryDir   dir;
+	const QString   filename = dir.filePath("test.trace");
+	TraceRecorder & recorder = TraceRecorder::instance();
+
+	QVERIFY(!recorder.isOpen());
+	QCOMPARE(recorder.name("Unused"), TraceRecorder::NO_NAME);
+	QVERIFY(recorder.open(filename, 3));
+	QVERIFY(recorder.isOpen());
+
+	const std::uint16_t source = recorder.name("Source");
+	const std::uint16_t event  = recorder.name("event");
+
+	QCOMPARE(recorder.name("Source"), source);
+	QVERIFY(source != event);
+
+	recorder.frame(TraceType::CAN_TX, 0x123, true, payload, sizeof(payload));
+	recorder.event(TraceType::EVENT, source, event, 7);
+	recorder.batch(42, 5000);
+	recorder.close();
+	QVERIFY(!recorder.isOpen());
+
+	const TraceFile complete(filename);
+
+	QVERIFY(complete.valid());
+	QCOMPARE(complete.header().capacity, 4u);
+	QCOMPARE(complete.records().size(), 3u);
+	QCOMPARE(complete.lost(), 0u);
+	QCOMPARE(complete.torn(), 0u);
+
+	const TraceRecord & frame = complete.records()[0];
+
+	QCOMPARE(frame.type,   std::uint8_t(TraceType::CAN_TX));
+	QCOMPARE(frame.source, 0x123 | TraceRecorder::EXTENDED);
+	QCOMPARE(frame.length, sizeof(payload));
+	QCOMPARE(frame.data[2], 0x03);
+
+	QCOMPARE(complete.name(complete.records()[1].source), QString("Source"));
+	QCOMPARE(complete.name(complete.records()[1].name),   QString("event"));
+	QCOMPARE(complete.records()[1].value, 7u);
+	QCOMPARE(complete.records()[2].source, 42u);
+	QCOMPARE(complete.records()[2].value,  5u);
+	QVERIFY(complete.records()[0].time <= complete.records()[2].time);
+
+	// Overwrite the oldest records.
+	QVERIFY(recorder.open(filename, 4));
+	for (unsigned i = 0; i < 6; i++)
+	{
+		recorder.batch(i, 0);
+	}
+	recorder.close();
+
+	const TraceFile wrapped(filename);
+
+	QVERIFY(wrapped.valid());
+	QCOMPARE(wrapped.records().size(), 4u);
+	QCOMPARE(wrapped.lost(), 2u);
+	QCOMPARE(wrapped.records().front().source, 2u);
+	QCOMPARE(wrapped.records().back().source,  5u);
+
+	QVERIFY(!TraceFile(dir.filePath("missing.trace")).valid());
+}
+
+void TestUtil::testMpscRing()
+{
+	MpscRing<std::string, 4> ring;
+
+	QVERIFY(ring.empty());
+	QCOMPARE(ring.capacity(), size_t(4));
+	QVERIFY(!ring.pop().has_value());
+
+	QVERIFY(ring.push("1"));
+	QVERIFY(ring.push("2"));
+	QVERIFY(ring.push("3"));
+	QVERIFY(ring.push("4"));
+	QVERIFY(!ring.push("5"));
+	QCOMPARE(ring.size(), size_t(4));
+
+	QVERIFY(ring.pop() == "1");
+	QVERIFY(ring.push("5"));
+	QVERIFY(ring.pop() == "2");
+	QVERIFY(ring.pop() == "3");
+	QVERIFY(ring.pop() == "4");
+	QVERIFY(ring.pop() == "5");
+	QVERIFY(!ring.pop().has_value());
+	QVERIFY(ring.empty());
+}
+
+void TestUtil::testMpscRingThreaded()
+{
+	static constexpr unsigned PRODUCERS = 4;
+	static constexpr unsigned COUNT     = 25000;
+
+	MpscRing<unsigned, 64>   ring;
+	std::vector<std::thread> producers;
+	std::vector<unsigned>    expected(PRODUCERS, 0);
+	unsigned                 received = 0;
+	bool                     ordered  = true;
+
+	for (unsigned p = 0; p < PRODUCERS; p++)
+	{
+		producers.emplace_back([&ring, p] ()
+		{
+			for (unsigned i = 0; i < COUNT; i++)
+			{
+				while (!ring.push(p * COUNT + i))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	while (received < PRODUCERS * COUNT)
+	{
+		const std::optional<unsigned> value = ring.pop();
+
+		if (value.has_value())
+		{
+			// The elements of each producer keep their order.
+			const unsigned producer = *value / COUNT;
+
+			ordered &= (*value % COUNT) == expected[producer];
+			expected[producer]++;
+			received++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	for (std::thread & producer : producers)
+	{
+		producer.join();
+	}
+
+	QVERIFY(ordered);
+	QVERIFY(ring.empty());
+}
+
+void TestUtil::testAsyncLogger()
+{
+	static constexpr unsigned COUNT = 100;
+
+	CaptureLogger   logger;
+	LoggerService & service = LoggerService::instance();
+
+	service.setAsynchronous(true);
+	QVERIFY(service.isAsynchronous());
+
+	logger.block();
+	for (unsigned i = 0; i < COUNT; i++)
+	{
+		qInfo("Async message %03u", i);
+	}
+
+	std::thread release([&logger]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		logger.hold = false;
+	});
+
+	// The flush waits until the blocked writer wrote everything.
+	service.flush();
+	QCOMPARE(logger.count("Async message"), size_t(COUNT));
+	QVERIFY(logger.flushes > 0);
+	release.join();
+
+	const std::vector<std::string> lines = logger.captured();
+	unsigned                       index = 0;
+
+	for (const std::string & line : lines)
+	{
+		if (line.find("Async message") != std::string::npos)
+		{
+			QVERIFY(line.find(QString::asprintf("Async message %03u", index).toStdString()) !=
+				std::string::npos);
+			index++;
+		}
+	}
+	QCOMPARE(index, COUNT);
+
+	service.setAsynchronous(false);
+	QVERIFY(!service.isAsynchronous());
+}
+
+void TestUtil::testAsyncLoggerDropped()
+{
+	static constexpr unsigned EXCESS = 16;
+
+	CaptureLogger   logger;
+	LoggerService & service = LoggerService::instance();
+
+	service.setAsynchronous(true);
+
+	const uint64_t before = service.statistics().dropped;
+
+	// The blocked writer already popped its message so the ring is empty.
+	logger.block();
+	for (unsigned i = 0; i < LoggerService::CAPACITY + EXCESS; i++)
+	{
+		qInfo("Async overflow %u", i);
+	}
+	QCOMPARE(service.statistics().dropped - before, uint64_t(EXCESS));
+
+	logger.hold = false;
+	service.flush();
+	service.setAsynchronous(false);
+
+	QCOMPARE(logger.count("Async overflow"), size_t(LoggerService::CAPACITY));
+	QCOMPARE(logger.count("16 messages dropped!"), size_t(1));
+}
+
+void TestUtil::testAsyncLoggerFatal()
+{
+	static constexpr unsigned COUNT = 10;
+
+	CaptureLogger   logger;
+	LoggerService & service = LoggerService::instance();
+
+	// Calling the installed handler directly does not abort.
+	const QtMessageHandler handler = qInstallMessageHandler(nullptr);
+
+	qInstallMessageHandler(handler);
+	service.setAsynchronous(true);
+
+	logger.block();
+	for (unsigned i = 0; i < COUNT; i++)
+	{
+		qInfo("Async queued %u", i);
+	}
+
+	std::thread release([&logger]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		logger.hold = false;
+	});
+
+	handler(QtFatalMsg, QMessageLogContext(), "Async fatal");
+	release.join();
+	service.setAsynchronous(false);
+
+	const std::vector<std::string> lines = logger.captured();
+
+	QCOMPARE(logger.count("Async queued"), size_t(COUNT));
+	QVERIFY(!lines.empty());
+	QVERIFY(lines.back().find("Async fatal") != std::string::npos);
+}
+
+void TestUtil::testAsyncLoggerStop()
+{
+	static constexpr unsigned COUNT = 10;
+
+	CaptureLogger   logger;
+	LoggerService & service = LoggerService::instance();
+
+	service.setAsynchronous(true);
+
+	logger.block();
+	for (unsigned i = 0; i < COUNT; i++)
+	{
+		qInfo("Async pending %u", i);
+	}
+
+	std::thread release([&logger]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		logger.hold = false;
+	});
+
+	// Stopping writes everything still queued.
+	service.setAsynchronous(false);
+	release.join();
+
+	QVERIFY(!service.isAsynchronous());
+	QCOMPARE(logger.count("Async pending"), size_t(COUNT));
+}
+
+void TestUtil::testAsyncLoggerTruncate()
+{
+	CaptureLogger   logger;
+	LoggerService & service = LoggerService::instance();
+	const QString   text(LoggerService::RECORD_SIZE, QChar(0x20ac));
+
+	service.setAsynchronous(true);
+
+	const uint64_t before = service.statistics().truncated;
+
+	qInfo("Async euro %s", qPrintable(text));
+	service.flush();
+	service.setAsynchronous(false);
+
+	QCOMPARE(service.statistics().truncated - before, uint64_t(1));
+	QCOMPARE(logger.count("Async euro"), size_t(1));
+
+	// Each euro sign takes three bytes so the record must not end inside
+	// one of them.
+	for (const std::string & line : logger.captured())
+	{
+		if (line.find("Async euro") != std::string::npos)
+		{
+			const QString decoded = QString::fromStdString(line);
+
+			QVERIFY(line.size() < LoggerService::RECORD_SIZE);
+			QVERIFY(!decoded.contains(QChar::ReplacementCharacter));
+			QVERIFY(decoded.endsWith(QChar(0x20ac)));
+		}
+	}
+}
+
+void TestUtil::testLoggerReentrant()
+{
+	CaptureLogger   capture;
+	ForwardLogger   forward;
+	LoggerService & service = LoggerService::instance();
+
+	QVERIFY(!service.isAsynchronous());
+
+	// The forwarding logger logs from another thread while the service
+	// dispatches synchronously.
+	qInfo("Forward outer");
+
+	QCOMPARE(capture.count("Forward outer"), size_t(1));
+	QCOMPARE(capture.count("Forward inner"), size_t(1));
+}
+
+void TestUtil::testFixedStack()
+{
+	FixedStack<int, 3> stack;
+
+	QVERIFY(stack.empty());
+	QCOMPARE(stack.capacity(), size_t(3));
+
+	QVERIFY(stack.push(1));
+	QVERIFY(stack.push(2));
+	QVERIFY(stack.push(3));
+	QVERIFY(!stack.push(4));
+	QCOMPARE(stack.size(), size_t(3));
+	QCOMPARE(stack.back(), 3);
+	QCOMPARE(stack[0], 1);
+	QCOMPARE(std::vector<int>(stack.begin(), stack.end()), std::vector<int>({ 1, 2, 3 }));
+
+	stack.pop();
+	QCOMPARE(stack.back(), 2);
+	QVERIFY(stack.push(5));
+	QCOMPARE(stack.back(), 5);
+
+	stack.truncate(1);
+	QCOMPARE(stack.size(), size_t(1));
+	QCOMPARE(stack.back(), 1);
+
+	stack.clear();
+	QVERIFY(stack.empty());
+}
+
+void TestUtil::testPhaseProfile()
+{
+	{
+		// Without an active profile nothing is recorded.
+		PhaseProfile::Scope phase("idle");
+	}
+
+	PhaseProfile profile([]()
+	{
+		return size_t(42);
+	});
+
+	for (int i = 0; i < 3; i++)
+	{
+		PhaseProfile::Scope outer("outer");
+		PhaseProfile::Scope inner("inner");
+	}
+
+	const std::vector<PhaseProfile::Phase> & phases = profile.phases();
+
+	QCOMPARE(phases.size(), size_t(2));
+	QCOMPARE(phases[0].name, "inner");
+	QCOMPARE(phases[1].name, "outer");
+	QCOMPARE(phases[0].calls, size_t(3));
+	QCOMPARE(phases[1].calls, size_t(3));
+	QCOMPARE(phases[1].allocations, size_t(0));
+	QVERIFY(phases[1].nsecs >= phases[0].nsecs);
+	QVERIFY(phases[1].peak_rss > 0);
+}
+
+void TestUtil::testPhasePeakRss()
+{
+	static constexpr size_t LARGE = 64 * 1024 * 1024;
+
+	if (!PhaseProfile::resetPeakRss())
+	{
+		QSKIP("Resetting the peak resident set size is not supported.");
+	}
+
+	PhaseProfile profile;
+
+	{
+		PhaseProfile::Scope outer("outer");
+
+		{
+			PhaseProfile::Scope     large("large");
+			const std::vector<char> memory(LARGE, 1);
+
+			QCOMPARE(memory.back(), char(1));
+		}
+
+		PhaseProfile::Scope small("small");
+	}
+
+	const std::vector<PhaseProfile::Phase> & phases = profile.phases();
+
+	QCOMPARE(phases.size(), size_t(3));
+	QCOMPARE(phases[0].name, "large");
+	QCOMPARE(phases[1].name, "small");
+	QCOMPARE(phases[2].name, "outer");
+
+	// The peak of a phase is not inherited from a previous phase but
+	// the outer phase contains the peak of its inner phases.
+	QVERIFY(phases[0].peak_rss >= long(LARGE / 1024));
+	QVERIFY(phases[1].peak_rss <  phases[0].peak_rss);
+	QCOMPARE(phases[2].peak_rss,  phases[0].peak_rss);
+}
+
+void TestUtil::testHistogram()
+{
+	static_assert(Histogram::bucket(0)            == 0);
+	static_assert(Histogram::bucket(1)            == 1);
+	static_assert(Histogram::bucket(2)            == 2);
+	static_assert(Histogram::bucket(3)            == 2);
+	static_assert(Histogram::bucket(4)            == 3);
+	static_assert(Histogram::bucket(UINT64_MAX)   == Histogram::BUCKETS - 1);
+	static_assert(Histogram::bucketFloor(0)       == 0);
+	static_assert(Histogram::bucketFloor(1)       == 1);
+	static_assert(Histogram::bucketFloor(3)       == 4);
+
+	Histogram histogram;
+
+	for (uint64_t value : { 0, 5, 6, 7, 8 })
+	{
+		histogram.add(value);
+	}
+	histogram.add(UINT64_MAX);
+
+	QCOMPARE(histogram[0],                      uint64_t(1));
+	QCOMPARE(histogram[Histogram::bucket(5)],   uint64_t(3));
+	QCOMPARE(histogram[Histogram::bucket(8)],   uint64_t(1));
+	QCOMPARE(histogram[Histogram::BUCKETS - 1], uint64_t(1));
+
+	for (size_t i = 1; i < Histogram::BUCKETS; i++)
+	{
+		QCOMPARE(Histogram::bucket(Histogram::bucketFloor(i)), i);
+	}
+}
+
+void TestUtil::testTimerWheel()
+{
+	TimerWheel                        wheel;
+	std::vector<TimerWheel::Handle>   fired;
+	const TimerWheel::Handle          late  = wheel.create();
+	const TimerWheel::Handle          early = wheel.create();
+	const TimerWheel::Handle          far   = wheel.create();
+	const TimerWheel::Handle          gone  = wheel.create();
+
+	QVERIFY(!wheel.nextDeadline().has_value());
+
+	wheel.start(late,  0, 5000);
+	wheel.start(early, 0,   70);
+	wheel.start(far,   0, 3600000);
+	wheel.start(gone,  0,   10);
+	wheel.stop(gone);
+
+	QVERIFY( wheel.isActive(late));
+	QVERIFY(!wheel.isActive(gone));
+	QCOMPARE(wheel.statistics().active, size_t(3));
+
+	// Rearm in place.
+	wheel.start(late, 0, 100);
+
+	QCOMPARE(wheel.advance(69, [&](const TimerWheel::Handle handle)
+	{
+		fired.push_back(handle);
+	}), size_t(0));
+	QCOMPARE(wheel.advance(200, [&](const TimerWheel::Handle handle)
+	{
+		fired.push_back(handle);
+	}), size_t(2));
+
+	QCOMPARE(fired.size(), size_t(2));
+	QCOMPARE(fired[0], early);
+	QCOMPARE(fired[1], late);
+	QVERIFY(!wheel.isActive(early));
+	QVERIFY( wheel.isActive(far));
+	QVERIFY(*wheel.nextDeadline() <= 3600000u);
+
+	wheel.advance(3600000, [&](const TimerWheel::Handle handle)
+	{
+		fired.push_back(handle);
+	});
+	QCOMPARE(fired.size(), size_t(3));
+	QCOMPARE(fired[2], far);
+	QVERIFY(!wheel.nextDeadline().has_value());
+
+	const TimerWheel::Statistics & statistics = wheel.statistics();
+
+	QCOMPARE(statistics.fired,  uint64_t(3));
+	QCOMPARE(statistics.active, size_t(0));
+	QCOMPARE(statistics.peak,   size_t(4));
+	QCOMPARE(statistics.lateness[Histogram::bucket(0)],   uint64_t(1));
+	QCOMPARE(statistics.lateness[Histogram::bucket(100)], uint64_t(1));
+	QCOMPARE(statistics.lateness[Histogram::bucket(130)], uint64_t(1));
+}
+
+void TestUtil::testTimerWheelPeriodic()
+{
+	TimerWheel               wheel(1000);
+	const TimerWheel::Handle periodic = wheel.create();
+	unsigned                 count    = 0;
+
+	wheel.start(periodic, 1000, 10, 10);
+	for (uint64_t now = 1001; now <= 1100; now++)
+	{
+		wheel.advance(now, [&](const TimerWheel::Handle handle)
+		{
+			QCOMPARE(handle, periodic);
+			count++;
+
+			// Create, start and destroy while expiring.
+			const TimerWheel::Handle single = wheel.create();
+
+			wheel.start(single, now, 0);
+			wheel.destroy(single);
+		});
+	}
+
+	QCOMPARE(count, 10u);
+	QVERIFY(wheel.isActive(periodic));
+	QCOMPARE(*wheel.nextDeadline(), uint64_t(1110));
+
+	wheel.destroy(periodic);
+	QVERIFY(!wheel.nextDeadline().has_value());
+	QCOMPARE(wheel.create(), periodic);
+}
@@ -75,6 +75,23 @@ namespace mrw::test
 		void testSharedVector();
 		void testBlanktime();
 		void testHostname();
+		void testSpscRing();
+		void testSpscRingThreaded();
+		void testMpscRing();
+		void testMpscRingThreaded();
+		void testAsyncLogger();
+		void testAsyncLoggerDropped();
+		void testAsyncLoggerFatal();
+		void testAsyncLoggerStop();
+		void testAsyncLoggerTruncate();
+		void testLoggerReentrant();
+		void testTraceRecorder();
+		void testFixedStack();
+		void testPhaseProfile();
+		void testPhasePeakRss();
+		void testHistogram();
+		void testTimerWheel();
+		void testTimerWheelPeriodic();
 	};
 }
 
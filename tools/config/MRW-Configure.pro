@@ -11,10 +11,12 @@ include(../../common.pri)
 CONFIG += console
 
 SOURCES += \
+	configpipeline.cpp \
 	configurationservice.cpp \
 	main.cpp
 
 HEADERS += \
+	configpipeline.h \
 	configurationservice.h
 
 LIBS            += -lMRW-Model -lMRW-Can -lMRW-Statecharts -lMRW-Util
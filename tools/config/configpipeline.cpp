@@ -0,0 +1,398 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+
+#include <util/appsupport.h>
+#include <util/settings.h>
+#include <statecharts/timerservice.h>
+#include <statecharts/ConfigStatechart.h>
+
+#include "configpipeline.h"
+
+using namespace mrw::can;
+using namespace mrw::model;
+using namespace mrw::util;
+
+using mrw::statechart::TimerService;
+using mrw::statechart::ConfigStatechart;
+
+ConfigPipeline::Options ConfigPipeline::Options::read()
+{
+	Settings      settings;
+	SettingsGroup host(&settings, AppSupport::instance().hostname());
+	SettingsGroup group(&settings, "configure");
+	Options       result;
+
+	result.enabled     = settings.value("pipeline",    result.enabled).toBool();
+	result.bitrate     = settings.value("bitrate",     result.bitrate).toUInt();
+	result.utilisation = settings.value("utilisation", result.utilisation).toDouble();
+	result.parallel    = settings.value("parallel",    result.parallel).toUInt();
+	result.retries     = settings.value("retries",     result.retries).toUInt();
+
+	result.bitrate     = std::max(result.bitrate, 1000u);
+	result.utilisation = std::clamp(result.utilisation, 0.05, 1.0);
+
+	return result;
+}
+
+ConfigPipeline::ConfigPipeline(
+	MrwBusService              &   service,
+	const std::vector<Controller *> & controllers,
+	const Options              &   pipeline_options,
+	Callback                       done) :
+	log("mrw.tools.config"),
+	bus(service),
+	options(pipeline_options),
+	callback(done)
+{
+	const size_t count = controllers.size();
+
+	nodes.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Node           &        node = nodes[i];
+		const ControllerId      id   = controllers[i]->id();
+		std::vector<MrwMessage> messages;
+
+		node.controller = controllers[i];
+		node.controller->configure(messages);
+
+		node.burst.reserve(messages.size() + 2);
+		node.burst.emplace_back(CFGBGN, id);
+		node.burst.insert(node.burst.end(), messages.begin(), messages.end());
+		node.burst.emplace_back(CFGEND, id);
+
+		// Every request is answered by the controller and after resetting
+		// it sends RESET MSG_RESET_PENDING, GETVER and RESET MSG_BOOTED.
+		for (const MrwMessage & request : node.burst)
+		{
+			node.cost_us += frameTime(request);
+			node.cost_us += frameTime(MrwMessage(id, request.unitNo(), request.command(), Response::MSG_OK));
+		}
+		node.cost_us += 3 * frameTime(MrwMessage(id, 0, RESET, Response::MSG_BOOTED));
+
+		index_map[id] = i;
+		waiting.push_back(i);
+	}
+	pending = count;
+}
+
+void ConfigPipeline::start()
+{
+	if (started)
+	{
+		return;
+	}
+
+	started  = true;
+	start_ms = TimerService::instance().now();
+	if (pending == 0)
+	{
+		callback(true);
+	}
+	else
+	{
+		pump();
+	}
+}
+
+bool ConfigPipeline::isStarted() const noexcept
+{
+	return started;
+}
+
+void ConfigPipeline::process(const MrwMessage & message)
+{
+	if (!message.isResponse())
+	{
+		return;
+	}
+
+	auto it = index_map.find(message.eid());
+
+	if (it == index_map.end())
+	{
+		return;
+	}
+
+	const size_t   index    = it->second;
+	Node     &     node     = nodes[index];
+	const Response response = message.response();
+
+	switch (message.command())
+	{
+	case CFGEND:
+		if (node.state == State::CONFIGURING)
+		{
+			if ((response == Response::MSG_OK) && (message.size() >= 1))
+			{
+				configuring--;
+				node.devices = message[0];
+				node.state   = State::BOOTING;
+				arm(index, ConfigStatechart::getResettime());
+				pump();
+			}
+			else
+			{
+				expire(index);
+			}
+		}
+		break;
+
+	case RESET:
+		if ((node.state == State::BOOTING) && (response == Response::MSG_BOOTED))
+		{
+			finish(index, State::BOOTED);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+size_t ConfigPipeline::configured() const noexcept
+{
+	size_t result = 0;
+
+	for (const Node & node : nodes)
+	{
+		if (node.state == State::BOOTED)
+		{
+			result += node.devices;
+		}
+	}
+	return result;
+}
+
+size_t ConfigPipeline::maxDevices() const noexcept
+{
+	size_t result = 0;
+
+	for (const Node & node : nodes)
+	{
+		result = std::max(result, node.burst.size() - 2);
+	}
+	return result;
+}
+
+ConfigPipeline::State ConfigPipeline::state(const ControllerId id) const
+{
+	return nodes.at(index_map.at(id)).state;
+}
+
+unsigned ConfigPipeline::attempts(const ControllerId id) const
+{
+	return nodes.at(index_map.at(id)).attempts;
+}
+
+uint64_t ConfigPipeline::busTime() const noexcept
+{
+	return bus_us;
+}
+
+uint64_t ConfigPipeline::elapsed() const noexcept
+{
+	return started ? TimerService::instance().now() - start_ms : 0;
+}
+
+void ConfigPipeline::info() const
+{
+	const double duration = elapsed();
+	int64_t      slowest  = 0;
+
+	qCInfo(log).noquote() << "Pipelined configuration:" << options.bitrate << "bit/s," <<
+		options.utilisation * 100.0 << "% utilisation," <<
+		options.parallel << "parallel," << options.retries << "retries";
+	qCInfo(log, "  Controllers: %zu waiting, %zu configuring, %zu booting, %zu booted, %zu failed",
+		count(State::WAITING), count(State::CONFIGURING), count(State::BOOTING),
+		count(State::BOOTED), count(State::FAILED));
+
+	for (const Node & node : nodes)
+	{
+		const int64_t time_ms = node.done_ms >= 0 ? node.done_ms - node.sent_ms : -1;
+
+		slowest = std::max(slowest, time_ms);
+		qCInfo(log, "  Controller %3u: %-11s %2zu devices, %u attempts, %6lld ms",
+			node.controller->id(), get(node.state), node.burst.size() - 2,
+			node.attempts, (long long)time_ms);
+	}
+
+	qCInfo(log, "  Duration: %.0f ms, slowest controller %lld ms", duration, (long long)slowest);
+	qCInfo(log, "  Estimated bus time: %.1f ms, %.1f%% load",
+		bus_us / 1000.0, duration > 0 ? bus_us / duration / 10.0 : 0.0);
+}
+
+uint64_t ConfigPipeline::frameTime(const MrwMessage & message) const noexcept
+{
+	return message.wire().transmissionTime(options.bitrate);
+}
+
+uint64_t ConfigPipeline::now() const noexcept
+{
+	return elapsed() * 1000;
+}
+
+size_t ConfigPipeline::count(const State state) const noexcept
+{
+	return std::count_if(nodes.begin(), nodes.end(), [state](const Node & node)
+	{
+		return node.state == state;
+	});
+}
+
+void ConfigPipeline::pump()
+{
+	while (!waiting.empty() && !pumping)
+	{
+		if ((options.parallel > 0) && (configuring >= options.parallel))
+		{
+			// Continued on CFGEND or timeout.
+			return;
+		}
+
+		const size_t   index     = waiting.front();
+		const uint64_t cost      = std::min(nodes[index].cost_us, BUCKET_US);
+		const uint64_t allowance = uint64_t(now() * options.utilisation) + BUCKET_US;
+
+		if (allowance > (spent_us + BUCKET_US))
+		{
+			spent_us = allowance - BUCKET_US;
+		}
+
+		const uint64_t available = allowance > spent_us ? allowance - spent_us : 0;
+
+		if (available < cost)
+		{
+			const double delay = (cost - available) / options.utilisation / 1000.0;
+
+			pumping = true;
+			TimerService::instance().singleShot(sc::time(delay) + 1, lifetime, [this]()
+			{
+				pumping = false;
+				pump();
+			});
+			return;
+		}
+
+		waiting.pop_front();
+		spent_us += nodes[index].cost_us;
+		bus_us   += nodes[index].cost_us;
+		send(index);
+	}
+}
+
+void ConfigPipeline::send(const size_t index)
+{
+	Node       &       node    = nodes[index];
+	const ControllerId id      = node.controller->id();
+	const size_t       queued  = bus.write(node.burst);
+	const unsigned     devices = node.burst.size() - 2;
+
+	if (node.attempts == 0)
+	{
+		node.sent_ms = elapsed();
+	}
+	node.state = State::CONFIGURING;
+	node.attempts++;
+	configuring++;
+
+	qCDebug(log, "---------------------- %u (%u devices, attempt %u)",
+		id, devices, node.attempts);
+	if (queued != node.burst.size())
+	{
+		qCWarning(log, "Only %zu of %zu configuration messages queued for controller %u.",
+			queued, node.burst.size(), id);
+	}
+
+	arm(index,
+		ConfigStatechart::getTimeout() +
+		ConfigStatechart::getFlashtime() * devices +
+		unsigned(node.cost_us / options.utilisation / 1000.0));
+}
+
+void ConfigPipeline::arm(const size_t index, const unsigned delay_ms)
+{
+	const uint64_t current = ++ticket;
+
+	nodes[index].ticket = current;
+	TimerService::instance().singleShot(sc::time(delay_ms), lifetime, [this, index, current]()
+	{
+		if (nodes[index].ticket == current)
+		{
+			expire(index);
+		}
+	});
+}
+
+void ConfigPipeline::expire(const size_t index)
+{
+	Node & node = nodes[index];
+
+	if (node.state == State::CONFIGURING)
+	{
+		configuring--;
+	}
+
+	if (node.attempts <= options.retries)
+	{
+		qCWarning(log, "Controller %u failed while %s, retrying.",
+			node.controller->id(), get(node.state));
+
+		node.state  = State::WAITING;
+		node.ticket = ++ticket;
+		waiting.push_back(index);
+		pump();
+	}
+	else
+	{
+		qCCritical(log, "Controller %u failed while %s!",
+			node.controller->id(), get(node.state));
+		finish(index, State::FAILED);
+	}
+}
+
+void ConfigPipeline::finish(const size_t index, const State state)
+{
+	Node & node = nodes[index];
+
+	node.state   = state;
+	node.done_ms = elapsed();
+	node.ticket  = ++ticket;
+
+	qCDebug(log, "---------------------- %u %s (%zu controllers left)",
+		node.controller->id(), get(state), pending - 1);
+	if (--pending == 0)
+	{
+		callback(count(State::FAILED) == 0);
+	}
+	else
+	{
+		pump();
+	}
+}
+
+const char * ConfigPipeline::get(const State state) noexcept
+{
+	switch (state)
+	{
+	case State::WAITING:
+		return "waiting";
+
+	case State::CONFIGURING:
+		return "configuring";
+
+	case State::BOOTING:
+		return "booting";
+
+	case State::BOOTED:
+		return "booted";
+
+	case State::FAILED:
+		return "failed";
+	}
+	return "?";
+}
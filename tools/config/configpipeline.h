@@ -0,0 +1,234 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef CONFIGPIPELINE_H
+#define CONFIGPIPELINE_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QLoggingCategory>
+
+#include <can/mrwbusservice.h>
+#include <can/mrwmessage.h>
+#include <model/controller.h>
+
+/**
+ * This class configures all controllers of a model railway at once. In
+ * contrast to the ConfigStatechart which configures one controller after
+ * another each controller has its own State:
+ *
+ * 1. WAITING until the configuration burst may be written.
+ * 2. CONFIGURING after writing CFGBGN, the device configuration and
+ *    CFGEND until the CFGEND MSG_OK response arrives. Meanwhile the
+ *    controller writes its EEPROM.
+ * 3. BOOTING until the RESET MSG_BOOTED response arrives.
+ * 4. BOOTED or FAILED if a timeout elapsed too often.
+ *
+ * So writing the EEPROM and resetting of all controllers overlap and the
+ * whole configuration takes roughly as long as the slowest controller.
+ *
+ * Configuration bursts are throttled by a token bucket measured in bus
+ * time. The bus time of a burst is estimated from the bit stuffed frame
+ * lengths of its requests and expected responses. A burst is written only
+ * if the bus time spent so far stays below the configured utilisation.
+ * The bucket starts full and holds at most BUCKET_US of unused bus time
+ * so a burst after a quiet phase does not flood the bus.
+ *
+ * The timeouts and the token bucket use the time of the
+ * mrw::statechart::TimerService. So the pipeline also runs in virtual
+ * time mode.
+ */
+class ConfigPipeline
+{
+public:
+	/**
+	 * The options of the pipelined configuration. They are read from the
+	 * &lt;hostname&gt;/configure group of the host settings.
+	 */
+	struct Options
+	{
+		/** True if the pipelined configuration is used at all. */
+		bool     enabled     = false;
+
+		/** The bit rate of the CAN bus in bit/s. */
+		unsigned bitrate     = 125000;
+
+		/** The maximum share of the bus time used by configuration bursts. */
+		double   utilisation = 0.5;
+
+		/** The maximum amount of concurrently configuring controllers or 0. */
+		unsigned parallel    = 0;
+
+		/** The amount of retries of a controller after a timeout. */
+		unsigned retries     = 1;
+
+		/**
+		 * This method reads the options from the host settings.
+		 *
+		 * @return The read options.
+		 */
+		static Options read();
+	};
+
+	/**
+	 * The configuration state of a single controller.
+	 */
+	enum class State
+	{
+		WAITING,
+		CONFIGURING,
+		BOOTING,
+		BOOTED,
+		FAILED
+	};
+
+	/** The maximum unused bus time kept in the token bucket in µs. */
+	static constexpr uint64_t BUCKET_US = 100000;
+
+	/**
+	 * The callback signalling that all controllers are either BOOTED or
+	 * FAILED. The parameter is true if no controller failed.
+	 */
+	typedef std::function<void(bool success)> Callback;
+
+	explicit ConfigPipeline(
+		mrw::can::MrwBusService              &    bus,
+		const std::vector<mrw::model::Controller *> & controllers,
+		const Options                   &         options,
+		Callback                                  done);
+	ConfigPipeline() = delete;
+	ConfigPipeline(const ConfigPipeline & other) = delete;
+	ConfigPipeline & operator=(const ConfigPipeline & other) = delete;
+
+	/**
+	 * This method starts the configuration of all controllers. It should
+	 * be called after the CAN bus is connected.
+	 */
+	void start();
+
+	/**
+	 * This method returns true if start() was already called.
+	 *
+	 * @return True if the configuration was started.
+	 */
+	bool isStarted() const noexcept;
+
+	/**
+	 * This method processes a message seen on the CAN bus.
+	 *
+	 * @param message The received message.
+	 */
+	void process(const mrw::can::MrwMessage & message);
+
+	/**
+	 * This method returns the amount of devices the controllers reported
+	 * as configured.
+	 *
+	 * @return The amount of configured devices.
+	 */
+	size_t configured() const noexcept;
+
+	/**
+	 * This method returns the maximum amount of devices of a single
+	 * controller.
+	 *
+	 * @return The maximum amount of devices per controller.
+	 */
+	size_t maxDevices() const noexcept;
+
+	/**
+	 * This method returns the configuration State of the given controller.
+	 *
+	 * @param id The ID of the controller.
+	 * @return The configuration State of the controller.
+	 */
+	State state(const mrw::can::ControllerId id) const;
+
+	/**
+	 * This method returns how often the configuration of the given
+	 * controller was sent.
+	 *
+	 * @param id The ID of the controller.
+	 * @return The amount of attempts.
+	 */
+	unsigned attempts(const mrw::can::ControllerId id) const;
+
+	/**
+	 * This method returns the estimated bus time of all bursts written so
+	 * far.
+	 *
+	 * @return The estimated bus time in µs.
+	 */
+	uint64_t busTime() const noexcept;
+
+	/**
+	 * This method returns the time since start() was called.
+	 *
+	 * @return The elapsed service time in ms.
+	 */
+	uint64_t elapsed() const noexcept;
+
+	/**
+	 * This method logs the options, the state of each controller and the
+	 * timing of the configuration.
+	 */
+	void info() const;
+
+private:
+	/**
+	 * The configuration state of one controller.
+	 */
+	struct Node
+	{
+		mrw::model::Controller      *       controller = nullptr;
+		std::vector<mrw::can::MrwMessage>   burst;
+		uint64_t                            cost_us    = 0;
+		State                               state      = State::WAITING;
+		unsigned                            attempts   = 0;
+		uint64_t                            ticket     = 0;
+		size_t                              devices    = 0;
+		int64_t                             sent_ms    = -1;
+		int64_t                             done_ms    = -1;
+	};
+
+	uint64_t frameTime(const mrw::can::MrwMessage & message) const noexcept;
+	uint64_t now() const noexcept;
+	size_t   count(const State state) const noexcept;
+
+	void pump();
+	void send(const size_t index);
+	void arm(const size_t index, const unsigned delay_ms);
+	void expire(const size_t index);
+	void finish(const size_t index, const State state);
+
+	static const char * get(const State state) noexcept;
+
+	QLoggingCategory                                log;
+	mrw::can::MrwBusService             &           bus;
+	const Options                                   options;
+	Callback                                        callback;
+	uint64_t                                        start_ms    = 0;
+
+	std::vector<Node>                               nodes;
+	std::unordered_map<mrw::can::ControllerId, size_t>   index_map;
+	std::deque<size_t>                              waiting;
+
+	uint64_t                                        spent_us    = 0;
+	uint64_t                                        bus_us      = 0;
+	uint64_t                                        ticket      = 0;
+	size_t                                          configuring = 0;
+	size_t                                          pending     = 0;
+	bool                                            pumping     = false;
+	bool                                            started     = false;
+	std::shared_ptr<bool>                           lifetime    = std::make_shared<bool>();
+};
+
+#endif
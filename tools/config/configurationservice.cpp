@@ -23,32 +23,79 @@ ConfigurationService::ConfigurationService(
 	MrwBusService(repo.interface(), repo.plugin(), parent, false),
 	log("mrw.tools.config")
 {
-	std::vector<Device *> devices;
+	const ConfigPipeline::Options options = ConfigPipeline::Options::read();
+	std::vector<Device *>         devices;
 
 	model = repo;
+	TimerService::instance().setVirtualTime(repo.virtualTime());
+	if (repo.virtualTime())
+	{
+		qCInfo(log, "Using virtual time.");
+	}
+
 	if (model != nullptr)
 	{
 		model->parts<Device>(devices);
 		device_count = devices.size();
 	}
 
-	connect(
-		this, &MrwBusService::connected,
-		&statechart, &ConfigStatechart::connected,
+	if (options.enabled)
+	{
+		std::vector<Controller *> all;
+
+		for (size_t i = 0; (model != nullptr) && (i < model->controllerCount()); i++)
+		{
+			all.push_back(model->controller(i));
+		}
+		pipeline = std::make_unique<ConfigPipeline>(*this, all, options, [this](bool success)
+		{
+			finish(success);
+		});
+
+		connect(
+			this, &MrwBusService::connected,
+			this, [this]()
+		{
+			pipeline->start();
+		},
 		Qt::QueuedConnection);
 
-	statechart.setTimerService(TimerService::instance());
-	statechart.setOperationCallback(*this);
+		TimerService::instance().singleShot(ConfigStatechart::getTimeout(), [this]()
+		{
+			if (!pipeline->isStarted())
+			{
+				fail();
+			}
+		});
+	}
+	else
+	{
+		connect(
+			this, &MrwBusService::connected,
+			&statechart, &ConfigStatechart::connected,
+			Qt::QueuedConnection);
 
-	Q_ASSERT(statechart.check());
-	statechart.enter();
+		enter();
+	}
 
-	can_device->connectDevice();
+	connectDevice();
 }
 
 ConfigurationService::~ConfigurationService()
 {
-	statechart.exit();
+	if (statechart.isActive())
+	{
+		statechart.exit();
+	}
+}
+
+void ConfigurationService::enter()
+{
+	statechart.setTimerService(TimerService::instance());
+	statechart.setOperationCallback(*this);
+
+	Q_ASSERT(statechart.check());
+	statechart.enter();
 }
 
 void ConfigurationService::info()
@@ -57,11 +104,19 @@ void ConfigurationService::info()
 	{
 		model->info();
 	}
+	if (pipeline)
+	{
+		pipeline->info();
+	}
 }
 
 void ConfigurationService::process(const MrwMessage & message)
 {
-	if (message.isResponse())
+	if (pipeline)
+	{
+		pipeline->process(message);
+	}
+	else if (message.isResponse())
 	{
 		const Command  cmd      = message.command();
 		const Response response = message.response();
@@ -101,15 +156,20 @@ void ConfigurationService::sendConfig(
 	const ControllerId              id,
 	const std::vector<MrwMessage> & messages)
 {
-	const MrwMessage cfg_begin(CFGBGN, id);
-	const MrwMessage cfg_end(  CFGEND, id);
+	std::vector<MrwMessage> burst;
 
-	write(cfg_begin);
-	for (const MrwMessage & msg : messages)
+	burst.reserve(messages.size() + 2);
+	burst.emplace_back(CFGBGN, id);
+	burst.insert(burst.end(), messages.begin(), messages.end());
+	burst.emplace_back(CFGEND, id);
+
+	const size_t queued = write(burst);
+
+	if (queued != burst.size())
 	{
-		write(msg);
+		qCWarning(log, "Only %zu of %zu configuration messages queued for controller %u.",
+			queued, burst.size(), id);
 	}
-	write(cfg_end);
 }
 
 sc::integer ConfigurationService::configure(sc::integer idx)
@@ -140,6 +200,18 @@ bool ConfigurationService::hasMore(sc::integer idx)
 	return idx < (int)model->controllerCount();
 }
 
+void ConfigurationService::finish(const bool success)
+{
+	if (success)
+	{
+		quit();
+	}
+	else
+	{
+		fail();
+	}
+}
+
 void ConfigurationService::booting()
 {
 	qCInfo(log, "Configuration completed and booting.");
@@ -151,8 +223,15 @@ void ConfigurationService::booting()
 
 void ConfigurationService::quit()
 {
+	if (pipeline)
+	{
+		pipeline->info();
+		config_count = pipeline->configured();
+	}
+
 	qCInfo(log, "Configured devices:   %3zu", config_count);
-	qCInfo(log, "Max devices per node: %3d", statechart.getMax());
+	qCInfo(log, "Max devices per node: %3zu",
+		pipeline ? pipeline->maxDevices() : size_t(statechart.getMax()));
 	qCInfo(log, "Assembly parts:       %3zu", device_count);
 	qCInfo(log, "Model railway facility ready.");
 	QCoreApplication::quit();
@@ -160,6 +239,10 @@ void ConfigurationService::quit()
 
 void ConfigurationService::fail()
 {
+	if (pipeline)
+	{
+		pipeline->info();
+	}
 	qCCritical(log, "Configuration timeout!");
 	QCoreApplication::exit(EXIT_FAILURE);
 }
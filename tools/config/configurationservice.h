@@ -19,8 +19,13 @@
 #include <statecharts/ConfigStatechart.h>
 #include <model/modelrepository.h>
 
+#include "configpipeline.h"
+
 /**
- * This class provides a service for configururing the CAN nodes.
+ * This class provides a service for configururing the CAN nodes. By
+ * default the ConfigStatechart configures one controller after another.
+ * If the pipelined mode is enabled in the host settings the
+ * ConfigPipeline configures all controllers at once.
  */
 class ConfigurationService :
 	public mrw::can::MrwBusService,
@@ -45,6 +50,9 @@ private:
 	/** Devices configured. */
 	size_t                                     config_count = 0;
 
+	/** The pipelined configuration if enabled. */
+	std::unique_ptr<ConfigPipeline>            pipeline;
+
 public:
 	explicit ConfigurationService(
 		mrw::model::ModelRepository & repo,
@@ -65,6 +73,9 @@ private:
 	sc::integer configure(sc::integer idx) override;
 	bool hasMore(sc::integer idx) override;
 
+	void enter();
+	void finish(const bool success);
+
 	void booting() override;
 	void quit() override;
 	void fail() override;
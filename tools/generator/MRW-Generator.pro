@@ -0,0 +1,25 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT -= gui
+
+include(../../common.pri)
+
+CONFIG += console
+
+SOURCES += \
+	layoutgenerator.cpp \
+	main.cpp
+
+HEADERS += \
+	layoutgenerator.h
+
+LIBS            += -lMRW-Model -lMRW-Can -lMRW-Util
+
+QMAKE_CLEAN     += $$TARGET
+
+install.files    = $$TARGET
+
+INSTALLS        += install
@@ -0,0 +1,866 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <utility>
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QXmlStreamWriter>
+
+#include <can/types.h>
+
+#include "layoutgenerator.h"
+
+using namespace mrw::can;
+
+const char * LayoutGenerator::REGION_FILENAME   = "Gruppen.properties";
+const char * LayoutGenerator::SIGNAL_FILENAME   = "Signale.properties";
+const char * LayoutGenerator::RAILPART_FILENAME = "Gleisteile.properties";
+
+namespace
+{
+	// Rows of the widget positions inside a rail road region.
+	constexpr int LOOP_UPPER_Y = 0;
+	constexpr int UPPER_Y      = 2;
+	constexpr int LOWER_Y      = 6;
+	constexpr int LOOP_LOWER_Y = 8;
+
+	const std::pair<LayoutGenerator::Topology, const char *> topology_names[]
+	{
+		{ LayoutGenerator::Topology::MAINLINE,  "mainline" },
+		{ LayoutGenerator::Topology::YARD,      "yard" },
+		{ LayoutGenerator::Topology::LOOP,      "loop" },
+		{ LayoutGenerator::Topology::CROSSOVER, "crossover" },
+		{ LayoutGenerator::Topology::MIXED,     "mixed" }
+	};
+}
+
+LayoutGenerator::LayoutGenerator(
+	const QString & layout_name,
+	const Options & input) :
+	name(layout_name),
+	options(input)
+{
+	generate();
+}
+
+/*************************************************************************
+**                                                                      **
+**       Topology construction                                          **
+**                                                                      **
+*************************************************************************/
+
+void LayoutGenerator::generate()
+{
+	const bool with_stations =
+		(options.topology == Topology::YARD) ||
+		(options.topology == Topology::MIXED);
+
+	for (unsigned s = 1; s <= std::max(options.stations, 1u); s++)
+	{
+		if (with_stations)
+		{
+			station(s);
+		}
+		line(s);
+	}
+}
+
+void LayoutGenerator::station(const unsigned number)
+{
+	const QString    prefix  = QString("S%1").arg(number);
+	const unsigned   tracks  = std::max(options.tracks, 2u);
+	const int        lower_y = UPPER_Y + 2 * tracks;
+	std::vector<End> west_ends(tracks);
+	std::vector<End> east_ends(tracks);
+
+	addRegion(QString("Station %1").arg(number), true);
+
+	// West entry with the entry signal of the upper track.
+	const int entry_up   = addSection(uniqueName(prefix + "E"));
+	const int entry_down = addSection(uniqueName(prefix + "E"));
+	const int entry_u    = addRail(entry_up,   UPPER_Y);
+	const int entry_l    = addRail(entry_down, lower_y);
+
+	addSignal(entry_up, "Einfahrsignal", true, ENTRY_PINS);
+	connect(upper, { entry_u, 'a' });
+	connect(lower, { entry_l, 'a' });
+	upper = { entry_u, 'b' };
+	lower = { entry_l, 'b' };
+	column++;
+
+	// West switch fan of the upper track.
+	const int west = addSection(uniqueName(prefix + "W"));
+
+	for (unsigned j = 0; (j + 1) < tracks; j++)
+	{
+		const int fork = addSwitch(west, false, UPPER_Y + 2 * j);
+
+		connect(upper, { fork, 'a' });
+		west_ends[j] = { fork, 'c' };
+		upper        = { fork, 'b' };
+		column++;
+	}
+	west_ends[tracks - 1] = upper;
+
+	// Platform tracks with exit signals in both directions.
+	for (unsigned j = 0; j < tracks; j++)
+	{
+		const int platform = addSection(uniqueName(prefix + "P"));
+		const int rail     = addRail(platform, UPPER_Y + 2 * j);
+
+		addSignal(platform, "Ausfahrsignal", true,  EXIT_PINS);
+		addSignal(platform, "Ausfahrsignal", false, EXIT_PINS);
+		connect(west_ends[j], { rail, 'a' });
+		east_ends[j] = { rail, 'b' };
+	}
+
+	// The lower track passes the station.
+	const int through   = addSection(uniqueName(prefix + "T"));
+	const int through_l = addRail(through, lower_y);
+
+	addSignal(through, "Ausfahrsignal", false, EXIT_PINS);
+	connect(lower, { through_l, 'a' });
+	lower = { through_l, 'b' };
+	column++;
+
+	// East switch fan merging into the upper track.
+	const int east = addSection(uniqueName(prefix + "W"));
+	End       straight = east_ends[tracks - 1];
+
+	for (int j = static_cast<int>(tracks) - 2; j >= 0; j--)
+	{
+		const int join = addSwitch(east, true, UPPER_Y + 2 * j);
+
+		connect(straight,     { join, 'b' });
+		connect(east_ends[j], { join, 'c' });
+		straight = { join, 'a' };
+		column++;
+	}
+	upper = straight;
+
+	// East exit with the entry signal of the lower track.
+	const int exit_up   = addSection(uniqueName(prefix + "A"));
+	const int exit_down = addSection(uniqueName(prefix + "A"));
+	const int exit_u    = addRail(exit_up,   UPPER_Y);
+	const int exit_l    = addRail(exit_down, lower_y);
+
+	addSignal(exit_down, "Einfahrsignal", false, ENTRY_PINS);
+	connect(upper, { exit_u, 'a' });
+	connect(lower, { exit_l, 'a' });
+	upper = { exit_u, 'b' };
+	lower = { exit_l, 'b' };
+	column++;
+}
+
+void LayoutGenerator::line(const unsigned number)
+{
+	const QString  prefix = QString("L%1").arg(number);
+	const unsigned blocks = options.topology == Topology::YARD ?
+		std::clamp(options.blocks, 1u, 2u) : std::max(options.blocks, 1u);
+
+	addRegion(QString("Line %1").arg(number), false);
+
+	for (unsigned b = 1; b <= blocks; b++)
+	{
+		block(prefix,
+			(options.crossing_interval > 0) && ((b % options.crossing_interval) == 0));
+
+		if ((options.interval == 0) || ((b % options.interval) != 0) || (b == blocks))
+		{
+			continue;
+		}
+
+		switch (options.topology)
+		{
+		case Topology::LOOP:
+			passingLoop(prefix);
+			break;
+
+		case Topology::CROSSOVER:
+			doubleCrossover(prefix);
+			break;
+
+		case Topology::MIXED:
+			if (((b / options.interval) % 2) != 0)
+			{
+				passingLoop(prefix);
+			}
+			else
+			{
+				doubleCrossover(prefix);
+			}
+			break;
+
+		default:
+			// Intentionally do nothing.
+			break;
+		}
+	}
+}
+
+void LayoutGenerator::block(const QString & prefix, const bool with_crossing)
+{
+	const int section_up   = addSection(uniqueName(prefix + "B"));
+	const int section_down = addSection(uniqueName(prefix + "B"));
+	const int rail_up      = addRail(section_up,   UPPER_Y);
+	const int rail_down    = addRail(section_down, LOWER_Y);
+
+	addSignal(section_up,   "Blocksignal", true,  BLOCK_PINS);
+	addSignal(section_down, "Blocksignal", false, BLOCK_PINS);
+	connect(upper, { rail_up,   'a' });
+	connect(lower, { rail_down, 'a' });
+	upper = { rail_up,   'b' };
+	lower = { rail_down, 'b' };
+	column++;
+
+	if (with_crossing)
+	{
+		addCrossing({ section_up, section_down });
+	}
+}
+
+void LayoutGenerator::passingLoop(const QString & prefix)
+{
+	const int west     = addSection(uniqueName(prefix + "W"));
+	const int fork_up  = addSwitch(west, false, UPPER_Y);
+	const int fork_dn  = addSwitch(west, false, LOWER_Y);
+
+	connect(upper, { fork_up, 'a' });
+	connect(lower, { fork_dn, 'a' });
+	column++;
+
+	const int main_up  = addSection(uniqueName(prefix + "M"));
+	const int loop_up  = addSection(uniqueName(prefix + "M"));
+	const int main_dn  = addSection(uniqueName(prefix + "M"));
+	const int loop_dn  = addSection(uniqueName(prefix + "M"));
+	const int rail_mu  = addRail(main_up, UPPER_Y);
+	const int rail_lu  = addRail(loop_up, LOOP_UPPER_Y);
+	const int rail_md  = addRail(main_dn, LOWER_Y);
+	const int rail_ld  = addRail(loop_dn, LOOP_LOWER_Y);
+
+	addSignal(main_up, "Blocksignal", true,  BLOCK_PINS);
+	addSignal(loop_up, "Blocksignal", true,  BLOCK_PINS);
+	addSignal(main_dn, "Blocksignal", false, BLOCK_PINS);
+	addSignal(loop_dn, "Blocksignal", false, BLOCK_PINS);
+	connect({ fork_up, 'b' }, { rail_mu, 'a' });
+	connect({ fork_up, 'c' }, { rail_lu, 'a' });
+	connect({ fork_dn, 'b' }, { rail_md, 'a' });
+	connect({ fork_dn, 'c' }, { rail_ld, 'a' });
+	column++;
+
+	const int east     = addSection(uniqueName(prefix + "W"));
+	const int join_up  = addSwitch(east, true, UPPER_Y);
+	const int join_dn  = addSwitch(east, true, LOWER_Y);
+
+	connect({ rail_mu, 'b' }, { join_up, 'b' });
+	connect({ rail_lu, 'b' }, { join_up, 'c' });
+	connect({ rail_md, 'b' }, { join_dn, 'b' });
+	connect({ rail_ld, 'b' }, { join_dn, 'c' });
+	upper = { join_up, 'a' };
+	lower = { join_dn, 'a' };
+	column++;
+}
+
+void LayoutGenerator::doubleCrossover(const QString & prefix)
+{
+	const int cross   = addSection(uniqueName(prefix + "X"));
+
+	// First crossover from the upper to the lower track.
+	const int fork_up = addSwitch(cross, false, UPPER_Y);
+	const int join_dn = addSwitch(cross, true,  LOWER_Y);
+
+	column++;
+
+	// Second crossover from the lower to the upper track.
+	const int join_up = addSwitch(cross, true,  UPPER_Y);
+	const int fork_dn = addSwitch(cross, false, LOWER_Y);
+
+	column++;
+
+	connect(upper,            { fork_up, 'a' });
+	connect({ fork_up, 'b' }, { join_up, 'b' });
+	connect({ fork_up, 'c' }, { join_dn, 'c' });
+	connect(lower,            { join_dn, 'b' });
+	connect({ join_dn, 'a' }, { fork_dn, 'a' });
+	connect({ fork_dn, 'c' }, { join_up, 'c' });
+	upper = { join_up, 'a' };
+	lower = { fork_dn, 'b' };
+}
+
+/*************************************************************************
+**                                                                      **
+**       Element creation                                               **
+**                                                                      **
+*************************************************************************/
+
+int LayoutGenerator::addRegion(const QString & region_name, const bool is_station)
+{
+	Region region;
+
+	region.name    = region_name;
+	region.station = is_station;
+	regions.emplace_back(region);
+
+	// Positions are relative to their region.
+	column = 0;
+
+	return regions.size() - 1;
+}
+
+int LayoutGenerator::addSection(const QString & section_name)
+{
+	const int   idx  = sections.size();
+	const int   ctrl = controller(section_slot++ / SECTIONS_PER_MODULE);
+	Section     section;
+
+	section.name       = section_name;
+	section.region     = regions.size() - 1;
+	section.index      = regions.back().sections.size();
+	section.controller = ctrl;
+	section.unit_no    = controllers[ctrl].next_unit++;
+
+	sections.emplace_back(section);
+	regions.back().sections.push_back(idx);
+	controllers[ctrl].sections.push_back(idx);
+
+	return idx;
+}
+
+int LayoutGenerator::addRail(const int section, const int y)
+{
+	const int idx = parts.size();
+	Part      part;
+
+	part.type    = "Gleis";
+	part.name    = uniqueName("g");
+	part.section = section;
+	part.index   = sections[section].parts.size();
+	part.x       = column;
+	part.y       = y;
+
+	parts.emplace_back(part);
+	sections[section].parts.push_back(idx);
+
+	return idx;
+}
+
+int LayoutGenerator::addSwitch(const int section, const bool a_in_dir, const int y)
+{
+	const int idx  = parts.size();
+	const int ctrl = controller(switch_slot++ / SWITCHES_PER_MODULE);
+	Part      part;
+
+	part.type       = "Weiche";
+	part.name       = uniqueName("w");
+	part.section    = section;
+	part.index      = sections[section].parts.size();
+	part.a_in_dir   = a_in_dir;
+	part.controller = ctrl;
+	part.unit_no    = controllers[ctrl].next_unit++;
+	part.x          = column;
+	part.y          = y;
+
+	parts.emplace_back(part);
+	sections[section].parts.push_back(idx);
+	controllers[ctrl].switches.push_back(idx);
+
+	return idx;
+}
+
+int LayoutGenerator::addSignal(
+	const int       section,
+	const QString & type,
+	const bool      in_dir,
+	const unsigned  pins)
+{
+	const int idx  = parts.size();
+	const int rail = sections[section].parts.front();
+	int       ctrl = NONE;
+	int       conn = NONE;
+	Part      part;
+
+	connectMux(pins, ctrl, conn);
+
+	part.type       = type;
+	part.name       = uniqueName(in_dir ? "F" : "B");
+	part.section    = section;
+	part.index      = sections[section].parts.size();
+	part.in_dir     = in_dir;
+	part.controller = ctrl;
+	part.connection = conn;
+	part.unit_no    = controllers[ctrl].next_unit++;
+	part.x          = parts[rail].x;
+	part.y          = parts[rail].y + (in_dir ? 1 : -1);
+
+	parts.emplace_back(part);
+	sections[section].parts.push_back(idx);
+	controllers[ctrl].connections[conn].signals.push_back(idx);
+
+	return idx;
+}
+
+void LayoutGenerator::addCrossing(const std::vector<int> & crossing_sections)
+{
+	const int idx  = crossings.size();
+	int       ctrl = NONE;
+	int       conn = NONE;
+	Crossing  crossing;
+
+	connectMux(CROSSING_PINS, ctrl, conn);
+
+	Connection & connection = controllers[ctrl].connections[conn];
+
+	crossing.name       = uniqueName("Crossing ");
+	crossing.controller = ctrl;
+	crossing.connection = conn;
+	crossing.index      = connection.crossings.size();
+	crossing.unit_no    = controllers[ctrl].next_unit++;
+	crossing.sections   = crossing_sections;
+
+	crossings.emplace_back(crossing);
+	connection.crossings.push_back(idx);
+	for (const int section : crossing_sections)
+	{
+		sections[section].crossing = idx;
+	}
+}
+
+int LayoutGenerator::controller(const size_t index)
+{
+	if (controllers.size() <= index)
+	{
+		controllers.resize(index + 1);
+	}
+	return index;
+}
+
+void LayoutGenerator::connectMux(const unsigned pins, int & ctrl, int & conn)
+{
+	while (true)
+	{
+		const int    idx   = controller(mux_controller);
+		Controller & entry = controllers[idx];
+
+		if ((!entry.connections.empty()) &&
+			((entry.connections.back().pins + pins) <= PINS_PER_CONNECTION))
+		{
+			entry.connections.back().pins += pins;
+			ctrl = idx;
+			conn = entry.connections.size() - 1;
+			return;
+		}
+		else if (entry.connections.size() < CONNECTIONS)
+		{
+			entry.connections.emplace_back();
+		}
+		else
+		{
+			mux_controller++;
+		}
+	}
+}
+
+void LayoutGenerator::connect(const End & left, const End & right)
+{
+	if ((left.part == NONE) || (right.part == NONE))
+	{
+		return;
+	}
+
+	auto slot = [this](const End & end) -> int &
+	{
+		Part & part = parts[end.part];
+
+		switch (end.slot)
+		{
+		case 'b':
+			return part.b;
+
+		case 'c':
+			return part.c;
+
+		default:
+			return part.a;
+		}
+	};
+
+	slot(left)  = right.part;
+	slot(right) = left.part;
+}
+
+QString LayoutGenerator::uniqueName(const QString & prefix)
+{
+	return prefix + QString::number(++counter);
+}
+
+/*************************************************************************
+**                                                                      **
+**       Output                                                         **
+**                                                                      **
+*************************************************************************/
+
+QString LayoutGenerator::filename(const QString & directory) const
+{
+	return QDir(directory).filePath(name + ".modelrailway");
+}
+
+bool LayoutGenerator::write(const QString & directory) const
+{
+	// The controller ID must not collide with the CAN broadcast ID.
+	if (controllers.size() >= CAN_BROADCAST_ID)
+	{
+		return false;
+	}
+
+	QFile file(filename(directory));
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		return false;
+	}
+
+	QXmlStreamWriter xml(&file);
+
+	xml.setAutoFormatting(true);
+	xml.writeStartDocument();
+	writeModel(xml);
+	xml.writeEndDocument();
+	if (xml.hasError() || !file.flush())
+	{
+		return false;
+	}
+
+	QStringList region_lines;
+	QStringList signal_lines;
+	QStringList railpart_lines;
+
+	for (const Region & region : regions)
+	{
+		const QString region_key = (region.station ? "Bahnhof" : "Strecke") + region.name;
+
+		// Values stored as invert direction flag.
+		region_lines << key(region_key) + "=false";
+		for (const int s : region.sections)
+		{
+			for (const int p : sections[s].parts)
+			{
+				const Part  & part     = parts[p];
+				const QString position = QString("%1,%2").arg(part.x).arg(part.y);
+
+				if (part.type == "Gleis")
+				{
+					railpart_lines << key("Gleis" + part.name) + "=" + position;
+				}
+				else if (part.type == "Weiche")
+				{
+					railpart_lines << key("Weiche" + part.name) + "=" + position;
+				}
+				else
+				{
+					signal_lines << key(region_key + part.name) + "=" + position;
+				}
+			}
+		}
+	}
+
+	const QDir dir(directory);
+
+	return
+		writeProperties(dir.filePath(REGION_FILENAME),   region_lines) &&
+		writeProperties(dir.filePath(SIGNAL_FILENAME),   signal_lines) &&
+		writeProperties(dir.filePath(RAILPART_FILENAME), railpart_lines);
+}
+
+void LayoutGenerator::writeModel(QXmlStreamWriter & xml) const
+{
+	xml.writeStartElement("Modelrailway:Modell");
+	xml.writeAttribute("xmi:version", "2.0");
+	xml.writeNamespace("http://www.omg.org/XMI", "xmi");
+	xml.writeNamespace("http://www.w3.org/2001/XMLSchema-instance", "xsi");
+	xml.writeNamespace("http://www.morknet.de/Modelrailway", "Modelrailway");
+	xml.writeAttribute("name", name);
+
+	writeControllers(xml);
+
+	for (const Region & region : regions)
+	{
+		xml.writeStartElement("gruppe");
+		xml.writeAttribute("xsi:type", region.station ? "Modelrailway:Bahnhof" : "Modelrailway:Strecke");
+		xml.writeAttribute("name", region.name);
+
+		for (const int s : region.sections)
+		{
+			const Section & section = sections[s];
+
+			xml.writeStartElement("abschnitt");
+			xml.writeAttribute("name", section.name);
+			xml.writeAttribute("unit_no", QString::number(section.unit_no));
+			xml.writeAttribute("modul", moduleRef(section.controller, false));
+			if (section.crossing != NONE)
+			{
+				xml.writeAttribute("crossing", crossingRef(section.crossing));
+			}
+
+			for (const int p : section.parts)
+			{
+				writePart(xml, parts[p]);
+			}
+			xml.writeEndElement();
+		}
+		xml.writeEndElement();
+	}
+	xml.writeEndElement();
+}
+
+void LayoutGenerator::writeControllers(QXmlStreamWriter & xml) const
+{
+	for (size_t c = 0; c < controllers.size(); c++)
+	{
+		const Controller & ctrl = controllers[c];
+		const int          base = (c + 1) * 10;
+
+		xml.writeStartElement("controller");
+		xml.writeAttribute("id", QString::number(c + 1));
+
+		for (size_t n = 0; n < ctrl.connections.size(); n++)
+		{
+			const Connection & connection = ctrl.connections[n];
+			QStringList        references;
+
+			for (const int signal : connection.signals)
+			{
+				references << partRef(signal);
+			}
+
+			xml.writeStartElement("anschluesse");
+			xml.writeAttribute("nummer", QString::number(base + 3 + n));
+			if (!references.isEmpty())
+			{
+				xml.writeAttribute("lichtsignale", references.join(' '));
+			}
+
+			for (const int crx : connection.crossings)
+			{
+				QStringList crossing_sections;
+
+				for (const int section : crossings[crx].sections)
+				{
+					crossing_sections << sectionRef(section);
+				}
+
+				xml.writeStartElement("crossing");
+				xml.writeAttribute("name", crossings[crx].name);
+				xml.writeAttribute("unit_no", QString::number(crossings[crx].unit_no));
+				xml.writeAttribute("abschnitte", crossing_sections.join(' '));
+				xml.writeEndElement();
+			}
+			xml.writeEndElement();
+		}
+
+		if (!ctrl.sections.empty())
+		{
+			QStringList references;
+
+			for (const int section : ctrl.sections)
+			{
+				references << sectionRef(section);
+			}
+
+			xml.writeStartElement("module");
+			xml.writeAttribute("xsi:type", "Modelrailway:Gleismodul");
+			xml.writeAttribute("nummer", QString::number(base + 1));
+			xml.writeAttribute("abschnitte", references.join(' '));
+			xml.writeEndElement();
+		}
+
+		if (!ctrl.switches.empty())
+		{
+			QStringList references;
+
+			for (const int part : ctrl.switches)
+			{
+				references << partRef(part);
+			}
+
+			xml.writeStartElement("module");
+			xml.writeAttribute("xsi:type", "Modelrailway:Impulsmodul");
+			xml.writeAttribute("nummer", QString::number(base + 2));
+			xml.writeAttribute("magnetartikel", references.join(' '));
+			xml.writeEndElement();
+		}
+		xml.writeEndElement();
+	}
+}
+
+void LayoutGenerator::writePart(QXmlStreamWriter & xml, const Part & part) const
+{
+	xml.writeStartElement("bauelement");
+	xml.writeAttribute("xsi:type", "Modelrailway:" + part.type);
+	xml.writeAttribute("name", part.name);
+	if (part.a_in_dir)
+	{
+		xml.writeAttribute("aInZaehlrichtung", "true");
+	}
+
+	if (part.type == "Weiche")
+	{
+		xml.writeAttribute("modul", moduleRef(part.controller, true));
+		xml.writeAttribute("unit_no", QString::number(part.unit_no));
+		xml.writeAttribute("neu", "true");
+		xml.writeAttribute("cIstAbzweig", "true");
+	}
+	else if (part.connection != NONE)
+	{
+		xml.writeAttribute("unit_no", QString::number(part.unit_no));
+		if (part.in_dir)
+		{
+			xml.writeAttribute("inZaehlrichtung", "true");
+		}
+		xml.writeAttribute("anschluss", connectionRef(part.controller, part.connection));
+	}
+
+	if (part.a != NONE)
+	{
+		xml.writeAttribute("a", partRef(part.a));
+	}
+	if (part.b != NONE)
+	{
+		xml.writeAttribute("b", partRef(part.b));
+	}
+	if (part.c != NONE)
+	{
+		xml.writeAttribute("c", partRef(part.c));
+	}
+	xml.writeEndElement();
+}
+
+bool LayoutGenerator::writeProperties(
+	const QString   &  properties_filename,
+	const QStringList & lines) const
+{
+	QFile file(properties_filename);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		return false;
+	}
+
+	QTextStream out(&file);
+
+	out << "# Generated positions of " << name << Qt::endl;
+	for (const QString & line : lines)
+	{
+		out << line << Qt::endl;
+	}
+	return out.status() == QTextStream::Ok;
+}
+
+QString LayoutGenerator::toString() const
+{
+	size_t switch_count = 0;
+
+	for (const Controller & ctrl : controllers)
+	{
+		switch_count += ctrl.switches.size();
+	}
+
+	const size_t rail_count = std::count_if(parts.begin(), parts.end(), [](const Part & part)
+	{
+		return part.type == "Gleis";
+	});
+
+	return QString("%1: %2 regions, %3 sections, %4 rails, %5 switches, %6 signals, %7 crossings, %8 controllers").
+		arg(name).
+		arg(regions.size()).
+		arg(sections.size()).
+		arg(rail_count).
+		arg(switch_count).
+		arg(parts.size() - rail_count - switch_count).
+		arg(crossings.size()).
+		arg(controllers.size());
+}
+
+/*************************************************************************
+**                                                                      **
+**       EMF references                                                 **
+**                                                                      **
+*************************************************************************/
+
+QString LayoutGenerator::partRef(const int part) const
+{
+	const Section & section = sections[parts[part].section];
+
+	return QString("//@gruppe.%1/@abschnitt.%2/@bauelement.%3").
+		arg(section.region).arg(section.index).arg(parts[part].index);
+}
+
+QString LayoutGenerator::sectionRef(const int section) const
+{
+	return QString("//@gruppe.%1/@abschnitt.%2").
+		arg(sections[section].region).arg(sections[section].index);
+}
+
+QString LayoutGenerator::moduleRef(const int ctrl, const bool switch_module) const
+{
+	// Only used modules are written so the switch module may be the
+	// first one.
+	const int index = switch_module && !controllers[ctrl].sections.empty() ? 1 : 0;
+
+	return QString("//@controller.%1/@module.%2").arg(ctrl).arg(index);
+}
+
+QString LayoutGenerator::connectionRef(const int ctrl, const int conn) const
+{
+	return QString("//@controller.%1/@anschluesse.%2").arg(ctrl).arg(conn);
+}
+
+QString LayoutGenerator::crossingRef(const int crossing) const
+{
+	const Crossing & crx = crossings[crossing];
+
+	return QString("//@controller.%1/@anschluesse.%2/@crossing.%3").
+		arg(crx.controller).arg(crx.connection).arg(crx.index);
+}
+
+QString LayoutGenerator::key(const QString & input)
+{
+	QString result = input;
+
+	return result.replace(" ", "");
+}
+
+/*************************************************************************
+**                                                                      **
+**       Topology names                                                 **
+**                                                                      **
+*************************************************************************/
+
+LayoutGenerator::Topology LayoutGenerator::topology(const QString & topology_name, bool & ok)
+{
+	for (const auto & [value, text] : topology_names)
+	{
+		if (topology_name == text)
+		{
+			ok = true;
+			return value;
+		}
+	}
+	ok = false;
+	return Topology::MIXED;
+}
+
+QStringList LayoutGenerator::topologies()
+{
+	QStringList names;
+
+	for (const auto & [value, text] : topology_names)
+	{
+		names << text;
+	}
+	return names;
+}
@@ -0,0 +1,270 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef LAYOUTGENERATOR_H
+#define LAYOUTGENERATOR_H
+
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+class QXmlStreamWriter;
+
+/**
+ * This class generates synthetic modelrailway files of arbitrary size
+ * including the position, region and signal properties files used by the
+ * ModelRepository.
+ *
+ * The generated layout is a double track line running in counting
+ * direction from left to right. The upper track is used in counting
+ * direction and the lower track against it. Depending on the Topology the
+ * line is assembled from stations with a fan of platform tracks, long
+ * main lines with block signals and road crossings, passing loops and
+ * double crossovers connecting both tracks.
+ *
+ * Devices are distributed over as many controllers as needed while
+ * respecting the limits of the controller hardware. Each controller uses
+ * one section module, one switch module with cut off and up to four
+ * multiplex connections driving light signals and road crossings.
+ *
+ * @see mrw::model::ModelRepository
+ */
+class LayoutGenerator
+{
+public:
+	/**
+	 * The topology selects which elements are inserted between the
+	 * block sections of the main lines.
+	 */
+	enum class Topology
+	{
+		/** Main lines with block signals and crossings only. */
+		MAINLINE,
+
+		/** Stations with platform tracks connected by short lines. */
+		YARD,
+
+		/** Main lines with passing loops. */
+		LOOP,
+
+		/** Main lines with double crossovers. */
+		CROSSOVER,
+
+		/** Stations and main lines with loops and crossovers. */
+		MIXED
+	};
+
+	/**
+	 * The options controlling the size of the generated layout.
+	 */
+	struct Options
+	{
+		/** The selected topology. */
+		Topology topology          = Topology::MIXED;
+
+		/** The amount of stations each followed by a main line. */
+		unsigned stations          = 10;
+
+		/** The amount of block sections of each main line. */
+		unsigned blocks            = 20;
+
+		/** The amount of platform tracks of each station. */
+		unsigned tracks            = 6;
+
+		/** The amount of blocks between two loops or crossovers. */
+		unsigned interval          = 5;
+
+		/** The amount of blocks between two road crossings. */
+		unsigned crossing_interval = 7;
+	};
+
+	static const char * REGION_FILENAME;
+	static const char * SIGNAL_FILENAME;
+	static const char * RAILPART_FILENAME;
+
+	explicit LayoutGenerator(const QString & layout_name, const Options & options);
+	LayoutGenerator() = delete;
+
+	/**
+	 * This method writes the modelrailway file and the three properties
+	 * files into the given directory. The modelrailway file is named by
+	 * the layout name.
+	 *
+	 * @param directory The target directory which has to exist.
+	 * @return True on success.
+	 */
+	bool write(const QString & directory) const;
+
+	/**
+	 * This method returns the filename of the written modelrailway file
+	 * inside the given directory.
+	 *
+	 * @param directory The target directory.
+	 * @return The modelrailway filename.
+	 */
+	QString filename(const QString & directory) const;
+
+	/**
+	 * This method returns a human readable summary of the generated
+	 * element counts.
+	 *
+	 * @return The summary.
+	 */
+	QString toString() const;
+
+	/**
+	 * This method parses a Topology from its lower case name.
+	 *
+	 * @param topology_name The topology name.
+	 * @param ok Set to true on success.
+	 * @return The parsed Topology.
+	 */
+	static Topology topology(const QString & topology_name, bool & ok);
+
+	/**
+	 * This method returns the lower case names of all topologies.
+	 *
+	 * @return The topology names.
+	 */
+	static QStringList topologies();
+
+private:
+	static constexpr unsigned SECTIONS_PER_MODULE  = 4;
+	static constexpr unsigned SWITCHES_PER_MODULE  = 4;
+	static constexpr unsigned CONNECTIONS          = 4;
+	static constexpr unsigned PINS_PER_CONNECTION  = 16;
+
+	static constexpr unsigned BLOCK_PINS    = 2;
+	static constexpr unsigned ENTRY_PINS    = 3;
+	static constexpr unsigned EXIT_PINS     = 5;
+	static constexpr unsigned CROSSING_PINS = 1;
+
+	static constexpr int      NONE = -1;
+
+	/**
+	 * This struct describes one side of a rail part by its index and the
+	 * connector name.
+	 */
+	struct End
+	{
+		int  part = NONE;
+		char slot = 'a';
+	};
+
+	struct Part
+	{
+		QString  type;
+		QString  name;
+		int      section    = NONE;
+		int      index      = 0;
+		bool     a_in_dir   = false;
+		bool     in_dir     = false;
+		int      a          = NONE;
+		int      b          = NONE;
+		int      c          = NONE;
+		int      controller = NONE;
+		int      connection = NONE;
+		unsigned unit_no    = 0;
+		int      x          = 0;
+		int      y          = 0;
+	};
+
+	struct Section
+	{
+		QString  name;
+		int      region     = NONE;
+		int      index      = 0;
+		int      controller = NONE;
+		unsigned unit_no    = 0;
+		int      crossing   = NONE;
+		std::vector<int> parts;
+	};
+
+	struct Region
+	{
+		QString          name;
+		bool             station = false;
+		std::vector<int> sections;
+	};
+
+	struct Crossing
+	{
+		QString          name;
+		int              controller = NONE;
+		int              connection = NONE;
+		int              index      = 0;
+		unsigned         unit_no    = 0;
+		std::vector<int> sections;
+	};
+
+	struct Connection
+	{
+		unsigned         pins = 0;
+		std::vector<int> signals;
+		std::vector<int> crossings;
+	};
+
+	struct Controller
+	{
+		std::vector<int>        sections;
+		std::vector<int>        switches;
+		std::vector<Connection> connections;
+		unsigned                next_unit = 1;
+	};
+
+	const QString            name;
+	const Options            options;
+
+	std::vector<Part>        parts;
+	std::vector<Section>     sections;
+	std::vector<Region>      regions;
+	std::vector<Crossing>    crossings;
+	std::vector<Controller>  controllers;
+
+	size_t                   section_slot   = 0;
+	size_t                   switch_slot    = 0;
+	int                      mux_controller = 0;
+
+	End                      upper;
+	End                      lower;
+	int                      column         = 0;
+	unsigned                 counter        = 0;
+
+	void    generate();
+	void    station(const unsigned number);
+	void    line(const unsigned number);
+	void    block(const QString & prefix, const bool with_crossing);
+	void    passingLoop(const QString & prefix);
+	void    doubleCrossover(const QString & prefix);
+
+	int     addRegion(const QString & region_name, const bool is_station);
+	int     addSection(const QString & section_name);
+	int     addRail(const int section, const int y);
+	int     addSwitch(const int section, const bool a_in_dir, const int y);
+	int     addSignal(const int section, const QString & type, const bool in_dir, const unsigned pins);
+	void    addCrossing(const std::vector<int> & crossing_sections);
+
+	int     controller(const size_t index);
+	void    connectMux(const unsigned pins, int & ctrl, int & conn);
+	void    connect(const End & left, const End & right);
+	QString uniqueName(const QString & prefix);
+
+	void    writeModel(QXmlStreamWriter & xml) const;
+	void    writeControllers(QXmlStreamWriter & xml) const;
+	void    writePart(QXmlStreamWriter & xml, const Part & part) const;
+	bool    writeProperties(const QString & filename, const QStringList & lines) const;
+
+	QString partRef(const int part) const;
+	QString sectionRef(const int section) const;
+	QString moduleRef(const int ctrl, const bool switch_module) const;
+	QString connectionRef(const int ctrl, const int conn) const;
+	QString crossingRef(const int crossing) const;
+	static QString key(const QString & input);
+};
+
+#endif
@@ -0,0 +1,123 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QLoggingCategory>
+
+#include <util/duration.h>
+#include <model/modelrailway.h>
+
+#include "layoutgenerator.h"
+
+using namespace mrw::util;
+using namespace mrw::model;
+
+static bool number(const char * arg, unsigned & value)
+{
+	bool           ok     = false;
+	const unsigned result = QString(arg).toUInt(&ok);
+
+	if (ok)
+	{
+		value = result;
+	}
+	return ok;
+}
+
+static bool verify(const QLoggingCategory & log, const QString & filename)
+{
+	ModelRailway         model(filename);
+	const MrwStatistic & statistics = model.statistics();
+
+	qCInfo(log, "Regions:       %5zu", statistics.region_count);
+	qCInfo(log, "Devices:       %5zu", statistics.device_count);
+	qCInfo(log, "Sections:      %5zu", statistics.section_count);
+	qCInfo(log, "Switches:      %5zu", statistics.switch_count);
+	qCInfo(log, "Signals:       %5zu", statistics.signal_count);
+	qCInfo(log, "Warnings:      %5zu", statistics.warnings);
+	qCInfo(log, "Errors:        %5zu", statistics.errors);
+
+	return model.valid() && (statistics.warnings == 0);
+}
+
+int main(int argc, char * argv[])
+{
+	QCoreApplication           app(argc, argv);
+	QLoggingCategory           log("mrw.tools.generator");
+	LayoutGenerator::Options   options;
+	QStringList                positional;
+	bool                       do_verify = false;
+	bool                       ok        = true;
+
+	Duration::pattern();
+	for (int i = 1; (i < argc) && ok; i++)
+	{
+		const bool has_value = (i + 1) < argc;
+
+		if (qstrcmp(argv[i], "--verify") == 0)
+		{
+			do_verify = true;
+		}
+		else if ((qstrcmp(argv[i], "--topology") == 0) && has_value)
+		{
+			options.topology = LayoutGenerator::topology(argv[++i], ok);
+		}
+		else if ((qstrcmp(argv[i], "--stations") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.stations);
+		}
+		else if ((qstrcmp(argv[i], "--blocks") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.blocks);
+		}
+		else if ((qstrcmp(argv[i], "--tracks") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.tracks);
+		}
+		else if ((qstrcmp(argv[i], "--interval") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.interval);
+		}
+		else if ((qstrcmp(argv[i], "--crossings") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.crossing_interval);
+		}
+		else if (argv[i][0] != '-')
+		{
+			positional << argv[i];
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	if (!ok || positional.isEmpty() || (positional.size() > 2))
+	{
+		qCCritical(log).noquote() <<
+			"Usage: MRW-Generator [--topology " + LayoutGenerator::topologies().join('|') + "]" <<
+			"[--stations n] [--blocks n] [--tracks n] [--interval n] [--crossings n]" <<
+			"[--verify] <name> [directory]";
+		return EXIT_FAILURE;
+	}
+
+	const QString         directory = positional.size() > 1 ? positional[1] : QDir::currentPath();
+	const LayoutGenerator generator(positional[0], options);
+
+	if (!QDir().mkpath(directory) || !generator.write(directory))
+	{
+		qCCritical(log).noquote() << "Cannot write layout into" << directory;
+		return EXIT_FAILURE;
+	}
+	qCInfo(log).noquote() << generator.toString();
+
+	if (do_verify && !verify(log, generator.filename(directory)))
+	{
+		qCCritical(log).noquote() << "Generated layout is not valid!";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
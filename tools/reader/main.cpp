@@ -4,24 +4,88 @@
 //
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
 #include <util/duration.h>
 #include <model/modelrailway.h>
+#include <model/modelsnapshot.h>
 #include <model/abstractswitch.h>
 #include <model/signal.h>
 
 using namespace mrw::util;
 using namespace mrw::model;
 
+static constexpr int LOOPS = 20;
+
+static bool snapshot(const QLoggingCategory & log, const QString & filename)
+{
+	const QString         & snapshot_filename = ModelSnapshot::filename(filename);
+	ModelSnapshot::Recorder recorder;
+	const ModelRailway      xml_model(filename, false, &recorder);
+	QElapsedTimer           timer;
+	qint64                  xml_time      = 0;
+	qint64                  snapshot_time = 0;
+
+	if (!ModelSnapshot::write(snapshot_filename, { filename }, xml_model, recorder, ModelSnapshot::Positions()))
+	{
+		qCCritical(log).noquote() << "Cannot write snapshot" << snapshot_filename;
+		return false;
+	}
+
+	const ModelSnapshot snapshot(snapshot_filename);
+
+	if (!snapshot.valid({ filename }))
+	{
+		qCCritical(log).noquote() << "Invalid snapshot" << snapshot_filename;
+		return false;
+	}
+
+	const ModelRailway snapshot_model(snapshot);
+
+	if (!snapshot.matches(snapshot_model) ||
+		!(xml_model.statistics() == snapshot_model.statistics()))
+	{
+		qCCritical(log).noquote() << "Snapshot differs from" << filename;
+		return false;
+	}
+
+	timer.start();
+	for (int i = 0; i < LOOPS; i++)
+	{
+		ModelRailway model(filename);
+	}
+	xml_time = timer.nsecsElapsed();
+
+	timer.restart();
+	for (int i = 0; i < LOOPS; i++)
+	{
+		ModelRailway model(snapshot);
+	}
+	snapshot_time = timer.nsecsElapsed();
+
+	qCInfo(log, "XML load:      %8.3f ms", xml_time      / 1000000.0 / LOOPS);
+	qCInfo(log, "Snapshot load: %8.3f ms", snapshot_time / 1000000.0 / LOOPS);
+
+	return true;
+}
+
 int main(int argc, char * argv[])
 {
 	QCoreApplication app(argc, argv);
 	QLoggingCategory log("mrw.tools.reader");
+	bool             use_snapshot = false;
+	int              result       = EXIT_SUCCESS;
 
 	Duration::pattern();
 	for (int i = 1; i < argc; i++)
 	{
+		if (qstrcmp(argv[i], "--snapshot") == 0)
+		{
+			use_snapshot = true;
+			continue;
+		}
+
 		ModelRailway model(argv[i]);
 		const MrwStatistic & statistics = model.statistics();
 
@@ -34,6 +98,11 @@ int main(int argc, char * argv[])
 		qCInfo(log, "Signal groups: %3zu", statistics.signal_group_count);
 		qCInfo(log, "Main signals:  %3zu", statistics.main_signal_count);
 		model.info();
+
+		if (use_snapshot && !snapshot(log, argv[i]))
+		{
+			result = EXIT_FAILURE;
+		}
 	}
-	return EXIT_SUCCESS;
+	return result;
 }
@@ -0,0 +1,27 @@
+#
+#  SPDX-License-Identifier: MIT
+#  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+#
+
+QT -= gui
+
+include(../../common.pri)
+
+CONFIG += console
+
+SOURCES += \
+	main.cpp \
+	recording.cpp \
+	replayservice.cpp
+
+HEADERS += \
+	recording.h \
+	replayservice.h
+
+LIBS            += -lMRW-Can -lMRW-Statecharts -lMRW-Util
+
+QMAKE_CLEAN     += $$TARGET
+
+install.files    = $$TARGET
+
+INSTALLS        += install
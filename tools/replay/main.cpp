@@ -0,0 +1,103 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <QCoreApplication>
+#include <QLoggingCategory>
+
+#include <util/duration.h>
+#include <util/dumphandler.h>
+#include <util/termhandler.h>
+#include <can/cansettings.h>
+
+#include "recording.h"
+#include "replayservice.h"
+
+using namespace mrw::util;
+using namespace mrw::can;
+
+static bool number(const char * arg, unsigned & value)
+{
+	bool           ok     = false;
+	const unsigned result = QString(arg).toUInt(&ok);
+
+	if (ok)
+	{
+		value = result;
+	}
+	return ok;
+}
+
+int main(int argc, char * argv[])
+{
+	QCoreApplication         app(argc, argv);
+	QLoggingCategory         log("mrw.tools.replay");
+	ReplayService::Options   options;
+	QStringList              positional;
+	unsigned                 gap             = 500;
+	bool                     inject_requests = false;
+	bool                     ok              = true;
+
+	Duration::pattern();
+	for (int i = 1; (i < argc) && ok; i++)
+	{
+		const bool has_value = (i + 1) < argc;
+
+		if (qstrcmp(argv[i], "--fast") == 0)
+		{
+			options.fast = true;
+		}
+		else if (qstrcmp(argv[i], "--requests") == 0)
+		{
+			inject_requests = true;
+		}
+		else if ((qstrcmp(argv[i], "--speed") == 0) && has_value)
+		{
+			options.speed = QString(argv[++i]).toDouble(&ok);
+			ok &= options.speed > 0;
+		}
+		else if ((qstrcmp(argv[i], "--timeout") == 0) && has_value)
+		{
+			ok = number(argv[++i], options.timeout);
+		}
+		else if ((qstrcmp(argv[i], "--gap") == 0) && has_value)
+		{
+			ok = number(argv[++i], gap);
+		}
+		else if (argv[i][0] != '-')
+		{
+			positional << argv[i];
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	if (!ok || (positional.size() != 1))
+	{
+		qCCritical(log).noquote() <<
+			"Usage: MRW-Replay [--fast] [--speed f] [--timeout ms] [--gap ms] [--requests]" <<
+			"<candump log|trace file>";
+		return EXIT_FAILURE;
+	}
+
+	Recording recording(gap);
+
+	if (!recording.load(positional[0], inject_requests))
+	{
+		qCCritical(log).noquote() << "Cannot read CAN frames from" << positional[0];
+		return EXIT_FAILURE;
+	}
+
+	TermHandler           term_handler;
+	CanSettings           settings;
+	ReplayService         service(recording, options, settings.interface(), settings.plugin());
+	DumpHandler           dumper([&]()
+	{
+		service.info();
+	});
+
+	return app.exec();
+}
@@ -0,0 +1,169 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+
+#include <QFile>
+#include <QRegularExpression>
+
+#include <util/tracefile.h>
+#include <can/mrwmessage.h>
+
+#include "recording.h"
+
+using namespace mrw::can;
+using namespace mrw::util;
+
+Recording::Recording(const unsigned gap_ms) : gap_ns(uint64_t(gap_ms) * 1000000)
+{
+}
+
+bool Recording::load(const QString & filename, const bool inject_requests)
+{
+	QFile file(filename);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	const bool is_trace = file.read(8) == "MRWTRACE";
+
+	file.close();
+	return is_trace ? loadTrace(filename) : loadCandump(filename, inject_requests);
+}
+
+const std::vector<Recording::Step> & Recording::steps() const noexcept
+{
+	return recording_steps;
+}
+
+size_t Recording::activations() const noexcept
+{
+	return routes.size();
+}
+
+bool Recording::isRoute(const size_t activation) const
+{
+	return routes.at(activation);
+}
+
+size_t Recording::frames() const noexcept
+{
+	return frame_count;
+}
+
+bool Recording::loadTrace(const QString & filename)
+{
+	const TraceFile trace(filename);
+
+	if (!trace.valid())
+	{
+		return false;
+	}
+
+	for (const TraceRecord & record : trace.records())
+	{
+		const bool input = record.type == uint8_t(TraceType::CAN_RX);
+
+		if (input || (record.type == uint8_t(TraceType::CAN_TX)))
+		{
+			const WireMessage wire(
+				record.source & ~TraceRecorder::EXTENDED,
+				(record.source & TraceRecorder::EXTENDED) != 0,
+				record.data, record.length);
+
+			append(record.time, wire, input);
+		}
+	}
+	return frame_count > 0;
+}
+
+bool Recording::loadCandump(const QString & filename, const bool inject_requests)
+{
+	// Matches "(1436509052.249713) can0 044C#0011" of candump -l and
+	// "(1436509052.249713)  can0  044C   [2]  00 11" of candump -ta.
+	static const QRegularExpression pattern(
+		R"(^\s*\((\d+)\.(\d+)\)\s+\S+\s+([0-9A-Fa-f]+)(?:#([0-9A-Fa-f]*)|\s+\[\d\]\s*((?:[0-9A-Fa-f]{2}\s*)*))\s*$)");
+
+	QFile file(filename);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return false;
+	}
+
+	while (!file.atEnd())
+	{
+		const QString                  line  = QString::fromLatin1(file.readLine());
+		const QRegularExpressionMatch  match = pattern.match(line);
+
+		if (!match.hasMatch())
+		{
+			continue;
+		}
+
+		const QString    fraction = match.captured(2).left(9).leftJustified(9, '0');
+		const uint64_t   time_ns  = match.captured(1).toULongLong() * 1000000000ull + fraction.toULongLong();
+		const QString    id       = match.captured(3);
+		const QByteArray payload  = QByteArray::fromHex(
+				(match.captured(4) + match.captured(5)).remove(' ').toLatin1());
+
+		const WireMessage wire(
+			id.toUInt(nullptr, 16), id.size() > 3,
+			reinterpret_cast<const uint8_t *>(payload.constData()), payload.size());
+
+		append(time_ns, wire, MrwMessage(wire).isResponse() != inject_requests);
+	}
+	return frame_count > 0;
+}
+
+void Recording::append(const uint64_t time_ns, const WireMessage & wire, const bool input)
+{
+	const MrwMessage message(wire);
+	const Command    cmd   = message.command();
+	const bool       quiet = (frame_count == 0) || (time_ns > (last_ns + gap_ns));
+
+	// Frames recorded by different threads may be slightly out of order.
+	const uint64_t   stamp = std::max(time_ns, last_ns);
+
+	if (frame_count == 0)
+	{
+		first_ns = time_ns;
+	}
+	if (quiet)
+	{
+		routes.push_back(false);
+	}
+
+	if (input || quiet)
+	{
+		Step step;
+
+		step.time_ns    = stamp - first_ns;
+		step.activation = routes.size() - 1;
+		recording_steps.push_back(step);
+	}
+
+	Step & step = recording_steps.back();
+
+	if (input)
+	{
+		step.has_input = true;
+		step.input     = wire;
+	}
+	else
+	{
+		step.expected.push_back(wire);
+	}
+
+	if ((cmd == SETLFT) || (cmd == SETRGT) || (cmd == SETRON) || (cmd == SETROF))
+	{
+		routes.back() = true;
+	}
+
+	last_ns = stamp;
+	frame_count++;
+}
@@ -0,0 +1,122 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+
+#include <can/wiremessage.h>
+
+/**
+ * This class contains a recorded CAN session prepared for replay. The
+ * session is read either from a candump log or from a trace file written
+ * by the mrw::util::TraceRecorder.
+ *
+ * Each frame is either an input which is injected into the application
+ * under test or an output the application is expected to send. The
+ * recording is split into steps. A step consists of one input and all
+ * outputs recorded until the next input. The outputs recorded before the
+ * first input form a step without input.
+ *
+ * Steps recorded without a quiet gap between them form an activation. An
+ * activation containing a switch or section command is a route
+ * activation.
+ */
+class Recording
+{
+public:
+	/**
+	 * One input frame together with its expected reaction.
+	 */
+	struct Step
+	{
+		/** The recorded time since the first frame in nanoseconds. */
+		uint64_t                              time_ns    = 0;
+
+		/** True if the step starts with an input. */
+		bool                                  has_input  = false;
+
+		/** The frame to inject. */
+		mrw::can::WireMessage                 input;
+
+		/** The frames the application under test is expected to send. */
+		std::vector<mrw::can::WireMessage>    expected;
+
+		/** The index of the activation this step belongs to. */
+		size_t                                activation = 0;
+	};
+
+	/**
+	 * The constructor creates an empty recording.
+	 *
+	 * @param gap_ms The quiet time in milliseconds separating two
+	 * activations.
+	 */
+	explicit Recording(const unsigned gap_ms);
+	Recording() = delete;
+
+	/**
+	 * This method loads a recorded CAN session. A trace file is detected
+	 * by its magic. Any other file is read as candump log. In trace files
+	 * the received frames are the inputs. In candump logs the direction
+	 * is given by the parameter.
+	 *
+	 * @param filename The recorded session.
+	 * @param inject_requests True if the requests of a candump log are
+	 * the inputs. Otherwise the responses are the inputs.
+	 * @return True on success.
+	 */
+	bool load(const QString & filename, const bool inject_requests);
+
+	/**
+	 * This method returns the recorded steps in recording order.
+	 *
+	 * @return The recorded steps.
+	 */
+	const std::vector<Step> & steps() const noexcept;
+
+	/**
+	 * This method returns the amount of activations.
+	 *
+	 * @return The amount of activations.
+	 */
+	size_t activations() const noexcept;
+
+	/**
+	 * This method returns true if the given activation contains a switch
+	 * or section command.
+	 *
+	 * @param activation The index of the activation.
+	 * @return True if the activation is a route activation.
+	 */
+	bool isRoute(const size_t activation) const;
+
+	/**
+	 * This method returns the amount of loaded frames.
+	 *
+	 * @return The amount of loaded frames.
+	 */
+	size_t frames() const noexcept;
+
+private:
+	bool loadTrace(const QString & filename);
+	bool loadCandump(const QString & filename, const bool inject_requests);
+	void append(const uint64_t time_ns, const mrw::can::WireMessage & wire, const bool input);
+
+	const uint64_t            gap_ns;
+	std::vector<Step>         recording_steps;
+	std::vector<bool>         routes;
+	uint64_t                  first_ns    = 0;
+	uint64_t                  last_ns     = 0;
+	size_t                    frame_count = 0;
+};
+
+#endif
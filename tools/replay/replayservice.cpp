@@ -0,0 +1,266 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <QCoreApplication>
+
+#include <statecharts/timerservice.h>
+
+#include "replayservice.h"
+
+using namespace mrw::can;
+
+using mrw::statechart::TimerService;
+
+static void statistics(
+	const QLoggingCategory & log,
+	const QString      &     label,
+	std::vector<double>   &  values)
+{
+	if (values.empty())
+	{
+		return;
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const double sum = std::accumulate(values.begin(), values.end(), 0.0);
+
+	qCInfo(log, "  %-16s %7zu %10.3f %10.3f %10.3f %10.3f %10.3f",
+		label.toLatin1().constData(), values.size(),
+		values.front(), sum / values.size(),
+		values[values.size() / 2],
+		values[std::min(values.size() - 1, values.size() * 99 / 100)],
+		values.back());
+}
+
+ReplayService::ReplayService(
+	const Recording    &    input,
+	const Options     &     replay_options,
+	const QString     &     interface,
+	const QString     &     plugin,
+	QObject          *      parent) :
+	MrwBusService(interface, plugin, parent),
+	log("mrw.tools.replay"),
+	recording(input),
+	options(replay_options),
+	progress(input.steps().size()),
+	activations(input.activations())
+{
+	for (const Recording::Step & step : recording.steps())
+	{
+		activations[step.activation].steps++;
+	}
+
+	connect(this, &MrwBusService::connected, this, &ReplayService::start);
+}
+
+void ReplayService::info()
+{
+	const size_t total   = recording.steps().size();
+	const double elapsed = clock.isValid() ? clock.nsecsElapsed() / 1000000.0 : 0.0;
+
+	qCInfo(log, "Replay: %zu frames, %zu of %zu steps written, %zu completed",
+		recording.frames(), next_step, total, completed);
+	qCInfo(log, "  %zu incomplete, %zu timeouts, %zu unexpected frames, %zu activations",
+		next_step - completed, timeouts, unexpected, recording.activations());
+	qCInfo(log, "  Duration: %.3f ms, %.1f steps/s", elapsed,
+		elapsed > 0 ? next_step * 1000.0 / elapsed : 0.0);
+
+	qCInfo(log, "Latency [ms]       %7s %10s %10s %10s %10s %10s",
+		"count", "min", "avg", "median", "p99", "max");
+	for (auto & [command, values] : latencies)
+	{
+		statistics(log, MrwMessage::get(command), values);
+	}
+	statistics(log, "Route", route_times);
+}
+
+void ReplayService::process(const MrwMessage & message)
+{
+	if (!started)
+	{
+		return;
+	}
+
+	auto it = expected.find(key(message.wire()));
+
+	if (it == expected.end())
+	{
+		unexpected++;
+		return;
+	}
+
+	const size_t index = it->second.front();
+
+	it->second.pop_front();
+	if (it->second.empty())
+	{
+		expected.erase(it);
+	}
+
+	if (--progress[index].pending == 0)
+	{
+		complete(index);
+
+		if (options.fast && ((index + 1) == next_step))
+		{
+			// Cancel the timeout and write the next input.
+			ticket++;
+			advance();
+		}
+		else if ((next_step == progress.size()) && (completed == progress.size()))
+		{
+			finish();
+		}
+	}
+}
+
+ReplayService::Key ReplayService::key(const WireMessage & wire) noexcept
+{
+	uint64_t payload = 0;
+
+	std::memcpy(&payload, wire.data(), wire.length());
+	return Key(wire.frameId(), wire.isExtended(), wire.length(), payload);
+}
+
+void ReplayService::start()
+{
+	if (started)
+	{
+		return;
+	}
+
+	qCInfo(log, "Replaying %zu steps %s...", progress.size(), options.fast ? "as fast as possible" : "with original timing");
+	started = true;
+	clock.start();
+	advance();
+}
+
+void ReplayService::advance()
+{
+	const std::vector<Recording::Step> & steps = recording.steps();
+
+	while (next_step < steps.size())
+	{
+		if (options.fast)
+		{
+			const size_t previous = next_step - 1;
+
+			if ((next_step > 0) && (progress[previous].pending > 0) && !progress[previous].released)
+			{
+				const uint64_t current = ++ticket;
+
+				TimerService::instance().singleShot(options.timeout, [this, current, previous]()
+				{
+					if (current == ticket)
+					{
+						timeouts++;
+						progress[previous].released = true;
+						advance();
+					}
+				});
+				return;
+			}
+		}
+		else
+		{
+			const qint64 due   = qint64(steps[next_step].time_ns / options.speed);
+			const qint64 delay = (due - clock.nsecsElapsed()) / 1000000;
+
+			if (delay > 0)
+			{
+				TimerService::instance().singleShot(sc::time(delay), [this]()
+				{
+					advance();
+				});
+				return;
+			}
+		}
+		activate(next_step++);
+	}
+
+	if (completed == steps.size())
+	{
+		finish();
+	}
+	else
+	{
+		const uint64_t current = ++ticket;
+
+		TimerService::instance().singleShot(options.timeout, [this, current]()
+		{
+			if (current == ticket)
+			{
+				finish();
+			}
+		});
+	}
+}
+
+void ReplayService::activate(const size_t index)
+{
+	const Recording::Step & step       = recording.steps()[index];
+	Progress        &       state      = progress[index];
+	Activation       &      activation = activations[step.activation];
+
+	state.sent_ns = clock.nsecsElapsed();
+	state.pending = step.expected.size();
+	if (activation.first_ns < 0)
+	{
+		activation.first_ns = state.sent_ns;
+	}
+
+	for (const WireMessage & wire : step.expected)
+	{
+		expected[key(wire)].push_back(index);
+	}
+
+	if (step.has_input)
+	{
+		write(MrwMessage(step.input));
+	}
+
+	if (state.pending == 0)
+	{
+		complete(index);
+	}
+}
+
+void ReplayService::complete(const size_t index)
+{
+	const Recording::Step & step       = recording.steps()[index];
+	Progress        &       state      = progress[index];
+	Activation       &      activation = activations[step.activation];
+
+	state.done_ns       = clock.nsecsElapsed();
+	activation.last_ns  = std::max(activation.last_ns, state.done_ns);
+	completed++;
+
+	if (step.has_input && !step.expected.empty())
+	{
+		const MrwMessage input(step.input);
+
+		latencies[input.command()].push_back((state.done_ns - state.sent_ns) / 1000000.0);
+	}
+
+	if ((--activation.steps == 0) && recording.isRoute(step.activation))
+	{
+		route_times.push_back((activation.last_ns - activation.first_ns) / 1000000.0);
+	}
+}
+
+void ReplayService::finish()
+{
+	if (!finished)
+	{
+		finished = true;
+		info();
+		QCoreApplication::quit();
+	}
+}
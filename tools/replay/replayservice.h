@@ -0,0 +1,133 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef REPLAYSERVICE_H
+#define REPLAYSERVICE_H
+
+#include <deque>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include <can/mrwbusservice.h>
+#include <can/mrwmessage.h>
+
+#include "recording.h"
+
+/**
+ * This class replays a Recording onto the CAN bus and measures how fast
+ * the application under test reacts. The inputs of the recording are
+ * written to the bus. Every received frame is matched against the
+ * outputs expected by the recording.
+ *
+ * Using the original timing each input is written at its recorded time
+ * scaled by a speed factor. In fast mode the next input is written as
+ * soon as all expected outputs of the previous step were received or a
+ * timeout elapsed. So the replay runs as fast as the application under
+ * test is able to process the frames.
+ *
+ * The processing latency of an input is the time from writing it until
+ * the last expected output of its step was received. The completion time
+ * of a route activation is the time from writing its first input until
+ * the last expected output of the activation was received.
+ *
+ * The replay stops after all steps are completed or the timeout after
+ * writing the last input elapsed.
+ */
+class ReplayService : public mrw::can::MrwBusService
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * The options of the replay.
+	 */
+	struct Options
+	{
+		/** True if the next input waits for the previous reaction only. */
+		bool     fast    = false;
+
+		/** The speed factor of the original timing. */
+		double   speed   = 1.0;
+
+		/** The time in milliseconds to wait for an expected reaction. */
+		unsigned timeout = 1000;
+	};
+
+	explicit ReplayService(
+		const Recording    &    recording,
+		const Options     &     options,
+		const QString     &     interface,
+		const QString     &     plugin,
+		QObject          *      parent = nullptr);
+	ReplayService() = delete;
+
+	/**
+	 * This method logs the replay counters and the measured latencies.
+	 */
+	void info();
+
+protected:
+	virtual void process(const mrw::can::MrwMessage & message) override;
+
+private:
+	/**
+	 * The replay state of one Recording::Step.
+	 */
+	struct Progress
+	{
+		qint64   sent_ns  = -1;
+		qint64   done_ns  = -1;
+		size_t   pending  = 0;
+		bool     released = false;
+	};
+
+	/**
+	 * The replay state of one activation.
+	 */
+	struct Activation
+	{
+		qint64   first_ns = -1;
+		qint64   last_ns  = -1;
+		size_t   steps    = 0;
+	};
+
+	typedef std::tuple<quint32, bool, size_t, uint64_t> Key;
+
+	static Key key(const mrw::can::WireMessage & wire) noexcept;
+
+	void start();
+	void advance();
+	void activate(const size_t index);
+	void complete(const size_t index);
+	void finish();
+
+	QLoggingCategory                        log;
+	const Recording            &            recording;
+	const Options                           options;
+
+	std::vector<Progress>                   progress;
+	std::vector<Activation>                 activations;
+	std::map<Key, std::deque<size_t>>       expected;
+	QElapsedTimer                           clock;
+
+	size_t                                  next_step  = 0;
+	size_t                                  completed  = 0;
+	size_t                                  unexpected = 0;
+	size_t                                  timeouts   = 0;
+	uint64_t                                ticket     = 0;
+	bool                                    started    = false;
+	bool                                    finished   = false;
+
+	std::map<mrw::can::Command, std::vector<double>>   latencies;
+	std::vector<double>                                route_times;
+};
+
+#endif
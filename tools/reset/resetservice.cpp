@@ -23,7 +23,7 @@ ResetService::ResetService(
 		write(message);
 	});
 
-	can_device->connectDevice();
+	connectDevice();
 }
 
 void ResetService::process(const MrwMessage & message)
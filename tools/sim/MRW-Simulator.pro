@@ -12,12 +12,14 @@ CONFIG += console
 
 SOURCES += \
 	main.cpp \
+	bussimulator.cpp \
 	simulatorservice.cpp
 
 HEADERS += \
+	bussimulator.h \
 	simulatorservice.h
 
-LIBS            += -lMRW-Model -lMRW-Can -lMRW-Util
+LIBS            += -lMRW-Model -lMRW-Can -lMRW-Statecharts -lMRW-Util
 
 install.files = $$TARGET
 
@@ -0,0 +1,367 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include <util/appsupport.h>
+#include <util/settings.h>
+#include <statecharts/timerservice.h>
+
+#include "bussimulator.h"
+
+using namespace mrw::can;
+using namespace mrw::util;
+
+using mrw::statechart::TimerService;
+
+BusSimulator::Latency BusSimulator::Latency::parse(const QString & input, bool & ok)
+{
+	const QStringList parts = input.split(':');
+	const QString     type  = parts.value(0).trimmed().toLower();
+	Latency           result;
+	bool              ok_first  = true;
+	bool              ok_second = true;
+
+	result.first  = parts.value(1, "0").toDouble(&ok_first);
+	result.second = parts.value(2, "0").toDouble(&ok_second);
+	ok = ok_first && ok_second && (parts.size() <= 3) && (result.first >= 0) && (result.second >= 0);
+
+	if (type == "fixed")
+	{
+		result.distribution = Distribution::FIXED;
+	}
+	else if (type == "uniform")
+	{
+		result.distribution = Distribution::UNIFORM;
+		ok = ok && (result.first <= result.second);
+	}
+	else if (type == "normal")
+	{
+		result.distribution = Distribution::NORMAL;
+		ok = ok && (result.second > 0);
+	}
+	else if (type == "exponential")
+	{
+		result.distribution = Distribution::EXPONENTIAL;
+		ok = ok && (result.first > 0);
+	}
+	else
+	{
+		ok = false;
+	}
+	return ok ? result : Latency();
+}
+
+QString BusSimulator::Latency::toString() const
+{
+	switch (distribution)
+	{
+	case Distribution::FIXED:
+		return QString("fixed:%1").arg(first);
+
+	case Distribution::UNIFORM:
+		return QString("uniform:%1:%2").arg(first).arg(second);
+
+	case Distribution::NORMAL:
+		return QString("normal:%1:%2").arg(first).arg(second);
+
+	case Distribution::EXPONENTIAL:
+		return QString("exponential:%1").arg(first);
+	}
+	return "?";
+}
+
+BusSimulator::Options BusSimulator::Options::read()
+{
+	Settings      settings;
+	SettingsGroup host(&settings, AppSupport::instance().hostname());
+	SettingsGroup group(&settings, "simulator");
+	Options       result;
+	bool          ok = false;
+
+	result.enabled    = settings.value("scaling",   result.enabled).toBool();
+	result.bitrate    = settings.value("bitrate",   result.bitrate).toUInt();
+	result.seed       = settings.value("seed",      result.seed).toUInt();
+	result.drop_rate  = settings.value("drop",      result.drop_rate).toDouble();
+	result.error_rate = settings.value("error",     result.error_rate).toDouble();
+	result.bus_errors = settings.value("buserror",  result.bus_errors).toDouble();
+	result.latency    = Latency::parse(settings.value("latency", result.latency.toString()).toString(), ok);
+	result.bitrate    = std::max(result.bitrate, 1000u);
+
+	return result;
+}
+
+BusSimulator::BusSimulator(
+	MrwBusService  & service,
+	const Options  & sim_options,
+	QObject    *     parent) :
+	QObject(parent),
+	bus(service),
+	options(sim_options),
+	generator(sim_options.seed),
+	sources(SOURCES)
+{
+}
+
+void BusSimulator::request(const MrwMessage & message, std::function<void()> deliver)
+{
+	clock_us = std::max(clock_us, now());
+	enqueue(HOST, Frame{ message, clock_us, std::move(deliver) });
+	arbitrate();
+	arm();
+}
+
+void BusSimulator::respond(
+	const ControllerId   id,
+	const MrwMessage  &  message,
+	const unsigned       delay_ms)
+{
+	Source & source = sources.at(id);
+	uint64_t ready  = 0;
+
+	clock_us = std::max(clock_us, now());
+	if (delay_ms == 0)
+	{
+		// The controller processes one request after another.
+		ready = std::max(clock_us, source.busy_until_us) + latency();
+		source.busy_until_us = ready;
+	}
+	else
+	{
+		ready = clock_us + delay_ms * 1000ull;
+	}
+
+	if (chance(options.drop_rate))
+	{
+		bus_statistics.dropped++;
+		return;
+	}
+
+	MrwMessage response = message;
+
+	if (chance(options.error_rate))
+	{
+		bus_statistics.errors++;
+		response = MrwMessage(id, message.unitNo(), message.command(), Response::MSG_QUEUE_FULL);
+	}
+
+	at(ready, [this, id, response, ready]()
+	{
+		enqueue(id, Frame{ response, ready, nullptr });
+		arbitrate();
+	});
+	arm();
+}
+
+uint64_t BusSimulator::frameTime(const MrwMessage & message) const noexcept
+{
+	return message.wire().transmissionTime(options.bitrate);
+}
+
+const BusSimulator::Statistics & BusSimulator::statistics() const noexcept
+{
+	return bus_statistics;
+}
+
+void BusSimulator::info(const QLoggingCategory & log) const
+{
+	const double load = clock_us > 0 ? 100.0 * bus_statistics.busy_us / clock_us : 0.0;
+
+	qCInfo(log).noquote() << "Bus simulation:" << options.bitrate << "bit/s, latency" <<
+		options.latency.toString() << "ms, seed" << options.seed;
+	qCInfo(log).noquote() << "  Frames:" << bus_statistics.requests << "requests," <<
+		bus_statistics.responses << "responses," << bus_statistics.retries << "retries";
+	qCInfo(log).noquote() << "  Injected:" << bus_statistics.dropped << "lost," <<
+		bus_statistics.errors << "errors";
+	qCInfo(log).noquote() << "  Bus load:" << QString::number(load, 'f', 1) << "% of" <<
+		clock_us / 1000 << "ms, peak queue" << bus_statistics.peak_queue;
+
+	for (size_t i = 0; i < Histogram::BUCKETS; i++)
+	{
+		if (bus_statistics.wait[i] != 0)
+		{
+			qCInfo(log).noquote() << "  Wait >=" << Histogram::bucketFloor(i) <<
+				"ms:" << bus_statistics.wait[i];
+		}
+	}
+}
+
+uint32_t BusSimulator::priority(const MrwMessage & message) noexcept
+{
+	const WireMessage wire = message.wire();
+	const quint32     id   = wire.frameId();
+
+	// The dominant RTR bit of a basic frame wins against the recessive
+	// SRR bit of an extended frame with the same base identifier.
+	return wire.isExtended() ?
+		((id >> CAN_SID_SHIFT) << 19) | (1 << 18) | (id & ((1 << CAN_SID_SHIFT) - 1)) :
+		id << 19;
+}
+
+void BusSimulator::enqueue(const size_t source, Frame && frame)
+{
+	std::deque<Frame> & queue = sources[source].queue;
+
+	if (queue.empty())
+	{
+		arbitration.push(Candidate{ priority(frame.message), sequence++, source });
+	}
+	queue.push_back(std::move(frame));
+
+	waiting++;
+	bus_statistics.peak_queue = std::max(bus_statistics.peak_queue, waiting);
+}
+
+void BusSimulator::arbitrate()
+{
+	if (bus_busy || arbitration.empty())
+	{
+		return;
+	}
+
+	const size_t  source    = arbitration.top().source;
+	const Frame & frame     = sources[source].queue.front();
+	const bool    corrupted = chance(options.bus_errors);
+	uint64_t      duration  = frameTime(frame.message);
+
+	arbitration.pop();
+	bus_busy = true;
+
+	if (corrupted)
+	{
+		// The error frame destroys the frame which has to be repeated.
+		duration += (ERROR_FRAME * 1000000 + options.bitrate - 1) / options.bitrate;
+	}
+	else
+	{
+		const uint64_t wait_ms = (clock_us - frame.ready_us) / 1000;
+
+		bus_statistics.wait.add(wait_ms);
+	}
+	bus_statistics.busy_us += duration;
+
+	at(clock_us + duration, [this, source, corrupted]()
+	{
+		transmitted(source, corrupted);
+	});
+}
+
+void BusSimulator::transmitted(const size_t source, const bool corrupted)
+{
+	std::deque<Frame> & queue = sources[source].queue;
+
+	bus_busy = false;
+	if (corrupted)
+	{
+		bus_statistics.retries++;
+	}
+	else
+	{
+		Frame frame = std::move(queue.front());
+
+		queue.pop_front();
+		waiting--;
+
+		if (source == HOST)
+		{
+			bus_statistics.requests++;
+			frame.deliver();
+		}
+		else
+		{
+			bus_statistics.responses++;
+			bus.write(frame.message);
+		}
+	}
+
+	if (!queue.empty())
+	{
+		arbitration.push(Candidate{ priority(queue.front().message), sequence++, source });
+	}
+	arbitrate();
+}
+
+void BusSimulator::at(const uint64_t time_us, std::function<void()> action)
+{
+	schedule.push(Event{ time_us, sequence++, std::move(action) });
+}
+
+void BusSimulator::run()
+{
+	const uint64_t current = now();
+
+	while (!schedule.empty() && (schedule.top().time_us <= current))
+	{
+		// Move out before popping since the action may schedule events.
+		Event event = std::move(const_cast<Event &>(schedule.top()));
+
+		schedule.pop();
+		clock_us = std::max(clock_us, event.time_us);
+		event.action();
+	}
+	arm();
+}
+
+void BusSimulator::arm()
+{
+	if (schedule.empty())
+	{
+		return;
+	}
+
+	const uint64_t due_ms = (schedule.top().time_us + 999) / 1000;
+
+	if (due_ms < armed_ms)
+	{
+		const uint64_t current_ms = now() / 1000;
+
+		armed_ms = due_ms;
+		TimerService::instance().singleShot(due_ms > current_ms ? due_ms - current_ms : 0, lifetime, [this, due_ms]()
+		{
+			if (armed_ms == due_ms)
+			{
+				armed_ms = NONE;
+			}
+			run();
+		});
+	}
+}
+
+uint64_t BusSimulator::now()
+{
+	return TimerService::instance().now() * 1000;
+}
+
+uint64_t BusSimulator::latency()
+{
+	const Latency & config = options.latency;
+	double          ms     = config.first;
+
+	switch (config.distribution)
+	{
+	case Distribution::FIXED:
+		break;
+
+	case Distribution::UNIFORM:
+		ms = std::uniform_real_distribution<double>(config.first, config.second)(generator);
+		break;
+
+	case Distribution::NORMAL:
+		ms = std::normal_distribution<double>(config.first, config.second)(generator);
+		break;
+
+	case Distribution::EXPONENTIAL:
+		ms = std::exponential_distribution<double>(1.0 / config.first)(generator);
+		break;
+	}
+	return uint64_t(std::llround(std::max(ms, 0.0) * 1000.0));
+}
+
+bool BusSimulator::chance(const double probability)
+{
+	return (probability > 0.0) &&
+		(std::uniform_real_distribution<double>(0.0, 1.0)(generator) < probability);
+}
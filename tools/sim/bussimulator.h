@@ -0,0 +1,320 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef BUSSIMULATOR_H
+#define BUSSIMULATOR_H
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QString>
+
+#include <can/mrwbusservice.h>
+#include <can/mrwmessage.h>
+#include <util/histogram.h>
+
+/**
+ * This class simulates the timing of a CAN bus with many controllers. It
+ * sits between the SimulatorService and the real (virtual) CAN bus.
+ *
+ * Every request of the host is delayed by its transmission time on the
+ * simulated bus before it is delivered to the SimulatorService. Every
+ * response is queued at its Controller after a processing latency drawn
+ * from a configurable distribution. Each Controller processes its
+ * requests one after another. All pending frames of the host and of the
+ * controllers compete for the bus by CAN ID priority like the bitwise
+ * arbitration of a real CAN bus. A response is written to the CAN bus
+ * when its simulated transmission is complete.
+ *
+ * Errors may be injected by losing responses, by replacing responses
+ * with an error code and by corrupting frames on the bus which causes
+ * an error frame and a retransmission.
+ *
+ * The simulation uses the mrw::statechart::TimerService. The
+ * SimulatorService refuses to combine the simulation with virtual time
+ * since the track control measures its latencies on the wall clock.
+ */
+class BusSimulator : public QObject
+{
+	Q_OBJECT
+
+public:
+	/**
+	 * The type of a latency distribution.
+	 */
+	enum class Distribution
+	{
+		/** Always the mean. */
+		FIXED,
+
+		/** Uniform between both parameters. */
+		UNIFORM,
+
+		/** Normal with mean and standard deviation not below zero. */
+		NORMAL,
+
+		/** Exponential with the given mean. */
+		EXPONENTIAL
+	};
+
+	/**
+	 * This struct describes a latency distribution in milliseconds. It
+	 * is configured as a string like <tt>uniform:2:8</tt>.
+	 */
+	struct Latency
+	{
+		Distribution distribution = Distribution::FIXED;
+		double       first        = 1.0;
+		double       second       = 0.0;
+
+		/**
+		 * This method parses a latency definition of the form
+		 * <tt>&lt;type&gt;:&lt;first&gt;[:&lt;second&gt;]</tt> where type is
+		 * one of fixed, uniform, normal or exponential.
+		 *
+		 * @param input The latency definition.
+		 * @param ok Set to true on success.
+		 * @return The parsed Latency.
+		 */
+		static Latency parse(const QString & input, bool & ok);
+
+		/**
+		 * This method returns the latency definition as string.
+		 *
+		 * @return The latency definition.
+		 */
+		QString toString() const;
+	};
+
+	/**
+	 * The options of the simulation. They are read from the
+	 * &lt;hostname&gt;/simulator group of the host settings.
+	 */
+	struct Options
+	{
+		/** True if the bus simulation is used at all. */
+		bool     enabled    = false;
+
+		/** The bit rate of the simulated bus in bit/s. */
+		unsigned bitrate    = 125000;
+
+		/** The seed of the random generator to repeat a run. */
+		unsigned seed       = 1;
+
+		/** The processing latency of a Controller. */
+		Latency  latency;
+
+		/** The probability of a lost response. */
+		double   drop_rate  = 0.0;
+
+		/** The probability of an error response. */
+		double   error_rate = 0.0;
+
+		/** The probability of a corrupted frame. */
+		double   bus_errors = 0.0;
+
+		/**
+		 * This method reads the options from the host settings.
+		 *
+		 * @return The read options.
+		 */
+		static Options read();
+	};
+
+	/**
+	 * This struct contains the simulation counters.
+	 */
+	struct Statistics
+	{
+		/** The frames sent by the host. */
+		uint64_t requests   = 0;
+
+		/** The frames sent by the controllers. */
+		uint64_t responses  = 0;
+
+		/** The lost responses. */
+		uint64_t dropped    = 0;
+
+		/** The responses replaced by an error code. */
+		uint64_t errors     = 0;
+
+		/** The corrupted and retransmitted frames. */
+		uint64_t retries    = 0;
+
+		/** The time the bus was busy in microseconds. */
+		uint64_t busy_us    = 0;
+
+		/** The maximum amount of frames waiting for the bus. */
+		size_t   peak_queue = 0;
+
+		/**
+		 * The time frames waited for the bus in milliseconds. Bucket zero
+		 * counts waits below one millisecond.
+		 */
+		mrw::util::Histogram wait;
+	};
+
+	explicit BusSimulator(
+		mrw::can::MrwBusService & bus,
+		const Options      &      options,
+		QObject         *         parent = nullptr);
+	BusSimulator() = delete;
+
+	/**
+	 * This method queues a request of the host for the simulated bus.
+	 * After its transmission the given function processes the request.
+	 *
+	 * @param message The request of the host.
+	 * @param deliver The function processing the delivered request.
+	 */
+	void request(const mrw::can::MrwMessage & message, std::function<void()> deliver);
+
+	/**
+	 * This method queues a response of a Controller. The response is
+	 * ready for transmission after the processing latency of the
+	 * Controller. An additional delay simulates a mechanical action like
+	 * turning a switch which does not block the Controller.
+	 *
+	 * @param id The ID of the responding Controller.
+	 * @param message The response.
+	 * @param delay_ms The additional delay in milliseconds.
+	 */
+	void respond(
+		const mrw::can::ControllerId   id,
+		const mrw::can::MrwMessage  &  message,
+		const unsigned                 delay_ms = 0);
+
+	/**
+	 * This method returns the transmission time of a CAN frame on the
+	 * simulated bus including worst case bit stuffing and the
+	 * interframe space.
+	 *
+	 * @param message The message to transmit.
+	 * @return The transmission time in microseconds.
+	 */
+	uint64_t frameTime(const mrw::can::MrwMessage & message) const noexcept;
+
+	/**
+	 * This method returns the simulation counters.
+	 *
+	 * @return The simulation counters.
+	 */
+	const Statistics & statistics() const noexcept;
+
+	/**
+	 * This method returns the arbitration priority of a CAN frame. The
+	 * frame with the lowest value wins the bus. The value compares the
+	 * base identifier first, then the SRR or RTR bit and at last the
+	 * identifier extension.
+	 *
+	 * @param message The message to transmit.
+	 * @return The arbitration priority.
+	 */
+	static uint32_t priority(const mrw::can::MrwMessage & message) noexcept;
+
+	/**
+	 * This method logs the simulation options and counters.
+	 *
+	 * @param log The logging category to use.
+	 */
+	void info(const QLoggingCategory & log) const;
+
+private:
+	static constexpr size_t   HOST         = mrw::can::CAN_BROADCAST_ID;
+	static constexpr size_t   SOURCES      = HOST + 1;
+	static constexpr uint64_t ERROR_FRAME  = 20;
+	static constexpr uint64_t NONE         = std::numeric_limits<uint64_t>::max();
+
+	/**
+	 * A frame waiting for the bus.
+	 */
+	struct Frame
+	{
+		mrw::can::MrwMessage  message;
+		uint64_t              ready_us = 0;
+		std::function<void()> deliver;
+	};
+
+	/**
+	 * The state of one bus participant.
+	 */
+	struct Source
+	{
+		std::deque<Frame> queue;
+		uint64_t          busy_until_us = 0;
+	};
+
+	/**
+	 * The head of a non empty Source queue taking part in arbitration.
+	 */
+	struct Candidate
+	{
+		uint32_t priority = 0;
+		uint64_t sequence = 0;
+		size_t   source   = 0;
+
+		bool operator > (const Candidate & other) const noexcept
+		{
+			return priority != other.priority ?
+				priority > other.priority :
+				sequence > other.sequence;
+		}
+	};
+
+	/**
+	 * A scheduled simulation step.
+	 */
+	struct Event
+	{
+		uint64_t              time_us  = 0;
+		uint64_t              sequence = 0;
+		std::function<void()> action;
+
+		bool operator > (const Event & other) const noexcept
+		{
+			return time_us != other.time_us ?
+				time_us > other.time_us :
+				sequence > other.sequence;
+		}
+	};
+
+	typedef std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> Arbitration;
+	typedef std::priority_queue<Event,     std::vector<Event>,     std::greater<Event>>     Schedule;
+
+	mrw::can::MrwBusService & bus;
+	const Options             options;
+	std::mt19937              generator;
+	std::vector<Source>       sources;
+	Arbitration               arbitration;
+	Schedule                  schedule;
+	uint64_t                  sequence  = 0;
+	uint64_t                  clock_us  = 0;
+	uint64_t                  armed_ms  = NONE;
+	size_t                    waiting   = 0;
+	bool                      bus_busy  = false;
+	Statistics                bus_statistics;
+	std::shared_ptr<bool>     lifetime  = std::make_shared<bool>();
+
+	void     enqueue(const size_t source, Frame && frame);
+	void     arbitrate();
+	void     transmitted(const size_t source, const bool corrupted);
+	void     at(const uint64_t time_us, std::function<void()> action);
+	void     run();
+	void     arm();
+	uint64_t now();
+	uint64_t latency();
+	bool     chance(const double probability);
+};
+
+#endif
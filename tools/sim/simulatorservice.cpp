@@ -3,18 +3,19 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
-#include <QTimer>
-
 #include <model/section.h>
 #include <model/regularswitch.h>
 #include <model/doublecrossswitch.h>
 #include <model/formsignal.h>
+#include <statecharts/timerservice.h>
 
 #include "simulatorservice.h"
 
 using namespace mrw::can;
 using namespace mrw::model;
 
+using mrw::statechart::TimerService;
+
 SimulatorService::SimulatorService(
 	ModelRepository & repo,
 	QObject     *     parent) :
@@ -22,6 +23,26 @@ SimulatorService::SimulatorService(
 	log("mrw.tools.sim")
 {
 	model = repo;
+
+	TimerService::instance().setVirtualTime(repo.virtualTime());
+	if (repo.virtualTime())
+	{
+		qCInfo(log, "Using virtual time.");
+	}
+
+	const BusSimulator::Options options = BusSimulator::Options::read();
+
+	if (options.enabled && repo.virtualTime())
+	{
+		// Virtual time skips every idle period. So the simulated bus
+		// timing would not show up in any measured latency.
+		qCWarning(log, "Bus simulation disabled since it cannot be combined with virtual time.");
+	}
+	else if (options.enabled)
+	{
+		engine = new BusSimulator(*this, options, this);
+		engine->info(log);
+	}
 }
 
 void SimulatorService::info()
@@ -30,12 +51,33 @@ void SimulatorService::info()
 	{
 		model->info();
 	}
+	TimerService::instance().info();
+
+	if (engine != nullptr)
+	{
+		engine->info(log);
+	}
 }
 
 void SimulatorService::process(const MrwMessage & message)
 {
 	qCInfo(log) << message;
 
+	if ((engine != nullptr) && !message.isResponse())
+	{
+		engine->request(message, [this, message]()
+		{
+			handle(message);
+		});
+	}
+	else
+	{
+		handle(message);
+	}
+}
+
+void SimulatorService::handle(const MrwMessage & message)
+{
 	if (!message.isResponse())
 	{
 		// Process request!
@@ -127,7 +169,7 @@ void SimulatorService::controller(
 
 	if (answer)
 	{
-		write(response);
+		send(controller->id(), response);
 	}
 
 	switch (cmd)
@@ -137,7 +179,7 @@ void SimulatorService::controller(
 	case CFGEND:
 		response = MrwMessage(controller->id(), NO_UNITNO, cmd, Response::MSG_RESET_PENDING);
 
-		write(response);
+		send(controller->id(), response);
 		[[fallthrough]];
 	case FLASH_CHECK:
 		bootSequence(controller->id());
@@ -207,6 +249,8 @@ void SimulatorService::device(const MrwMessage & message)
 	case CFGPL2:
 	case CFGPL3:
 	case CFGSL2:
+	case CFGSF2:
+	case CFGCRX:
 		device_count++;
 		break;
 
@@ -221,19 +265,14 @@ void SimulatorService::device(const MrwMessage & message)
 		response.append(b);
 	}
 
-	write(response);
+	send(id, response);
 
 	if ((code == Response::MSG_QUEUED) && (timeout > 0))
 	{
-		std::function<void()>  late_ok = [this, id, unit_no, cmd, timeout]()
-		{
-			MrwMessage ok(id, unit_no, cmd, Response::MSG_OK);
-
-			ok.append(timeout / SLICE);
-			write(ok);
-		};
+		MrwMessage late_ok(id, unit_no, cmd, Response::MSG_OK);
 
-		QTimer::singleShot(timeout, late_ok);
+		late_ok.append(timeout / SLICE);
+		send(id, late_ok, timeout);
 	}
 }
 
@@ -280,11 +319,33 @@ void SimulatorService::bootSequence(const ControllerId id)
 	response.append(1);
 	response.append(0x23);
 	response.append(0x45);
-	write(response);
+	send(id, response);
 
 	response = MrwMessage(id, NO_UNITNO, RESET, Response::MSG_BOOTED);
 	response.append(0);
-	write(response);
+	send(id, response);
+}
+
+void SimulatorService::send(
+	const ControllerId   id,
+	const MrwMessage  &  response,
+	const unsigned       delay_ms)
+{
+	if (engine != nullptr)
+	{
+		engine->respond(id, response, delay_ms);
+	}
+	else if (delay_ms > 0)
+	{
+		TimerService::instance().singleShot(delay_ms, [this, response]()
+		{
+			write(response);
+		});
+	}
+	else
+	{
+		write(response);
+	}
 }
 
 bool SimulatorService::isFormSignal(const Device * device)
@@ -16,6 +16,8 @@
 #include <model/modelrepository.h>
 #include <model/device.h>
 
+#include "bussimulator.h"
+
 /**
  * This service class simulates the behaviour of a modelrailway.
  */
@@ -32,7 +34,8 @@ private:
 	/** Time between timer interrupts in ms. */
 	static constexpr double    SLICE       = 1000.0 / SLICE_COUNT;
 
-	mrw::model::ModelRailway * model = nullptr;
+	mrw::model::ModelRailway * model        = nullptr;
+	BusSimulator       *       engine       = nullptr;
 	unsigned                   device_count = 0;
 
 public:
@@ -48,6 +51,11 @@ protected:
 	virtual void process(const mrw::can::MrwMessage & message) override;
 
 private:
+	void    handle(const mrw::can::MrwMessage & message);
+	void    send(
+		const mrw::can::ControllerId   id,
+		const mrw::can::MrwMessage  &  response,
+		const unsigned                 delay_ms = 0);
 	void    broadcast(const mrw::can::MrwMessage & message);
 	void    append(mrw::can::MrwMessage & response, uint8_t size);
 	void    controller(
@@ -0,0 +1,337 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QLoggingCategory>
+
+#include <util/tracefile.h>
+#include <can/mrwmessage.h>
+#include <can/wiremessage.h>
+
+using namespace mrw::util;
+using namespace mrw::can;
+
+/**
+ * The filter of the printed records. An empty criteria matches all
+ * records.
+ */
+struct Filter
+{
+	std::vector<TraceType> types;
+	QString                name;
+	int                    id   = -1;
+	double                 from = 0;
+	double                 to   = -1;
+};
+
+/**
+ * The minimum, average and maximum of a series of durations.
+ */
+struct Series
+{
+	std::vector<double> values;
+
+	void print(const QLoggingCategory & log, const QString & label)
+	{
+		if (values.empty())
+		{
+			return;
+		}
+
+		std::sort(values.begin(), values.end());
+
+		double sum = 0;
+
+		for (const double value : values)
+		{
+			sum += value;
+		}
+
+		qCInfo(log, "  %-24s %7zu %10.3f %10.3f %10.3f %10.3f %10.3f",
+			label.toLatin1().constData(), values.size(),
+			values.front(), sum / values.size(),
+			values[values.size() / 2],
+			values[std::min(values.size() - 1, values.size() * 99 / 100)],
+			values.back());
+	}
+};
+
+static const char * type_names[] =
+{
+	"NONE", "RX", "TX", "EVENT", "TIMEOUT", "BATCH"
+};
+
+static const char * typeName(const std::uint8_t value)
+{
+	return value < std::size(type_names) ? type_names[value] : "?";
+}
+
+static bool type(const char * arg, std::vector<TraceType> & types)
+{
+	for (const QString & token : QString(arg).toUpper().split(','))
+	{
+		const auto it = std::find(std::begin(type_names), std::end(type_names), token);
+
+		if ((it == std::begin(type_names)) || (it == std::end(type_names)))
+		{
+			return false;
+		}
+		types.push_back(TraceType(it - std::begin(type_names)));
+	}
+	return true;
+}
+
+static double milliseconds(const TraceRecord & record)
+{
+	return record.time / 1000000.0;
+}
+
+static MrwMessage message(const TraceRecord & record)
+{
+	const WireMessage wire(
+		record.source & ~TraceRecorder::EXTENDED,
+		(record.source & TraceRecorder::EXTENDED) != 0,
+		record.data, record.length);
+
+	return MrwMessage(wire);
+}
+
+static bool isFrame(const TraceRecord & record)
+{
+	return (record.type == std::uint8_t(TraceType::CAN_RX)) || (record.type == std::uint8_t(TraceType::CAN_TX));
+}
+
+static QString describe(const TraceFile & file, const TraceRecord & record)
+{
+	switch (TraceType(record.type))
+	{
+	case TraceType::CAN_RX:
+	case TraceType::CAN_TX:
+		return message(record).toString();
+
+	case TraceType::EVENT:
+		return file.name(record.source) + " -> " + file.name(record.name);
+
+	case TraceType::TIMEOUT:
+		return file.name(record.source) + QString::asprintf(" timeout #%u", record.value);
+
+	case TraceType::BATCH:
+		return QString::asprintf("Batch (ID=%u) completed after %.3f ms", record.source, record.value / 1000.0);
+
+	default:
+		return "?";
+	}
+}
+
+static bool matches(const TraceFile & file, const TraceRecord & record, const Filter & filter)
+{
+	const double time = milliseconds(record);
+
+	if ((time < filter.from) || ((filter.to >= 0) && (time > filter.to)))
+	{
+		return false;
+	}
+
+	if (!filter.types.empty() &&
+		(std::find(filter.types.begin(), filter.types.end(), TraceType(record.type)) == filter.types.end()))
+	{
+		return false;
+	}
+
+	if (filter.id >= 0)
+	{
+		if (isFrame(record))
+		{
+			const MrwMessage msg = message(record);
+			const int        id  = msg.isResponse() ? msg.eid() : msg.sid();
+
+			if (id != filter.id)
+			{
+				return false;
+			}
+		}
+		else if ((record.type != std::uint8_t(TraceType::BATCH)) || (int(record.source) != filter.id))
+		{
+			return false;
+		}
+	}
+
+	if (!filter.name.isEmpty())
+	{
+		if ((record.type != std::uint8_t(TraceType::EVENT)) && (record.type != std::uint8_t(TraceType::TIMEOUT)))
+		{
+			return false;
+		}
+		return file.name(record.source).contains(filter.name, Qt::CaseInsensitive) ||
+			file.name(record.name).contains(filter.name, Qt::CaseInsensitive);
+	}
+	return true;
+}
+
+static void summarize(const QLoggingCategory & log, const TraceFile & file, const Filter & filter)
+{
+	typedef std::pair<ControllerId, UnitNo> DeviceKey;
+
+	std::map<DeviceKey, double>  pending;
+	std::map<DeviceKey, Series>  switches;
+	std::map<TraceType, size_t>  counts;
+	Series                       batches;
+	double                       first = -1;
+	double                       last  = 0;
+
+	for (const TraceRecord & record : file.records())
+	{
+		if (!matches(file, record, filter))
+		{
+			continue;
+		}
+
+		const double time = milliseconds(record);
+
+		counts[TraceType(record.type)]++;
+		first = first < 0 ? time : first;
+		last  = time;
+
+		if (isFrame(record))
+		{
+			const MrwMessage msg = message(record);
+
+			if ((msg.command() != SETLFT) && (msg.command() != SETRGT))
+			{
+				continue;
+			}
+
+			if (!msg.isResponse())
+			{
+				pending[DeviceKey(msg.sid(), msg.unitNo())] = time;
+			}
+			else if (msg.response() == Response::MSG_OK)
+			{
+				auto it = pending.find(DeviceKey(msg.eid(), msg.unitNo()));
+
+				if (it != pending.end())
+				{
+					switches[it->first].values.push_back(time - it->second);
+					pending.erase(it);
+				}
+			}
+		}
+		else if (record.type == std::uint8_t(TraceType::BATCH))
+		{
+			batches.values.push_back(record.value / 1000.0);
+		}
+	}
+
+	qCInfo(log, "Records:     %zu (%llu lost, %llu torn)", file.records().size(),
+		(unsigned long long)file.lost(), (unsigned long long)file.torn());
+	qCInfo(log, "Time span:   %.3f ms", first < 0 ? 0.0 : last - first);
+	for (const auto & [record_type, count] : counts)
+	{
+		qCInfo(log, "  %-10s %10zu", typeName(std::uint8_t(record_type)), count);
+	}
+
+	qCInfo(log, "Latency [ms]             %7s %10s %10s %10s %10s %10s",
+		"count", "min", "avg", "median", "p99", "max");
+	for (auto & [key, series] : switches)
+	{
+		series.print(log, QString::asprintf("SETLFT/SETRGT %04x:%04x", key.first, key.second));
+	}
+	batches.print(log, "Batch");
+
+	if (!pending.empty())
+	{
+		qCInfo(log, "Switches without MSG_OK response: %zu", pending.size());
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	QCoreApplication    app(argc, argv);
+	QLoggingCategory    log("mrw.tools.trace");
+	Filter              filter;
+	QStringList         positional;
+	bool                do_summary = false;
+	bool                ok         = true;
+
+	for (int i = 1; (i < argc) && ok; i++)
+	{
+		const bool has_value = (i + 1) < argc;
+
+		if (qstrcmp(argv[i], "--summary") == 0)
+		{
+			do_summary = true;
+		}
+		else if ((qstrcmp(argv[i], "--type") == 0) && has_value)
+		{
+			ok = type(argv[++i], filter.types);
+		}
+		else if ((qstrcmp(argv[i], "--name") == 0) && has_value)
+		{
+			filter.name = argv[++i];
+		}
+		else if ((qstrcmp(argv[i], "--id") == 0) && has_value)
+		{
+			filter.id = QString(argv[++i]).toInt(&ok, 0);
+		}
+		else if ((qstrcmp(argv[i], "--from") == 0) && has_value)
+		{
+			filter.from = QString(argv[++i]).toDouble(&ok);
+		}
+		else if ((qstrcmp(argv[i], "--to") == 0) && has_value)
+		{
+			filter.to = QString(argv[++i]).toDouble(&ok);
+		}
+		else if (argv[i][0] != '-')
+		{
+			positional << argv[i];
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	if (!ok || (positional.size() != 1))
+	{
+		qCCritical(log).noquote() <<
+			"Usage: MRW-Trace [--type rx,tx,event,timeout,batch] [--name text] [--id n]" <<
+			"[--from ms] [--to ms] [--summary] <trace file>";
+		return EXIT_FAILURE;
+	}
+
+	const TraceFile file(positional[0]);
+
+	if (!file.valid())
+	{
+		qCCritical(log).noquote() << "Cannot read" << positional[0] << ":" << file.error();
+		return EXIT_FAILURE;
+	}
+
+	qCInfo(log).noquote() << "Trace started:" <<
+		QDateTime::fromMSecsSinceEpoch(file.header().epoch_ms).toString(Qt::ISODateWithMs);
+
+	if (do_summary)
+	{
+		summarize(log, file, filter);
+	}
+	else
+	{
+		for (const TraceRecord & record : file.records())
+		{
+			if (matches(file, record, filter))
+			{
+				qCInfo(log, "%14.6f %-7s %s", milliseconds(record), typeName(record.type),
+					describe(file, record).toLatin1().constData());
+			}
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -12,10 +12,12 @@ CONFIG  += console
 
 SOURCES += \
 	main.cpp \
-	trackerservice.cpp
+	trackerservice.cpp \
+	trainengine.cpp
 
 HEADERS += \
-	trackerservice.h
+	trackerservice.h \
+	trainengine.h
 
 LIBS    += -lMRW-Model -lMRW-Can -lMRW-Statecharts -lMRW-Util
 
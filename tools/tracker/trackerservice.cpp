@@ -21,7 +21,19 @@ TrackerService::TrackerService(
 	MrwBusService(repo.interface(), repo.plugin(), parent),
 	log("mrw.tools.tracker")
 {
+	const TrainEngine::Options options = TrainEngine::Options::read();
+
 	model = repo;
+	TimerService::instance().setVirtualTime(repo.virtualTime());
+	if (repo.virtualTime())
+	{
+		qCInfo(log, "Using virtual time.");
+	}
+
+	if (options.trains > 0)
+	{
+		engine = std::make_unique<TrainEngine>(*this, model, options);
+	}
 
 	statechart.setTimerService(TimerService::instance());
 	statechart.setOperationCallback(*this);
@@ -41,10 +53,20 @@ void TrackerService::info()
 	{
 		model->info();
 	}
+	if (engine)
+	{
+		engine->info(log);
+	}
 }
 
 void TrackerService::process(const MrwMessage & message)
 {
+	if (engine)
+	{
+		engine->process(message);
+		return;
+	}
+
 	if (message.isResponse() && (message.response() == Response::MSG_OK))
 	{
 		const Command cmd = message.command();
@@ -8,6 +8,8 @@
 #ifndef TRACKERSERVICE_H
 #define TRACKERSERVICE_H
 
+#include <memory>
+
 #include <QLoggingCategory>
 #include <QTimer>
 
@@ -18,6 +20,8 @@
 #include <statecharts/timerservice.h>
 #include <statecharts/TrackerStatechart.h>
 
+#include "trainengine.h"
+
 class TrackerService :
 	public mrw::can::MrwBusService,
 	public mrw::util::Self<mrw::statechart::TrackerStatechart::OperationCallback>
@@ -35,6 +39,8 @@ private:
 	mrw::model::Route::SectionTrack::iterator   position;
 	mrw::model::Route::SectionTrack::iterator   previous;
 
+	std::unique_ptr<TrainEngine>                engine;
+
 public:
 	TrackerService() = delete;
 	explicit TrackerService(
@@ -0,0 +1,495 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <vector>
+
+#include <util/appsupport.h>
+#include <util/settings.h>
+#include <model/abstractswitch.h>
+#include <model/regularswitch.h>
+#include <model/doublecrossswitch.h>
+#include <model/section.h>
+#include <model/controller.h>
+#include <statecharts/timerservice.h>
+
+#include "trainengine.h"
+
+using namespace mrw::can;
+using namespace mrw::model;
+using namespace mrw::util;
+
+using mrw::statechart::TimerService;
+
+TrainEngine::Options TrainEngine::Options::read()
+{
+	Settings      settings;
+	SettingsGroup host(&settings, AppSupport::instance().hostname());
+	SettingsGroup group(&settings, "tracker");
+	Options       result;
+
+	result.trains   = settings.value("trains",   result.trains).toUInt();
+	result.length   = settings.value("length",   result.length).toUInt();
+	result.step     = settings.value("step",     result.step).toUInt();
+	result.variance = settings.value("variance", result.variance).toDouble();
+	result.start    = settings.value("start",    result.start).toUInt();
+	result.dwell    = settings.value("dwell",    result.dwell).toUInt();
+	result.seed     = settings.value("seed",     result.seed).toUInt();
+
+	result.length   = std::max(result.length, 1u);
+	result.step     = std::max(result.step,   1u);
+	result.variance = std::clamp(result.variance, 0.0, 0.9);
+
+	return result;
+}
+
+TrainEngine::TrainEngine(
+	MrwBusService  & service,
+	ModelRailway  *  model_railway,
+	const Options  & engine_options) :
+	bus(service),
+	model(model_railway),
+	options(engine_options),
+	generator(engine_options.seed)
+{
+	clock.start();
+}
+
+void TrainEngine::process(const MrwMessage & message)
+{
+	const Command cmd = message.command();
+
+	if (!message.isResponse())
+	{
+		if ((cmd == SETLFT) || (cmd == SETRGT))
+		{
+			AbstractSwitch * part = device<AbstractSwitch>(message);
+
+			if (part != nullptr)
+			{
+				turning.insert(part);
+			}
+		}
+		else if (cmd == SETROF)
+		{
+			auto it = freed.find(device<Section>(message));
+
+			if (it != freed.end())
+			{
+				const uint64_t elapsed = clock.elapsed() - it->second;
+
+				engine_statistics.latency.add(elapsed);
+				freed.erase(it);
+			}
+		}
+		return;
+	}
+
+	if (message.response() != Response::MSG_OK)
+	{
+		// A failed switch keeps turning so no train passes it.
+		return;
+	}
+
+	switch (cmd)
+	{
+	case SETLFT:
+	case SETRGT:
+		{
+			AbstractSwitch * part = device<AbstractSwitch>(message);
+
+			if (part != nullptr)
+			{
+				turn(part, cmd == SETLFT ?
+					SwitchState::SWITCH_STATE_LEFT :
+					SwitchState::SWITCH_STATE_RIGHT);
+				turning.erase(part);
+			}
+		}
+		break;
+
+	case SETRON:
+	case SETROF:
+		{
+			Section * section = device<Section>(message);
+
+			if (section == nullptr)
+			{
+				throw std::invalid_argument(QString::asprintf(
+						"Device not found: %04x:%04x", message.eid(), message.unitNo()).toStdString());
+			}
+			activate(section, cmd == SETRON);
+		}
+		break;
+
+	default:
+		// Intentionally do nothing!
+		break;
+	}
+}
+
+size_t TrainEngine::count() const noexcept
+{
+	return trains.size();
+}
+
+const TrainEngine::Statistics & TrainEngine::statistics() const noexcept
+{
+	return engine_statistics;
+}
+
+void TrainEngine::info(const QLoggingCategory & log) const
+{
+	qCInfo(log).noquote() << "Trains:" << trains.size() << "of" << options.trains <<
+		"moving, peak" << engine_statistics.peak << ", length" << options.length <<
+		"sections, step" << options.step << "ms";
+	qCInfo(log).noquote() << "  Routes:" << engine_statistics.routes << "activated," <<
+		engine_statistics.extended << "extended," << engine_statistics.rejected << "rejected";
+	qCInfo(log).noquote() << "  Trains:" << engine_statistics.started << "started," <<
+		engine_statistics.finished << "finished";
+	qCInfo(log).noquote() << "  Moves: " << engine_statistics.moves << "sections," <<
+		engine_statistics.stalls << "stalls," << engine_statistics.responses << "responses," <<
+		turning.size() << "switches turning";
+
+	for (size_t i = 0; i < Histogram::BUCKETS; i++)
+	{
+		if (engine_statistics.latency[i] != 0)
+		{
+			qCInfo(log).noquote() << "  Unblock latency >=" << Histogram::bucketFloor(i) <<
+				"ms:" << engine_statistics.latency[i];
+		}
+	}
+}
+
+void TrainEngine::activate(Section * section, const bool enable)
+{
+	section->enable(enable);
+	if (enable)
+	{
+		const uint64_t ticket = ++generation;
+
+		// Only the check of the section enabled last finds a route start.
+		activations[section] = ticket;
+		TimerService::instance().singleShot(options.start, lifetime, [this, section, ticket]()
+		{
+			check(section, ticket);
+		});
+	}
+	else
+	{
+		activations.erase(section);
+	}
+}
+
+void TrainEngine::check(Section * section, const uint64_t ticket)
+{
+	auto it = activations.find(section);
+
+	if ((it == activations.end()) || (it->second != ticket) || !section->enabled())
+	{
+		return;
+	}
+
+	if (section->occupation())
+	{
+		extend(section);
+		return;
+	}
+
+	const Chain forward  = inspect(section, true,  ticket);
+	const Chain backward = inspect(section, false, ticket);
+
+	if ((forward == Chain::BLOCKED) || (backward == Chain::BLOCKED))
+	{
+		// A later activation or a moving train owns these sections.
+		return;
+	}
+
+	engine_statistics.routes++;
+	if ((forward == backward) || (trains.size() >= options.trains))
+	{
+		// The start section must be at exactly one end of the route.
+		engine_statistics.rejected++;
+	}
+	else
+	{
+		depart(section, forward == Chain::FREE);
+	}
+}
+
+void TrainEngine::extend(Section * section)
+{
+	for (auto & [number, train] : trains)
+	{
+		if (train.arrived && (train.occupied.front() == section))
+		{
+			Section * ahead = neighbour(section, train.dir);
+
+			if ((ahead == nullptr) || !ahead->enabled())
+			{
+				// The new route reverses the driving direction.
+				train.dir = !train.dir;
+				ahead     = neighbour(section, train.dir);
+			}
+
+			if ((ahead != nullptr) && ahead->enabled())
+			{
+				// The waiting train continues on the new route.
+				train.cursor  = entry(section);
+				train.arrived = false;
+				engine_statistics.routes++;
+				engine_statistics.extended++;
+				schedule(number, train.step);
+			}
+			return;
+		}
+	}
+}
+
+TrainEngine::Chain TrainEngine::inspect(
+	Section    *   section,
+	const bool     dir,
+	const uint64_t ticket) const
+{
+	std::unordered_set<Section *> visited{ section };
+	Section           *           next   = neighbour(section, dir);
+	Chain                         result = Chain::END;
+
+	while ((next != nullptr) && next->enabled() && visited.insert(next).second)
+	{
+		auto it = activations.find(next);
+
+		if (next->occupation() || ((it != activations.end()) && (it->second > ticket)))
+		{
+			return Chain::BLOCKED;
+		}
+
+		result = Chain::FREE;
+		next   = neighbour(next, dir);
+	}
+	return result;
+}
+
+void TrainEngine::depart(Section * first, const bool dir)
+{
+	std::uniform_real_distribution<double> deviation(-options.variance, options.variance);
+
+	const unsigned number = next_number++;
+	Train     &    train  = trains[number];
+
+	train.step   = std::max(unsigned(options.step * (1.0 + deviation(generator))), 1u);
+	train.cursor = entry(first);
+	train.dir    = dir;
+
+	occupy(first, true);
+	train.occupied.push_front(first);
+
+	engine_statistics.started++;
+	engine_statistics.peak = std::max(engine_statistics.peak, trains.size());
+	schedule(number, train.step);
+}
+
+void TrainEngine::advance(const unsigned number)
+{
+	Train  & train = trains.at(number);
+	Section * head = train.occupied.front();
+
+	if (!train.arrived && head->enabled())
+	{
+		// A disabled head section is the destination.
+		Cursor    cursor = train.cursor;
+		Section * next   = follow(cursor, train.dir);
+
+		if (next != nullptr)
+		{
+			if (passable(next))
+			{
+				train.cursor = cursor;
+				occupy(next, true);
+				train.occupied.push_front(next);
+				engine_statistics.moves++;
+
+				if (train.occupied.size() > options.length)
+				{
+					occupy(train.occupied.back(), false);
+					train.occupied.pop_back();
+				}
+			}
+			else
+			{
+				engine_statistics.stalls++;
+			}
+			schedule(number, train.step);
+			return;
+		}
+	}
+
+	if (train.occupied.size() > 1)
+	{
+		// Pull into the destination section.
+		occupy(train.occupied.back(), false);
+		train.occupied.pop_back();
+		schedule(number, train.step);
+	}
+	else if (!train.arrived)
+	{
+		train.arrived = true;
+		schedule(number, options.dwell);
+	}
+	else
+	{
+		// Leave the layout.
+		occupy(train.occupied.front(), false);
+		trains.erase(number);
+		engine_statistics.finished++;
+	}
+}
+
+bool TrainEngine::passable(Section * section) const
+{
+	if (section->occupation())
+	{
+		return false;
+	}
+
+	return std::none_of(turning.begin(), turning.end(), [section](const AbstractSwitch * part)
+	{
+		return part->section() == section;
+	});
+}
+
+void TrainEngine::occupy(Section * section, const bool occupation)
+{
+	MrwMessage message(section->controller()->id(), section->unitNo(), GETRBS, Response::MSG_OK);
+
+	section->setOccupation(occupation);
+	message.append(occupation);
+	bus.write(message);
+	engine_statistics.responses++;
+
+	if (occupation)
+	{
+		freed.erase(section);
+	}
+	else
+	{
+		freed[section] = clock.elapsed();
+	}
+}
+
+void TrainEngine::schedule(const unsigned number, const unsigned delay_ms)
+{
+	// A newer schedule supersedes a pending one.
+	const uint64_t ticket = ++trains.at(number).ticket;
+
+	TimerService::instance().singleShot(delay_ms, lifetime, [this, number, ticket]()
+	{
+		auto it = trains.find(number);
+
+		if ((it != trains.end()) && (it->second.ticket == ticket))
+		{
+			advance(number);
+		}
+	});
+}
+
+void TrainEngine::turn(AbstractSwitch * part, const SwitchState state)
+{
+	RegularSwitch   *   rs  = dynamic_cast<RegularSwitch *>(part);
+	DoubleCrossSwitch * dcs = dynamic_cast<DoubleCrossSwitch *>(part);
+
+	if (rs != nullptr)
+	{
+		rs->setState(static_cast<RegularSwitch::State>(state), true);
+	}
+	else if (dcs != nullptr)
+	{
+		// The double cross switch reports curved as left.
+		dcs->setState(state == SwitchState::SWITCH_STATE_LEFT ?
+			DoubleCrossSwitch::State::AC :
+			DoubleCrossSwitch::State::AD, true);
+	}
+}
+
+TrainEngine::Cursor TrainEngine::entry(Section * section)
+{
+	std::vector<RailPart *> rails;
+	Cursor                  cursor;
+
+	// Any rail part leaves the section in the driving direction.
+	section->parts<RailPart>(rails);
+	if (!rails.empty())
+	{
+		cursor.part = rails.front();
+	}
+	return cursor;
+}
+
+Section * TrainEngine::neighbour(Section * section, const bool dir)
+{
+	Cursor cursor = entry(section);
+
+	return follow(cursor, dir);
+}
+
+Section * TrainEngine::follow(Cursor & cursor, const bool dir)
+{
+	if (cursor.part == nullptr)
+	{
+		return nullptr;
+	}
+
+	const Section * section = cursor.part->section();
+
+	do
+	{
+		RailPart * succ = step(cursor.prev, cursor.part, dir);
+
+		cursor.prev = cursor.part;
+		cursor.part = succ;
+	}
+	while ((cursor.part != nullptr) && (cursor.part->section() == section));
+
+	return cursor.part != nullptr ? cursor.part->section() : nullptr;
+}
+
+RailPart * TrainEngine::step(
+	const RailPart * prev,
+	RailPart    *    part,
+	const bool       dir)
+{
+	const std::set<RailInfo> & candidates = part->advance(dir);
+	const AbstractSwitch   *   actual     = dynamic_cast<const AbstractSwitch *>(part);
+
+	if (candidates.empty())
+	{
+		return nullptr;
+	}
+	if ((actual == nullptr) || (candidates.size() == 1))
+	{
+		return *candidates.begin();
+	}
+
+	if (prev == nullptr)
+	{
+		// Assume the train came from any rail part behind the switch.
+		const std::set<RailInfo> & behind = part->advance(!dir);
+
+		if (behind.empty())
+		{
+			return *candidates.begin();
+		}
+		prev = *behind.begin();
+	}
+
+	for (const RailInfo & info : candidates)
+	{
+		if (!actual->needsTurn(prev, info))
+		{
+			return info;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,261 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef TRAINENGINE_H
+#define TRAINENGINE_H
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include <can/mrwbusservice.h>
+#include <can/mrwmessage.h>
+#include <model/modelrailway.h>
+#include <util/histogram.h>
+
+namespace mrw::model
+{
+	class AbstractSwitch;
+	class RailPart;
+}
+
+/**
+ * This class moves any number of simulated trains along the activated
+ * routes at the same time. It replaces the single train TrackerStatechart
+ * if the amount of trains is configured.
+ *
+ * The engine watches the CAN bus and records the confirmed section
+ * enable states and switch states into its own ModelRailway. The path of
+ * a train is found by walking the rail graph from section to section in
+ * its driving direction. At a switch the leg matching the confirmed
+ * switch state is taken. So the trains follow the routes of the model
+ * regardless of the timing of the frames.
+ *
+ * A route is enabled in reverse driving order. So the section enabled
+ * last is the start of a route if only one of its neighbours is enabled.
+ * If a train is waiting at its destination on that section the route
+ * extends the route of that train. Otherwise a new train is placed onto
+ * the start section.
+ *
+ * Each train advances by one section per step using its own speed and
+ * occupies at most the configured amount of sections. A train enters the
+ * next section if no other train occupies it and if none of its switches
+ * is still turning. The first disabled section after the enabled ones is
+ * the destination of the route.
+ * Every change of an occupation is sent as a GETRBS response like a real
+ * section module would do. After a dwell time at its destination a train
+ * leaves the layout and frees its remaining sections.
+ *
+ * The time from freeing a section until the control application disables
+ * it is recorded as the event processing latency of the control
+ * application.
+ *
+ * The movement uses the mrw::statechart::TimerService.
+ */
+class TrainEngine
+{
+public:
+	/**
+	 * The options of the train movement. They are read from the
+	 * &lt;hostname&gt;/tracker group of the host settings.
+	 */
+	struct Options
+	{
+		/** The maximum amount of concurrently moving trains. */
+		unsigned trains   = 0;
+
+		/** The amount of sections occupied by one train. */
+		unsigned length   = 2;
+
+		/** The time a train needs to pass one section in milliseconds. */
+		unsigned step     = 300;
+
+		/** The maximum relative deviation of a train speed. */
+		double   variance = 0.0;
+
+		/** The delay after a route is enabled until a train departs in milliseconds. */
+		unsigned start    = 1000;
+
+		/** The time a train waits at its destination in milliseconds. */
+		unsigned dwell    = 2000;
+
+		/** The seed of the random generator to repeat a run. */
+		unsigned seed     = 1;
+
+		/**
+		 * This method reads the options from the host settings.
+		 *
+		 * @return The read options.
+		 */
+		static Options read();
+	};
+
+	/**
+	 * This struct contains the movement counters.
+	 */
+	struct Statistics
+	{
+		/** The amount of detected route activations. */
+		uint64_t routes    = 0;
+
+		/** The amount of placed trains. */
+		uint64_t started   = 0;
+
+		/** The amount of trains which left the layout. */
+		uint64_t finished  = 0;
+
+		/** The amount of routes extending the route of a waiting train. */
+		uint64_t extended  = 0;
+
+		/** The amount of routes without a placed train. */
+		uint64_t rejected  = 0;
+
+		/** The amount of entered sections. */
+		uint64_t moves     = 0;
+
+		/** The amount of steps a train had to wait. */
+		uint64_t stalls    = 0;
+
+		/** The amount of sent GETRBS responses. */
+		uint64_t responses = 0;
+
+		/** The maximum amount of concurrently moving trains. */
+		size_t   peak      = 0;
+
+		/**
+		 * The time from freeing a section until the control application
+		 * disabled it in milliseconds.
+		 */
+		mrw::util::Histogram latency;
+	};
+
+	explicit TrainEngine(
+		mrw::can::MrwBusService   &   bus,
+		mrw::model::ModelRailway   *  model,
+		const Options        &        options);
+	TrainEngine() = delete;
+	TrainEngine(const TrainEngine & other) = delete;
+	TrainEngine & operator=(const TrainEngine & other) = delete;
+
+	/**
+	 * This method processes a message seen on the CAN bus.
+	 *
+	 * @param message The received message.
+	 */
+	void process(const mrw::can::MrwMessage & message);
+
+	/**
+	 * This method returns the amount of trains on the layout.
+	 *
+	 * @return The train count.
+	 */
+	size_t count() const noexcept;
+
+	/**
+	 * This method returns the movement counters.
+	 *
+	 * @return The movement counters.
+	 */
+	const Statistics & statistics() const noexcept;
+
+	/**
+	 * This method logs the movement options and counters.
+	 *
+	 * @param log The logging category to use.
+	 */
+	void info(const QLoggingCategory & log) const;
+
+private:
+	/**
+	 * A position inside the rail graph. The RailPart was entered from
+	 * the previous RailPart which may be @c nullptr if unknown.
+	 */
+	struct Cursor
+	{
+		mrw::model::RailPart        *       prev    = nullptr;
+		mrw::model::RailPart        *       part    = nullptr;
+	};
+
+	/**
+	 * A simulated train. The front of the occupied sections is the head
+	 * of the train. The cursor points into the head section.
+	 */
+	struct Train
+	{
+		unsigned                            step    = 0;
+		uint64_t                            ticket  = 0;
+		std::deque<mrw::model::Section *>   occupied;
+		Cursor                              cursor;
+		bool                                dir     = true;
+		bool                                arrived = false;
+	};
+
+	/**
+	 * The result of inspecting the enabled sections in one direction.
+	 */
+	enum class Chain
+	{
+		/** The neighbour section is not enabled. */
+		END,
+
+		/** The enabled sections are free. */
+		FREE,
+
+		/** The enabled sections are occupied or enabled later. */
+		BLOCKED
+	};
+
+	mrw::can::MrwBusService          &          bus;
+	mrw::model::ModelRailway         *          model;
+	const Options                               options;
+	std::mt19937                                generator;
+
+	std::unordered_map<mrw::model::Section *, uint64_t>      activations;
+	uint64_t                                                 generation = 0;
+
+	std::unordered_map<unsigned, Train>         trains;
+	unsigned                                    next_number = 1;
+
+	std::unordered_set<mrw::model::AbstractSwitch *>          turning;
+	std::unordered_map<mrw::model::Section *, qint64>        freed;
+	QElapsedTimer                                            clock;
+	Statistics                                               engine_statistics;
+	std::shared_ptr<bool>                                    lifetime = std::make_shared<bool>();
+
+	void activate(mrw::model::Section * section, const bool enable);
+	void check(mrw::model::Section * section, const uint64_t ticket);
+	void extend(mrw::model::Section * section);
+	Chain inspect(mrw::model::Section * section, const bool dir, const uint64_t ticket) const;
+	void depart(mrw::model::Section * section, const bool dir);
+	void advance(const unsigned number);
+	bool passable(mrw::model::Section * section) const;
+	void occupy(mrw::model::Section * section, const bool occupation);
+	void schedule(const unsigned number, const unsigned delay_ms);
+
+	static void turn(mrw::model::AbstractSwitch * part, const mrw::can::SwitchState state);
+	static Cursor entry(mrw::model::Section * section);
+	static mrw::model::Section * neighbour(mrw::model::Section * section, const bool dir);
+	static mrw::model::Section * follow(Cursor & cursor, const bool dir);
+	static mrw::model::RailPart * step(
+		const mrw::model::RailPart * prev,
+		mrw::model::RailPart    *    part,
+		const bool                   dir);
+
+	template<class T> T * device(const mrw::can::MrwMessage & message) const
+	{
+		const mrw::can::ControllerId id = message.isResponse() ? message.eid() : message.sid();
+
+		return dynamic_cast<T *>(model->deviceById(id, message.unitNo()));
+	}
+};
+
+#endif
@@ -40,7 +40,7 @@ UpdateService::UpdateService(
 	Q_ASSERT(statechart.check());
 	statechart.enter();
 
-	can_device->connectDevice();
+	connectDevice();
 }
 
 UpdateService::~UpdateService()
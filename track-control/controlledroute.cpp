@@ -8,7 +8,10 @@
 
 #include <util/method.h>
 #include <util/stringutil.h>
+#include <can/mrwbusservice.h>
+#include <model/routecost.h>
 #include <statecharts/timerservice.h>
+#include <statecharts/statecharttracer.h>
 #include <ctrl/controllerregistry.h>
 #include <ctrl/crossingcontroller.h>
 #include <ctrl/regularswitchcontrollerproxy.h>
@@ -27,6 +30,15 @@ using namespace mrw::ctrl;
 
 using LockState = Device::LockState;
 using Symbol    = Signal::Symbol;
+using Burst     = mrw::can::MrwBusService::Burst;
+
+/**
+ * The planner cost model shared by all routes. It prefers tracks which
+ * need fewer switch motors to move.
+ */
+static const SwitchingCost switching_cost;
+
+Histogram ControlledRoute::activation_latency;
 
 ControlledRoute::ControlledRoute(
 	const bool           dir,
@@ -36,6 +48,7 @@ ControlledRoute::ControlledRoute(
 	Route(dir, wanted_state, first, parent)
 {
 	rename();
+	setCostModel(&switching_cost);
 	list_item.setData(USER_ROLE, QVariant::fromValue(this));
 
 	connect(
@@ -58,6 +71,22 @@ ControlledRoute::ControlledRoute(
 		&statechart, &RouteStatechart::activated,
 		this, &ControlledRoute::dump,
 		Qt::QueuedConnection);
+	connect(
+		this, &ControlledRoute::turn,
+		this, [this]()
+	{
+		turned_ms = TimerService::instance().now();
+	});
+	connect(
+		&statechart, &RouteStatechart::activated,
+		this, [this]()
+	{
+		activation_latency.add(TimerService::instance().now() - turned_ms);
+	});
+	StatechartTracer::instance().attach(&statechart, [this]()
+	{
+		return list_item.text();
+	});
 
 	statechart.setTimerService(TimerService::instance());
 	statechart.setOperationCallback(*this);
@@ -85,6 +114,20 @@ ControlledRoute::~ControlledRoute()
 	statechart.exit();
 }
 
+void ControlledRoute::info()
+{
+	qCInfo(mrw::tools::log, "Route activation latency:");
+	for (size_t i = 0; i < Histogram::BUCKETS; i++)
+	{
+		if (activation_latency[i] != 0)
+		{
+			qCInfo(mrw::tools::log, "  >= %6llu ms: %llu",
+				(unsigned long long)Histogram::bucketFloor(i),
+				(unsigned long long)activation_latency[i]);
+		}
+	}
+}
+
 /*************************************************************************
 **                                                                      **
 **       Preparing extension of route                                   **
@@ -269,6 +312,7 @@ void ControlledRoute::rename()
 		}
 	}
 	list_item.setText(name);
+	StatechartTracer::instance().rename(&statechart);
 }
 
 /*************************************************************************
@@ -634,6 +678,8 @@ void ControlledRoute::turnCrossings()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	for (Section * section : sections)
 	{
 		Device       *       device     = section->crossing();
@@ -653,6 +699,8 @@ void ControlledRoute::turnSwitches()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	for (RailPart * part : track)
 	{
 		Device     *     device     = dynamic_cast<Device *>(part);
@@ -670,6 +718,8 @@ void ControlledRoute::turnFlanks()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	// Now turn
 	for (RegularSwitch * flank_switch : flank_switches)
 	{
@@ -686,6 +736,8 @@ void ControlledRoute::enableSignals()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	collectSignalControllers(controllers_unlocked, true);
 	collectSignalControllers(controllers_locked,   false);
 
@@ -702,6 +754,8 @@ void ControlledRoute::extendSignals()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	for (auto it = controllers_locked.rbegin(); it != controllers_locked.rend(); ++it)
 	{
 		SignalControllerProxy * controller = *it;
@@ -715,6 +769,8 @@ void ControlledRoute::enableSections()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	for (auto it = sections.rbegin(); it != sections.rend(); ++it)
 	{
 		SectionController * controller =
@@ -735,6 +791,8 @@ void ControlledRoute::disableSections()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	std::vector<SectionController *> controllers;
 
 	collectSectionControllers(controllers);
@@ -748,6 +806,8 @@ void ControlledRoute::disableSignals()
 {
 	__METHOD__;
 
+	Burst burst(ControllerRegistry::can());
+
 	std::vector<SignalControllerProxy *> controllers;
 
 	collectSignalControllers(controllers);
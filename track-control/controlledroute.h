@@ -14,6 +14,7 @@
 #include <QListWidgetItem>
 
 #include <util/batch.h>
+#include <util/histogram.h>
 #include <util/self.h>
 #include <model/section.h>
 #include <model/signal.h>
@@ -40,6 +41,12 @@ private:
 	std::vector<mrw::ctrl::SignalControllerProxy *> controllers_unlocked;
 	std::vector<mrw::ctrl::SignalControllerProxy *> controllers_locked;
 
+	/** The service time of the last turn request in ms. */
+	uint64_t        turned_ms = 0;
+
+	/** The time from turning until activation of all routes in ms. */
+	static mrw::util::Histogram activation_latency;
+
 public:
 	static constexpr int    USER_ROLE = Qt::UserRole + 1;
 
@@ -55,6 +62,13 @@ public:
 	// Implementation of mrw::model::Route
 	virtual void dump() const override;
 
+	/**
+	 * This method logs the histogram of the route activation latencies.
+	 * The latency is the time from turning a route until all of its
+	 * devices reported their new state.
+	 */
+	static void info();
+
 signals:
 	void turn();
 	void disable();
@@ -6,6 +6,7 @@
 #include <util/method.h>
 #include <ctrl/controllerregistry.h>
 #include <ctrl/basecontroller.h>
+#include <model/modelrailway.h>
 
 using namespace mrw::util;
 using namespace mrw::can;
@@ -30,11 +31,29 @@ void ControllerRegistry::registerController(
 	ControllerRegistrand * ctrl)
 {
 	registry.emplace(device, ctrl);
+	if (device != nullptr)
+	{
+		RegistryEntry & entry = device_table.slot(DeviceId(device));
+
+		if (entry.device == nullptr)
+		{
+			entry = RegistryEntry{ device, ctrl };
+		}
+	}
 }
 
 void ControllerRegistry::unregisterController(Device * device)
 {
 	registry.erase(device);
+	if (device != nullptr)
+	{
+		RegistryEntry & entry = device_table.slot(DeviceId(device));
+
+		if (entry.device == device)
+		{
+			entry = RegistryEntry();
+		}
+	}
 }
 
 ControllerRegistrand * ControllerRegistry::find(Device * device) const
@@ -48,6 +67,13 @@ ControllerRegistrand * ControllerRegistry::find(Device * device) const
 	return it != registry.end() ? it->second : nullptr;
 }
 
+const RegistryEntry & ControllerRegistry::find(
+	const ControllerId id,
+	const UnitNo       unit_no) const noexcept
+{
+	return device_table.get(id, unit_no);
+}
+
 void ControllerRegistry::registerService(MrwBusService * service)
 {
 	Q_ASSERT(can_service == nullptr);
@@ -56,6 +82,13 @@ void ControllerRegistry::registerService(MrwBusService * service)
 	can_service = service;
 }
 
+void ControllerRegistry::unregisterService(MrwBusService * service)
+{
+	Q_ASSERT(can_service == service);
+
+	can_service = nullptr;
+}
+
 MrwBusService * ControllerRegistry::can()
 {
 	Q_ASSERT(instance().can_service != nullptr);
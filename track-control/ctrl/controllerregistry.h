@@ -12,6 +12,7 @@
 
 #include <QObject>
 
+#include <can/devicetable.h>
 #include <can/mrwbusservice.h>
 #include <model/device.h>
 #include <ctrl/controllerregistrand.h>
@@ -22,6 +23,16 @@ namespace mrw::ctrl
 {
 	class ControllerRegistrand;
 
+	/**
+	 * This structure combines a registered Device with its
+	 * ControllerRegistrand for the flat lookup by CAN address.
+	 */
+	struct RegistryEntry
+	{
+		mrw::model::Device   *  device     = nullptr;
+		ControllerRegistrand  * registrand = nullptr;
+	};
+
 	class ControllerRegistry :
 		public QObject,
 		public mrw::util::Singleton<ControllerRegistry>
@@ -35,6 +46,7 @@ namespace mrw::ctrl
 		friend class Singleton<ControllerRegistry>;
 
 		std::unordered_map<mrw::model::Device *, ControllerRegistrand * >  registry;
+		mrw::can::DeviceTable<RegistryEntry>                               device_table;
 		mrw::can::MrwBusService                      *                     can_service = nullptr;
 
 	public:
@@ -45,6 +57,22 @@ namespace mrw::ctrl
 
 		ControllerRegistrand * find(model::Device * device) const;
 
+		/**
+		 * This method looks up the Device and its ControllerRegistrand by
+		 * the CAN address of a response message. It uses a flat table
+		 * which is kept in sync with registerController() and
+		 * unregisterController() so no hashing and no dynamic_cast is
+		 * needed for each received MrwMessage.
+		 *
+		 * @param id The ControllerId of the sending Controller.
+		 * @param unit_no The UnitNo of the sending Device.
+		 * @return The RegistryEntry which contains @c nullptr values if
+		 * nothing is registered.
+		 */
+		const RegistryEntry & find(
+			const mrw::can::ControllerId id,
+			const mrw::can::UnitNo       unit_no) const noexcept;
+
 		template <class R> R * find(mrw::model::Device * device) const
 		{
 			return dynamic_cast<R *>(find(device));
@@ -64,6 +92,7 @@ namespace mrw::ctrl
 		}
 
 		void registerService(mrw::can::MrwBusService * service);
+		void unregisterService(mrw::can::MrwBusService * service);
 		static mrw::can::MrwBusService * can();
 
 	signals:
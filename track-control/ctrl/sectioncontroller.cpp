@@ -12,6 +12,7 @@
 #include <ctrl/sectioncontroller.h>
 #include <ctrl/controllerregistry.h>
 #include <statecharts/timerservice.h>
+#include <statecharts/statecharttracer.h>
 
 using namespace mrw::can;
 using namespace mrw::model;
@@ -114,6 +115,10 @@ SectionController::SectionController(
 	{
 		qCDebug(log).noquote() << ctrl_section->toString() << "Inquiry completed.";
 	});
+	StatechartTracer::instance().attach(&statechart, [this]()
+	{
+		return name();
+	});
 
 	statechart.setTimerService(TimerService::instance());
 	statechart.setOperationCallback(*this);
@@ -14,6 +14,7 @@
 #include <ctrl/signalcontrollerproxy.h>
 #include <ctrl/controllerregistry.h>
 #include <statecharts/timerservice.h>
+#include <statecharts/statecharttracer.h>
 
 using namespace mrw::util;
 using namespace mrw::can;
@@ -215,6 +216,11 @@ void SignalControllerProxy::initStatechart()
 	statechart_distant.start(distant_signal, main_signal);
 	statechart_shunt.start(shunt_signal, main_signal);
 
+	StatechartTracer::instance().attach(&statechart, [this]()
+	{
+		return name();
+	});
+
 	statechart.setTimerService(TimerService::instance());
 	statechart.setOperationCallback(*this);
 
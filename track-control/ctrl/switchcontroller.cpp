@@ -5,6 +5,7 @@
 
 #include <util/method.h>
 #include <statecharts/timerservice.h>
+#include <statecharts/statecharttracer.h>
 
 #include "ctrl/controllerregistry.h"
 #include "ctrl/switchcontroller.h"
@@ -16,6 +17,11 @@ using namespace mrw::ctrl;
 
 SwitchController::SwitchController()
 {
+	StatechartTracer::instance().attach(&statechart, [this]()
+	{
+		return name();
+	});
+
 	statechart.setTimerService(TimerService::instance());
 	statechart.setOperationCallback(*this);
 
@@ -15,7 +15,9 @@
 #include <util/method.h>
 #include <util/settings.h>
 #include <util/dumphandler.h>
+#include <util/tracerecorder.h>
 #include <model/modelrepository.h>
+#include <statecharts/timerservice.h>
 #include <log/stdlogger.h>
 #include <log/filelogger.h>
 #include <log/syslogger.h>
@@ -23,6 +25,7 @@
 #include <ui/style.h>
 
 #include "mainwindow.h"
+#include "controlledroute.h"
 #include "mrwmessagedispatcher.h"
 #include "log.h"
 
@@ -41,17 +44,31 @@ int main(int argc, char * argv[])
 	LoggerService::instance().registerLogger(&std_logger);
 	LoggerService::instance().registerLogger(&file_logger);
 	LoggerService::instance().registerLogger(&sys_logger);
+	LoggerService::instance().setAsynchronous(true);
 
 	ModelRepository          repo(ModelRepository::proposeModelName(), true);
 
 	if (repo)
 	{
-		MrwMessageDispatcher dispatcher(repo, repo.interface(), repo.plugin());
+		mrw::statechart::TimerService::instance().setVirtualTime(repo.virtualTime());
+		if (!repo.traceFilename().isEmpty())
+		{
+			// Open before any controller or CAN thread records.
+			TraceRecorder::instance().open(repo.traceFilename(), repo.traceSize());
+		}
+
+		MrwMessageDispatcher dispatcher(repo, repo.interface(), repo.plugin(), nullptr, repo.threaded());
 		DumpHandler          dumper([&]()
 		{
-			ModelRailway * model = repo;
+			const LoggerService::Statistics statistics = LoggerService::instance().statistics();
+			ModelRailway          *         model      = repo;
 
 			model->info();
+			mrw::statechart::TimerService::instance().info();
+			ControlledRoute::info();
+			qCInfo(mrw::tools::log).noquote() << "Logging:" << statistics.queued << "queued," <<
+				statistics.dropped << "dropped," << statistics.truncated << "truncated," <<
+				statistics.batches << "batches, peak" << statistics.peak;
 		});
 
 		Style::setEstwStyle(app);
@@ -77,6 +94,7 @@ int main(int argc, char * argv[])
 			qCInfo(mrw::tools::log)           << "Qt version:" << qVersion();
 			qCInfo(mrw::tools::log).noquote() << "CAN plugin:" << repo.plugin();
 			qCInfo(mrw::tools::log).noquote() << "CAN iface: " << repo.interface();
+			qCInfo(mrw::tools::log)           << "CAN thread:" << dispatcher.isThreaded();
 			qCInfo(mrw::tools::log, "==========================================================");
 #ifdef USE_SYSTEMD
 			sd_notify(0, "READY=1");
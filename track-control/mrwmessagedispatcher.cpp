@@ -3,6 +3,8 @@
 //  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
 //
 
+#include <memory>
+
 #include <QCoreApplication>
 
 #include <util/method.h>
@@ -20,9 +22,22 @@ MrwMessageDispatcher::MrwMessageDispatcher(
 	ModelRailway   *  model_railway,
 	const QString  &  interface,
 	const QString  &  plugin,
-	QObject     *     parent) :
-	MrwBusService(interface, plugin, parent, false),
-	model(model_railway)
+	QObject     *     parent,
+	const bool        threaded) :
+	MrwBusService(interface, plugin, parent, false, threaded),
+	model(model_railway),
+	coalescer(
+		[this] (const MrwMessage & message)
+	{
+		dispatch(message);
+	},
+	[this] ()
+	{
+		QMetaObject::invokeMethod(this, [this] ()
+		{
+			coalescer.flush();
+		}, Qt::QueuedConnection);
+	})
 {
 	__METHOD__;
 
@@ -38,23 +53,56 @@ MrwMessageDispatcher::~MrwMessageDispatcher()
 {
 	__METHOD__;
 
+	ControllerRegistry::instance().unregisterService(this);
+
 	qCInfo(mrw::tools::log, "  Shutting down MRW message dispatcher.");
+	qCInfo(mrw::tools::log, "  Occupation responses coalesced: %llu, delivered: %llu.",
+		(unsigned long long)coalescer.statistics().coalesced,
+		(unsigned long long)coalescer.statistics().delivered);
+}
+
+const OccupationCoalescer::Statistics & MrwMessageDispatcher::coalescing() const noexcept
+{
+	return coalescer.statistics();
 }
 
 void MrwMessageDispatcher::emergencyStop()
 {
-	std::vector<Section *> sections;
+	std::vector<MrwMessage> messages;
 
-	model->parts<Section>(sections);
-	for (Section * section : sections)
+	for (size_t r = 0; r < model->regionCount(); r++)
 	{
-		const MrwMessage message = section->command(SETROF);
+		const Region * region = model->region(r);
+
+		for (size_t s = 0; s < region->sectionCount(); s++)
+		{
+			const Section * section = region->section(s);
+
+			if (Device::hasController(section))
+			{
+				messages.emplace_back(section->command(SETROF));
+			}
+		}
+	}
+
+	std::unique_ptr<bool[]> results = std::make_unique<bool[]>(messages.size());
+	const size_t            queued  = write(messages, std::span<bool>(results.get(), messages.size()));
 
-		write(message);
+	for (size_t i = 0; (queued < messages.size()) && (i < messages.size()); i++)
+	{
+		if (!results[i])
+		{
+			qCCritical(mrw::tools::log).noquote() << "Emergency stop not queued:" << messages[i];
+		}
 	}
 }
 
 void MrwMessageDispatcher::process(const MrwMessage & message)
+{
+	coalescer.process(message);
+}
+
+void MrwMessageDispatcher::dispatch(const MrwMessage & message)
 {
 	const ControllerId dst = message.sid();
 
@@ -66,9 +114,8 @@ void MrwMessageDispatcher::process(const MrwMessage & message)
 			// ...and we are addressed.
 			const ControllerId     id         = message.eid();
 			const UnitNo           unit_no    = message.unitNo();
-			Device        *        device     = model->deviceById(id, unit_no);
 			ControllerRegistrand * controller =
-				ControllerRegistry::instance().find<ControllerRegistrand>(device);
+				ControllerRegistry::instance().find(id, unit_no).registrand;
 
 			if (controller != nullptr)
 			{
@@ -145,7 +192,7 @@ void MrwMessageDispatcher::connectBus()
 	if (!isConnected())
 	{
 		qCDebug(mrw::tools::log, "Connecting CAN device...");
-		can_device->connectDevice();
+		connectDevice();
 	}
 	else
 	{
@@ -155,5 +202,5 @@ void MrwMessageDispatcher::connectBus()
 
 bool MrwMessageDispatcher::isConnected()
 {
-	return can_device->state() == QCanBusDevice::ConnectedState;
+	return valid();
 }
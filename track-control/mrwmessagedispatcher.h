@@ -11,6 +11,7 @@
 #include <util/self.h>
 #include <statecharts/OperatingModeStatechart.h>
 #include <can/mrwbusservice.h>
+#include <can/occupationcoalescer.h>
 #include <model/modelrailway.h>
 
 class MrwMessageDispatcher :
@@ -22,16 +23,27 @@ class MrwMessageDispatcher :
 private:
 	mrw::model::ModelRailway    *    model   = nullptr;
 
+	mrw::can::OccupationCoalescer    coalescer;
+
 public:
 	MrwMessageDispatcher() = delete;
 	explicit MrwMessageDispatcher(
 		mrw::model::ModelRailway  *  model_railway,
 		const QString        &       interface = "can0",
 		const QString        &       plugin    = "socketcan",
-		QObject           *          parent    = nullptr);
+		QObject           *          parent    = nullptr,
+		const bool                   threaded  = false);
 
 	virtual ~MrwMessageDispatcher();
 
+	/**
+	 * This method returns the counters of the occupation coalescing
+	 * stage.
+	 *
+	 * @return The coalescing counters.
+	 */
+	const mrw::can::OccupationCoalescer::Statistics & coalescing() const noexcept;
+
 signals:
 	void brightness(unsigned value);
 
@@ -43,6 +55,9 @@ protected:
 	virtual bool filter(const mrw::can::MrwMessage & message);
 	virtual void connectBus() override;
 	virtual bool isConnected() override;
+
+private:
+	void dispatch(const mrw::can::MrwMessage & message);
 };
 
 #endif
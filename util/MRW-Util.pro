@@ -19,11 +19,15 @@ SOURCES += \
 	globalbatch.cpp \
 	hexline.cpp \
 	log.cpp \
+	phaseprofile.cpp \
 	properties.cpp \
 	settings.cpp \
 	signalhandler.cpp \
 	stringutil.cpp \
-	termhandler.cpp
+	termhandler.cpp \
+	timerwheel.cpp \
+	tracefile.cpp \
+	tracerecorder.cpp
 
 HEADERS += \
 	appsupport.h \
@@ -34,17 +38,25 @@ HEADERS += \
 	constantenumerator.h \
 	dumphandler.h \
 	duration.h \
+	fixedstack.h \
+	histogram.h \
 	globalbatch.h \
 	hexline.h \
 	log.h \
 	method.h \
+	mpscring.h \
+	phaseprofile.h \
 	properties.h \
 	random.h \
 	self.h \
 	settings.h \
 	signalhandler.h \
 	singleton.h \
+	spscring.h \
 	stringutil.h \
-	termhandler.h
+	termhandler.h \
+	timerwheel.h \
+	tracefile.h \
+	tracerecorder.h
 
 QMAKE_CLEAN         += $$TARGET
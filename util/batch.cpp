@@ -8,6 +8,7 @@
 #include <util/batch.h>
 #include <util/batchparticipant.h>
 #include <util/log.h>
+#include <util/tracerecorder.h>
 
 using namespace mrw::util;
 
@@ -56,6 +57,10 @@ bool Batch::increase(BatchParticipant * element) noexcept
 {
 	if (transaction.find(element) == transaction.end())
 	{
+		if (transaction.empty() && TraceRecorder::instance().isOpen())
+		{
+			start_ns = TraceRecorder::now();
+		}
 		transaction.emplace(element);
 		qCDebug(log, "Transaction (ID=%u) increased to %zu element(s). Added: %s",
 			id, transaction.size(),  element->name().toLatin1().constData());
@@ -81,6 +86,7 @@ bool Batch::decrease(BatchParticipant * element) noexcept
 		{
 			qCDebug(log, "======================= Transaction (ID=%u) completed.",
 				id);
+			traceCompletion();
 			emit completed();
 		}
 		return true;
@@ -105,6 +111,7 @@ void Batch::tryComplete()
 	{
 		qCDebug(log, "======================= Transaction (ID=%u) completed (was empty).",
 			id);
+		traceCompletion();
 		emit completed();
 	}
 	else
@@ -133,3 +140,14 @@ void Batch::remove(BatchParticipant * element) noexcept
 {
 	transaction.erase(element);
 }
+
+void Batch::traceCompletion() noexcept
+{
+	TraceRecorder & recorder = TraceRecorder::instance();
+
+	if (recorder.isOpen())
+	{
+		recorder.batch(id, start_ns != 0 ? TraceRecorder::now() - start_ns : 0);
+	}
+	start_ns = 0;
+}
@@ -118,7 +118,11 @@ namespace mrw::util
 		friend class BatchParticipant;
 
 	private:
+		/** The monotonic time the transaction became non empty. */
+		uint64_t                               start_ns = 0;
+
 		void remove(BatchParticipant * element) noexcept;
+		void traceCompletion() noexcept;
 	};
 }
 
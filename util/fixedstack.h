@@ -0,0 +1,131 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_FIXEDSTACK_H
+#define MRW_UTIL_FIXEDSTACK_H
+
+#include <array>
+#include <cstddef>
+
+namespace mrw::util
+{
+	/**
+	 * This template class implements a stack with a fixed capacity which
+	 * never allocates memory. It is intended for trivially copyable
+	 * elements like pointers used in recursive searches where the maximum
+	 * depth is known at compile time.
+	 *
+	 * @tparam T The element type.
+	 * @tparam CAPACITY The maximum amount of elements.
+	 */
+	template<class T, size_t CAPACITY> class FixedStack
+	{
+		std::array<T, CAPACITY> elements{};
+		size_t                  count = 0;
+
+	public:
+		using const_iterator = typename std::array<T, CAPACITY>::const_iterator;
+
+		/**
+		 * This method pushes an element on top of the stack.
+		 *
+		 * @param value The element to push.
+		 * @return True if the element was pushed or false if the stack was
+		 * full.
+		 */
+		bool push(const T & value) noexcept
+		{
+			if (count >= CAPACITY)
+			{
+				return false;
+			}
+			elements[count++] = value;
+			return true;
+		}
+
+		/**
+		 * This method removes the top element. The stack must not be
+		 * empty.
+		 */
+		void pop() noexcept
+		{
+			count--;
+		}
+
+		/**
+		 * This method returns the top element. The stack must not be
+		 * empty.
+		 *
+		 * @return The top element.
+		 */
+		[[nodiscard]]
+		const T & back() const noexcept
+		{
+			return elements[count - 1];
+		}
+
+		/**
+		 * This method returns the element at the given position counted
+		 * from the bottom of the stack.
+		 *
+		 * @param index The position which must be less than size().
+		 * @return The element at the given position.
+		 */
+		[[nodiscard]]
+		const T & operator[](const size_t index) const noexcept
+		{
+			return elements[index];
+		}
+
+		/**
+		 * This method removes all elements above the given size.
+		 *
+		 * @param new_size The new size which must not exceed size().
+		 */
+		void truncate(const size_t new_size) noexcept
+		{
+			count = new_size;
+		}
+
+		void clear() noexcept
+		{
+			count = 0;
+		}
+
+		[[nodiscard]]
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		[[nodiscard]]
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+		[[nodiscard]]
+		static constexpr size_t capacity() noexcept
+		{
+			return CAPACITY;
+		}
+
+		[[nodiscard]]
+		const_iterator begin() const noexcept
+		{
+			return elements.begin();
+		}
+
+		[[nodiscard]]
+		const_iterator end() const noexcept
+		{
+			return elements.begin() + count;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,84 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_HISTOGRAM_H
+#define MRW_UTIL_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace mrw::util
+{
+	/**
+	 * This class implements a histogram with logarithmic buckets. Bucket
+	 * zero counts the value zero and bucket n counts the values from
+	 * 2^(n-1) until 2^n-1. The last bucket counts all larger values, too.
+	 * Counting a value never allocates memory.
+	 */
+	class Histogram
+	{
+	public:
+		/** The amount of histogram buckets. */
+		static constexpr size_t BUCKETS = 16;
+
+	private:
+		std::array<uint64_t, BUCKETS> counts{};
+
+	public:
+		/**
+		 * This method counts the given value into its bucket.
+		 *
+		 * @param value The value to count.
+		 */
+		constexpr void add(const uint64_t value) noexcept
+		{
+			counts[bucket(value)]++;
+		}
+
+		/**
+		 * This method returns the count of the given bucket.
+		 *
+		 * @param index The bucket index.
+		 * @return The amount of values counted by the bucket.
+		 */
+		[[nodiscard]]
+		constexpr uint64_t operator[](const size_t index) const noexcept
+		{
+			return counts[index];
+		}
+
+		/**
+		 * This method returns the histogram bucket of the given value.
+		 *
+		 * @param value The value to classify.
+		 * @return The bucket index.
+		 */
+		[[nodiscard]]
+		static constexpr size_t bucket(const uint64_t value) noexcept
+		{
+			return std::min<size_t>(std::bit_width(value), BUCKETS - 1);
+		}
+
+		/**
+		 * This method returns the smallest value counted by the given
+		 * histogram bucket.
+		 *
+		 * @param index The bucket index.
+		 * @return The lower limit of the bucket.
+		 */
+		[[nodiscard]]
+		static constexpr uint64_t bucketFloor(const size_t index) noexcept
+		{
+			return index == 0 ? 0 : uint64_t(1) << (index - 1);
+		}
+	};
+}
+
+#endif
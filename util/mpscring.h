@@ -0,0 +1,195 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_MPSCRING_H
+#define MRW_UTIL_MPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+
+namespace mrw::util
+{
+	/**
+	 * This template class implements a bounded lock free ring buffer for
+	 * any amount of producer threads and exactly one consumer thread. Each
+	 * slot carries a sequence number which tells whether the slot is free
+	 * for the producer of a given position or filled for the consumer. The
+	 * producers reserve a position by a compare and swap on the tail
+	 * index. The consumer only writes the head index. Both indices are
+	 * placed on their own cache lines to avoid false sharing.
+	 *
+	 * An element becomes visible to the consumer when its producer
+	 * completed the push(). So a slow producer delays the elements of
+	 * producers which reserved later positions but it never blocks them.
+	 *
+	 * The ring never allocates memory after construction. If the ring is
+	 * full push() fails and the caller has to decide whether to drop the
+	 * element or to retry later.
+	 *
+	 * @note Calling pop() from more than one thread is undefined behaviour.
+	 *
+	 * @tparam T The element type which must be move constructible. It does
+	 * not need a default constructor.
+	 * @tparam CAPACITY The maximum amount of elements which must be a power
+	 * of two.
+	 * @see SpscRing
+	 */
+	template<class T, size_t CAPACITY> class MpscRing
+	{
+		static_assert(CAPACITY >= 2, "Ring capacity too small!");
+		static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Ring capacity must be a power of two!");
+
+		static constexpr size_t MASK       = CAPACITY - 1;
+		static constexpr size_t CACHE_LINE = 64;
+
+		/**
+		 * Uninitialized storage for one element. An element is constructed
+		 * on push() and destroyed on pop().
+		 */
+		struct Slot
+		{
+			std::atomic<size_t>          sequence{0};
+			alignas(T) std::byte         storage[sizeof(T)];
+		};
+
+		alignas(CACHE_LINE) std::atomic<size_t>        head{0};
+		alignas(CACHE_LINE) std::atomic<size_t>        tail{0};
+		alignas(CACHE_LINE) std::array<Slot, CAPACITY> buffer;
+
+	public:
+		MpscRing()
+		{
+			for (size_t i = 0; i < CAPACITY; i++)
+			{
+				buffer[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		MpscRing(const MpscRing & other) = delete;
+		MpscRing & operator=(const MpscRing & other) = delete;
+
+		/**
+		 * The destructor destroys all remaining elements.
+		 */
+		~MpscRing()
+		{
+			while (pop().has_value())
+			{
+				// Intentionally left blank.
+			}
+		}
+
+		/**
+		 * This method appends an element to the ring. It may be called from
+		 * any thread.
+		 *
+		 * @param value The element to append.
+		 * @return True if the element was appended or false if the ring
+		 * was full.
+		 */
+		bool push(T value) noexcept
+		{
+			size_t pos = tail.load(std::memory_order_relaxed);
+
+			for (;;)
+			{
+				Slot     &     cell       = buffer[pos & MASK];
+				const size_t   seq        = cell.sequence.load(std::memory_order_acquire);
+				const intptr_t difference = intptr_t(seq) - intptr_t(pos);
+
+				if (difference == 0)
+				{
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						new (cell.storage) T(std::move(value));
+						cell.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					// The consumer did not release this slot yet.
+					return false;
+				}
+				else
+				{
+					pos = tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/**
+		 * This method removes the oldest element from the ring. It must
+		 * only be called from the consumer thread.
+		 *
+		 * @return The oldest element or std::nullopt if the ring was empty
+		 * or the oldest element is not completely pushed yet.
+		 */
+		std::optional<T> pop() noexcept
+		{
+			const size_t pos  = head.load(std::memory_order_relaxed);
+			Slot     &   cell = buffer[pos & MASK];
+
+			if (cell.sequence.load(std::memory_order_acquire) != (pos + 1))
+			{
+				return std::nullopt;
+			}
+
+			T              * element = std::launder(reinterpret_cast<T *>(cell.storage));
+			std::optional<T> result(std::move(*element));
+
+			element->~T();
+			cell.sequence.store(pos + CAPACITY, std::memory_order_release);
+			head.store(pos + 1, std::memory_order_release);
+			return result;
+		}
+
+		/**
+		 * This method returns the amount of elements currently reserved or
+		 * queued. The value is only a snapshot if called while another
+		 * thread is active.
+		 *
+		 * @return The amount of queued elements.
+		 */
+		[[nodiscard]]
+		size_t size() const noexcept
+		{
+			// Load head first: The tail never falls behind a head read before.
+			const size_t first = head.load(std::memory_order_acquire);
+
+			return tail.load(std::memory_order_acquire) - first;
+		}
+
+		/**
+		 * This method returns true if no element is queued.
+		 *
+		 * @return True if the ring is empty.
+		 */
+		[[nodiscard]]
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		/**
+		 * This method returns the maximum amount of elements.
+		 *
+		 * @return The ring capacity.
+		 */
+		[[nodiscard]]
+		static constexpr size_t capacity() noexcept
+		{
+			return CAPACITY;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,144 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include <QByteArray>
+
+#include <util/phaseprofile.h>
+
+using namespace mrw::util;
+
+thread_local PhaseProfile * PhaseProfile::active = nullptr;
+
+PhaseProfile::Scope::Scope(const char * phase_name) noexcept :
+	profile(PhaseProfile::active),
+	name(phase_name)
+{
+	if (profile != nullptr)
+	{
+		profile->enter(this);
+		allocations = profile->allocations();
+		timer.start();
+	}
+}
+
+PhaseProfile::Scope::~Scope()
+{
+	if (profile != nullptr)
+	{
+		profile->leave(this);
+	}
+}
+
+PhaseProfile::PhaseProfile(AllocationCounter allocation_counter) noexcept :
+	previous(active),
+	counter(allocation_counter)
+{
+	active = this;
+}
+
+PhaseProfile::~PhaseProfile()
+{
+	active = previous;
+}
+
+const std::vector<PhaseProfile::Phase> & PhaseProfile::phases() const noexcept
+{
+	return phase_list;
+}
+
+long PhaseProfile::peakRss() noexcept
+{
+	// Plain system calls since the measurement must not allocate memory.
+	char      buffer[4096];
+	const int fd = open("/proc/self/status", O_RDONLY);
+
+	if (fd >= 0)
+	{
+		const ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+
+		close(fd);
+		if (size > 0)
+		{
+			buffer[size] = 0;
+
+			const char * hwm = std::strstr(buffer, "VmHWM:");
+
+			if (hwm != nullptr)
+			{
+				return std::strtol(hwm + 6, nullptr, 10);
+			}
+		}
+	}
+
+	struct rusage usage {};
+
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+}
+
+bool PhaseProfile::resetPeakRss() noexcept
+{
+	const int fd = open("/proc/self/clear_refs", O_WRONLY);
+
+	if (fd >= 0)
+	{
+		const bool success = write(fd, "5", 1) == 1;
+
+		close(fd);
+		return success;
+	}
+	return false;
+}
+
+size_t PhaseProfile::allocations() const noexcept
+{
+	return counter != nullptr ? counter() : 0;
+}
+
+void PhaseProfile::enter(Scope * scope) noexcept
+{
+	// Resetting the high-water mark also resets it for the outer phases.
+	// So they carry the peak measured so far.
+	scope->outer = innermost;
+	if (innermost != nullptr)
+	{
+		innermost->peak_rss = std::max(innermost->peak_rss, peakRss());
+	}
+	innermost = scope;
+	resetPeakRss();
+}
+
+void PhaseProfile::leave(Scope * scope)
+{
+	const qint64 nsecs            = scope->timer.nsecsElapsed();
+	const size_t allocation_count = allocations() - scope->allocations;
+	const long   rss              = std::max(scope->peak_rss, peakRss());
+
+	innermost = scope->outer;
+	if (innermost != nullptr)
+	{
+		innermost->peak_rss = std::max(innermost->peak_rss, rss);
+	}
+
+	for (Phase & phase : phase_list)
+	{
+		if (qstrcmp(phase.name, scope->name) == 0)
+		{
+			phase.calls++;
+			phase.nsecs       += nsecs;
+			phase.allocations += allocation_count;
+			phase.peak_rss     = std::max(phase.peak_rss, rss);
+			return;
+		}
+	}
+	phase_list.push_back(Phase{scope->name, 1, nsecs, allocation_count, rss});
+}
@@ -0,0 +1,150 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_PHASEPROFILE_H
+#define MRW_UTIL_PHASEPROFILE_H
+
+#include <vector>
+
+#include <QElapsedTimer>
+
+namespace mrw::util
+{
+	/**
+	 * This class collects the time, the amount of memory allocations and
+	 * the peak resident set size of named phases. Phases are marked by a
+	 * PhaseProfile::Scope instance inside the code of interest. As long as
+	 * no PhaseProfile is active in the current thread a Scope costs a
+	 * single pointer test so it may stay in production code.
+	 *
+	 * Multiple invocations of the same phase are summed up. Nested phases
+	 * are recorded separately so the time of an outer phase contains the
+	 * time of its inner phases.
+	 *
+	 * Counting allocations needs a replacement of the global operator
+	 * new which is up to the application. The application passes a
+	 * function returning the current allocation count. Without such a
+	 * function all allocation counts are zero.
+	 *
+	 * The peak resident set size of a phase is measured by resetting the
+	 * high-water mark of the process on phase entry and reading it on
+	 * phase exit. This needs a Linux kernel allowing to write
+	 * /proc/self/clear_refs. Otherwise the peak resident set size of the
+	 * whole process lifetime is reported.
+	 */
+	class PhaseProfile
+	{
+	public:
+		/** The function type returning the current allocation count. */
+		typedef size_t (*AllocationCounter)();
+
+		/**
+		 * This struct contains the accumulated measurements of one phase.
+		 */
+		struct Phase
+		{
+			/** The phase name. */
+			const char * name        = nullptr;
+
+			/** The amount of phase invocations. */
+			size_t       calls       = 0;
+
+			/** The accumulated wall time in nanoseconds. */
+			qint64       nsecs       = 0;
+
+			/** The accumulated amount of memory allocations. */
+			size_t       allocations = 0;
+
+			/** The peak resident set size in kB during the phase. */
+			long         peak_rss    = 0;
+		};
+
+		/**
+		 * This class measures the phase from its construction until its
+		 * destruction if a PhaseProfile is active in the current thread.
+		 */
+		class Scope
+		{
+			PhaseProfile * profile     = nullptr;
+			Scope     *    outer       = nullptr;
+			const char  *  name        = nullptr;
+			size_t         allocations = 0;
+			long           peak_rss    = 0;
+			QElapsedTimer  timer;
+
+			friend class PhaseProfile;
+
+		public:
+			/**
+			 * The constructor starts the measurement.
+			 *
+			 * @param phase_name The phase name which must be a string
+			 * literal.
+			 */
+			explicit Scope(const char * phase_name) noexcept;
+			Scope(const Scope & other) = delete;
+			Scope & operator=(const Scope & other) = delete;
+
+			/**
+			 * The destructor stops the measurement and records the result.
+			 */
+			~Scope();
+		};
+
+		/**
+		 * The constructor activates this profile for the current thread.
+		 *
+		 * @param counter The optional allocation counting function.
+		 */
+		explicit PhaseProfile(AllocationCounter counter = nullptr) noexcept;
+		PhaseProfile(const PhaseProfile & other) = delete;
+		PhaseProfile & operator=(const PhaseProfile & other) = delete;
+
+		/**
+		 * The destructor reactivates the previously active profile.
+		 */
+		~PhaseProfile();
+
+		/**
+		 * This method returns the recorded phases in order of their first
+		 * completion.
+		 *
+		 * @return The recorded phases.
+		 */
+		const std::vector<Phase> & phases() const noexcept;
+
+		/**
+		 * This method returns the peak resident set size of this process
+		 * since the last resetPeakRss() call or since process start.
+		 *
+		 * @return The peak resident set size in kB.
+		 */
+		static long peakRss() noexcept;
+
+		/**
+		 * This method resets the peak resident set size of this process
+		 * to the current resident set size.
+		 *
+		 * @return True if the kernel supports resetting.
+		 */
+		static bool resetPeakRss() noexcept;
+
+	private:
+		static thread_local PhaseProfile * active;
+
+		PhaseProfile    *   previous  = nullptr;
+		Scope       *       innermost = nullptr;
+		AllocationCounter   counter   = nullptr;
+		std::vector<Phase>  phase_list;
+
+		size_t allocations() const noexcept;
+		void   enter(Scope * scope) noexcept;
+		void   leave(Scope * scope);
+	};
+}
+
+#endif
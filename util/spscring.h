@@ -0,0 +1,166 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_SPSCRING_H
+#define MRW_UTIL_SPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+
+namespace mrw::util
+{
+	/**
+	 * This template class implements a bounded lock free ring buffer for
+	 * exactly one producer thread and exactly one consumer thread. The
+	 * producer only writes the tail index and the consumer only writes the
+	 * head index. So no lock and no compare and swap is needed. The indices
+	 * are placed on their own cache lines to avoid false sharing between
+	 * both threads.
+	 *
+	 * The ring never allocates memory after construction. If the ring is
+	 * full push() fails and the caller has to decide whether to drop the
+	 * element or to retry later.
+	 *
+	 * @note Calling push() from more than one thread or pop() from more than
+	 * one thread is undefined behaviour.
+	 *
+	 * @tparam T The element type which must be move constructible. It does
+	 * not need a default constructor.
+	 * @tparam CAPACITY The maximum amount of elements which must be a power
+	 * of two.
+	 */
+	template<class T, size_t CAPACITY> class SpscRing
+	{
+		static_assert(CAPACITY >= 2, "Ring capacity too small!");
+		static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Ring capacity must be a power of two!");
+
+		static constexpr size_t MASK       = CAPACITY - 1;
+		static constexpr size_t CACHE_LINE = 64;
+
+		/**
+		 * Uninitialized storage for one element. An element is constructed
+		 * on push() and destroyed on pop().
+		 */
+		struct Slot
+		{
+			alignas(T) std::byte storage[sizeof(T)];
+		};
+
+		alignas(CACHE_LINE) std::atomic<size_t>        head{0};
+		alignas(CACHE_LINE) std::atomic<size_t>        tail{0};
+		alignas(CACHE_LINE) std::array<Slot, CAPACITY> buffer;
+
+		T * slot(const size_t pos) noexcept
+		{
+			return std::launder(reinterpret_cast<T *>(buffer[pos & MASK].storage));
+		}
+
+	public:
+		SpscRing() = default;
+		SpscRing(const SpscRing & other) = delete;
+		SpscRing & operator=(const SpscRing & other) = delete;
+
+		/**
+		 * The destructor destroys all remaining elements.
+		 */
+		~SpscRing()
+		{
+			while (pop().has_value())
+			{
+				// Intentionally left blank.
+			}
+		}
+
+		/**
+		 * This method appends an element to the ring. It must only be
+		 * called from the producer thread.
+		 *
+		 * @param value The element to append.
+		 * @return True if the element was appended or false if the ring
+		 * was full.
+		 */
+		bool push(T value) noexcept
+		{
+			const size_t pos = tail.load(std::memory_order_relaxed);
+
+			if ((pos - head.load(std::memory_order_acquire)) >= CAPACITY)
+			{
+				return false;
+			}
+
+			new (buffer[pos & MASK].storage) T(std::move(value));
+			tail.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * This method removes the oldest element from the ring. It must
+		 * only be called from the consumer thread.
+		 *
+		 * @return The oldest element or std::nullopt if the ring was empty.
+		 */
+		std::optional<T> pop() noexcept
+		{
+			const size_t pos = head.load(std::memory_order_relaxed);
+
+			if (pos == tail.load(std::memory_order_acquire))
+			{
+				return std::nullopt;
+			}
+
+			T              * element = slot(pos);
+			std::optional<T> result(std::move(*element));
+
+			element->~T();
+			head.store(pos + 1, std::memory_order_release);
+			return result;
+		}
+
+		/**
+		 * This method returns the amount of elements currently queued. The
+		 * value is only a snapshot if called while the other side is
+		 * active.
+		 *
+		 * @return The amount of queued elements.
+		 */
+		[[nodiscard]]
+		size_t size() const noexcept
+		{
+			// Load head first: The tail never falls behind a head read before.
+			const size_t first = head.load(std::memory_order_acquire);
+
+			return tail.load(std::memory_order_acquire) - first;
+		}
+
+		/**
+		 * This method returns true if no element is queued.
+		 *
+		 * @return True if the ring is empty.
+		 */
+		[[nodiscard]]
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		/**
+		 * This method returns the maximum amount of elements.
+		 *
+		 * @return The ring capacity.
+		 */
+		[[nodiscard]]
+		static constexpr size_t capacity() noexcept
+		{
+			return CAPACITY;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,235 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <bit>
+
+#include <util/timerwheel.h>
+
+using namespace mrw::util;
+
+TimerWheel::TimerWheel(const uint64_t start_ms) : current(start_ms)
+{
+}
+
+TimerWheel::Handle TimerWheel::create()
+{
+	Handle handle = INVALID;
+
+	if (free_nodes.empty())
+	{
+		handle = Handle(nodes.size());
+		nodes.emplace_back();
+	}
+	else
+	{
+		handle = free_nodes.back();
+		free_nodes.pop_back();
+	}
+
+	nodes[handle].allocated = true;
+	return handle;
+}
+
+void TimerWheel::destroy(const Handle handle) noexcept
+{
+	if ((handle < nodes.size()) && nodes[handle].allocated)
+	{
+		stop(handle);
+		nodes[handle] = Node();
+		free_nodes.push_back(handle);
+	}
+}
+
+void TimerWheel::start(
+	const Handle   handle,
+	const uint64_t now_ms,
+	const uint64_t delay_ms,
+	const uint64_t period_ms) noexcept
+{
+	Node & node = nodes[handle];
+
+	stop(handle);
+	node.period = period_ms;
+	insert(handle, std::clamp(now_ms + delay_ms, current + 1, HORIZON));
+}
+
+void TimerWheel::stop(const Handle handle) noexcept
+{
+	if (nodes[handle].slot != UNLINKED)
+	{
+		unlink(handle);
+	}
+}
+
+bool TimerWheel::isActive(const Handle handle) const noexcept
+{
+	return nodes[handle].slot != UNLINKED;
+}
+
+std::optional<uint64_t> TimerWheel::nextDeadline() const noexcept
+{
+	unsigned level = 0;
+	unsigned index = 0;
+
+	if (nextSlot(level, index))
+	{
+		return slotStart(level, index);
+	}
+	return std::nullopt;
+}
+
+uint64_t TimerWheel::time() const noexcept
+{
+	return current;
+}
+
+const TimerWheel::Statistics & TimerWheel::statistics() const noexcept
+{
+	return wheel_statistics;
+}
+
+TimerWheel::Handle TimerWheel::expire(const uint64_t now_ms) noexcept
+{
+	unsigned level = 0;
+	unsigned index = 0;
+
+	while (nextSlot(level, index))
+	{
+		const uint64_t start = slotStart(level, index);
+		const unsigned slot  = level * SLOTS + index;
+
+		if (start > now_ms)
+		{
+			break;
+		}
+		current = start;
+
+		if (level == 0)
+		{
+			// All timers of a first level slot share the same deadline.
+			const Handle handle = popFront(slot);
+			Node    &    node   = nodes[handle];
+
+			wheel_statistics.fired++;
+			wheel_statistics.lateness.add(now_ms - node.deadline);
+
+			if (node.period > 0)
+			{
+				// Skip missed periods instead of catching up.
+				insert(handle, std::clamp(node.deadline + node.period, now_ms + 1, HORIZON));
+			}
+			return handle;
+		}
+
+		// The wheel time reached the slot so its timers fit into a lower level.
+		for (Handle handle = popFront(slot); handle != INVALID; handle = popFront(slot))
+		{
+			insert(handle, nodes[handle].deadline);
+			wheel_statistics.cascaded++;
+		}
+	}
+
+	current = std::max(current, now_ms);
+	return INVALID;
+}
+
+bool TimerWheel::nextSlot(unsigned & level, unsigned & index) const noexcept
+{
+	for (level = 0; level < LEVELS; level++)
+	{
+		const unsigned position = (current >> (BITS * level)) & MASK;
+		const uint64_t pending  = occupied[level] & (~uint64_t(0) << position);
+
+		if (pending != 0)
+		{
+			index = std::countr_zero(pending);
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64_t TimerWheel::slotStart(const unsigned level, const unsigned index) const noexcept
+{
+	const unsigned shift = BITS * level;
+	const uint64_t base  = (current >> (shift + BITS)) << (shift + BITS);
+
+	return base | (uint64_t(index) << shift);
+}
+
+void TimerWheel::insert(const Handle handle, const uint64_t deadline) noexcept
+{
+	const uint64_t difference = deadline ^ current;
+	const unsigned level      = difference == 0 ? 0 : (std::bit_width(difference) - 1) / BITS;
+	const unsigned index      = (deadline >> (BITS * level)) & MASK;
+	const unsigned slot       = level * SLOTS + index;
+	Node     &     node       = nodes[handle];
+	List     &     list       = slots[slot];
+
+	node.deadline = deadline;
+	node.slot     = slot;
+	node.prev     = list.tail;
+	node.next     = INVALID;
+
+	if (list.tail != INVALID)
+	{
+		nodes[list.tail].next = handle;
+	}
+	else
+	{
+		list.head = handle;
+	}
+	list.tail = handle;
+	occupied[level] |= uint64_t(1) << index;
+
+	wheel_statistics.active++;
+	wheel_statistics.peak = std::max(wheel_statistics.peak, wheel_statistics.active);
+}
+
+void TimerWheel::unlink(const Handle handle) noexcept
+{
+	Node & node = nodes[handle];
+	List & list = slots[node.slot];
+
+	if (node.prev != INVALID)
+	{
+		nodes[node.prev].next = node.next;
+	}
+	else
+	{
+		list.head = node.next;
+	}
+
+	if (node.next != INVALID)
+	{
+		nodes[node.next].prev = node.prev;
+	}
+	else
+	{
+		list.tail = node.prev;
+	}
+
+	if (list.head == INVALID)
+	{
+		occupied[node.slot / SLOTS] &= ~(uint64_t(1) << (node.slot % SLOTS));
+	}
+
+	node.prev = INVALID;
+	node.next = INVALID;
+	node.slot = UNLINKED;
+	wheel_statistics.active--;
+}
+
+TimerWheel::Handle TimerWheel::popFront(const unsigned slot) noexcept
+{
+	const Handle handle = slots[slot].head;
+
+	if (handle != INVALID)
+	{
+		unlink(handle);
+	}
+	return handle;
+}
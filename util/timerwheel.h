@@ -0,0 +1,242 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_TIMERWHEEL_H
+#define MRW_UTIL_TIMERWHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <util/histogram.h>
+
+namespace mrw::util
+{
+	/**
+	 * This class implements a hierarchical timer wheel with a resolution
+	 * of one millisecond. It only manages deadlines. The time source and
+	 * the wake up are up to the caller which passes the current time to
+	 * start() and advance() and uses nextDeadline() to schedule the next
+	 * call to advance().
+	 *
+	 * The wheel consists of LEVELS levels each of SLOTS slots. A timer is
+	 * placed into the level of the most significant bit in which its
+	 * deadline differs from the current wheel time. Each slot is an
+	 * intrusive double linked list of timers so starting, restarting and
+	 * stopping a timer are O(1). When the wheel time reaches a slot of a
+	 * higher level its timers are cascaded down to the lower levels. The
+	 * first level has a resolution of one millisecond so timers expire
+	 * in the order of their deadlines. Timers with the same deadline
+	 * expire in the order they were started.
+	 *
+	 * Timers are referenced by a Handle which is allocated once using
+	 * create() and may be started and stopped any number of times until
+	 * it is released using destroy().
+	 *
+	 * Additionally the wheel records a histogram of the expiry lateness
+	 * and a histogram of the amount of active timers sampled on each
+	 * advance() call.
+	 */
+	class TimerWheel
+	{
+	public:
+		/** The timer reference. */
+		typedef uint32_t Handle;
+
+		/** An invalid Handle. */
+		static constexpr Handle INVALID = std::numeric_limits<Handle>::max();
+
+		/**
+		 * This struct contains the statistics of the wheel.
+		 */
+		struct Statistics
+		{
+			/** The amount of currently active timers. */
+			size_t    active    = 0;
+
+			/** The maximum amount of active timers. */
+			size_t    peak      = 0;
+
+			/** The amount of expired timers. */
+			uint64_t  fired     = 0;
+
+			/** The amount of timers moved to a lower level. */
+			uint64_t  cascaded  = 0;
+
+			/** The lateness of expired timers in milliseconds. */
+			Histogram lateness;
+
+			/** The amount of active timers sampled on each advance. */
+			Histogram timers;
+		};
+
+		explicit TimerWheel(const uint64_t start_ms = 0);
+		TimerWheel(const TimerWheel & other) = delete;
+		TimerWheel & operator=(const TimerWheel & other) = delete;
+
+		/**
+		 * This method allocates an inactive timer.
+		 *
+		 * @return The Handle of the new timer.
+		 */
+		[[nodiscard]]
+		Handle create();
+
+		/**
+		 * This method stops the given timer and releases its Handle. The
+		 * Handle may be reused by a later create() call.
+		 *
+		 * @param handle The timer to release.
+		 */
+		void destroy(const Handle handle) noexcept;
+
+		/**
+		 * This method starts or restarts the given timer. A running timer
+		 * is rearmed with the new deadline.
+		 *
+		 * @param handle The timer to start.
+		 * @param now_ms The current time in milliseconds.
+		 * @param delay_ms The delay until expiry in milliseconds.
+		 * @param period_ms The period of a periodic timer or zero for a
+		 * single shot timer.
+		 */
+		void start(
+			const Handle   handle,
+			const uint64_t now_ms,
+			const uint64_t delay_ms,
+			const uint64_t period_ms = 0) noexcept;
+
+		/**
+		 * This method stops the given timer if it is running.
+		 *
+		 * @param handle The timer to stop.
+		 */
+		void stop(const Handle handle) noexcept;
+
+		/**
+		 * This method returns true if the given timer is running.
+		 *
+		 * @param handle The timer to test.
+		 * @return True if the timer is running.
+		 */
+		[[nodiscard]]
+		bool isActive(const Handle handle) const noexcept;
+
+		/**
+		 * This method advances the wheel time and calls the given function
+		 * for each expired timer in deadline order. The function may
+		 * start, stop, create and destroy timers. A periodic timer is
+		 * already rearmed when the function is called.
+		 *
+		 * @param now_ms The current time in milliseconds.
+		 * @param fire The function called with the Handle of each expired
+		 * timer.
+		 * @return The amount of expired timers.
+		 */
+		template<class F> size_t advance(const uint64_t now_ms, F && fire)
+		{
+			size_t count = 0;
+
+			for (Handle handle = expire(now_ms); handle != INVALID; handle = expire(now_ms))
+			{
+				fire(handle);
+				count++;
+			}
+			wheel_statistics.timers.add(wheel_statistics.active);
+			return count;
+		}
+
+		/**
+		 * This method returns the time until advance() should be called
+		 * next. This may be earlier than the next deadline if timers have
+		 * to be cascaded to a lower level.
+		 *
+		 * @return The next wake up time or std::nullopt if no timer is
+		 * running.
+		 */
+		[[nodiscard]]
+		std::optional<uint64_t> nextDeadline() const noexcept;
+
+		/**
+		 * This method returns the current wheel time which is the time of
+		 * the last advance() call.
+		 *
+		 * @return The wheel time in milliseconds.
+		 */
+		[[nodiscard]]
+		uint64_t time() const noexcept;
+
+		/**
+		 * This method returns the wheel statistics.
+		 *
+		 * @return The wheel statistics.
+		 */
+		[[nodiscard]]
+		const Statistics & statistics() const noexcept;
+
+	private:
+		static constexpr unsigned BITS   = 6;
+		static constexpr unsigned SLOTS  = 1 << BITS;
+		static constexpr unsigned LEVELS = 7;
+		static constexpr uint64_t MASK   = SLOTS - 1;
+
+		/** The last representable deadline. */
+		static constexpr uint64_t HORIZON = (uint64_t(1) << (BITS * LEVELS)) - 1;
+
+		static constexpr uint16_t UNLINKED = std::numeric_limits<uint16_t>::max();
+
+		struct Node
+		{
+			uint64_t deadline  = 0;
+			uint64_t period    = 0;
+			Handle   prev      = INVALID;
+			Handle   next      = INVALID;
+			uint16_t slot      = UNLINKED;
+			bool     allocated = false;
+		};
+
+		struct List
+		{
+			Handle   head = INVALID;
+			Handle   tail = INVALID;
+		};
+
+		std::vector<Node>                   nodes;
+		std::vector<Handle>                 free_nodes;
+		std::array<List, LEVELS * SLOTS>    slots;
+		std::array<uint64_t, LEVELS>        occupied{};
+		uint64_t                            current;
+		Statistics                          wheel_statistics;
+
+		/**
+		 * This method returns the next expired timer and rearms it if it
+		 * is periodic. On the way timers of higher levels are cascaded.
+		 *
+		 * @param now_ms The current time in milliseconds.
+		 * @return The expired timer or INVALID if no timer is due.
+		 */
+		Handle expire(const uint64_t now_ms) noexcept;
+
+		/**
+		 * This method finds the next occupied slot.
+		 *
+		 * @param level The level of the found slot.
+		 * @param index The index of the found slot inside its level.
+		 * @return True if a slot was found.
+		 */
+		bool nextSlot(unsigned & level, unsigned & index) const noexcept;
+		uint64_t slotStart(const unsigned level, const unsigned index) const noexcept;
+
+		void insert(const Handle handle, const uint64_t deadline) noexcept;
+		void unlink(const Handle handle) noexcept;
+		Handle popFront(const unsigned slot) noexcept;
+	};
+}
+
+#endif
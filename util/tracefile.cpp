@@ -0,0 +1,121 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <QFile>
+
+#include <util/tracefile.h>
+
+using namespace mrw::util;
+
+TraceFile::TraceFile(const QString & filename)
+{
+	QFile file(filename);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		message = file.errorString();
+		return;
+	}
+
+	const QByteArray content = file.readAll();
+	const char   *   base    = content.constData();
+
+	if (size_t(content.size()) < sizeof(TraceHeader))
+	{
+		message = "File too short";
+		return;
+	}
+
+	std::memcpy(&trace_header, base, sizeof(TraceHeader));
+	if ((std::memcmp(trace_header.magic, "MRWTRACE", sizeof(trace_header.magic)) != 0) ||
+		(trace_header.version != TraceRecorder::VERSION) ||
+		(trace_header.record_size != sizeof(TraceRecord)) ||
+		!std::has_single_bit(trace_header.capacity) ||
+		(trace_header.name_size == 0))
+	{
+		message = "No trace file";
+		return;
+	}
+
+	const size_t name_table = size_t(trace_header.name_capacity) * trace_header.name_size;
+	const size_t expected   = sizeof(TraceHeader) + name_table + trace_header.capacity * sizeof(TraceRecord);
+
+	if (size_t(content.size()) < expected)
+	{
+		message = "Trace file truncated";
+		return;
+	}
+
+	const char * name_base = base + sizeof(TraceHeader);
+	const char * ring_base = name_base + name_table;
+	const size_t count     = std::min(trace_header.names, trace_header.name_capacity);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const char * entry = name_base + i * trace_header.name_size;
+
+		names << QString::fromUtf8(entry, qstrnlen(entry, trace_header.name_size));
+	}
+
+	const std::uint64_t next  = trace_header.next;
+	const std::uint64_t first = next > trace_header.capacity ? next - trace_header.capacity : 0;
+	const std::uint64_t mask  = trace_header.capacity - 1;
+
+	lost_count = first;
+	trace_records.reserve(next - first);
+	for (std::uint64_t i = first; i < next; i++)
+	{
+		TraceRecord record;
+
+		std::memcpy(&record, ring_base + (i & mask) * sizeof(TraceRecord), sizeof(TraceRecord));
+		if ((record.sequence == std::uint32_t(i + 1)) && (record.type != std::uint8_t(TraceType::NONE)))
+		{
+			trace_records.push_back(record);
+		}
+		else
+		{
+			torn_count++;
+		}
+	}
+}
+
+bool TraceFile::valid() const noexcept
+{
+	return message.isEmpty();
+}
+
+const QString & TraceFile::error() const noexcept
+{
+	return message;
+}
+
+const TraceHeader & TraceFile::header() const noexcept
+{
+	return trace_header;
+}
+
+const std::vector<TraceRecord> & TraceFile::records() const noexcept
+{
+	return trace_records;
+}
+
+QString TraceFile::name(const std::uint16_t index) const
+{
+	return index < names.size() ? names[index] : QString("?");
+}
+
+std::uint64_t TraceFile::lost() const noexcept
+{
+	return lost_count;
+}
+
+std::uint64_t TraceFile::torn() const noexcept
+{
+	return torn_count;
+}
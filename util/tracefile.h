@@ -0,0 +1,111 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_TRACEFILE_H
+#define MRW_UTIL_TRACEFILE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#include <util/tracerecorder.h>
+
+namespace mrw::util
+{
+	/**
+	 * This class reads a trace file written by the TraceRecorder. Only
+	 * completely written records are loaded in the order they were
+	 * recorded. Records overwritten by the ring or torn by a crash are
+	 * counted but skipped. The file may be read while the application is
+	 * still recording.
+	 *
+	 * @see TraceRecorder
+	 */
+	class TraceFile
+	{
+	public:
+		/**
+		 * This constructor loads the given trace file.
+		 *
+		 * @param filename The trace file to read.
+		 */
+		explicit TraceFile(const QString & filename);
+		TraceFile() = delete;
+
+		/**
+		 * This method returns true if the trace file was read successfully.
+		 *
+		 * @return True if valid.
+		 */
+		[[nodiscard]]
+		bool valid() const noexcept;
+
+		/**
+		 * This method returns the reason why the trace file is not valid.
+		 *
+		 * @return The error message or an empty string.
+		 */
+		[[nodiscard]]
+		const QString & error() const noexcept;
+
+		/**
+		 * This method returns the header of the trace file.
+		 *
+		 * @return The trace file header.
+		 */
+		[[nodiscard]]
+		const TraceHeader & header() const noexcept;
+
+		/**
+		 * This method returns all completely written records in recording
+		 * order.
+		 *
+		 * @return The valid records.
+		 */
+		[[nodiscard]]
+		const std::vector<TraceRecord> & records() const noexcept;
+
+		/**
+		 * This method returns the name of the given name index.
+		 *
+		 * @param index The name index of a TraceRecord.
+		 * @return The name or "?" if the index is unknown.
+		 */
+		[[nodiscard]]
+		QString name(const std::uint16_t index) const;
+
+		/**
+		 * This method returns the amount of records overwritten by the
+		 * ring.
+		 *
+		 * @return The amount of lost records.
+		 */
+		[[nodiscard]]
+		std::uint64_t lost() const noexcept;
+
+		/**
+		 * This method returns the amount of records which were incompletely
+		 * written.
+		 *
+		 * @return The amount of torn records.
+		 */
+		[[nodiscard]]
+		std::uint64_t torn() const noexcept;
+
+	private:
+		TraceHeader                trace_header{};
+		std::vector<TraceRecord>   trace_records;
+		QStringList                names;
+		QString                    message;
+		std::uint64_t              lost_count = 0;
+		std::uint64_t              torn_count = 0;
+	};
+}
+
+#endif
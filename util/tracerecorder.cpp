@@ -0,0 +1,225 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <QDateTime>
+#include <QFile>
+
+#include <util/log.h>
+#include <util/tracerecorder.h>
+
+using namespace mrw::util;
+
+TraceRecorder::~TraceRecorder()
+{
+	close();
+}
+
+bool TraceRecorder::open(const QString & filename, const size_t capacity)
+{
+	close();
+
+	const size_t count = std::bit_ceil(std::max<size_t>(capacity, 2));
+	const size_t size  = sizeof(TraceHeader) + NAME_CAPACITY * NAME_SIZE + count * sizeof(TraceRecord);
+	const int    fd    = ::open(QFile::encodeName(filename).constData(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (fd < 0)
+	{
+		qCWarning(log).noquote() << "Cannot create trace file" << filename << ":" << strerror(errno);
+		return false;
+	}
+
+	if (ftruncate(fd, off_t(size)) != 0)
+	{
+		qCWarning(log).noquote() << "Cannot resize trace file" << filename << ":" << strerror(errno);
+		::close(fd);
+		return false;
+	}
+
+	void * memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	// The mapping keeps the file referenced.
+	::close(fd);
+	if (memory == MAP_FAILED)
+	{
+		qCWarning(log).noquote() << "Cannot map trace file" << filename << ":" << strerror(errno);
+		return false;
+	}
+
+	char * base = static_cast<char *>(memory);
+
+	header    = reinterpret_cast<TraceHeader *>(base);
+	names     = base + sizeof(TraceHeader);
+	mask      = count - 1;
+	file_size = size;
+
+	std::memcpy(header->magic, "MRWTRACE", sizeof(header->magic));
+	header->version       = VERSION;
+	header->record_size   = sizeof(TraceRecord);
+	header->capacity      = count;
+	header->name_size     = NAME_SIZE;
+	header->name_capacity = NAME_CAPACITY;
+	header->base_ns       = now();
+	header->epoch_ms      = QDateTime::currentMSecsSinceEpoch();
+	header->next          = 0;
+	header->names         = 0;
+	name_map.clear();
+
+	records = reinterpret_cast<TraceRecord *>(names + NAME_CAPACITY * NAME_SIZE);
+
+	qCInfo(log).noquote() << "Tracing" << count << "records into" << filename;
+	return true;
+}
+
+void TraceRecorder::close() noexcept
+{
+	if (header != nullptr)
+	{
+		records = nullptr;
+		msync(header, file_size, MS_ASYNC);
+		munmap(header, file_size);
+		header    = nullptr;
+		names     = nullptr;
+		mask      = 0;
+		file_size = 0;
+	}
+}
+
+std::uint16_t TraceRecorder::name(const QString & text)
+{
+	if (!isOpen())
+	{
+		return NO_NAME;
+	}
+
+	std::lock_guard guard(name_mutex);
+
+	auto it = name_map.find(text);
+
+	if (it != name_map.end())
+	{
+		return *it;
+	}
+
+	std::atomic_ref<std::uint32_t> used(header->names);
+	const std::uint32_t            index = used.load(std::memory_order_relaxed);
+
+	if (index >= std::min<std::uint32_t>(NAME_CAPACITY, NO_NAME))
+	{
+		return NO_NAME;
+	}
+
+	const QByteArray & utf8  = text.toUtf8();
+	char       *       entry = names + size_t(index) * NAME_SIZE;
+	const size_t       size  = std::min<size_t>(utf8.size(), NAME_SIZE - 1);
+
+	std::memcpy(entry, utf8.constData(), size);
+	std::memset(entry + size, 0, NAME_SIZE - size);
+	used.store(index + 1, std::memory_order_release);
+
+	name_map.insert(text, std::uint16_t(index));
+	return std::uint16_t(index);
+}
+
+void TraceRecorder::frame(
+	const TraceType      type,
+	const std::uint32_t  id,
+	const bool           extended,
+	const std::uint8_t * data,
+	const size_t         size) noexcept
+{
+	std::uint32_t sequence = 0;
+	TraceRecord * record   = claim(sequence);
+
+	if (record != nullptr)
+	{
+		record->type   = std::uint8_t(type);
+		record->length = std::uint8_t(std::min(size, sizeof(record->data)));
+		record->name   = NO_NAME;
+		record->source = extended ? (id | EXTENDED) : id;
+		record->value  = 0;
+		std::memset(record->data, 0, sizeof(record->data));
+		std::memcpy(record->data, data, record->length);
+		commit(record, sequence);
+	}
+}
+
+void TraceRecorder::event(
+	const TraceType      type,
+	const std::uint16_t  source,
+	const std::uint16_t  event,
+	const std::uint32_t  value) noexcept
+{
+	std::uint32_t sequence = 0;
+	TraceRecord * record   = claim(sequence);
+
+	if (record != nullptr)
+	{
+		record->type   = std::uint8_t(type);
+		record->length = 0;
+		record->name   = event;
+		record->source = source;
+		record->value  = value;
+		std::memset(record->data, 0, sizeof(record->data));
+		commit(record, sequence);
+	}
+}
+
+void TraceRecorder::batch(const std::uint32_t id, const std::uint64_t duration_ns) noexcept
+{
+	std::uint32_t sequence = 0;
+	TraceRecord * record   = claim(sequence);
+
+	if (record != nullptr)
+	{
+		record->type   = std::uint8_t(TraceType::BATCH);
+		record->length = 0;
+		record->name   = NO_NAME;
+		record->source = id;
+		record->value  = std::uint32_t(std::min<std::uint64_t>(duration_ns / 1000, UINT32_MAX));
+		std::memset(record->data, 0, sizeof(record->data));
+		commit(record, sequence);
+	}
+}
+
+std::uint64_t TraceRecorder::now() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceRecord * TraceRecorder::claim(std::uint32_t & sequence) noexcept
+{
+	if (!isOpen())
+	{
+		return nullptr;
+	}
+
+	const std::uint64_t index  = std::atomic_ref<std::uint64_t>(header->next).fetch_add(1, std::memory_order_relaxed);
+	TraceRecord    *    record = &records[index & mask];
+
+	// Invalidate the slot until the record is complete.
+	std::atomic_ref<std::uint32_t>(record->sequence).store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	sequence     = std::uint32_t(index + 1);
+	record->time = now() - header->base_ns;
+	return record;
+}
+
+void TraceRecorder::commit(TraceRecord * record, const std::uint32_t sequence) noexcept
+{
+	std::atomic_ref<std::uint32_t>(record->sequence).store(sequence, std::memory_order_release);
+}
@@ -0,0 +1,265 @@
+//
+//  SPDX-License-Identifier: MIT
+//  SPDX-FileCopyrightText: Copyright (C) 2008-2026 Steffen A. Mork
+//
+
+#pragma once
+
+#ifndef MRW_UTIL_TRACERECORDER_H
+#define MRW_UTIL_TRACERECORDER_H
+
+#include <cstdint>
+#include <mutex>
+
+#include <QHash>
+#include <QString>
+
+#include <util/singleton.h>
+
+namespace mrw::util
+{
+	/**
+	 * The kind of a TraceRecord.
+	 */
+	enum class TraceType : std::uint8_t
+	{
+		/** An unused or incompletely written record. */
+		NONE    = 0,
+
+		/** A received CAN frame. */
+		CAN_RX  = 1,
+
+		/** A sent CAN frame. */
+		CAN_TX  = 2,
+
+		/** An out event of a statechart. */
+		EVENT   = 3,
+
+		/** A time event of a statechart. */
+		TIMEOUT = 4,
+
+		/** A completed Batch. */
+		BATCH   = 5
+	};
+
+	/**
+	 * This struct is the header at the start of a trace file. It is
+	 * followed by the name table and the record ring.
+	 */
+	struct TraceHeader
+	{
+		/** The magic "MRWTRACE". */
+		char          magic[8];
+
+		/** The file format version. */
+		std::uint32_t version;
+
+		/** The size of one TraceRecord. */
+		std::uint32_t record_size;
+
+		/** The amount of records in the ring which is a power of two. */
+		std::uint64_t capacity;
+
+		/** The size of one name entry including the terminating zero. */
+		std::uint32_t name_size;
+
+		/** The maximum amount of names. */
+		std::uint32_t name_capacity;
+
+		/** The monotonic time of opening in nanoseconds. */
+		std::uint64_t base_ns;
+
+		/** The wall clock time of opening in milliseconds since epoch. */
+		std::int64_t  epoch_ms;
+
+		/** The amount of ever written records. */
+		std::uint64_t next;
+
+		/** The amount of used names. */
+		std::uint32_t names;
+
+		std::uint32_t reserved;
+	};
+
+	/**
+	 * This struct is one fixed size entry of the trace ring.
+	 */
+	struct TraceRecord
+	{
+		/** The monotonic time since opening in nanoseconds. */
+		std::uint64_t time;
+
+		/**
+		 * The low bits of the record number plus one. It is written last
+		 * so a reader detects torn or overwritten records.
+		 */
+		std::uint32_t sequence;
+
+		/** The TraceType. */
+		std::uint8_t  type;
+
+		/** The payload length of a CAN frame. */
+		std::uint8_t  length;
+
+		/** The name index of an event. */
+		std::uint16_t name;
+
+		/**
+		 * The CAN identifier with bit 31 set for extended frames, the
+		 * name index of the event source or the Batch ID.
+		 */
+		std::uint32_t source;
+
+		/** The time event ID or the Batch duration in microseconds. */
+		std::uint32_t value;
+
+		/** The CAN payload. */
+		std::uint8_t  data[8];
+	};
+
+	static_assert(sizeof(TraceHeader) == 64, "Unexpected trace header size!");
+	static_assert(sizeof(TraceRecord) == 32, "Unexpected trace record size!");
+
+	/**
+	 * This singleton writes a compact binary trace into a memory mapped
+	 * ring file. The file contains a TraceHeader, a table of names and a
+	 * ring of fixed size TraceRecord entries. Recording a TraceRecord is
+	 * lock free and never calls the kernel. Any thread may record. If the
+	 * ring is full the oldest records are overwritten. Since the file is
+	 * shared memory the trace survives a crash of the application.
+	 *
+	 * Names of event sources and events are stored once in the name table
+	 * and are referenced by their index.
+	 *
+	 * If no trace file is open all record methods return immediately. The
+	 * trace file has to be opened before any other thread records.
+	 *
+	 * @see TraceType
+	 */
+	class TraceRecorder : public Singleton<TraceRecorder>
+	{
+		friend class Singleton<TraceRecorder>;
+
+	public:
+		/** The file format version. */
+		static constexpr std::uint32_t VERSION          = 1;
+
+		/** The size of one name entry. */
+		static constexpr std::uint32_t NAME_SIZE        = 48;
+
+		/** The maximum amount of names. */
+		static constexpr std::uint32_t NAME_CAPACITY    = 8192;
+
+		/** The name index of unknown names. */
+		static constexpr std::uint16_t NO_NAME          = 0xffff;
+
+		/** The default amount of records. */
+		static constexpr size_t        DEFAULT_CAPACITY = 1 << 20;
+
+		/** Marks an extended CAN identifier in TraceRecord::source. */
+		static constexpr std::uint32_t EXTENDED         = 0x80000000;
+
+		~TraceRecorder();
+
+		/**
+		 * This method creates or truncates the given trace file and maps
+		 * it into memory. An already open trace file is closed first.
+		 *
+		 * @param filename The trace file to write.
+		 * @param capacity The amount of records rounded up to a power of
+		 * two.
+		 * @return True on success.
+		 */
+		bool open(const QString & filename, const size_t capacity = DEFAULT_CAPACITY);
+
+		/**
+		 * This method unmaps and closes the trace file.
+		 */
+		void close() noexcept;
+
+		/**
+		 * This method returns true if a trace file is open.
+		 *
+		 * @return True if recording.
+		 */
+		[[nodiscard]]
+		inline bool isOpen() const noexcept
+		{
+			return records != nullptr;
+		}
+
+		/**
+		 * This method returns the index of the given name in the name
+		 * table. Unknown names are appended. Names are truncated to
+		 * NAME_SIZE - 1 bytes.
+		 *
+		 * @param text The name to look up.
+		 * @return The name index or NO_NAME if the table is full or no
+		 * trace file is open.
+		 */
+		std::uint16_t name(const QString & text);
+
+		/**
+		 * This method records a received or sent CAN frame.
+		 *
+		 * @param type Either TraceType::CAN_RX or TraceType::CAN_TX.
+		 * @param id The CAN identifier.
+		 * @param extended True for the extended frame format.
+		 * @param data The payload.
+		 * @param size The payload length.
+		 */
+		void frame(
+			const TraceType      type,
+			const std::uint32_t  id,
+			const bool           extended,
+			const std::uint8_t * data,
+			const size_t         size) noexcept;
+
+		/**
+		 * This method records a statechart event.
+		 *
+		 * @param type Either TraceType::EVENT or TraceType::TIMEOUT.
+		 * @param source The name index of the event source.
+		 * @param event The name index of the event.
+		 * @param value An additional value like the time event ID.
+		 */
+		void event(
+			const TraceType      type,
+			const std::uint16_t  source,
+			const std::uint16_t  event,
+			const std::uint32_t  value = 0) noexcept;
+
+		/**
+		 * This method records a completed Batch.
+		 *
+		 * @param id The Batch ID.
+		 * @param duration_ns The time from creating the Batch until its
+		 * completion in nanoseconds.
+		 */
+		void batch(const std::uint32_t id, const std::uint64_t duration_ns) noexcept;
+
+		/**
+		 * This method returns the monotonic time in nanoseconds.
+		 *
+		 * @return The monotonic time.
+		 */
+		[[nodiscard]]
+		static std::uint64_t now() noexcept;
+
+	private:
+		TraceRecorder() = default;
+
+		TraceRecord * claim(std::uint32_t & sequence) noexcept;
+		void          commit(TraceRecord * record, const std::uint32_t sequence) noexcept;
+
+		TraceHeader             *          header    = nullptr;
+		char                    *          names     = nullptr;
+		TraceRecord             *          records   = nullptr;
+		size_t                             mask      = 0;
+		size_t                             file_size = 0;
+		std::mutex                         name_mutex;
+		QHash<QString, std::uint16_t>      name_map;
+	};
+}
+
+#endif